@@ -157,6 +157,7 @@ install (
     src/ripple/protocol/STParsedJSON.h
     src/ripple/protocol/STPathSet.h
     src/ripple/protocol/STTx.h
+    src/ripple/protocol/STTxView.h
     src/ripple/protocol/STValidation.h
     src/ripple/protocol/STVector256.h
     src/ripple/protocol/SecretKey.h
@@ -338,6 +339,7 @@ target_sources (chainsqld PRIVATE
   src/ripple/protocol/impl/STParsedJSON.cpp
   src/ripple/protocol/impl/STPathSet.cpp
   src/ripple/protocol/impl/STTx.cpp
+  src/ripple/protocol/impl/STTxView.cpp
   src/ripple/protocol/impl/STValidation.cpp
   src/ripple/protocol/impl/STVar.cpp
   src/ripple/protocol/impl/STVector256.cpp
@@ -408,6 +410,7 @@ target_sources (chainsqld PRIVATE
   src/ripple/app/misc/impl/LoadFeeTrack.cpp
   src/ripple/app/misc/impl/Manifest.cpp
   src/ripple/app/misc/impl/Transaction.cpp
+  src/ripple/app/misc/impl/TxBatcher.cpp
   src/ripple/app/misc/impl/TxQ.cpp
   src/ripple/app/misc/impl/ValidatorKeys.cpp
   src/ripple/app/misc/impl/ValidatorList.cpp
@@ -478,6 +481,7 @@ target_sources (chainsqld PRIVATE
   src/ripple/core/impl/DatabaseCon.cpp
   src/ripple/core/impl/Job.cpp
   src/ripple/core/impl/JobQueue.cpp
+  src/ripple/core/impl/JobLanes.cpp
   src/ripple/core/impl/LoadEvent.cpp
   src/ripple/core/impl/LoadMonitor.cpp
   src/ripple/core/impl/SNTPClock.cpp
@@ -489,6 +493,7 @@ target_sources (chainsqld PRIVATE
      main sources:
        subdir: ledger
   #]===============================]
+  src/ripple/ledger/impl/ApplyArena.cpp
   src/ripple/ledger/impl/ApplyStateTable.cpp
   src/ripple/ledger/impl/ApplyView.cpp
   src/ripple/ledger/impl/ApplyViewBase.cpp
@@ -646,6 +651,7 @@ target_sources (chainsqld PRIVATE
   src/ripple/rpc/impl/ShardArchiveHandler.cpp
   src/ripple/rpc/impl/ShardVerificationScheduler.cpp
   src/ripple/rpc/impl/Status.cpp
+  src/ripple/rpc/impl/StreamWriter.cpp
   src/ripple/rpc/impl/TransactionSign.cpp
 
   #[===============================[
@@ -677,12 +683,15 @@ target_sources (chainsqld PRIVATE
   src/peersafe/app/misc/impl/ExtVM.cpp
   src/peersafe/app/misc/impl/SleOps.cpp
   src/peersafe/app/misc/impl/StateManager.cpp
+  src/peersafe/app/misc/impl/StoragePrefetch.cpp
   src/peersafe/app/misc/impl/TxPool.cpp
   src/peersafe/app/sql/SQLConditionTree.cpp
   src/peersafe/app/sql/STTx2SQL.cpp
   src/peersafe/app/sql/TxStore.cpp
   src/peersafe/app/storage/impl/TableStorage.cpp
   src/peersafe/app/storage/impl/TableStorageItem.cpp
+  src/peersafe/app/table/impl/QueryCache.cpp
+  src/peersafe/app/table/impl/TableMirror.cpp
   src/peersafe/app/table/impl/TableAuditItem.cpp
   src/peersafe/app/table/impl/TableDumpItem.cpp
   src/peersafe/app/table/impl/TableStatusDB.cpp
@@ -707,6 +716,10 @@ target_sources (chainsqld PRIVATE
   src/peersafe/app/util/TableSyncUtil.cpp
   src/peersafe/app/prometh/impl/PrometheusClient.cpp
   src/peersafe/app/ledger/LedgerAdjust.cpp
+  src/peersafe/app/ledger/LedgerObjectCounter.cpp
+  src/peersafe/app/ledger/LedgerTimeline.cpp
+  src/peersafe/app/ledger/TxSetPreflight.cpp
+  src/peersafe/app/ledger/StatisStore.cpp
   src/peersafe/basics/impl/characterUtilities.cpp
   src/peersafe/crypto/impl/AES.cpp
   src/peersafe/crypto/impl/ECDSAKey.cpp
@@ -729,9 +742,9 @@ target_sources (chainsqld PRIVATE
   src/peersafe/precompiled/PreContractRegister.cpp
   src/peersafe/precompiled/ABI.cpp
   src/peersafe/precompiled/TableOpPrecompiled.cpp
+  src/peersafe/precompiled/TableRows.cpp
   src/peersafe/precompiled/ToolsPrecompiled.cpp
   src/peersafe/precompiled/Utils.cpp
-  src/peersafe/precompiled/ripemd160.cpp
   src/peersafe/protocol/impl/Contract.cpp
   src/peersafe/protocol/impl/STEntry.cpp
   src/peersafe/protocol/impl/STMap256.cpp
@@ -751,7 +764,9 @@ target_sources (chainsqld PRIVATE
   src/peersafe/consensus/pop/impl/PopAdaptor.cpp
   src/peersafe/consensus/pop/impl/PopConsensus.cpp
   src/peersafe/consensus/hotstuff/impl/Block.cpp
+  src/peersafe/consensus/hotstuff/impl/BlockLog.cpp
   src/peersafe/consensus/hotstuff/impl/BlockStorage.cpp
+  src/peersafe/consensus/hotstuff/impl/CertVerifier.cpp
   src/peersafe/consensus/hotstuff/impl/EpochChange.cpp
   src/peersafe/consensus/hotstuff/impl/EpochState.cpp
   src/peersafe/consensus/hotstuff/impl/Hotstuff.cpp
@@ -780,6 +795,7 @@ target_sources (chainsqld PRIVATE
   src/peersafe/rpc/handlers/TableHandler.cpp
   src/peersafe/rpc/handlers/TableName.cpp
   src/peersafe/rpc/handlers/LedgerObjects.cpp
+  src/peersafe/rpc/handlers/LedgerTimeline.cpp
   src/peersafe/rpc/handlers/MallocTrim.cpp
   src/peersafe/rpc/handlers/NodeSize.cpp
   src/peersafe/rpc/handlers/MonitorStatis.cpp
@@ -805,6 +821,7 @@ target_sources (chainsqld PRIVATE
   #]===============================]
   src/wasmvm/vm/impl/action.cc
   src/wasmvm/vm/impl/chainsqlWasmVm.cc
+  src/wasmvm/vm/impl/moduleCache.cc
   ${test_srcs}
   #[===============================[
       test sources:
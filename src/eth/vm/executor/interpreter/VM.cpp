@@ -5,11 +5,55 @@
 #include "VM.h"
 #include <eth/evmc/include/evmc/evmc.hpp>
 #include <eth/vm/utils/keccak.h>
+#include <memory>
+#include <vector>
 // #include <eth/ethash/include/ethash/keccak.hpp>
 
 uint64_t eth::VMSchedule::dropsPerByte = 1000;
+std::atomic<uint64_t> eth::VM::s_memoryGrows{0};
+
 namespace
 {
+// A thread runs the calls nested in a call on the same thread, so the VMs
+// it keeps are used as a stack: the Nth of them serves depth N.
+constexpr size_t maxPooledVMs = 32;
+// A VM whose buffers grew past this is freed rather than kept
+constexpr size_t maxPooledCapacity = 1024 * 1024;
+
+std::atomic<bool> s_pooling{true};
+std::atomic<uint64_t> s_created{0};
+std::atomic<uint64_t> s_reused{0};
+
+thread_local std::vector<std::unique_ptr<eth::VM>> t_pool;
+
+std::unique_ptr<eth::VM> acquireVM()
+{
+    if (s_pooling.load(std::memory_order_relaxed) && !t_pool.empty())
+    {
+        auto vm = std::move(t_pool.back());
+        t_pool.pop_back();
+        s_reused.fetch_add(1, std::memory_order_relaxed);
+        return vm;
+    }
+    s_created.fetch_add(1, std::memory_order_relaxed);
+    return std::make_unique<eth::VM>();
+}
+
+void releaseVM(std::unique_ptr<eth::VM> _vm, eth::owning_bytes_ref& _output)
+{
+    if (!s_pooling.load(std::memory_order_relaxed) || t_pool.size() >= maxPooledVMs)
+        return;
+
+    // The memory of the VM was moved into the output by RETURN or REVERT
+    if (!_output.empty())
+        _vm->reclaim(_output.takeBytes());
+    if (_vm->capacity() > maxPooledCapacity)
+        return;
+
+    _vm->reset();
+    t_pool.push_back(std::move(_vm));
+}
+
 void destroy(evmc_vm* _instance)
 {
     (void)_instance;
@@ -31,7 +75,7 @@ evmc_result execute(evmc_vm* _instance, const evmc_host_interface* _host,
     size_t _codeSize) noexcept
 {
     //(void)_instance;
-    std::unique_ptr<eth::VM> vm{new eth::VM};
+    std::unique_ptr<eth::VM> vm = acquireVM();
 
     evmc_result result = {};
 	eth::owning_bytes_ref output;
@@ -106,10 +150,28 @@ evmc_result execute(evmc_vm* _instance, const evmc_host_interface* _host,
         result.release = delete_output;
     }
 
+    releaseVM(std::move(vm), output);
     return result;
 }
 }  // namespace
 
+namespace eth
+{
+InterpreterPoolStats interpreterPoolStats() noexcept
+{
+    InterpreterPoolStats stats;
+    stats.created = s_created.load(std::memory_order_relaxed);
+    stats.reused = s_reused.load(std::memory_order_relaxed);
+    stats.memoryGrows = VM::s_memoryGrows.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void setInterpreterPooling(bool _enable) noexcept
+{
+    s_pooling.store(_enable, std::memory_order_relaxed);
+}
+}  // namespace eth
+
 extern "C" evmc_vm* evmc_create_aleth_interpreter() noexcept
 {
     // TODO: Allow creating multiple instances with different configurations.
@@ -207,7 +269,11 @@ void VM::updateMem(uint64_t _newMem)
     m_newMemSize = (_newMem + 31) / 32 * 32;
     updateGas();
     if (m_newMemSize > m_mem.size())
+    {
+        if (m_newMemSize > m_mem.capacity())
+            s_memoryGrows.fetch_add(1, std::memory_order_relaxed);
         m_mem.resize(m_newMemSize);
+    }
 }
 
 void VM::logGasMem()
@@ -252,6 +318,47 @@ void VM::fetchInstruction()
     m_copyMemSize = 0;
 }
 
+void VM::reset()
+{
+    m_io_gas = 0;
+    m_exception = 0;
+    m_host = nullptr;
+    m_context = nullptr;
+    m_message = nullptr;
+    m_tx_context.reset();
+    m_bounce = nullptr;
+    m_nSteps = 0;
+    m_output = owning_bytes_ref{};
+
+    // clear() keeps the capacity, and memory grown again by resize() is
+    // zeroed as the EVM requires
+    m_mem.clear();
+    m_code.clear();
+    m_returnData.clear();
+    m_pool.clear();
+    m_beginSubs.clear();
+    m_jumpDests.clear();
+
+    m_PC = 0;
+    m_SP = m_SPP = m_stackEnd;
+    m_runGas = 0;
+    m_newMemSize = 0;
+    m_copyMemSize = 0;
+}
+
+void VM::reclaim(bytes&& _mem)
+{
+    if (_mem.capacity() > m_mem.capacity())
+        m_mem = std::move(_mem);
+}
+
+size_t VM::capacity() const
+{
+    return m_mem.capacity() + m_code.capacity() + m_returnData.capacity() +
+        m_pool.capacity() * sizeof(intx::uint256) +
+        (m_beginSubs.capacity() + m_jumpDests.capacity()) * sizeof(uint64_t);
+}
+
 evmc_tx_context const& VM::getTxContext()
 {
     if (!m_tx_context)
@@ -267,6 +374,7 @@ evmc_tx_context const& VM::getTxContext()
 owning_bytes_ref VM::exec(const evmc_host_interface* _host, evmc_host_context* _context,
     evmc_revision _rev, const evmc_message* _msg, uint8_t const* _code, size_t _codeSize)
 {
+    reset();
     m_host = _host;
     m_context = _context;
     m_rev = _rev;
@@ -13,6 +13,8 @@
 
 #include <boost/optional.hpp>
 
+#include <atomic>
+
 //todo: the version should be in build info.
 #define INTERPRETER_VERSION "0.0.1"
 
@@ -61,6 +63,18 @@ public:
     owning_bytes_ref exec(const evmc_host_interface* _host, evmc_host_context* _context,
         evmc_revision _rev, const evmc_message* _msg, uint8_t const* _code, size_t _codeSize);
 
+    /// Forget the previous execution, keeping the capacity of the buffers.
+    void reset();
+
+    /// Take back the memory an output was moved out of, once it was copied.
+    void reclaim(bytes&& _mem);
+
+    /// Bytes allocated for the buffers of this VM.
+    size_t capacity() const;
+
+    /// Times the memory of any VM had to be reallocated to grow.
+    static std::atomic<uint64_t> s_memoryGrows;
+
     uint64_t m_io_gas = 0;
     int m_exception = 0;
 private:
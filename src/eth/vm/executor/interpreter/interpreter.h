@@ -6,6 +6,10 @@
 #include <eth/evmc/include/evmc/evmc.h>
 #include <eth/evmc/include/evmc/utils.h>
 
+#if __cplusplus
+#include <cstdint>
+#endif
+
 //#define EVMC_EXPORT
 //
 //#if __cplusplus
@@ -23,3 +27,23 @@ EVMC_EXPORT struct evmc_vm* evmc_create_aleth_interpreter() EVMC_NOEXCEPT;
 #if __cplusplus
 }
 #endif
+
+#if __cplusplus
+namespace eth
+{
+/// Counters of the VM instances each thread keeps for the calls it executes.
+/// A call nested N deep runs on the Nth VM of the thread, whose memory, stack,
+/// code and return data buffers are still allocated from the previous call.
+struct InterpreterPoolStats
+{
+    uint64_t created = 0;       ///< VM instances allocated
+    uint64_t reused = 0;        ///< calls run on a pooled VM
+    uint64_t memoryGrows = 0;   ///< times the memory of a VM was reallocated
+};
+
+InterpreterPoolStats interpreterPoolStats() noexcept;
+
+/// Pooling is on by default, turning it off allocates a VM per call.
+void setInterpreterPooling(bool _enable) noexcept;
+}  // namespace eth
+#endif
@@ -4,159 +4,202 @@
 namespace eth
 {
 
-/** libkeccak-tiny
+/** Keccak-256, as Ethereum uses it: Keccak with the original 0x01 padding,
+ *  rather than the 0x06 of FIPS 202 SHA3-256.
  *
- * A single-file implementation of SHA-3 and SHAKE.
- *
- * Implementor: David Leon Gil
- * License: CC0, attribution kindly requested. Blame taken too,
- * but not liability.
+ *  The state is kept in 64 bit lanes and the rounds are unrolled. Six lanes
+ *  are kept complemented during the permutation, which turns most of the
+ *  NOTs of the chi step into ORs ("lane complementing", see the Keccak
+ *  implementation overview, section 2.2).
  */
 
-/******** The Keccak-f[1600] permutation ********/
-
-/*** Constants. ***/
-static const uint8_t rho[24] = \
-  { 1,  3,   6, 10, 15, 21,
-	28, 36, 45, 55,  2, 14,
-	27, 41, 56,  8, 25, 43,
-	62, 18, 39, 61, 20, 44};
-static const uint8_t pi[24] = \
-  {10,  7, 11, 17, 18, 3,
-   5, 16,  8, 21, 24, 4,
-   15, 23, 19, 13, 12, 2,
-   20, 14, 22,  9, 6,  1};
-static const uint64_t RC[24] = \
-  {1ULL, 0x8082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
-   0x808bULL, 0x80000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
-   0x8aULL, 0x88ULL, 0x80008009ULL, 0x8000000aULL,
-   0x8000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
-   0x8000000000008002ULL, 0x8000000000000080ULL, 0x800aULL, 0x800000008000000aULL,
-   0x8000000080008081ULL, 0x8000000000008080ULL, 0x80000001ULL, 0x8000000080008008ULL};
-
-/*** Helper macros to unroll the permutation. ***/
-#define rol(x, s) (((x) << s) | ((x) >> (64 - s)))
-#define REPEAT6(e) e e e e e e
-#define REPEAT24(e) REPEAT6(e e e e)
-#define REPEAT5(e) e e e e e
-#define FOR5(v, s, e) \
-  v = 0;            \
-  REPEAT5(e; v = decltype(v)(v + s);)
-
-/*** Keccak-f[1600] ***/
-static inline void keccakf(void* state) {
-	uint64_t* a = (uint64_t*)state;
-	uint64_t b[5] = {0};
-	uint64_t t = 0;
-	uint8_t x, y;
-
-	for (int i = 0; i < 24; i++) {
-		// Theta
-		FOR5(x, 1,
-			 b[x] = 0;
-					 FOR5(y, 5,
-						  b[x] ^= a[x + y]; ))
-		FOR5(x, 1,
-			 FOR5(y, 5,
-				  a[y + x] ^= b[(x + 4) % 5] ^ rol(b[(x + 1) % 5], 1); ))
-		// Rho and pi
-		t = a[1];
-		x = 0;
-		REPEAT24(b[0] = a[pi[x]];
-						 a[pi[x]] = rol(t, rho[x]);
-						 t = b[0];
-						 x++; )
-		// Chi
-		FOR5(y,
-			 5,
-			 FOR5(x, 1,
-				  b[x] = a[y + x];)
-					 FOR5(x, 1,
-					 a[y + x] = b[x] ^ ((~b[(x + 1) % 5]) & b[(x + 2) % 5]); ))
-		// Iota
-		a[0] ^= RC[i];
-	}
+namespace
+{
+
+constexpr size_t rate = 136;  // 1600 - 2 * 256 bits
+constexpr size_t rateLanes = rate / 8;
+
+constexpr uint64_t RC[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+    0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL};
+
+inline uint64_t rol(uint64_t x, unsigned s)
+{
+    return (x << s) | (x >> (64 - s));
+}
+
+// Byte order independent, compilers turn these into a single load or store
+inline uint64_t load64(uint8_t const* p)
+{
+    return uint64_t(p[0]) | uint64_t(p[1]) << 8 | uint64_t(p[2]) << 16 |
+        uint64_t(p[3]) << 24 | uint64_t(p[4]) << 32 | uint64_t(p[5]) << 40 |
+        uint64_t(p[6]) << 48 | uint64_t(p[7]) << 56;
+}
+
+inline void store64(uint8_t* p, uint64_t v)
+{
+    for (int i = 0; i < 8; ++i)
+        p[i] = uint8_t(v >> (8 * i));
+}
+
+// The lanes kept complemented: Abe, Abi, Ago, Aki, Ami, Asa
+inline void complement(uint64_t* a)
+{
+    a[1] = ~a[1];
+    a[2] = ~a[2];
+    a[8] = ~a[8];
+    a[12] = ~a[12];
+    a[17] = ~a[17];
+    a[20] = ~a[20];
+}
+
+// One round from A to E, lanes indexed x + 5 * y
+inline void round(uint64_t const* A, uint64_t* E, uint64_t rc)
+{
+    uint64_t const Ca = A[0] ^ A[5] ^ A[10] ^ A[15] ^ A[20];
+    uint64_t const Ce = A[1] ^ A[6] ^ A[11] ^ A[16] ^ A[21];
+    uint64_t const Ci = A[2] ^ A[7] ^ A[12] ^ A[17] ^ A[22];
+    uint64_t const Co = A[3] ^ A[8] ^ A[13] ^ A[18] ^ A[23];
+    uint64_t const Cu = A[4] ^ A[9] ^ A[14] ^ A[19] ^ A[24];
+    uint64_t const Da = Cu ^ rol(Ce, 1);
+    uint64_t const De = Ca ^ rol(Ci, 1);
+    uint64_t const Di = Ce ^ rol(Co, 1);
+    uint64_t const Do = Ci ^ rol(Cu, 1);
+    uint64_t const Du = Co ^ rol(Ca, 1);
+
+    uint64_t b0, b1, b2, b3, b4;
+
+    b0 = A[0] ^ Da;
+    b1 = rol(A[6] ^ De, 44);
+    b2 = rol(A[12] ^ Di, 43);
+    b3 = rol(A[18] ^ Do, 21);
+    b4 = rol(A[24] ^ Du, 14);
+    E[0] = b0 ^ (b1 | b2) ^ rc;
+    E[1] = b1 ^ (~b2 | b3);
+    E[2] = b2 ^ (b3 & b4);
+    E[3] = b3 ^ (b4 | b0);
+    E[4] = b4 ^ (b0 & b1);
+
+    b0 = rol(A[3] ^ Do, 28);
+    b1 = rol(A[9] ^ Du, 20);
+    b2 = rol(A[10] ^ Da, 3);
+    b3 = rol(A[16] ^ De, 45);
+    b4 = rol(A[22] ^ Di, 61);
+    E[5] = b0 ^ (b1 | b2);
+    E[6] = b1 ^ (b2 & b3);
+    E[7] = b2 ^ (b3 | ~b4);
+    E[8] = b3 ^ (b4 | b0);
+    E[9] = b4 ^ (b0 & b1);
+
+    b0 = rol(A[1] ^ De, 1);
+    b1 = rol(A[7] ^ Di, 6);
+    b2 = rol(A[13] ^ Do, 25);
+    b3 = rol(A[19] ^ Du, 8);
+    b4 = rol(A[20] ^ Da, 18);
+    E[10] = b0 ^ (b1 | b2);
+    E[11] = b1 ^ (b2 & b3);
+    E[12] = b2 ^ (~b3 & b4);
+    E[13] = ~b3 ^ (b4 | b0);
+    E[14] = b4 ^ (b0 & b1);
+
+    b0 = rol(A[4] ^ Du, 27);
+    b1 = rol(A[5] ^ Da, 36);
+    b2 = rol(A[11] ^ De, 10);
+    b3 = rol(A[17] ^ Di, 15);
+    b4 = rol(A[23] ^ Do, 56);
+    E[15] = b0 ^ (b1 & b2);
+    E[16] = b1 ^ (b2 | b3);
+    E[17] = b2 ^ (~b3 | b4);
+    E[18] = ~b3 ^ (b4 & b0);
+    E[19] = b4 ^ (b0 | b1);
+
+    b0 = rol(A[2] ^ Di, 62);
+    b1 = rol(A[8] ^ Do, 55);
+    b2 = rol(A[14] ^ Du, 39);
+    b3 = rol(A[15] ^ Da, 41);
+    b4 = rol(A[21] ^ De, 2);
+    E[20] = b0 ^ (~b1 & b2);
+    E[21] = ~b1 ^ (b2 | b3);
+    E[22] = b2 ^ (b3 & b4);
+    E[23] = b3 ^ (b4 | b0);
+    E[24] = b4 ^ (b0 & b1);
 }
 
-/******** The FIPS202-defined functions. ********/
-
-/*** Some helper macros. ***/
-
-#define _(S) do { S } while (0)
-#define FOR(i, ST, L, S) \
-  _(for (size_t i = 0; i < L; i += ST) { S; })
-#define mkapply_ds(NAME, S)                                          \
-  static inline void NAME(uint8_t* dst,                              \
-						  const uint8_t* src,                        \
-						  size_t len) {                              \
-	FOR(i, 1, len, S);                                               \
-  }
-#define mkapply_sd(NAME, S)                                          \
-  static inline void NAME(const uint8_t* src,                        \
-						  uint8_t* dst,                              \
-						  size_t len) {                              \
-	FOR(i, 1, len, S);                                               \
-  }
-
-mkapply_ds(xorin, dst[i] ^= src[i])  // xorin
-mkapply_sd(setout, dst[i] = src[i])  // setout
-
-#define P keccakf
-#define Plen 200
-
-// Fold P*F over the full blocks of an input.
-#define foldP(I, L, F) \
-  while (L >= rate) {  \
-	F(a, I, rate);     \
-	P(a);              \
-	I += rate;         \
-	L -= rate;         \
-  }
-
-/** The sponge-based hash construction. **/
-static inline int hash(uint8_t* out, size_t outlen,
-					   const uint8_t* in, size_t inlen,
-					   size_t rate, uint8_t delim) {
-	if ((out == NULL) || ((in == NULL) && inlen != 0) || (rate >= Plen)) {
-		return -1;
-	}
-	uint8_t a[Plen] = {0};
-	// Absorb input.
-	foldP(in, inlen, xorin);
-	// Xor in the DS and pad frame.
-	a[inlen] ^= delim;
-	a[rate - 1] ^= 0x80;
-	// Xor in the last block.
-	xorin(a, in, inlen);
-	// Apply P
-	P(a);
-	// Squeeze output.
-	foldP(out, outlen, setout);
-	setout(a, out, outlen);
-	memset(a, 0, 200);
-	return 0;
+void keccakf(uint64_t* a)
+{
+    uint64_t e[25];
+    complement(a);
+    for (int i = 0; i < 24; i += 2)
+    {
+        round(a, e, RC[i]);
+        round(e, a, RC[i + 1]);
+    }
+    complement(a);
 }
 
-/*** Helper macros to define SHA3 and SHAKE instances. ***/
-#define defkeccak(bits)                                           \
-  static int keccak_##bits(uint8_t* out, size_t outlen,           \
-				  const uint8_t* in, size_t inlen) {              \
-	if (outlen > (bits/8)) {                                      \
-	  return -1;                                                  \
-	}                                                             \
-	return hash(out, outlen, in, inlen, 200 - (bits / 4), 0x01);  \
-  }
+// Blocks absorbed for a message of _size bytes, the padded one included
+inline size_t blockCount(uint64_t _size)
+{
+    return _size / rate + 1;
+}
 
-defkeccak(256)
+// Absorb the block _n of a message, without permuting
+void absorb(uint64_t* a, uint8_t const* _data, uint64_t _size, size_t _n)
+{
+    uint8_t const* p = _data + _n * rate;
+    if (_n < _size / rate)
+    {
+        for (size_t i = 0; i < rateLanes; ++i)
+            a[i] ^= load64(p + 8 * i);
+        return;
+    }
+
+    uint8_t last[rate] = {0};
+    size_t const remain = _size % rate;
+    if (remain)
+        std::memcpy(last, p, remain);
+    last[remain] ^= 0x01;
+    last[rate - 1] ^= 0x80;
+    for (size_t i = 0; i < rateLanes; ++i)
+        a[i] ^= load64(last + 8 * i);
+}
+
+void squeeze(uint64_t const* a, uint8_t* o_hash)
+{
+    for (size_t i = 0; i < 4; ++i)
+        store64(o_hash + 8 * i, a[i]);
+}
+
+}  // namespace
 
 void keccak(uint8_t const* _data, uint64_t _size, uint8_t* o_hash)
 {
-	keccak_256(o_hash, 32, _data, _size);
+    uint64_t a[25] = {0};
+    auto const blocks = blockCount(_size);
+    for (size_t n = 0; n < blocks; ++n)
+    {
+        absorb(a, _data, _size, n);
+        keccakf(a);
+    }
+    squeeze(a, o_hash);
+}
+
+void keccak(uint8_t const* const* _data, uint64_t const* _sizes, size_t _count,
+    uint8_t* o_hashes)
+{
+    for (size_t m = 0; m < _count; ++m)
+        keccak(_data[m], _sizes[m], o_hashes + 32 * m);
 }
 
 void sha3(uint8_t const* _data, uint64_t _size, uint8_t* o_hash)
 {
-    keccak_256(o_hash, 32, _data, _size);
+    keccak(_data, _size, o_hash);
 }
 
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <iostream>
 
@@ -7,6 +8,11 @@ namespace eth {
 
 void keccak(uint8_t const *_data, uint64_t _size, uint8_t *o_hash);
 
+/// Hash _count messages at once, o_hashes receives 32 bytes for each of them.
+/// For the many small messages of a Merkle proof, in a single call.
+void keccak(uint8_t const *const *_data, uint64_t const *_sizes, size_t _count,
+    uint8_t *o_hashes);
+
 void sha3(uint8_t const *_data, uint64_t _size, uint8_t *o_hash);
 
 // The same as assert, but expression is always evaluated and result returned
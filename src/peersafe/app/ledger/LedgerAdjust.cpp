@@ -24,86 +24,24 @@
 #include <ripple/protocol/UintTypes.h>
 #include <peersafe/schema/Schema.h>
 #include <peersafe/app/ledger/LedgerAdjust.h>
+#include <peersafe/app/ledger/StatisStore.h>
 #include <peersafe/app/sql/TxnDBConn.h>
 #include <boost/format.hpp>
+#include <algorithm>
+#include <limits>
 
 namespace ripple {
-int 
-LedgerAdjust::getTxSucessCount(LockedSociSession db)
-{
-    boost::optional<int> value;
-    int count = 0;
-    std::string sql = boost::str(boost::format(
-                    R"(select count(*) from Transactions WHERE TxResult = 'tesSUCCESS';)"));
-    soci::statement st = (db->prepare << sql, soci::into(value));
-    auto res = st.execute(true);
-
-    if (res && *value)
-        count = (*value);
-    return count;
-}
-
-int 
-LedgerAdjust::getTxFailCount(LockedSociSession db)
-{
-    boost::optional<int> value;
-    int count = 0;
-    std::string sql = boost::str(boost::format(
-                    R"(select count(*) from Transactions WHERE TxResult != 'tesSUCCESS';)"));
-    soci::statement st = (db->prepare << sql, soci::into(value));
-    auto res = st.execute(true);
-
-    if (res && *value)
-        count = (*value);
-    return count;
-}
-
-int 
-LedgerAdjust::getContractCreateCount(LockedSociSession db)
-{
-    boost::optional<int> value;
-    int count = 0;
-    std::string sql = boost::str(boost::format(
-                    R"(select count(distinct(Owner)) from TraceTransactions WHERE TransType = 'Contract';)"));
-    soci::statement st = (db->prepare << sql, soci::into(value));
-    auto res = st.execute(true);
-
-    if (res && *value)
-        count = (*value);
-    return count;
-}
-
-int 
-LedgerAdjust::getContractCallCount(LockedSociSession db)
-{
-    int count = 0;
-    boost::optional<int> value;
-    std::string sql = boost::str(boost::format(
-                    R"(select count(*) from TraceTransactions WHERE TransType = 'Contract';)"));
-    soci::statement st = (db->prepare << sql, soci::into(value));
-    auto res = st.execute(true);
-
-    if (res && *value)
-        count = (*value);
-    return count;
-}
 
-int 
-LedgerAdjust::getAccountCount(LockedSociSession db)
+static void
+setCounts(Schema& app, StatisStore::Statis const& statis)
 {
-    boost::optional<int> value;
-    int count = 0;
-    std::string sql = boost::str(boost::format(
-                    R"(select count(distinct(Account)) from AccountTransactions;)"));
-    soci::statement st = (db->prepare << sql, soci::into(value));
-    auto res = st.execute(true);
-
-    if (res && *value)
-        count = (*value);
-    if(count == 0)
-        return 1;
-    else 
-        return count;
+    auto countSle = app.getPrometheusClient().getPromethSle();
+    countSle->setFieldU32(sfTxSuccessCountField, statis.txSuccess);
+    countSle->setFieldU32(sfTxFailureCountField, statis.txFailure);
+    countSle->setFieldU32(sfContractCallCountField, statis.contractCall);
+    countSle->setFieldU32(sfContractCreateCountField, statis.contractCreate);
+    countSle->setFieldU32(
+        sfAccountCountField, LedgerAdjust::getAccountCount(statis));
 }
 
 void
@@ -116,18 +54,34 @@ LedgerAdjust::createSle(Schema& app)
         return;
     }
 
-    TxnDBCon& connection = app.getTxnDB();
-    auto countSle = app.getPrometheusClient().getPromethSle();
-    countSle->setFieldU32(sfTxSuccessCountField, getTxSucessCount(connection.checkoutDbRead()));
-    countSle->setFieldU32(sfTxFailureCountField, getTxFailCount(connection.checkoutDbRead()));
-    countSle->setFieldU32(sfContractCallCountField,getContractCallCount(connection.checkoutDbRead()));
-    int contractCount = getContractCreateCount(connection.checkoutDbRead());
-    countSle->setFieldU32(sfContractCreateCountField, contractCount);
-    int accountCount = getAccountCount(connection.checkoutDbRead());
-    if(accountCount > 1)
-        accountCount = accountCount - contractCount;
-    countSle->setFieldU32(sfAccountCountField, accountCount);
-    
+    auto& store = app.getStatisStore();
+    if (auto const statis = store.totals())
+    {
+        setCounts(app, *statis);
+        return;
+    }
+
+    // Recounting the stored ledgers takes a while. Until it is done the
+    // SLE stays incomplete, which the updates below treat as not ready.
+    JLOG(app.journal("LedgerAdjust").info())
+        << "Statistics not ready, rebuilding them";
+    store.scheduleRebuild(
+        [&app](boost::optional<StatisStore::Statis> const& statis) {
+            if (statis)
+                setCounts(app, *statis);
+        });
+}
+
+std::uint32_t
+LedgerAdjust::getAccountCount(StatisStore::Statis const& statis)
+{
+    // Contracts are accounts too, but counted separately. The two are
+    // recorded apart, so don't let a skewed pair wrap around.
+    if (statis.accounts <= std::max<std::uint64_t>(statis.contractCreate, 1))
+        return 1;
+    return static_cast<std::uint32_t>(std::min<std::uint64_t>(
+        statis.accounts - statis.contractCreate,
+        std::numeric_limits<std::uint32_t>::max()));
 }
 
 bool 
@@ -8,6 +8,7 @@
 #include <ripple/basics/Log.h>
 #include <ripple/basics/TaggedCache.h>
 #include <peersafe/schema/Schema.h>
+#include <peersafe/app/ledger/StatisStore.h>
 #include <ripple/app/ledger/OpenLedger.h>
 #include <ripple/ledger/ApplyView.h>
 #include <ripple/app/misc/NetworkOPs.h>
@@ -32,11 +33,7 @@ namespace ripple {
 		//LedgerAdjust();
 		
 		//virtual ~LedgerAdjust();
-        static int getTxSucessCount(LockedSociSession db);
-        static int getTxFailCount(LockedSociSession db);
-        static int getContractCreateCount(LockedSociSession db);
-        static int getContractCallCount(LockedSociSession db);
-        static int getAccountCount(LockedSociSession db);
+        static std::uint32_t getAccountCount(StatisStore::Statis const& statis);
         static void updateContractCount(Schema& app, ApplyView& view, ContractState state);
 		static void updateTxCount(Schema& app, OpenView& view, int successCount, int failCount);
 		static void updateAccountCount(Schema& app, OpenView& view,int accountCount);
@@ -0,0 +1,398 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <peersafe/app/ledger/LedgerObjectCounter.h>
+#include <peersafe/schema/Schema.h>
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/core/DatabaseCon.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/core/SociDB.h>
+#include <ripple/ledger/OpenView.h>
+#include <ripple/protocol/SField.h>
+#include <ripple/protocol/Serializer.h>
+#include <ripple/protocol/STLedgerEntry.h>
+#include <boost/format.hpp>
+#include <sstream>
+#include <vector>
+
+namespace ripple {
+
+// How far back RPC requests may walk to find counted ancestors
+static std::size_t const maxDeriveDepth = 256;
+
+// Saved ledgers normally follow their parent; allow for some reordering
+static std::size_t const maxSavedDepth = 8;
+
+// Ledgers changing more objects than this are counted by a full scan
+static int const maxDeltaItems = 1 << 18;
+
+// Recent ledgers kept in memory
+static std::size_t const maxCached = 512;
+
+static LedgerEntryType
+entryType(SHAMapItem const& item)
+{
+    // LedgerEntryType has the lowest field code, so it always leads a
+    // canonical serialization and the rest of the object needn't be parsed.
+    SerialIter sit(item.slice());
+    int type = 0;
+    int name = 0;
+    sit.getFieldID(type, name);
+    if (type == STI_UINT16 && name == sfLedgerEntryType.fieldValue)
+        return static_cast<LedgerEntryType>(sit.get16());
+    return SLE(SerialIter{item.slice()}, item.key()).getType();
+}
+
+static bool
+adjust(
+    LedgerObjectCounter::Counts& counts,
+    LedgerEntryType type,
+    std::int64_t delta)
+{
+    auto& count = counts[type];
+    if (delta < 0 && count < static_cast<std::uint64_t>(-delta))
+        return false;
+    count += delta;
+    if (count == 0)
+        counts.erase(type);
+    return true;
+}
+
+LedgerObjectCounter::LedgerObjectCounter(Schema& app, beast::Journal journal)
+    : app_(app), journal_(journal)
+{
+}
+
+boost::optional<LedgerObjectCounter::Counts>
+LedgerObjectCounter::get(ReadView const& view)
+{
+    if (view.open())
+    {
+        // The open ledger is its closed base plus the pending changes
+        auto const open = dynamic_cast<OpenView const*>(&view);
+        if (!open)
+            return boost::none;
+        auto base =
+            app_.getLedgerMaster().getLedgerByHash(view.info().parentHash);
+        if (!base)
+            return boost::none;
+        auto counts = derive(base, maxDeriveDepth);
+        if (!counts)
+            return boost::none;
+        for (auto const& [type, delta] : open->objectCountDeltas())
+        {
+            if (!adjust(*counts, type, delta))
+                return boost::none;
+        }
+        return counts;
+    }
+
+    if (auto counts = fetch(view.info().hash))
+        return counts;
+    auto ledger = app_.getLedgerMaster().getLedgerByHash(view.info().hash);
+    if (!ledger)
+        return boost::none;
+    return derive(ledger, maxDeriveDepth);
+}
+
+void
+LedgerObjectCounter::onLedgerSaved(std::shared_ptr<Ledger const> const& ledger)
+{
+    try
+    {
+        // History is backfilled newest first: count it from the child
+        // just counted rather than walk back to ancestors that aren't
+        if (auto counts = deriveFromChild(ledger))
+        {
+            seed(ledger->info(), *counts);
+            return;
+        }
+        if (auto counts = derive(ledger, maxSavedDepth))
+        {
+            persist(ledger->info(), *counts);
+            return;
+        }
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(journal_.warn()) << "Counting objects of ledger "
+                              << ledger->info().seq << ": " << e.what();
+    }
+
+    // Only the newest ledger is worth a full scan; older ones are counted
+    // on demand by walking from it.
+    auto const seq = ledger->info().seq;
+    {
+        std::lock_guard lock(mutex_);
+        if (seq <= newest_)
+            return;
+    }
+    if (seq < app_.getLedgerMaster().getValidLedgerIndex())
+        return;
+    scheduleScan(ledger);
+}
+
+void
+LedgerObjectCounter::seed(LedgerInfo const& info, Counts const& counts)
+{
+    remember(info, counts);
+    persist(info, counts);
+}
+
+LedgerObjectCounter::Counts
+LedgerObjectCounter::scan(ReadView const& view)
+{
+    Counts counts;
+    for (auto const& sle : view.sles)
+        ++counts[sle->getType()];
+    return counts;
+}
+
+bool
+LedgerObjectCounter::applyDelta(
+    Counts& counts,
+    SHAMap const& map,
+    SHAMap const& parent,
+    int maxItems)
+{
+    SHAMap::Delta delta;
+    try
+    {
+        if (!map.compare(parent, delta, maxItems))
+            return false;
+    }
+    catch (std::exception const&)
+    {
+        return false;
+    }
+
+    for (auto const& [key, items] : delta)
+    {
+        (void)key;
+        auto const& [ours, theirs] = items;
+        // Modified in place: the type of an entry never changes
+        if (ours && theirs)
+            continue;
+        if (!adjust(
+                counts,
+                entryType(ours ? *ours : *theirs),
+                ours ? 1 : -1))
+            return false;
+    }
+    return true;
+}
+
+boost::optional<LedgerObjectCounter::Counts>
+LedgerObjectCounter::derive(
+    std::shared_ptr<Ledger const> ledger,
+    std::size_t maxDepth)
+{
+    // Walk back to the nearest ancestor with known counts...
+    std::vector<std::shared_ptr<Ledger const>> chain;
+    boost::optional<Counts> counts;
+    while (!(counts = fetch(ledger->info().hash)))
+    {
+        if (chain.size() >= maxDepth || ledger->info().seq <= 1)
+            return boost::none;
+        chain.push_back(ledger);
+        ledger =
+            app_.getLedgerMaster().getLedgerByHash(ledger->info().parentHash);
+        if (!ledger)
+            return boost::none;
+    }
+
+    // ...then replay each ledger's changes on top of it
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+    {
+        if (!applyDelta(
+                *counts, (*it)->stateMap(), ledger->stateMap(), maxDeltaItems))
+        {
+            JLOG(journal_.debug())
+                << "No delta from " << ledger->info().seq << " to "
+                << (*it)->info().seq;
+            return boost::none;
+        }
+        ledger = *it;
+        remember(ledger->info(), *counts);
+    }
+    return counts;
+}
+
+boost::optional<LedgerObjectCounter::Counts>
+LedgerObjectCounter::deriveFromChild(std::shared_ptr<Ledger const> const& ledger)
+{
+    auto const child =
+        app_.getLedgerMaster().getLedgerBySeq(ledger->info().seq + 1);
+    if (!child || child->info().parentHash != ledger->info().hash)
+        return boost::none;
+    auto counts = fetch(child->info().hash);
+    if (!counts)
+        return boost::none;
+
+    // The same delta, taken the other way round
+    if (!applyDelta(
+            *counts, ledger->stateMap(), child->stateMap(), maxDeltaItems))
+        return boost::none;
+    return counts;
+}
+
+boost::optional<LedgerObjectCounter::Counts>
+LedgerObjectCounter::fetch(uint256 const& hash)
+{
+    {
+        std::lock_guard lock(mutex_);
+        auto it = cache_.find(hash);
+        if (it != cache_.end())
+            return it->second.counts;
+    }
+
+    boost::optional<std::uint64_t> seq;
+    boost::optional<std::string> value;
+    {
+        auto db = app_.getLedgerDB().checkoutDb();
+        *db << boost::str(
+                   boost::format("SELECT LedgerSeq, Counts FROM LedgerObjects "
+                                 "WHERE LedgerHash = '%s';") %
+                   to_string(hash)),
+            soci::into(seq), soci::into(value);
+    }
+    if (!seq || !value)
+        return boost::none;
+
+    auto counts = fromString(*value);
+    if (!counts)
+    {
+        JLOG(journal_.warn()) << "Unreadable object counts for " << hash;
+        return boost::none;
+    }
+
+    std::lock_guard lock(mutex_);
+    cache_[hash] = Entry{static_cast<LedgerIndex>(*seq), *counts};
+    return counts;
+}
+
+void
+LedgerObjectCounter::remember(LedgerInfo const& info, Counts const& counts)
+{
+    std::lock_guard lock(mutex_);
+    cache_[info.hash] = Entry{info.seq, counts};
+    newest_ = std::max(newest_, info.seq);
+
+    if (cache_.size() <= maxCached)
+        return;
+    for (auto it = cache_.begin(); it != cache_.end();)
+    {
+        if (it->second.seq + maxCached / 2 < newest_)
+            it = cache_.erase(it);
+        else
+            ++it;
+    }
+}
+
+void
+LedgerObjectCounter::persist(LedgerInfo const& info, Counts const& counts)
+{
+    auto db = app_.getLedgerDB().checkoutDb();
+    *db << boost::str(
+        boost::format("INSERT OR REPLACE INTO LedgerObjects "
+                      "(LedgerHash, LedgerSeq, Counts) "
+                      "VALUES ('%s', %u, '%s');") %
+        to_string(info.hash) % info.seq % toString(counts));
+}
+
+void
+LedgerObjectCounter::scheduleScan(std::shared_ptr<Ledger const> const& ledger)
+{
+    if (scanning_.exchange(true))
+        return;
+
+    JLOG(journal_.info()) << "Counting the objects of ledger "
+                          << ledger->info().seq;
+    bool const added = app_.getJobQueue().addJob(
+        jtLEDGER_OBJECTS,
+        "LedgerObjects::scan",
+        [this, ledger](Job&) {
+            try
+            {
+                auto counts = scan(*ledger);
+                seed(ledger->info(), counts);
+
+                // Ledgers validated while the scan ran continue from it
+                auto& ledgerMaster = app_.getLedgerMaster();
+                auto parent = ledger;
+                for (auto seq = parent->info().seq + 1;
+                     seq <= ledgerMaster.getValidLedgerIndex();
+                     ++seq)
+                {
+                    auto next = ledgerMaster.getLedgerBySeq(seq);
+                    if (!next ||
+                        next->info().parentHash != parent->info().hash ||
+                        !applyDelta(
+                            counts,
+                            next->stateMap(),
+                            parent->stateMap(),
+                            maxDeltaItems))
+                        break;
+                    seed(next->info(), counts);
+                    parent = next;
+                }
+                JLOG(journal_.info()) << "Object counts known from ledger "
+                                      << parent->info().seq;
+            }
+            catch (std::exception const& e)
+            {
+                JLOG(journal_.warn()) << "Counting ledger objects: " << e.what();
+            }
+            scanning_ = false;
+        },
+        app_.doJobCounter());
+    if (!added)
+        scanning_ = false;
+}
+
+std::string
+LedgerObjectCounter::toString(Counts const& counts)
+{
+    std::ostringstream ss;
+    for (auto const& [type, count] : counts)
+        ss << static_cast<int>(type) << ':' << count << ';';
+    return ss.str();
+}
+
+boost::optional<LedgerObjectCounter::Counts>
+LedgerObjectCounter::fromString(std::string const& s)
+{
+    Counts counts;
+    std::istringstream ss(s);
+    int type;
+    char colon, semicolon;
+    std::uint32_t count;
+    while (ss >> type >> colon >> count >> semicolon)
+    {
+        if (colon != ':' || semicolon != ';')
+            return boost::none;
+        counts[static_cast<LedgerEntryType>(type)] = count;
+    }
+    if (!ss.eof())
+        return boost::none;
+    return counts;
+}
+
+}  // namespace ripple
@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_LEDGEROBJECTCOUNTER_H_INCLUDED
+#define RIPPLE_APP_LEDGER_LEDGEROBJECTCOUNTER_H_INCLUDED
+
+#include <ripple/basics/Log.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/protocol/LedgerFormats.h>
+#include <ripple/protocol/Protocol.h>
+#include <ripple/shamap/SHAMap.h>
+#include <boost/optional.hpp>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace ripple {
+
+class Ledger;
+class ReadView;
+class Schema;
+struct LedgerInfo;
+
+/*
+Number of state objects of each LedgerEntryType, per ledger.
+
+Counting by walking the state map costs a full deserializing scan, so the
+counts are instead carried forward from the parent ledger: every validated
+ledger is compared with its parent (only the differing SHAMap branches are
+visited) and the created and deleted entries adjust the parent's counts.
+The result is kept in memory for recent ledgers and in the LedgerObjects
+table of the ledger database, keyed by ledger hash.
+
+The chain has to start somewhere: when the newest saved ledger has no
+counted ancestor nearby, one full scan is run in the background. History
+ledgers, which are backfilled newest first, are instead counted from their
+child, and are otherwise left to be derived on demand.
+*/
+class LedgerObjectCounter
+{
+public:
+    using Counts = std::map<LedgerEntryType, std::uint32_t>;
+
+    LedgerObjectCounter(Schema& app, beast::Journal journal);
+
+    /** Counts for a closed or open view, or boost::none if not known. */
+    boost::optional<Counts>
+    get(ReadView const& view);
+
+    /** Carries the counts forward to a validated ledger and stores them. */
+    void
+    onLedgerSaved(std::shared_ptr<Ledger const> const& ledger);
+
+    /** Replaces the counts of a closed ledger, e.g. after a full scan. */
+    void
+    seed(LedgerInfo const& info, Counts const& counts);
+
+    /** Counts every object of `view` the slow way. */
+    static Counts
+    scan(ReadView const& view);
+
+    /** Adjusts `counts` of `parent` by the objects created and deleted in
+        `map`. Returns false if the maps differ in more than `maxItems` or
+        a node is missing.
+    */
+    static bool
+    applyDelta(
+        Counts& counts,
+        SHAMap const& map,
+        SHAMap const& parent,
+        int maxItems);
+
+private:
+    struct Entry
+    {
+        LedgerIndex seq;
+        Counts counts;
+    };
+
+    boost::optional<Counts>
+    derive(std::shared_ptr<Ledger const> ledger, std::size_t maxDepth);
+
+    /** Counts of `ledger` from those of its counted child, if any. */
+    boost::optional<Counts>
+    deriveFromChild(std::shared_ptr<Ledger const> const& ledger);
+
+    boost::optional<Counts>
+    fetch(uint256 const& hash);
+
+    void
+    remember(LedgerInfo const& info, Counts const& counts);
+
+    void
+    persist(LedgerInfo const& info, Counts const& counts);
+
+    void
+    scheduleScan(std::shared_ptr<Ledger const> const& ledger);
+
+    static std::string
+    toString(Counts const& counts);
+
+    static boost::optional<Counts>
+    fromString(std::string const& s);
+
+    Schema& app_;
+    beast::Journal const journal_;
+
+    std::mutex mutable mutex_;
+    std::map<uint256, Entry> cache_;
+    LedgerIndex newest_ = 0;
+    std::atomic<bool> scanning_{false};
+};
+
+}  // namespace ripple
+
+#endif
@@ -0,0 +1,246 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <peersafe/app/ledger/LedgerTimeline.h>
+#include <ripple/basics/BasicConfig.h>
+#include <ripple/core/Config.h>
+#include <ripple/core/ConfigSections.h>
+#include <ripple/protocol/jss.h>
+#include <algorithm>
+
+namespace ripple {
+
+// Samples waiting for PrometheusClient; with no exporter running the queue
+// simply stops growing here.
+static std::size_t const maxPendingSamples = 4096;
+
+// Transaction sets asked for but never delivered are forgotten past this.
+static std::size_t const maxTxSetRequests = 64;
+
+char const*
+LedgerTimeline::phaseName(Phase phase)
+{
+    switch (phase)
+    {
+        case txSetAcquire:
+            return "tx_set_acquire";
+        case txSetPreflight:
+            return "tx_set_preflight";
+        case build:
+            return "build";
+        case applyTxs:
+            return "apply";
+        case shamapFlush:
+            return "shamap_flush";
+        case nodestoreWrite:
+            return "nodestore_write";
+        case sqlCommit:
+            return "sql_commit";
+        case tableStorage:
+            return "table_storage";
+        case publish:
+            return "publish";
+        default:
+            return "unknown";
+    }
+}
+
+LedgerTimeline::LedgerTimeline(Setup const& setup, beast::Journal journal)
+    : setup_(setup), journal_(journal)
+{
+    if (setup_.enable)
+        ring_.resize(std::max<std::size_t>(setup_.size, 1));
+}
+
+void
+LedgerTimeline::record(
+    LedgerIndex seq,
+    Phase phase,
+    clock_type::time_point start,
+    clock_type::time_point end)
+{
+    if (!enabled() || phase >= phaseCount)
+        return;
+
+    auto const duration = end - start;
+    std::lock_guard lock(mutex_);
+
+    auto& entry = ring_[seq % ring_.size()];
+    if (entry.seq != seq)
+    {
+        // A late report for a ledger that has already been overwritten.
+        if (entry.seq > seq)
+            return;
+        entry = Entry{};
+        entry.seq = seq;
+    }
+    newest_ = std::max(newest_, seq);
+
+    auto& span = entry.spans[phase];
+    if (span.count == 0 || start < span.start)
+        span.start = start;
+    span.duration += duration;
+    ++span.count;
+    if (phase == applyTxs)
+        entry.applyPasses.push_back(duration);
+
+    if (samples_.size() < maxPendingSamples)
+        samples_.emplace_back(
+            phase,
+            std::chrono::duration_cast<std::chrono::microseconds>(duration));
+}
+
+void
+LedgerTimeline::txSetRequested(uint256 const& id, LedgerIndex seq)
+{
+    if (!enabled())
+        return;
+
+    std::lock_guard lock(mutex_);
+    if (txSetRequests_.size() >= maxTxSetRequests)
+    {
+        JLOG(journal_.debug())
+            << "Dropping " << txSetRequests_.size()
+            << " transaction set requests never delivered";
+        txSetRequests_.clear();
+    }
+    txSetRequests_.emplace(id, std::make_pair(seq, clock_type::now()));
+}
+
+void
+LedgerTimeline::txSetAcquired(uint256 const& id)
+{
+    if (!enabled())
+        return;
+
+    LedgerIndex seq;
+    clock_type::time_point start;
+    {
+        std::lock_guard lock(mutex_);
+        auto it = txSetRequests_.find(id);
+        if (it == txSetRequests_.end())
+            return;
+        std::tie(seq, start) = it->second;
+        txSetRequests_.erase(it);
+    }
+    record(seq, txSetAcquire, start, clock_type::now());
+}
+
+Json::Value
+LedgerTimeline::toJson(Entry const& entry) const
+{
+    using namespace std::chrono;
+    auto us = [](clock_type::duration d) {
+        return static_cast<Json::UInt>(duration_cast<microseconds>(d).count());
+    };
+
+    boost::optional<clock_type::time_point> first, last;
+    for (auto const& span : entry.spans)
+    {
+        if (span.count == 0)
+            continue;
+        if (!first || span.start < *first)
+            first = span.start;
+        if (!last || span.start + span.duration > *last)
+            last = span.start + span.duration;
+    }
+
+    Json::Value ret(Json::objectValue);
+    ret[jss::ledger_index] = entry.seq;
+    ret["total_us"] = first ? us(*last - *first) : 0;
+
+    Json::Value& phases = (ret["phases"] = Json::objectValue);
+    for (std::size_t i = 0; i < phaseCount; ++i)
+    {
+        auto const& span = entry.spans[i];
+        if (span.count == 0)
+            continue;
+        Json::Value& p = (phases[phaseName(static_cast<Phase>(i))] =
+                              Json::objectValue);
+        p["offset_us"] = us(span.start - *first);
+        p["duration_us"] = us(span.duration);
+        if (span.count > 1)
+            p["count"] = span.count;
+    }
+
+    if (!entry.applyPasses.empty())
+    {
+        Json::Value& passes = (ret["apply_passes_us"] = Json::arrayValue);
+        for (auto const& d : entry.applyPasses)
+            passes.append(us(d));
+    }
+    return ret;
+}
+
+Json::Value
+LedgerTimeline::getJson(std::size_t limit, boost::optional<LedgerIndex> seq)
+    const
+{
+    Json::Value ret(Json::arrayValue);
+    if (!enabled())
+        return ret;
+
+    std::lock_guard lock(mutex_);
+    if (seq)
+    {
+        auto const& entry = ring_[*seq % ring_.size()];
+        if (entry.seq == *seq)
+            ret.append(toJson(entry));
+        return ret;
+    }
+
+    for (LedgerIndex s = newest_;
+         s != 0 && newest_ - s < ring_.size() && ret.size() < limit;
+         --s)
+    {
+        auto const& entry = ring_[s % ring_.size()];
+        if (entry.seq == s)
+            ret.append(toJson(entry));
+    }
+    return ret;
+}
+
+void
+LedgerTimeline::drainSamples(
+    std::function<void(Phase, std::chrono::microseconds)> const& f)
+{
+    if (!enabled())
+        return;
+
+    decltype(samples_) samples;
+    {
+        std::lock_guard lock(mutex_);
+        samples.swap(samples_);
+    }
+    for (auto const& [phase, duration] : samples)
+        f(phase, duration);
+}
+
+LedgerTimeline::Setup
+setup_LedgerTimeline(Config const& config)
+{
+    LedgerTimeline::Setup setup;
+
+    auto const& section = config.section(ConfigSection::ledgerTimeline());
+    set(setup.enable, "enable", section);
+    set(setup.size, "size", section);
+    return setup;
+}
+
+}  // namespace ripple
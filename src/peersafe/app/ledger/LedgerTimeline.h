@@ -0,0 +1,177 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_LEDGERTIMELINE_H_INCLUDED
+#define RIPPLE_APP_LEDGER_LEDGERTIMELINE_H_INCLUDED
+
+#include <ripple/basics/base_uint.h>
+#include <ripple/basics/Log.h>
+#include <ripple/json/json_value.h>
+#include <ripple/protocol/Protocol.h>
+#include <boost/optional.hpp>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+class Config;
+
+/*
+Per-ledger breakdown of where close time goes.
+
+Consensus, ledger building, the node store, the SQL databases and
+publishing each report how long their part of a ledger took, keyed by the
+ledger sequence. The last `size` ledgers are kept in a ring buffer for the
+ledger_timeline command, and every sample is also queued for the Prometheus
+histograms, which PrometheusClient drains on its timer.
+
+When [ledger_timeline] is not enabled a Scope is a flag test and nothing
+else: no clock reads, no lock.
+*/
+class LedgerTimeline
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    enum Phase : std::uint8_t {
+        txSetAcquire,
+        txSetPreflight,
+        build,
+        applyTxs,
+        shamapFlush,
+        nodestoreWrite,
+        sqlCommit,
+        tableStorage,
+        publish,
+        phaseCount
+    };
+
+    static char const*
+    phaseName(Phase phase);
+
+    struct Setup
+    {
+        explicit Setup() = default;
+
+        bool enable = false;
+        std::size_t size = 256;
+    };
+
+    /** Times the enclosing block as `phase` of ledger `seq`. */
+    class Scope
+    {
+    public:
+        Scope(LedgerTimeline& timeline, LedgerIndex seq, Phase phase)
+            : timeline_(timeline.enabled() ? &timeline : nullptr)
+            , seq_(seq)
+            , phase_(phase)
+        {
+            if (timeline_)
+                start_ = clock_type::now();
+        }
+
+        ~Scope()
+        {
+            if (timeline_)
+                timeline_->record(seq_, phase_, start_, clock_type::now());
+        }
+
+        Scope(Scope const&) = delete;
+        Scope&
+        operator=(Scope const&) = delete;
+
+    private:
+        LedgerTimeline* const timeline_;
+        LedgerIndex const seq_;
+        Phase const phase_;
+        clock_type::time_point start_;
+    };
+
+    LedgerTimeline(Setup const& setup, beast::Journal journal);
+
+    bool
+    enabled() const
+    {
+        return setup_.enable;
+    }
+
+    void
+    record(
+        LedgerIndex seq,
+        Phase phase,
+        clock_type::time_point start,
+        clock_type::time_point end);
+
+    /** A transaction set for ledger `seq` was asked for and isn't local. */
+    void
+    txSetRequested(uint256 const& id, LedgerIndex seq);
+
+    /** Records the wait if `id` was asked for with txSetRequested. */
+    void
+    txSetAcquired(uint256 const& id);
+
+    /** The most recent `limit` ledgers, newest first, or just `seq`. */
+    Json::Value
+    getJson(std::size_t limit, boost::optional<LedgerIndex> seq) const;
+
+    /** Hands every sample recorded since the last call to `f`. */
+    void
+    drainSamples(
+        std::function<void(Phase, std::chrono::microseconds)> const& f);
+
+private:
+    struct Span
+    {
+        clock_type::time_point start;
+        clock_type::duration duration{0};
+        std::uint32_t count = 0;
+    };
+
+    struct Entry
+    {
+        LedgerIndex seq = 0;
+        std::array<Span, phaseCount> spans;
+        std::vector<clock_type::duration> applyPasses;
+    };
+
+    Json::Value
+    toJson(Entry const& entry) const;
+
+    Setup const setup_;
+    beast::Journal const journal_;
+
+    std::mutex mutable mutex_;
+    std::vector<Entry> ring_;
+    LedgerIndex newest_ = 0;
+    std::vector<std::pair<Phase, std::chrono::microseconds>> samples_;
+    std::map<uint256, std::pair<LedgerIndex, clock_type::time_point>>
+        txSetRequests_;
+};
+
+LedgerTimeline::Setup
+setup_LedgerTimeline(Config const& config);
+
+}  // namespace ripple
+
+#endif
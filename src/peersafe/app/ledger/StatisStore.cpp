@@ -0,0 +1,537 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <peersafe/app/ledger/StatisStore.h>
+#include <peersafe/app/sql/TxnDBConn.h>
+#include <peersafe/schema/Schema.h>
+#include <ripple/app/main/DBInit.h>
+#include <ripple/core/DatabaseCon.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/core/SociDB.h>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+
+// Upper bound on the sessions a rebuild reads with
+static unsigned const maxRebuildThreads = 8;
+
+// StatisFirstSeen.Kind
+static int const firstSeenAccount = 0;
+static int const firstSeenContract = 1;
+
+static std::uint64_t
+queryCount(soci::session& db, std::string const& sql)
+{
+    boost::optional<std::uint64_t> value;
+    db << sql, soci::into(value);
+    return value.value_or(0);
+}
+
+static std::string
+signedDelta(std::uint64_t now, std::uint64_t before)
+{
+    return now >= before ? "+ " + std::to_string(now - before)
+                         : "- " + std::to_string(before - now);
+}
+
+bool
+StatisStore::Statis::operator==(Statis const& other) const
+{
+    return txSuccess == other.txSuccess && txFailure == other.txFailure &&
+        contractCreate == other.contractCreate &&
+        contractCall == other.contractCall && accounts == other.accounts;
+}
+
+StatisStore::StatisStore(Schema& app, beast::Journal journal)
+    : app_(app), journal_(journal)
+{
+}
+
+void
+StatisStore::onLedgerSaved(
+    soci::session& db,
+    LedgerIndex seq,
+    std::uint64_t txSuccess,
+    std::uint64_t txFailure)
+{
+    try
+    {
+        // A ledger inside a rebuilt or folded chunk is already counted
+        // there. Only the row starting closest below it can cover it.
+        boost::optional<std::uint64_t> coverStart, coverEnd;
+        db << boost::str(
+                  boost::format("SELECT StartSeq, EndSeq FROM StatisDeltas "
+                                "WHERE StartSeq <= %u "
+                                "ORDER BY StartSeq DESC LIMIT 1;") %
+                  seq),
+            soci::into(coverStart), soci::into(coverEnd);
+        if (coverStart && coverEnd && *coverEnd >= seq &&
+            *coverStart != *coverEnd)
+            return;
+
+        // The ledger may be saved again; replace its earlier contribution
+        Statis before;
+        boost::optional<std::uint64_t> success, failure, create, call, accounts;
+        db << boost::str(
+                  boost::format("SELECT TxSuccess, TxFailure, ContractCreate, "
+                                "ContractCall, Accounts FROM StatisDeltas "
+                                "WHERE StartSeq = %u;") %
+                  seq),
+            soci::into(success), soci::into(failure), soci::into(create),
+            soci::into(call), soci::into(accounts);
+        before.txSuccess = success.value_or(0);
+        before.txFailure = failure.value_or(0);
+        before.contractCreate = create.value_or(0);
+        before.contractCall = call.value_or(0);
+        before.accounts = accounts.value_or(0);
+
+        recordFirstSeen(db, seq, seq);
+        auto delta = countRange(db, seq, seq);
+        delta.txSuccess = txSuccess;
+        delta.txFailure = txFailure;
+
+        db << boost::str(
+            boost::format(
+                "INSERT OR REPLACE INTO StatisDeltas "
+                "(StartSeq, EndSeq, TxSuccess, TxFailure, ContractCreate, "
+                "ContractCall, Accounts) VALUES (%u, %u, %u, %u, %u, %u, %u);") %
+            seq % seq % delta.txSuccess % delta.txFailure %
+            delta.contractCreate % delta.contractCall % delta.accounts);
+        db << boost::str(
+            boost::format("UPDATE StatisTotals SET "
+                          "TxSuccess = TxSuccess %s, "
+                          "TxFailure = TxFailure %s, "
+                          "ContractCreate = ContractCreate %s, "
+                          "ContractCall = ContractCall %s, "
+                          "Accounts = Accounts %s WHERE Id = 1;") %
+            signedDelta(delta.txSuccess, before.txSuccess) %
+            signedDelta(delta.txFailure, before.txFailure) %
+            signedDelta(delta.contractCreate, before.contractCreate) %
+            signedDelta(delta.contractCall, before.contractCall) %
+            signedDelta(delta.accounts, before.accounts));
+
+        // A rebuild replaces the rows of the range it counted, so it must
+        // not find them merged with rows outside of it.
+        if (rebuilds_ == 0)
+            fold(db, seq);
+    }
+    catch (std::exception const& e)
+    {
+        // Don't fail the ledger over its statistics: drop the checkpoint so
+        // the next start rebuilds it instead.
+        JLOG(journal_.warn())
+            << "Statistics of ledger " << seq << ": " << e.what();
+        db << "DELETE FROM StatisTotals;";
+    }
+}
+
+boost::optional<StatisStore::Statis>
+StatisStore::totals()
+{
+    if (!app_.config().useTxTables())
+        return boost::none;
+
+    boost::optional<std::uint64_t> success, failure, create, call, accounts;
+    {
+        auto db = app_.getTxnDB().checkoutDb();
+        *db << "SELECT TxSuccess, TxFailure, ContractCreate, ContractCall, "
+               "Accounts FROM StatisTotals WHERE Id = 1;",
+            soci::into(success), soci::into(failure), soci::into(create),
+            soci::into(call), soci::into(accounts);
+    }
+    if (!success)
+        return boost::none;
+
+    Statis statis;
+    statis.txSuccess = *success;
+    statis.txFailure = failure.value_or(0);
+    statis.contractCreate = create.value_or(0);
+    statis.contractCall = call.value_or(0);
+    statis.accounts = accounts.value_or(0);
+    return statis;
+}
+
+boost::optional<StatisStore::Statis>
+StatisStore::rebuild(std::uint32_t chunkSize)
+{
+    if (!app_.config().useTxTables())
+        return boost::none;
+    chunkSize = std::max<std::uint32_t>(chunkSize, 1);
+
+    // Holds back folding in onLedgerSaved until the rebuild is done
+    ++rebuilds_;
+    struct Running
+    {
+        std::atomic<int>& count;
+        ~Running()
+        {
+            --count;
+        }
+    } running{rebuilds_};
+
+    try
+    {
+        auto& txnDB = app_.getTxnDB();
+
+        boost::optional<std::uint64_t> minSeq, maxSeq;
+        {
+            auto db = txnDB.checkoutDb();
+            *db << "SELECT MIN(LedgerSeq), MAX(LedgerSeq) FROM Transactions;",
+                soci::into(minSeq), soci::into(maxSeq);
+
+            // Rows folded across either end of the stored range keep
+            // counting the ledgers they cover, pruned ones included.
+            if (minSeq && maxSeq)
+            {
+                boost::optional<std::uint64_t> below, above;
+                *db << boost::str(
+                           boost::format("SELECT MAX(EndSeq) FROM StatisDeltas "
+                                         "WHERE StartSeq < %u AND EndSeq >= %u;") %
+                           *minSeq % *minSeq),
+                    soci::into(below);
+                *db << boost::str(
+                           boost::format("SELECT MIN(StartSeq) FROM StatisDeltas "
+                                         "WHERE StartSeq <= %u AND EndSeq > %u;") %
+                           *maxSeq % *maxSeq),
+                    soci::into(above);
+                if (below)
+                    minSeq = *below + 1;
+                if (above)
+                    maxSeq = *above - 1;
+            }
+        }
+
+        using Chunk = std::pair<LedgerIndex, LedgerIndex>;
+        std::vector<Chunk> chunks;
+        if (minSeq && maxSeq)
+        {
+            for (std::uint64_t start = *minSeq; start <= *maxSeq;
+                 start += chunkSize)
+            {
+                chunks.emplace_back(
+                    static_cast<LedgerIndex>(start),
+                    static_cast<LedgerIndex>(
+                        std::min<std::uint64_t>(start + chunkSize - 1, *maxSeq)));
+            }
+        }
+        JLOG(journal_.info()) << "Rebuilding statistics in " << chunks.size()
+                              << " chunks";
+
+        // Whatever is already recorded keeps its ledger, so the accounts
+        // and contracts of pruned ledgers stay counted. Going through the
+        // chunks in ascending order gives every new row its earliest ledger,
+        // and a short transaction per chunk lets saved ledgers in between.
+        for (auto const& [first, last] : chunks)
+        {
+            auto db = txnDB.checkoutDb();
+            soci::transaction tr(*db);
+            recordFirstSeen(*db, first, last);
+            tr.commit();
+        }
+
+        // Chunks only read rows of their own range, so they can be counted
+        // in any order and on separate sessions.
+        std::vector<Statis> results(chunks.size());
+        auto count = [&](soci::session& db, std::size_t i) {
+            auto const [first, last] = chunks[i];
+            results[i] = countRange(db, first, last);
+            if (txnDB.hasTxResult())
+            {
+                auto const range = boost::str(
+                    boost::format("LedgerSeq >= %u AND LedgerSeq <= %u") %
+                    first % last);
+                results[i].txSuccess = queryCount(
+                    db,
+                    "SELECT COUNT(*) FROM Transactions WHERE " + range +
+                        " AND TxResult = 'tesSUCCESS';");
+                results[i].txFailure = queryCount(
+                    db,
+                    "SELECT COUNT(*) FROM Transactions WHERE " + range +
+                        " AND TxResult != 'tesSUCCESS';");
+            }
+        };
+
+        auto const setup = setup_DatabaseCon(app_.config());
+        // Standalone nodes keep the database in a temporary file that
+        // other sessions can't open.
+        bool const temporary = setup.standAlone &&
+            setup.startUp != Config::LOAD &&
+            setup.startUp != Config::LOAD_FILE &&
+            setup.startUp != Config::REPLAY;
+        auto const threads = std::min<std::size_t>(
+            {chunks.size(),
+             std::max(1u, std::thread::hardware_concurrency()),
+             maxRebuildThreads});
+
+        if (temporary || threads <= 1)
+        {
+            auto db = txnDB.checkoutDb();
+            for (std::size_t i = 0; i < chunks.size(); ++i)
+                count(*db, i);
+        }
+        else
+        {
+            auto const path = (setup.dataDir / TxDBName).string();
+            std::atomic<std::size_t> next{0};
+            std::exception_ptr error;
+            std::mutex errorMutex;
+            std::vector<std::thread> workers;
+            for (std::size_t t = 0; t < threads; ++t)
+            {
+                workers.emplace_back([&] {
+                    try
+                    {
+                        soci::session db;
+                        open(db, "sqlite", path);
+                        for (auto i = next++; i < chunks.size(); i = next++)
+                            count(db, i);
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard lock(errorMutex);
+                        if (!error)
+                            error = std::current_exception();
+                        next = chunks.size();
+                    }
+                });
+            }
+            for (auto& worker : workers)
+                worker.join();
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+        auto db = txnDB.checkoutDb();
+        soci::transaction tr(*db);
+        if (!chunks.empty())
+        {
+            *db << boost::str(
+                boost::format("DELETE FROM StatisDeltas "
+                              "WHERE StartSeq <= %u AND EndSeq >= %u;") %
+                chunks.back().second % chunks.front().first);
+        }
+        for (std::size_t i = 0; i < chunks.size(); ++i)
+        {
+            auto const& r = results[i];
+            *db << boost::str(
+                boost::format("INSERT INTO StatisDeltas "
+                              "(StartSeq, EndSeq, TxSuccess, TxFailure, "
+                              "ContractCreate, ContractCall, Accounts) "
+                              "VALUES (%u, %u, %u, %u, %u, %u, %u);") %
+                chunks[i].first % chunks[i].second % r.txSuccess %
+                r.txFailure % r.contractCreate % r.contractCall % r.accounts);
+        }
+        // Ledgers saved while the chunks were counted have their own rows.
+        // Contracts and accounts are every one ever recorded, including
+        // those first seen before the stored range.
+        *db << "DELETE FROM StatisTotals;";
+        *db << boost::str(
+            boost::format(
+                "INSERT INTO StatisTotals "
+                "(Id, TxSuccess, TxFailure, ContractCreate, ContractCall, "
+                "Accounts) SELECT 1, IFNULL(SUM(TxSuccess), 0), "
+                "IFNULL(SUM(TxFailure), 0), "
+                "(SELECT COUNT(*) FROM StatisFirstSeen WHERE Kind = %d), "
+                "IFNULL(SUM(ContractCall), 0), "
+                "(SELECT COUNT(*) FROM StatisFirstSeen WHERE Kind = %d) "
+                "FROM StatisDeltas;") %
+            firstSeenContract % firstSeenAccount);
+        tr.commit();
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(journal_.error()) << "Rebuilding statistics: " << e.what();
+        return boost::none;
+    }
+
+    auto result = totals();
+    if (result)
+    {
+        JLOG(journal_.info())
+            << "Statistics rebuilt: " << result->txSuccess << " successful and "
+            << result->txFailure << " failed transactions, "
+            << result->contractCreate << " contracts, " << result->accounts
+            << " accounts";
+    }
+    return result;
+}
+
+void
+StatisStore::scheduleRebuild(RebuildHandler onDone)
+{
+    {
+        std::lock_guard lock(mutex_);
+        if (onDone)
+            waiting_.push_back(std::move(onDone));
+        if (rebuilding_)
+            return;
+        rebuilding_ = true;
+    }
+
+    auto finish = [this](boost::optional<Statis> const& result) {
+        std::vector<RebuildHandler> waiting;
+        {
+            std::lock_guard lock(mutex_);
+            waiting.swap(waiting_);
+            rebuilding_ = false;
+        }
+        for (auto const& handler : waiting)
+            handler(result);
+    };
+
+    bool const added = app_.getJobQueue().addJob(
+        jtCREATE_PROMETH_SLE,
+        "StatisStore::rebuild",
+        [this, finish](Job&) { finish(rebuild()); },
+        app_.doJobCounter());
+    if (!added)
+        finish(boost::none);
+}
+
+bool
+StatisStore::rebuilding() const
+{
+    std::lock_guard lock(mutex_);
+    return rebuilding_;
+}
+
+void
+StatisStore::fold(soci::session& db, LedgerIndex seq)
+{
+    LedgerIndex const first = seq - seq % foldSize;
+    LedgerIndex const last = first + foldSize - 1;
+
+    // Only a block that every ledger saved its own row in is folded, so a
+    // ledger missing from it can't later be taken as already counted.
+    if (queryCount(
+            db,
+            boost::str(
+                boost::format("SELECT COUNT(*) FROM StatisDeltas "
+                              "WHERE StartSeq >= %u AND StartSeq <= %u "
+                              "AND EndSeq = StartSeq;") %
+                first % last)) != foldSize)
+        return;
+
+    // Chunks right next to the block grow to take it in, so a run of
+    // saved ledgers is kept in a single row.
+    std::uint64_t start = first;
+    std::uint64_t end = last;
+    boost::optional<std::uint64_t> prevStart, prevEnd, nextEnd;
+    db << boost::str(
+              boost::format("SELECT StartSeq, EndSeq FROM StatisDeltas "
+                            "WHERE StartSeq < %u "
+                            "ORDER BY StartSeq DESC LIMIT 1;") %
+              first),
+        soci::into(prevStart), soci::into(prevEnd);
+    if (prevStart && prevEnd && *prevEnd + 1 == first && *prevStart != *prevEnd)
+        start = *prevStart;
+    db << boost::str(
+              boost::format("SELECT EndSeq FROM StatisDeltas "
+                            "WHERE StartSeq = %u AND EndSeq > StartSeq;") %
+              (last + 1)),
+        soci::into(nextEnd);
+    if (nextEnd)
+        end = *nextEnd;
+
+    boost::optional<std::uint64_t> success, failure, create, call, accounts;
+    db << boost::str(
+              boost::format("SELECT SUM(TxSuccess), SUM(TxFailure), "
+                            "SUM(ContractCreate), SUM(ContractCall), "
+                            "SUM(Accounts) FROM StatisDeltas "
+                            "WHERE StartSeq >= %u AND StartSeq <= %u;") %
+              start % end),
+        soci::into(success), soci::into(failure), soci::into(create),
+        soci::into(call), soci::into(accounts);
+    db << boost::str(
+        boost::format("DELETE FROM StatisDeltas "
+                      "WHERE StartSeq >= %u AND StartSeq <= %u;") %
+        start % end);
+    db << boost::str(
+        boost::format(
+            "INSERT INTO StatisDeltas "
+            "(StartSeq, EndSeq, TxSuccess, TxFailure, ContractCreate, "
+            "ContractCall, Accounts) VALUES (%u, %u, %u, %u, %u, %u, %u);") %
+        start % end % success.value_or(0) % failure.value_or(0) %
+        create.value_or(0) % call.value_or(0) % accounts.value_or(0));
+}
+
+void
+StatisStore::recordFirstSeen(
+    soci::session& db,
+    LedgerIndex first,
+    LedgerIndex last)
+{
+    // Online delete prunes the transaction tables but not StatisFirstSeen,
+    // so an account or contract is recorded once, with the ledger it was
+    // first stored in, however long ago its transactions were removed.
+    auto const range = boost::str(
+        boost::format("LedgerSeq >= %u AND LedgerSeq <= %u") % first % last);
+    db << boost::str(
+        boost::format(
+            "INSERT OR IGNORE INTO StatisFirstSeen (Kind, Id, LedgerSeq) "
+            "SELECT %d, Account, MIN(LedgerSeq) FROM AccountTransactions "
+            "WHERE %s GROUP BY Account;") %
+        firstSeenAccount % range);
+    if (app_.config().USE_TRACE_TABLE)
+    {
+        db << boost::str(
+            boost::format(
+                "INSERT OR IGNORE INTO StatisFirstSeen (Kind, Id, LedgerSeq) "
+                "SELECT %d, Owner, MIN(LedgerSeq) FROM TraceTransactions "
+                "WHERE %s AND TransType = 'Contract' GROUP BY Owner;") %
+            firstSeenContract % range);
+    }
+}
+
+StatisStore::Statis
+StatisStore::countRange(soci::session& db, LedgerIndex first, LedgerIndex last)
+{
+    auto const firstSeen = [&](int kind) {
+        return queryCount(
+            db,
+            boost::str(
+                boost::format("SELECT COUNT(*) FROM StatisFirstSeen "
+                              "WHERE Kind = %d AND LedgerSeq >= %u "
+                              "AND LedgerSeq <= %u;") %
+                kind % first % last));
+    };
+
+    Statis statis;
+    if (app_.config().USE_TRACE_TABLE)
+    {
+        statis.contractCall = queryCount(
+            db,
+            boost::str(
+                boost::format("SELECT COUNT(*) FROM TraceTransactions "
+                              "WHERE LedgerSeq >= %u AND LedgerSeq <= %u "
+                              "AND TransType = 'Contract';") %
+                first % last));
+        statis.contractCreate = firstSeen(firstSeenContract);
+    }
+    statis.accounts = firstSeen(firstSeenAccount);
+    return statis;
+}
+
+}  // namespace ripple
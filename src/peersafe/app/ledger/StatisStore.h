@@ -0,0 +1,152 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_STATISSTORE_H_INCLUDED
+#define RIPPLE_APP_LEDGER_STATISSTORE_H_INCLUDED
+
+#include <ripple/basics/Log.h>
+#include <ripple/protocol/Protocol.h>
+#include <boost/optional.hpp>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace soci {
+class session;
+}
+
+namespace ripple {
+
+class Schema;
+
+/*
+Chain wide transaction, contract and account statistics.
+
+Counting them with COUNT(*) over the transaction tables gets slower as the
+chain grows, so every validated ledger instead records its own contribution
+(a delta row in StatisDeltas) in the same SQL transaction that stores its
+transactions, and adds it to the single checkpoint row of StatisTotals.
+
+Distinct contracts and accounts are recorded in StatisFirstSeen with the
+first ledger they appear in, and counted only when they are added there.
+Online delete doesn't prune that table, so the totals are cumulative: they
+keep counting ledgers whose transactions were since removed.
+
+A node that has no checkpoint yet rebuilds one from the transaction tables,
+splitting the ledger range into chunks counted in parallel. Each chunk row
+replaces the delta rows it covers.
+
+So that StatisDeltas doesn't grow by a row per ledger forever, the rows of
+every aligned block of foldSize ledgers are folded into one chunk row once
+all of them are saved, and merged with the chunks next to it.
+*/
+class StatisStore
+{
+public:
+    struct Statis
+    {
+        std::uint64_t txSuccess = 0;
+        std::uint64_t txFailure = 0;
+        std::uint64_t contractCreate = 0;
+        std::uint64_t contractCall = 0;
+        std::uint64_t accounts = 0;
+
+        bool
+        operator==(Statis const& other) const;
+    };
+
+    // Ledgers counted by one rebuild chunk
+    static std::uint32_t const defaultChunkSize = 100000;
+
+    // Ledgers whose delta rows are folded into one chunk row
+    static std::uint32_t const foldSize = 256;
+
+    StatisStore(Schema& app, beast::Journal journal);
+
+    /** Records the statistics of ledger `seq`, whose transactions were just
+        written inside the open SQL transaction on `db`.
+    */
+    void
+    onLedgerSaved(
+        soci::session& db,
+        LedgerIndex seq,
+        std::uint64_t txSuccess,
+        std::uint64_t txFailure);
+
+    /** The checkpointed totals, or boost::none if never built. */
+    boost::optional<Statis>
+    totals();
+
+    /** Recounts every stored ledger and checkpoints the result.
+
+        Returns boost::none if the transaction tables are not in use or the
+        rebuild failed.
+    */
+    boost::optional<Statis>
+    rebuild(std::uint32_t chunkSize = defaultChunkSize);
+
+    using RebuildHandler = std::function<void(boost::optional<Statis> const&)>;
+
+    /** Runs rebuild() in a job unless one is already running.
+
+        `onDone`, if set, is called with the result once the rebuild that is
+        running or just scheduled finishes.
+    */
+    void
+    scheduleRebuild(RebuildHandler onDone = {});
+
+    /** True while a scheduled rebuild hasn't finished. */
+    bool
+    rebuilding() const;
+
+private:
+    /** Records the accounts and contracts of ledgers [first, last] that
+        StatisFirstSeen doesn't have yet.
+    */
+    void
+    recordFirstSeen(soci::session& db, LedgerIndex first, LedgerIndex last);
+
+    /** Folds the block of foldSize ledgers holding `seq` into a chunk row
+        once every ledger in it has its own row.
+    */
+    void
+    fold(soci::session& db, LedgerIndex seq);
+
+    /** Counts ledgers [first, last]; contracts and accounts are those first
+        seen there, so recordFirstSeen must have run for the range.
+    */
+    Statis
+    countRange(soci::session& db, LedgerIndex first, LedgerIndex last);
+
+    Schema& app_;
+    beast::Journal const journal_;
+
+    // Rebuilds running, scheduled or not
+    std::atomic<int> rebuilds_{0};
+
+    std::mutex mutable mutex_;
+    bool rebuilding_ = false;
+    std::vector<RebuildHandler> waiting_;
+};
+
+}  // namespace ripple
+
+#endif
@@ -0,0 +1,205 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <peersafe/app/ledger/LedgerTimeline.h>
+#include <peersafe/app/ledger/TxSetPreflight.h>
+#include <peersafe/schema/Schema.h>
+#include <ripple/app/misc/HashRouter.h>
+#include <ripple/app/tx/applySteps.h>
+#include <ripple/core/ConfigSections.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/shamap/SHAMap.h>
+
+namespace ripple {
+
+// Preflight passed with the rules of current_
+#define SF_PREFLIGHTGOOD SF_PRIVATE7
+
+TxSetPreflight::TxSetPreflight(
+    Schema& app,
+    Setup const& setup,
+    beast::Journal journal)
+    : app_(app), setup_(setup), journal_(journal)
+{
+}
+
+void
+TxSetPreflight::verify(
+    std::shared_ptr<SHAMap> const& set,
+    std::shared_ptr<ReadView const> const& parent)
+{
+    if (!setup_.enable || !set || !parent)
+        return;
+
+    auto const& rules = parent->rules();
+    {
+        std::lock_guard lock(mutex_);
+        auto const current = current_.load();
+        if (!current || !(current->rules == rules))
+        {
+            // A pass with the old rules says nothing about the new ones.
+            // They are cleared before the new generation is published, and
+            // no flag is set meanwhile, since check() waits for mutex_.
+            if (current)
+                app_.getHashRouter().clearFlags(SF_PREFLIGHTGOOD);
+            generations_.push_back(
+                Generation{rules, current ? current->number + 1 : 0});
+            current_.store(&generations_.back());
+        }
+    }
+
+    std::vector<std::vector<std::shared_ptr<SHAMapItem const>>> chunks(1);
+    set->visitLeaves([&](std::shared_ptr<SHAMapItem const> const& item) {
+        if (chunks.back().size() >= setup_.chunk)
+            chunks.emplace_back();
+        chunks.back().push_back(item);
+    });
+    if (chunks.back().empty())
+        return;
+
+    ++sets_;
+    auto const batch =
+        std::make_shared<Batch>(rules, parent->seq() + 1, chunks.size());
+    for (auto& items : chunks)
+    {
+        app_.getJobQueue().addJob(
+            jtTX_PREFLIGHT,
+            "TxSetPreflight",
+            [this, batch, items = std::move(items)](Job&) {
+                check(batch, items);
+            },
+            app_.doJobCounter());
+    }
+}
+
+void
+TxSetPreflight::check(
+    std::shared_ptr<Batch> const& batch,
+    std::vector<std::shared_ptr<SHAMapItem const>> const& items)
+{
+    auto& router = app_.getHashRouter();
+
+    std::vector<uint256> passed;
+    passed.reserve(items.size());
+    for (auto const& item : items)
+    {
+        if (router.getFlags(item->key()) & SF_PREFLIGHTGOOD)
+        {
+            ++cached_;
+            continue;
+        }
+
+        try
+        {
+            STTx const tx{SerialIter{item->slice()}};
+            // Checks the signature too, and keeps the result in the router
+            auto const result =
+                preflight(app_, batch->rules, tx, tapForConsensus, journal_);
+            ++checked_;
+            if (result.ter == tesSUCCESS)
+                passed.push_back(tx.getTransactionID());
+            else
+                ++failed_;
+        }
+        catch (std::exception const& e)
+        {
+            ++failed_;
+            JLOG(journal_.debug())
+                << "Preflight of " << item->key() << " throws: " << e.what();
+        }
+    }
+
+    if (!passed.empty())
+    {
+        std::lock_guard lock(mutex_);
+        // The rules changed while this chunk was checked
+        auto const current = current_.load();
+        if (current && current->rules == batch->rules)
+        {
+            for (auto const& id : passed)
+                router.setFlags(id, SF_PREFLIGHTGOOD);
+        }
+    }
+
+    if (--batch->pending == 0)
+    {
+        using namespace std::chrono;
+        auto const end = clock_type::now();
+        auto const us = duration_cast<microseconds>(end - batch->start);
+        lastUs_ = us.count();
+        totalUs_ += us.count();
+        app_.getLedgerTimeline().record(
+            batch->seq, LedgerTimeline::txSetPreflight, batch->start, end);
+        JLOG(journal_.debug()) << "Preflight of the set for ledger "
+                               << batch->seq << " took " << us.count() << "us";
+    }
+}
+
+bool
+TxSetPreflight::passed(STTx const& tx, Rules const& rules, ApplyFlags flags)
+{
+    if (!setup_.enable || !(flags & tapForConsensus))
+        return false;
+
+    // A flag is only set while current_ holds the generation it was
+    // checked with, and the flags of a generation are cleared before the
+    // next one is published. So if the generation is the same before and
+    // after the flag is read, the flag was set under it.
+    auto const before = current_.load();
+    if (before && before->rules == rules &&
+        (app_.getHashRouter().getFlags(tx.getTransactionID()) &
+         SF_PREFLIGHTGOOD) &&
+        current_.load() == before)
+    {
+        ++hits_;
+        return true;
+    }
+    ++misses_;
+    return false;
+}
+
+Json::Value
+TxSetPreflight::getJson() const
+{
+    Json::Value ret(Json::objectValue);
+    ret["sets"] = static_cast<Json::UInt>(sets_);
+    ret["checked"] = static_cast<Json::UInt>(checked_);
+    ret["already_checked"] = static_cast<Json::UInt>(cached_);
+    ret["failed"] = static_cast<Json::UInt>(failed_);
+    ret["apply_skipped"] = static_cast<Json::UInt>(hits_);
+    ret["apply_unchecked"] = static_cast<Json::UInt>(misses_);
+    ret["last_set_us"] = static_cast<Json::UInt>(lastUs_);
+    ret["total_us"] = static_cast<Json::UInt>(totalUs_);
+    return ret;
+}
+
+TxSetPreflight::Setup
+setup_TxSetPreflight(Config const& config)
+{
+    TxSetPreflight::Setup setup;
+
+    auto const& section = config.section(ConfigSection::consensusPreflight());
+    set(setup.enable, "enable", section);
+    set(setup.chunk, "chunk", section);
+    if (setup.chunk == 0)
+        setup.chunk = 1;
+    return setup;
+}
+
+}  // namespace ripple
@@ -0,0 +1,157 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifndef CHAINSQL_APP_LEDGER_TXSETPREFLIGHT_H_INCLUDED
+#define CHAINSQL_APP_LEDGER_TXSETPREFLIGHT_H_INCLUDED
+
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/core/Config.h>
+#include <ripple/json/json_value.h>
+#include <ripple/ledger/ApplyView.h>
+#include <ripple/ledger/ReadView.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/shamap/SHAMapItem.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+class Schema;
+class SHAMap;
+
+/** Checks the transactions of a consensus set before the set is applied.
+
+    As soon as a transaction set is complete, whether acquired from a peer
+    or built locally, its transactions are split into chunks and each
+    chunk runs the stateless preflight, signature check included, in a job
+    of its own. The signature result lands in the HashRouter flags
+    checkValidity already keeps, and a transaction which passed preflight
+    gets a flag of its own.
+
+    apply() then skips preflight for the flagged transactions when called
+    with tapForConsensus, as long as the view it applies to has the rules
+    they were checked with. That covers the ledgers built from a consensus
+    set by applyTransactions, the ParallelApply workers and the replay in
+    buildLedger. The flag is cleared from every transaction when the rules
+    change, so it never outlives the rules it was computed with.
+
+    The apply loop never waits for the checks, a transaction not checked
+    yet goes through preflight as before.
+*/
+class TxSetPreflight
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    struct Setup
+    {
+        explicit Setup() = default;
+
+        bool enable = false;
+        // Transactions checked by one job
+        std::size_t chunk = 128;
+    };
+
+    TxSetPreflight(Schema& app, Setup const& setup, beast::Journal journal);
+
+    bool
+    enabled() const
+    {
+        return setup_.enable;
+    }
+
+    /** Start checking the transactions of `set`.
+        @param set a complete transaction set
+        @param parent the ledger the set is to be applied on
+     */
+    void
+    verify(
+        std::shared_ptr<SHAMap> const& set,
+        std::shared_ptr<ReadView const> const& parent);
+
+    /** Whether preflight of `tx` can be skipped.
+        True if `tx` passed preflight with `rules` while its set was
+        checked, and `flags` are those of a consensus ledger.
+     */
+    bool
+    passed(STTx const& tx, Rules const& rules, ApplyFlags flags);
+
+    Json::Value
+    getJson() const;
+
+private:
+    struct Batch
+    {
+        Batch(Rules const& rules_, LedgerIndex seq_, std::size_t chunks)
+            : rules(rules_), seq(seq_), start(clock_type::now()), pending(chunks)
+        {
+        }
+
+        Rules const rules;
+        LedgerIndex const seq;
+        clock_type::time_point const start;
+        std::atomic<std::size_t> pending;
+    };
+
+    void
+    check(
+        std::shared_ptr<Batch> const& batch,
+        std::vector<std::shared_ptr<SHAMapItem const>> const& items);
+
+    Schema& app_;
+    Setup const setup_;
+    beast::Journal const journal_;
+
+    // The rules sets were checked with, numbered as they change
+    struct Generation
+    {
+        Rules rules;
+        std::uint64_t number;
+    };
+
+    // Held while the rules are replaced or the preflight flag is set
+    std::mutex mutable mutex_;
+    // Rules only change with amendments, so this stays short, and entries
+    // are never freed so passed() can read current_ without the mutex.
+    std::deque<Generation> generations_;
+    // The generation the flagged transactions passed with
+    std::atomic<Generation const*> current_{nullptr};
+
+    std::atomic<std::uint64_t> sets_{0};
+    std::atomic<std::uint64_t> checked_{0};
+    std::atomic<std::uint64_t> cached_{0};
+    std::atomic<std::uint64_t> failed_{0};
+    std::atomic<std::uint64_t> hits_{0};
+    std::atomic<std::uint64_t> misses_{0};
+    std::atomic<std::uint64_t> totalUs_{0};
+    std::atomic<std::uint64_t> lastUs_{0};
+};
+
+TxSetPreflight::Setup
+setup_TxSetPreflight(Config const& config);
+
+}  // namespace ripple
+
+#endif
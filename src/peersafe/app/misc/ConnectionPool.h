@@ -23,7 +23,10 @@ public:
         if (conn_ == nullptr)
             return;
         store_ = std::make_shared<TxStore>(
-            conn_->GetDBConn(), app.config(), app.journal("RPCHandler"));
+            conn_->GetDBConn(),
+            app.config(),
+            app.journal("RPCHandler"),
+            &app.getTableMirror());
         last_access_ = stopwatch().now();
     }
     
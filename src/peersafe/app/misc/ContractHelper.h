@@ -11,6 +11,7 @@
 #include <ripple/ledger/OpenView.h>
 #include <ripple/protocol/TER.h>
 #include <peersafe/schema/Schema.h>
+#include <peersafe/app/misc/StoragePrefetch.h>
 
 namespace ripple {
 
@@ -86,6 +87,12 @@ public:
     ValueOpType 
     getOpType(ValueType const& value);
 
+    StoragePrefetch&
+    prefetch()
+    {
+        return mPrefetch;
+    }
+
 private:
 	Schema&									app_;
 	TaggedCache<uint256, std::vector<STTx>>	mTxCache;
@@ -97,6 +104,7 @@ private:
     std::map<AccountID, map256>     mStateCache;
     std::map<AccountID, std::shared_ptr<SHAMap>> mShaMapCache;
     beast::Journal                  mJournal;
+    StoragePrefetch                 mPrefetch;
 };
 
 }
@@ -30,6 +30,11 @@ public:
 
 	const STTx& getTx();
 
+	/// The contract function the transaction calls, as keyed by
+	/// StoragePrefetch::functionKey(). Zero unless prefetching is enabled.
+	uint256 const& prefetchFunction() const { return prefetchFunction_; }
+	void setPrefetchFunction(uint256 const& function) { prefetchFunction_ = function; }
+
 	bool addressHasCode(AccountID const& addr);
 	/// Sets the code of the account. Must only be called during / after contract creation.
 	void setCode(AccountID const& _address, eth::bytes&& _code);
@@ -149,6 +154,7 @@ private:
 	std::map<std::string, uint160>			  sqlTxsNameInDB_;
 
     std::unordered_set<AccountID>             unrevertablyTouched_;
+	uint256									  prefetchFunction_;
 };
 
 }
@@ -0,0 +1,187 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifndef CHAINSQL_APP_MISC_STORAGEPREFETCH_H_INCLUDED
+#define CHAINSQL_APP_MISC_STORAGEPREFETCH_H_INCLUDED
+
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/core/Config.h>
+#include <ripple/json/json_value.h>
+#include <ripple/ledger/ReadView.h>
+#include <ripple/protocol/STTx.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+class Schema;
+
+/** Warms the storage of the contracts a ledger is about to call.
+
+    Every SLOAD and SSTORE of a message call is remembered under the
+    contract and function selector the transaction calls, in a bounded
+    access list. Functions and keys not used for maxIdle ledgers are
+    forgotten, and the least recently used ones make room when a list is
+    full. Before a set of transactions is applied, the storage
+    SHAMap nodes on the paths to the keys their access lists name are
+    read from the node store in the background, one job per contract and
+    one batch of reads per tree level. The apply loop then finds them in
+    the caches instead of waiting on the disk one key at a time.
+
+    Nothing depends on a prefetch completing, a wrong or late guess only
+    costs the reads.
+*/
+class StoragePrefetch
+{
+public:
+    struct Setup
+    {
+        explicit Setup() = default;
+
+        bool enable = false;
+        // Keys remembered for one contract function
+        std::size_t maxKeys = 64;
+        // Contract functions remembered
+        std::size_t maxFunctions = 4096;
+        // Ledgers a function or key is remembered after its last access
+        std::uint64_t maxIdle = 256;
+    };
+
+    StoragePrefetch(Schema& app, Setup const& setup, beast::Journal journal);
+
+    bool
+    enabled() const
+    {
+        return setup_.enable;
+    }
+
+    /** Transactions calling the same function of a contract share a key.
+        Zero for a transaction which is not a message call.
+     */
+    static uint256
+    functionKey(STTx const& tx);
+
+    /** A message call of `function`, as returned by functionKey(),
+        accessed `key` in the storage of `contract`. `contract` may be
+        another contract than the one the transaction calls.
+     */
+    void
+    recordAccess(
+        uint256 const& function,
+        AccountID const& contract,
+        uint256 const& key);
+
+    /** Start warming the storage the transactions are expected to access.
+        @param parent the ledger the transactions are applied on
+        @param txs a map of transactions, as in CanonicalTXSet
+     */
+    template <class Map>
+    void
+    prefetch(ReadView const& parent, Map const& txs)
+    {
+        if (!setup_.enable)
+            return;
+
+        std::vector<std::shared_ptr<STTx const>> v;
+        v.reserve(txs.size());
+        for (auto const& item : txs)
+            v.push_back(item.second);
+        schedule(parent, v);
+    }
+
+    /** The apply loop read the storage item `index` from the node store */
+    void
+    onRead(uint256 const& index);
+
+    Json::Value
+    getJson() const;
+
+private:
+    // The storage keys accessed by the calls of one function
+    struct Function
+    {
+        // The generation each key was last accessed in, by contract
+        hash_map<AccountID, hash_map<uint256, std::uint64_t>> keys;
+        std::size_t size = 0;
+        std::uint64_t used = 0;
+    };
+
+    // Functions and expected items are split by their first byte, so that
+    // the transactions applied and the reads counted rarely wait on
+    // each other
+    static constexpr std::size_t shardCount = 16;
+
+    struct Shard
+    {
+        std::mutex mutex;
+        hash_map<uint256, Function> functions;
+        // Storage items prefetched for the ledger being applied
+        hash_set<uint256> expected;
+    };
+
+    static std::size_t
+    shardOf(uint256 const& key)
+    {
+        return *key.begin() % shardCount;
+    }
+
+    // Make room for a key accessed in generation `now`.
+    // Returns false if every key was accessed in it already.
+    static bool
+    evictKey(Function& f, std::uint64_t now);
+
+    void
+    schedule(
+        ReadView const& parent,
+        std::vector<std::shared_ptr<STTx const>> const& txs);
+
+    // Read the nodes from `root` down to the items `indexes`
+    void
+    warm(uint256 const& root, std::vector<uint256> indexes);
+
+    Schema& app_;
+    Setup const setup_;
+    beast::Journal const journal_;
+
+    std::array<Shard, shardCount> mutable shards_;
+    // Bumped for each set of transactions prefetched
+    std::atomic<std::uint64_t> generation_{0};
+
+    std::atomic<std::uint64_t> calls_{0};
+    std::atomic<std::uint64_t> predicted_{0};
+    std::atomic<std::uint64_t> keys_{0};
+    std::atomic<std::uint64_t> nodesRead_{0};
+    std::atomic<std::uint64_t> nodesCached_{0};
+    std::atomic<std::uint64_t> reads_{0};
+    std::atomic<std::uint64_t> hits_{0};
+};
+
+StoragePrefetch::Setup
+setup_StoragePrefetch(Config const& config);
+
+}  // namespace ripple
+
+#endif
@@ -36,6 +36,7 @@
 #include <peersafe/schema/Schema.h>
 #include <set>
 #include <unordered_map>
+#include <vector>
 
 namespace ripple {
 
@@ -49,16 +50,15 @@ struct transactionCompare
         std::shared_ptr<Transaction> const& first,
         std::shared_ptr<Transaction> const& second) const
     {
-        if (first->getSTransaction()->getAccountID(sfAccount) ==
-            second->getSTransaction()->getAccountID(sfAccount))
+        auto const a = first->getSTransaction()->view();
+        auto const b = second->getSTransaction()->view();
+        if (a->account == b->account)
         {
-            return first->getSTransaction()->getFieldU32(sfSequence) <
-                second->getSTransaction()->getFieldU32(sfSequence);
+            return a->sequence < b->sequence;
         }
         else
         {
-            return first->getSTransaction()->getAccountID(sfAccount) <
-                second->getSTransaction()->getAccountID(sfAccount);
+            return a->account < b->account;
         }
         // return first->getTime() <= second->getTime();
     }
@@ -148,6 +148,12 @@ public:
     TER
     insertTx(std::shared_ptr<Transaction> transaction, LedgerIndex ledgerSeq);
 
+    // Insert several Txs under one lock, returning the result of each.
+    std::vector<TER>
+    insertTxs(
+        std::vector<std::shared_ptr<Transaction>> const& transactions,
+        LedgerIndex ledgerSeq);
+
     // When block validated, remove Txs from pool and avoid set.
     void
     removeTxs(
@@ -187,6 +193,12 @@ protected:
     removeExpired();
 
 private:
+    // Requires a unique lock on mutexSet_
+    TER
+    insertLocked(
+        std::shared_ptr<Transaction> const& transaction,
+        LedgerIndex ledgerSeq);
+
     Schema& app_;
 
     std::shared_mutex mutable mutexSet_;
@@ -20,6 +20,10 @@ namespace ripple {
               stopwatch(),
               app.journal("ContractHelper"))
         , mJournal(app_.journal("ContractHelper"))
+        , mPrefetch(
+              app,
+              setup_StoragePrefetch(app.config()),
+              app.journal("StoragePrefetch"))
     {
     }
 
@@ -153,6 +157,8 @@ namespace ripple {
         try
         {
             auto realKey = sha512Half(contract, key);
+            if (!bQuery)
+                mPrefetch.onRead(realKey);
             auto const& item = mapPtr->peekItem(realKey);
             if (!item)
                 return boost::none;
@@ -1,8 +1,10 @@
 #include <ripple/app/tx/impl/Transactor.h>
 #include <peersafe/app/misc/Executive.h>
+#include <peersafe/app/misc/ContractHelper.h>
 #include <eth/vm/VMFactory.h>
 #include <peersafe/core/Tuning.h>
 #include <ripple/protocol/digest.h>
+#include <ripple/protocol/Feature.h>
 #include <peersafe/schema/Schema.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/basics/StringUtilities.h>
@@ -49,6 +51,11 @@ void Executive::initialize() {
 	int64_t gas = tx.getFieldU32(sfGas);
 	int64_t gasCost = int64_t(gas * m_gasPrice);
 	m_gasCost = gasCost;
+
+	// Keyed once here for every storage access of the nested calls
+	auto& prefetch = m_s.ctx().app.getContractHelper().prefetch();
+	if (prefetch.enabled())
+		m_s.setPrefetchFunction(StoragePrefetch::functionKey(tx));
 }
 
 bool Executive::execute() {
@@ -190,6 +197,15 @@ bool Executive::call(CallParametersR const& _p, uint256 const& _gasPrice, Accoun
     {
         auto retPre = m_PreContractFace.executePreDiy(
             m_s, _p.codeAddress, _p.data, _p.senderAddress, _origin);
+        // The batch hashes charge by the size of their input, which must
+        // not take more than the call was given
+        if (m_s.ctx().view().rules().enabled(featureBatchHash) &&
+            _p.gas < get<2>(retPre))
+        {
+            m_gas = 0;
+            m_excepted = tefGAS_INSUFFICIENT;
+            return true;
+        }
         m_gas = (_p.gas - get<2>(retPre));
         TER ter = get<0>(retPre);
         if (ter != tesSUCCESS)
@@ -131,6 +131,8 @@ ExtVM::store(evmc_uint256be const& key)
     {
         bool bQuery =
             (oSle_.getTx().getFieldU16(sfContractOpType) == QueryCall);
+        helper.prefetch().recordAccess(
+            oSle_.prefetchFunction(), contract, uKey);
         auto value =
             helper.fetchValue(contract, mapStore.rootHash(), uKey, bQuery);
         if (value)
@@ -163,6 +165,8 @@ ExtVM::setStore(evmc_uint256be const& key, evmc_uint256be const& value)
     uint256 uValue = fromEvmC(value);
     if (useNewStorage(mapStore, oSle_))
     {
+        helper.prefetch().recordAccess(
+            oSle_.prefetchFunction(), contract, uKey);
         helper.setStorage(contract, mapStore.rootHash(), uKey, uValue);
     }
     else
@@ -0,0 +1,392 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <peersafe/app/misc/StoragePrefetch.h>
+#include <peersafe/protocol/ContractDefines.h>
+#include <peersafe/protocol/STMap256.h>
+#include <peersafe/schema/Schema.h>
+#include <ripple/core/ConfigSections.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/nodestore/Database.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/digest.h>
+#include <ripple/shamap/Family.h>
+#include <ripple/shamap/SHAMapNodeID.h>
+#include <ripple/shamap/SHAMapTreeNode.h>
+
+#include <algorithm>
+#include <map>
+
+namespace ripple {
+
+StoragePrefetch::StoragePrefetch(
+    Schema& app,
+    Setup const& setup,
+    beast::Journal journal)
+    : app_(app), setup_(setup), journal_(journal)
+{
+}
+
+uint256
+StoragePrefetch::functionKey(STTx const& tx)
+{
+    if (tx.getTxnType() != ttCONTRACT ||
+        !tx.isFieldPresent(sfContractAddress) ||
+        tx.getFieldU16(sfContractOpType) != MessageCall)
+        return beast::zero;
+
+    // The function selector is the first 4 bytes of the call data
+    std::uint32_t selector = 0;
+    auto const data = tx.getFieldVL(sfContractData);
+    for (std::size_t i = 0; i < data.size() && i < 4; ++i)
+        selector = (selector << 8) | data[i];
+
+    return sha512Half(tx.getAccountID(sfContractAddress), selector);
+}
+
+bool
+StoragePrefetch::evictKey(Function& f, std::uint64_t now)
+{
+    auto oldest = f.keys.end();
+    hash_map<uint256, std::uint64_t>::iterator key;
+    for (auto c = f.keys.begin(); c != f.keys.end(); ++c)
+    {
+        for (auto k = c->second.begin(); k != c->second.end(); ++k)
+        {
+            if (k->second < now &&
+                (oldest == f.keys.end() || k->second < key->second))
+            {
+                oldest = c;
+                key = k;
+            }
+        }
+    }
+    if (oldest == f.keys.end())
+        return false;
+
+    oldest->second.erase(key);
+    if (oldest->second.empty())
+        f.keys.erase(oldest);
+    --f.size;
+    return true;
+}
+
+void
+StoragePrefetch::recordAccess(
+    uint256 const& function,
+    AccountID const& contract,
+    uint256 const& key)
+{
+    if (!setup_.enable || function == beast::zero)
+        return;
+
+    auto const now = generation_.load(std::memory_order_relaxed);
+    auto& shard = shards_[shardOf(function)];
+    std::lock_guard lock(shard.mutex);
+
+    auto it = shard.functions.find(function);
+    if (it == shard.functions.end())
+    {
+        auto const maxFunctions =
+            std::max<std::size_t>(1, setup_.maxFunctions / shardCount);
+        if (shard.functions.size() >= maxFunctions)
+        {
+            // The least recently used function makes room
+            auto const oldest = std::min_element(
+                shard.functions.begin(),
+                shard.functions.end(),
+                [](auto const& a, auto const& b) {
+                    return a.second.used < b.second.used;
+                });
+            shard.functions.erase(oldest);
+        }
+        it = shard.functions.emplace(function, Function{}).first;
+    }
+
+    auto& f = it->second;
+    f.used = now;
+
+    auto const c = f.keys.find(contract);
+    if (c != f.keys.end())
+    {
+        auto const k = c->second.find(key);
+        if (k != c->second.end())
+        {
+            k->second = now;
+            return;
+        }
+    }
+
+    if (f.size >= setup_.maxKeys && !evictKey(f, now))
+        return;
+    f.keys[contract].emplace(key, now);
+    ++f.size;
+}
+
+void
+StoragePrefetch::schedule(
+    ReadView const& parent,
+    std::vector<std::shared_ptr<STTx const>> const& txs)
+{
+    auto const now = ++generation_;
+    auto const idle = [&](std::uint64_t used) {
+        return used + setup_.maxIdle < now;
+    };
+
+    for (auto& shard : shards_)
+    {
+        std::lock_guard lock(shard.mutex);
+        shard.expected.clear();
+        for (auto it = shard.functions.begin(); it != shard.functions.end();)
+        {
+            if (idle(it->second.used))
+                it = shard.functions.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    // The storage items to read, by the shard expecting them
+    std::array<std::vector<std::pair<AccountID, uint256>>, shardCount> byShard;
+    for (auto const& tx : txs)
+    {
+        auto const function = functionKey(*tx);
+        if (function == beast::zero)
+            continue;
+
+        ++calls_;
+        auto& shard = shards_[shardOf(function)];
+        std::lock_guard lock(shard.mutex);
+        auto const it = shard.functions.find(function);
+        if (it == shard.functions.end())
+            continue;
+
+        ++predicted_;
+        auto& f = it->second;
+        f.used = now;
+        for (auto c = f.keys.begin(); c != f.keys.end();)
+        {
+            for (auto k = c->second.begin(); k != c->second.end();)
+            {
+                if (idle(k->second))
+                {
+                    k = c->second.erase(k);
+                    --f.size;
+                    continue;
+                }
+                auto const index = sha512Half(c->first, k->first);
+                byShard[shardOf(index)].emplace_back(c->first, index);
+                ++k;
+            }
+            if (c->second.empty())
+                c = f.keys.erase(c);
+            else
+                ++c;
+        }
+    }
+
+    // The storage items to read, by contract
+    std::map<AccountID, std::vector<uint256>> indexes;
+    for (std::size_t i = 0; i < shardCount; ++i)
+    {
+        if (byShard[i].empty())
+            continue;
+        std::lock_guard lock(shards_[i].mutex);
+        for (auto const& [contract, index] : byShard[i])
+        {
+            if (shards_[i].expected.insert(index).second)
+                indexes[contract].push_back(index);
+        }
+    }
+
+    for (auto& [contract, items] : indexes)
+    {
+        auto const sle = parent.read(keylet::account(contract));
+        if (!sle || !sle->isFieldPresent(sfStorageOverlay))
+            continue;
+        auto const root = sle->getFieldM256(sfStorageOverlay).rootHash();
+        if (!root || *root == beast::zero)
+            continue;
+
+        keys_ += items.size();
+        app_.getJobQueue().addJob(
+            jtSTORAGE_PREFETCH,
+            "StoragePrefetch",
+            [this, root = *root, items = std::move(items)](Job&) mutable {
+                warm(root, std::move(items));
+            },
+            app_.doJobCounter());
+    }
+}
+
+void
+StoragePrefetch::warm(uint256 const& root, std::vector<uint256> indexes)
+{
+    struct Pending
+    {
+        SHAMapHash hash;
+        SHAMapNodeID id;
+        std::vector<uint256> indexes;
+        std::shared_ptr<SHAMapAbstractNode> node;
+        bool cached;
+        bool reading;
+    };
+
+    auto& family = app_.getNodeFamily();
+    auto& db = family.db();
+    // Contract storage maps are not tied to a ledger
+    auto const cache = family.getTreeNodeCache(0);
+
+    std::vector<Pending> level;
+    level.push_back(
+        {SHAMapHash{root},
+         SHAMapNodeID{},
+         std::move(indexes),
+         nullptr,
+         false,
+         false});
+
+    try
+    {
+        while (!level.empty())
+        {
+            // Start every read of this level before waiting for one
+            bool reading = false;
+            for (auto& p : level)
+            {
+                if ((p.node = cache->fetch(p.hash.as_uint256())))
+                {
+                    p.cached = true;
+                    ++nodesCached_;
+                    continue;
+                }
+
+                std::shared_ptr<NodeObject> obj;
+                if (!db.asyncFetch(p.hash.as_uint256(), 0, obj))
+                    reading = p.reading = true;
+                else if (obj)
+                    p.node = SHAMapAbstractNode::makeFromPrefix(
+                        makeSlice(obj->getData()), p.hash);
+            }
+
+            if (reading)
+                db.waitReads();
+
+            std::vector<Pending> next;
+            for (auto& p : level)
+            {
+                if (p.reading)
+                {
+                    // In the node store's cache now, unless evicted already
+                    if (auto obj = db.fetch(p.hash.as_uint256(), 0))
+                        p.node = SHAMapAbstractNode::makeFromPrefix(
+                            makeSlice(obj->getData()), p.hash);
+                }
+                if (!p.node)
+                    continue;
+
+                if (!p.cached)
+                {
+                    ++nodesRead_;
+                    cache->canonicalize_replace_client(
+                        p.hash.as_uint256(), p.node);
+                }
+
+                if (!p.node->isInner())
+                    continue;
+
+                auto const inner =
+                    std::static_pointer_cast<SHAMapInnerNode>(p.node);
+                std::map<int, std::vector<uint256>> branches;
+                for (auto const& index : p.indexes)
+                    branches[p.id.selectBranch(index)].push_back(index);
+
+                for (auto& [branch, items] : branches)
+                {
+                    if (inner->isEmptyBranch(branch))
+                        continue;
+                    next.push_back(
+                        {inner->getChildHash(branch),
+                         p.id.getChildNodeID(branch),
+                         std::move(items),
+                         nullptr,
+                         false,
+                         false});
+                }
+            }
+            level = std::move(next);
+        }
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(journal_.warn()) << "Prefetching storage of " << root
+                              << " failed: " << e.what();
+    }
+}
+
+void
+StoragePrefetch::onRead(uint256 const& index)
+{
+    if (!setup_.enable)
+        return;
+
+    ++reads_;
+    auto& shard = shards_[shardOf(index)];
+    std::lock_guard lock(shard.mutex);
+    if (shard.expected.count(index))
+        ++hits_;
+}
+
+Json::Value
+StoragePrefetch::getJson() const
+{
+    Json::Value ret(Json::objectValue);
+    ret["calls"] = static_cast<Json::UInt>(calls_);
+    ret["predicted_calls"] = static_cast<Json::UInt>(predicted_);
+    ret["prefetched_keys"] = static_cast<Json::UInt>(keys_);
+    ret["nodes_read"] = static_cast<Json::UInt>(nodesRead_);
+    ret["nodes_cached"] = static_cast<Json::UInt>(nodesCached_);
+    ret["storage_reads"] = static_cast<Json::UInt>(reads_);
+    ret["storage_hits"] = static_cast<Json::UInt>(hits_);
+    if (reads_ != 0)
+        ret["hit_rate"] = static_cast<double>(hits_) / reads_;
+    std::size_t functions = 0;
+    for (auto& shard : shards_)
+    {
+        std::lock_guard lock(shard.mutex);
+        functions += shard.functions.size();
+    }
+    ret["functions"] = static_cast<Json::UInt>(functions);
+    return ret;
+}
+
+StoragePrefetch::Setup
+setup_StoragePrefetch(Config const& config)
+{
+    StoragePrefetch::Setup setup;
+
+    auto const& section = config.section(ConfigSection::contractPrefetch());
+    set(setup.enable, "enable", section);
+    set(setup.maxKeys, "max_keys", section);
+    set(setup.maxFunctions, "max_functions", section);
+    set(setup.maxIdle, "max_idle_ledgers", section);
+    return setup;
+}
+
+}  // namespace ripple
@@ -20,6 +20,7 @@
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <peersafe/app/misc/TxPool.h>
 #include <peersafe/app/misc/StateManager.h>
+#include <peersafe/app/prometh/PrometheusClient.h>
 
 namespace ripple {
 
@@ -61,6 +62,40 @@ TER
 TxPool::insertTx(
     std::shared_ptr<Transaction> transaction,
     LedgerIndex ledgerSeq)
+{
+    std::unique_lock<std::shared_mutex> lock(mutexSet_);
+
+    auto const ter = insertLocked(transaction, ledgerSeq);
+    if (ter == tesSUCCESS)
+        app_.getPrometheusClient().onTxPoolSize(mTxsSet.size());
+    return ter;
+}
+
+std::vector<TER>
+TxPool::insertTxs(
+    std::vector<std::shared_ptr<Transaction>> const& transactions,
+    LedgerIndex ledgerSeq)
+{
+    std::vector<TER> result;
+    result.reserve(transactions.size());
+
+    std::unique_lock<std::shared_mutex> lock(mutexSet_);
+
+    bool inserted = false;
+    for (auto const& transaction : transactions)
+    {
+        result.push_back(insertLocked(transaction, ledgerSeq));
+        inserted = inserted || result.back() == tesSUCCESS;
+    }
+    if (inserted)
+        app_.getPrometheusClient().onTxPoolSize(mTxsSet.size());
+    return result;
+}
+
+TER
+TxPool::insertLocked(
+    std::shared_ptr<Transaction> const& transaction,
+    LedgerIndex ledgerSeq)
 {
     if (mTxsSet.size() >= mMaxTxsInPool)
     {
@@ -69,8 +104,6 @@ TxPool::insertTx(
         return telTX_POOL_FULL;
     }
 
-    std::unique_lock<std::shared_mutex> lock(mutexSet_);
-
     if (mInLedgerCache.count(transaction->getID()) > 0)
     {
         JLOG(j_.info()) << "Inserting a applied Tx: " << transaction->getID();
@@ -115,6 +148,7 @@ TxPool::removeTxs(
 {
     int count = 0;
     TransactionSet::iterator iterSet;
+    auto const now = utcTime();
     try
     {
         for (auto const& item : cSet)
@@ -128,6 +162,9 @@ TxPool::removeTxs(
             {
                 // If not exist, throw std::out_of_range exception.
                 iterSet = mTxsHash.at(item.key());
+                app_.getPrometheusClient().onTxPoolRemove(
+                    std::chrono::milliseconds{
+                        now - std::min(now, (*iterSet)->getTimeCreate())});
                 // remove from Tx pool.
                 mTxsHash.erase(item.key());
                 mTxsSet.erase(iterSet);
@@ -145,6 +182,7 @@ TxPool::removeTxs(
     }
 
     JLOG(j_.info()) << "Remove " << count << " txs for ledger " << ledgerSeq;
+    app_.getPrometheusClient().onTxPoolSize(getTxCountInPool());
 
     checkSyncStatus(ledgerSeq, prevHash);
 }
@@ -2,9 +2,11 @@
 #define RIPPLE_RPC_PROMETHEUS_CLIENT_UTIL_H_INCLUDED
 
 #include <prometheus/counter.h>
+#include <prometheus/histogram.h>
 #include <prometheus/exposer.h>
 #include <prometheus/registry.h>
 #include <ripple/core/Config.h>
+#include <ripple/core/JobTypes.h>
 #include <ripple/beast/utility/PropertyStream.h>
 #include <ripple/protocol/Protocol.h>
 #include <ripple/basics/Log.h>
@@ -12,10 +14,13 @@
 #include <peersafe/schema/Schema.h>
 #include <ripple/app/ledger/OpenLedger.h>
 #include <ripple/ledger/ApplyView.h>
+#include <peersafe/app/ledger/LedgerTimeline.h>
 #include <array>
 #include <chrono>
 #include <cstdlib>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 
@@ -38,6 +43,23 @@ namespace ripple {
 		prometheus::Family<prometheus::Gauge>& getContractCallCountGauge();
 		prometheus::Family<prometheus::Gauge>& getAccountCountGauge();
 		prometheus::Family<prometheus::Gauge>& getBlockHeightGauge();
+		prometheus::Family<prometheus::Histogram>& getLedgerPhaseHistogram();
+		prometheus::Family<prometheus::Counter>& getTxReceivedCounter();
+		prometheus::Family<prometheus::Gauge>& getTxPoolSizeGauge();
+		prometheus::Family<prometheus::Histogram>& getTxPoolAgeHistogram();
+		prometheus::Family<prometheus::Histogram>& getConsensusRoundHistogram();
+		prometheus::Family<prometheus::Histogram>& getSqlCommitHistogram();
+
+		// Node-wide metrics. The job queue, the node store and the overlay
+		// are shared by every schema, so these carry no schemaId. All of
+		// them are atomic updates and safe to call from any thread.
+		void onJob(JobType type, std::chrono::microseconds wait, std::chrono::microseconds run);
+		void onNodeStoreFetch(bool isAsync, std::chrono::milliseconds elapsed);
+		void onNodeStoreWrite(std::chrono::milliseconds elapsed);
+		// A reconnecting peer gets the counter of its earlier connection
+		// back, so a counter is removed only when its last user is gone.
+		prometheus::Counter& addPeerTraffic(std::string const& peer, char const* direction);
+		void removePeerTraffic(prometheus::Counter& counter);
 	private:
 		Application&			app_;
 		beast::Journal          journal_;
@@ -55,7 +77,25 @@ namespace ripple {
 		prometheus::Family<prometheus::Gauge>& m_contractCallCount_gauge;
 		prometheus::Family<prometheus::Gauge>& m_accountCount_gauge;
 		prometheus::Family<prometheus::Gauge>& m_blockHeight_gauge;
-		
+		prometheus::Family<prometheus::Histogram>& m_ledgerPhase_histogram;
+		prometheus::Family<prometheus::Counter>& m_txReceived_counter;
+		prometheus::Family<prometheus::Gauge>& m_txPoolSize_gauge;
+		prometheus::Family<prometheus::Histogram>& m_txPoolAge_histogram;
+		prometheus::Family<prometheus::Histogram>& m_consensusRound_histogram;
+		prometheus::Family<prometheus::Histogram>& m_sqlCommit_histogram;
+		prometheus::Family<prometheus::Histogram>& m_jobWait_histogram;
+		prometheus::Family<prometheus::Histogram>& m_jobRun_histogram;
+		prometheus::Family<prometheus::Histogram>& m_nodestoreRead_histogram;
+		prometheus::Family<prometheus::Histogram>& m_nodestoreWrite_histogram;
+		prometheus::Family<prometheus::Counter>& m_peerTraffic_counter;
+		std::mutex m_peerTraffic_mutex;
+		std::map<prometheus::Counter*, std::size_t> m_peerTraffic_refs;
+
+		// Filled in the constructor and only read afterwards
+		std::map<JobType, std::pair<prometheus::Histogram*, prometheus::Histogram*>> m_job_histograms;
+		prometheus::Histogram& m_nodestoreSyncRead_histogram;
+		prometheus::Histogram& m_nodestoreAsyncRead_histogram;
+		prometheus::Histogram& m_nodestoreBatchWrite_histogram;
 	};
 	class PrometheusClient {
 
@@ -72,6 +112,13 @@ namespace ripple {
         int getSchemaCount(Schema& app);
         std::shared_ptr<SLE>& getPromethSle();
         void setup();
+
+		// Fed straight from the transaction, consensus and SQL paths
+		void onTxReceived(bool local);
+		void onTxPoolSize(std::size_t size);
+		void onTxPoolRemove(std::chrono::milliseconds age);
+		void onConsensusRound(std::chrono::milliseconds duration);
+		void onSqlCommit(std::chrono::microseconds duration);
 	private:
 		Schema&				app_;
 		beast::Journal      journal_;
@@ -87,6 +134,13 @@ namespace ripple {
 		prometheus::Gauge& m_contractCallCount_gauge;
 		prometheus::Gauge& m_accountCount_gauge;
 		prometheus::Gauge& m_blockHeight_gauge;
+		std::array<prometheus::Histogram*, LedgerTimeline::phaseCount> m_ledgerPhase_histograms;
+		prometheus::Counter& m_txReceivedLocal_counter;
+		prometheus::Counter& m_txReceivedPeer_counter;
+		prometheus::Gauge& m_txPoolSize_gauge;
+		prometheus::Histogram& m_txPoolAge_histogram;
+		prometheus::Histogram& m_consensusRound_histogram;
+		prometheus::Histogram& m_sqlCommit_histogram;
         std::shared_ptr<SLE> m_promethSle;
 		
 	};
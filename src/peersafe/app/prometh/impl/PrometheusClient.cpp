@@ -35,6 +35,24 @@
 #include <ripple/core/ConfigSections.h>
 namespace ripple {
 
+// Job queue waits and runs: tens of microseconds up to stalls
+static prometheus::Histogram::BucketBoundaries const jobBuckets{
+    0.0001, 0.0005, 0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1, 5};
+
+// Node store and SQL latencies; the node store reports whole milliseconds
+static prometheus::Histogram::BucketBoundaries const ioBuckets{
+    0.0005, 0.001, 0.002, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 1};
+
+// Consensus rounds and time spent waiting in the pool
+static prometheus::Histogram::BucketBoundaries const roundBuckets{
+    0.25, 0.5, 1, 2, 3, 5, 10, 20, 30, 60, 120};
+
+static std::string
+schemaLabel(Schema& app)
+{
+    return to_string(app.getSchemaParams().schemaId());
+}
+
 std::string
 PromethExposer::getPort(Application& app)
 {
@@ -103,9 +121,76 @@ PromethExposer::PromethExposer(
                                    .Help("block height")
                                    .Labels({{"pubkey_node", pubkey_node_}})
                                    .Register(*m_registry))
+    , m_ledgerPhase_histogram(prometheus::BuildHistogram()
+                                   .Name("Chainsqld_ledger_phase_seconds")
+                                   .Help("time spent in each phase of a ledger close")
+                                   .Labels({{"pubkey_node", pubkey_node_}})
+                                   .Register(*m_registry))
+    , m_txReceived_counter(prometheus::BuildCounter()
+                                   .Name("Chainsqld_tx_received_total")
+                                   .Help("transactions received, by source")
+                                   .Labels({{"pubkey_node", pubkey_node_}})
+                                   .Register(*m_registry))
+    , m_txPoolSize_gauge(prometheus::BuildGauge()
+                                   .Name("Chainsqld_txpool_size")
+                                   .Help("transactions waiting in the pool")
+                                   .Labels({{"pubkey_node", pubkey_node_}})
+                                   .Register(*m_registry))
+    , m_txPoolAge_histogram(prometheus::BuildHistogram()
+                                   .Name("Chainsqld_txpool_age_seconds")
+                                   .Help("time from receipt until a transaction leaves the pool in a ledger")
+                                   .Labels({{"pubkey_node", pubkey_node_}})
+                                   .Register(*m_registry))
+    , m_consensusRound_histogram(prometheus::BuildHistogram()
+                                   .Name("Chainsqld_consensus_round_seconds")
+                                   .Help("consensus round duration")
+                                   .Labels({{"pubkey_node", pubkey_node_}})
+                                   .Register(*m_registry))
+    , m_sqlCommit_histogram(prometheus::BuildHistogram()
+                                   .Name("Chainsqld_sql_commit_seconds")
+                                   .Help("time to commit a validated ledger to the SQL databases")
+                                   .Labels({{"pubkey_node", pubkey_node_}})
+                                   .Register(*m_registry))
+    , m_jobWait_histogram(prometheus::BuildHistogram()
+                                   .Name("Chainsqld_job_wait_seconds")
+                                   .Help("time jobs spend queued, by job type")
+                                   .Labels({{"pubkey_node", pubkey_node_}})
+                                   .Register(*m_registry))
+    , m_jobRun_histogram(prometheus::BuildHistogram()
+                                   .Name("Chainsqld_job_run_seconds")
+                                   .Help("time jobs spend running, by job type")
+                                   .Labels({{"pubkey_node", pubkey_node_}})
+                                   .Register(*m_registry))
+    , m_nodestoreRead_histogram(prometheus::BuildHistogram()
+                                   .Name("Chainsqld_nodestore_read_seconds")
+                                   .Help("node store reads that went to disk")
+                                   .Labels({{"pubkey_node", pubkey_node_}})
+                                   .Register(*m_registry))
+    , m_nodestoreWrite_histogram(prometheus::BuildHistogram()
+                                   .Name("Chainsqld_nodestore_write_seconds")
+                                   .Help("node store batch writes")
+                                   .Labels({{"pubkey_node", pubkey_node_}})
+                                   .Register(*m_registry))
+    , m_peerTraffic_counter(prometheus::BuildCounter()
+                                   .Name("Chainsqld_peer_traffic_bytes_total")
+                                   .Help("bytes exchanged with each peer")
+                                   .Labels({{"pubkey_node", pubkey_node_}})
+                                   .Register(*m_registry))
+    , m_nodestoreSyncRead_histogram(m_nodestoreRead_histogram.Add({{"mode", "sync"}}, ioBuckets))
+    , m_nodestoreAsyncRead_histogram(m_nodestoreRead_histogram.Add({{"mode", "async"}}, ioBuckets))
+    , m_nodestoreBatchWrite_histogram(m_nodestoreWrite_histogram.Add({}, ioBuckets))
 {
      using namespace prometheus;
 
+    for (auto const& [type, jobType] : JobTypes::instance())
+    {
+        m_job_histograms.emplace(
+            type,
+            std::make_pair(
+                &m_jobWait_histogram.Add({{"job_type", jobType.name()}}, jobBuckets),
+                &m_jobRun_histogram.Add({{"job_type", jobType.name()}}, jobBuckets)));
+    }
+
     try
     {
         std::string port;
@@ -190,6 +275,90 @@ PromethExposer::getBlockHeightGauge()
     return m_blockHeight_gauge;
 }
 
+prometheus::Family<prometheus::Histogram>&
+PromethExposer::getLedgerPhaseHistogram()
+{
+    return m_ledgerPhase_histogram;
+}
+
+prometheus::Family<prometheus::Counter>&
+PromethExposer::getTxReceivedCounter()
+{
+    return m_txReceived_counter;
+}
+
+prometheus::Family<prometheus::Gauge>&
+PromethExposer::getTxPoolSizeGauge()
+{
+    return m_txPoolSize_gauge;
+}
+
+prometheus::Family<prometheus::Histogram>&
+PromethExposer::getTxPoolAgeHistogram()
+{
+    return m_txPoolAge_histogram;
+}
+
+prometheus::Family<prometheus::Histogram>&
+PromethExposer::getConsensusRoundHistogram()
+{
+    return m_consensusRound_histogram;
+}
+
+prometheus::Family<prometheus::Histogram>&
+PromethExposer::getSqlCommitHistogram()
+{
+    return m_sqlCommit_histogram;
+}
+
+void
+PromethExposer::onJob(
+    JobType type,
+    std::chrono::microseconds wait,
+    std::chrono::microseconds run)
+{
+    auto it = m_job_histograms.find(type);
+    if (it == m_job_histograms.end())
+        return;
+    it->second.first->Observe(wait.count() / 1e6);
+    it->second.second->Observe(run.count() / 1e6);
+}
+
+void
+PromethExposer::onNodeStoreFetch(bool isAsync, std::chrono::milliseconds elapsed)
+{
+    auto& histogram = isAsync ? m_nodestoreAsyncRead_histogram
+                              : m_nodestoreSyncRead_histogram;
+    histogram.Observe(elapsed.count() / 1e3);
+}
+
+void
+PromethExposer::onNodeStoreWrite(std::chrono::milliseconds elapsed)
+{
+    m_nodestoreBatchWrite_histogram.Observe(elapsed.count() / 1e3);
+}
+
+prometheus::Counter&
+PromethExposer::addPeerTraffic(std::string const& peer, char const* direction)
+{
+    std::lock_guard<std::mutex> lock(m_peerTraffic_mutex);
+    auto& counter =
+        m_peerTraffic_counter.Add({{"peer", peer}, {"direction", direction}});
+    ++m_peerTraffic_refs[&counter];
+    return counter;
+}
+
+void
+PromethExposer::removePeerTraffic(prometheus::Counter& counter)
+{
+    std::lock_guard<std::mutex> lock(m_peerTraffic_mutex);
+    auto it = m_peerTraffic_refs.find(&counter);
+    if (it == m_peerTraffic_refs.end() || --it->second > 0)
+        return;
+    m_peerTraffic_refs.erase(it);
+    m_peerTraffic_counter.Remove(&counter);
+}
+
 PrometheusClient::PrometheusClient(
     Schema& app,
     Config& cfg,
@@ -208,10 +377,28 @@ PrometheusClient::PrometheusClient(
     , m_contractCallCount_gauge(exposer_.getContractCallCountGauge().Add({{"schemaId", to_string(app_.getSchemaParams().schemaId())}}))
     , m_accountCount_gauge(exposer_.getAccountCountGauge().Add({{"schemaId", to_string(app_.getSchemaParams().schemaId())}}))
     , m_blockHeight_gauge(exposer_.getBlockHeightGauge().Add({{"schemaId", to_string(app_.getSchemaParams().schemaId())}}))
+    , m_txReceivedLocal_counter(exposer_.getTxReceivedCounter().Add({{"schemaId", schemaLabel(app_)}, {"source", "local"}}))
+    , m_txReceivedPeer_counter(exposer_.getTxReceivedCounter().Add({{"schemaId", schemaLabel(app_)}, {"source", "peer"}}))
+    , m_txPoolSize_gauge(exposer_.getTxPoolSizeGauge().Add({{"schemaId", schemaLabel(app_)}}))
+    , m_txPoolAge_histogram(exposer_.getTxPoolAgeHistogram().Add({{"schemaId", schemaLabel(app_)}}, roundBuckets))
+    , m_consensusRound_histogram(exposer_.getConsensusRoundHistogram().Add({{"schemaId", schemaLabel(app_)}}, roundBuckets))
+    , m_sqlCommit_histogram(exposer_.getSqlCommitHistogram().Add({{"schemaId", schemaLabel(app_)}}, ioBuckets))
     , m_promethSle(std::make_unique<SLE>(keylet::statis()))
     
 {
-    
+    // Close phases run from milliseconds to the multi-second outliers
+    prometheus::Histogram::BucketBoundaries const buckets{
+        0.001, 0.005, 0.01, 0.05, 0.1, 0.25, 0.5, 1, 2, 4, 8};
+    m_ledgerPhase_histograms.fill(nullptr);
+    if (!app_.getLedgerTimeline().enabled())
+        return;
+    for (std::size_t i = 0; i < LedgerTimeline::phaseCount; ++i)
+    {
+        m_ledgerPhase_histograms[i] = &exposer_.getLedgerPhaseHistogram().Add(
+            {{"schemaId", to_string(app_.getSchemaParams().schemaId())},
+             {"phase", LedgerTimeline::phaseName(static_cast<LedgerTimeline::Phase>(i))}},
+            buckets);
+    }
 }
 PrometheusClient::~PrometheusClient()
 {
@@ -223,6 +410,47 @@ PrometheusClient::~PrometheusClient()
     exposer_.getContractCallCountGauge().Remove(&m_contractCallCount_gauge);
     exposer_.getAccountCountGauge().Remove(&m_accountCount_gauge);
     exposer_.getBlockHeightGauge().Remove(&m_blockHeight_gauge);
+    for (auto histogram : m_ledgerPhase_histograms)
+    {
+        if (histogram)
+            exposer_.getLedgerPhaseHistogram().Remove(histogram);
+    }
+    exposer_.getTxReceivedCounter().Remove(&m_txReceivedLocal_counter);
+    exposer_.getTxReceivedCounter().Remove(&m_txReceivedPeer_counter);
+    exposer_.getTxPoolSizeGauge().Remove(&m_txPoolSize_gauge);
+    exposer_.getTxPoolAgeHistogram().Remove(&m_txPoolAge_histogram);
+    exposer_.getConsensusRoundHistogram().Remove(&m_consensusRound_histogram);
+    exposer_.getSqlCommitHistogram().Remove(&m_sqlCommit_histogram);
+}
+
+void
+PrometheusClient::onTxReceived(bool local)
+{
+    (local ? m_txReceivedLocal_counter : m_txReceivedPeer_counter).Increment();
+}
+
+void
+PrometheusClient::onTxPoolSize(std::size_t size)
+{
+    m_txPoolSize_gauge.Set(static_cast<double>(size));
+}
+
+void
+PrometheusClient::onTxPoolRemove(std::chrono::milliseconds age)
+{
+    m_txPoolAge_histogram.Observe(age.count() / 1e3);
+}
+
+void
+PrometheusClient::onConsensusRound(std::chrono::milliseconds duration)
+{
+    m_consensusRound_histogram.Observe(duration.count() / 1e3);
+}
+
+void
+PrometheusClient::onSqlCommit(std::chrono::microseconds duration)
+{
+    m_sqlCommit_histogram.Observe(duration.count() / 1e6);
 }
 
 std::shared_ptr<SLE>&
@@ -258,6 +486,13 @@ PrometheusClient::timerEntry(NetClock::time_point const& now)
         return;
     }
     m_promethTime = now;
+
+    app_.getLedgerTimeline().drainSamples(
+        [this](LedgerTimeline::Phase phase, std::chrono::microseconds d) {
+            if (auto histogram = m_ledgerPhase_histograms[phase])
+                histogram->Observe(d.count() / 1e6);
+        });
+
     int count = getSchemaCount(app_);
     m_schema_gauge.Set(count);
 
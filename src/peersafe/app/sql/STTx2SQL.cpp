@@ -28,6 +28,7 @@
 #include <peersafe/app/sql/STTx2SQL.h>
 #include <peersafe/app/sql/TxStore.h>
 #include <peersafe/app/sql/SQLConditionTree.h>
+#include <peersafe/app/table/TableMirror.h>
 
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
@@ -3578,8 +3579,9 @@ STTx2SQL::ParseFieldVL(const ripple::STTx& tx, const SF_Blob& field,std::string
     if (tx.isFieldPresent(field))
     {
         bHasField = true;
-        auto blob = tx.getFieldVL(field);
-        fieldName.assign(blob.begin(), blob.end());
+        auto const slice = tx.getFieldSlice(field);
+        fieldName.assign(
+            reinterpret_cast<char const*>(slice.data()), slice.size());
         //auto sql_str =
         //    (boost::format("select * from information_schema.columns WHERE "
         //                   "table_name ='%s'AND column_name ='%s'") %
@@ -3937,9 +3939,13 @@ std::pair<int /*retcode*/, std::string /*sql*/> STTx2SQL::ExecuteSQL(
 		return ret;
 	}
 
-	uint16_t optype = tx.getFieldU16(sfOpType);
-	const ripple::STArray& tables = tx.getFieldArray(sfTables);
-	ripple::uint160 hex_tablename = tables[0].getFieldH160(sfNameInDB);
+	auto const view = tx.view();
+	if (!view->opType || view->tables.empty()) {
+		ret = { -1, "Transaction has no tables." };
+		return ret;
+	}
+	uint16_t optype = *view->opType;
+	ripple::uint160 const& hex_tablename = view->tables[0].nameInDB;
 	//ripple::uint160 hex_tablename = tx.getFieldH160(sfNameInDB);
 	std::string tn = ripple::to_string(hex_tablename);
 	if (tn.empty()) {
@@ -4287,6 +4293,12 @@ Json::Value TxStore::txHistory(Json::Value& tx_json) {
 		return RPC::make_error(rpcINTERNAL, errMsg);
     }
 
+    if (mirror_)
+    {
+        if (auto result = mirror_->select(tx_json, select_limit_, databasecon_))
+            return std::move(*result);
+    }
+
     return helper::query_directly(tx_json, databasecon_, buildsql.get(), select_limit_);
 }
 
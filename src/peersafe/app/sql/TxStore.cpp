@@ -22,6 +22,7 @@
 
 #include <peersafe/app/sql/TxStore.h>
 #include <peersafe/app/sql/STTx2SQL.h>
+#include <peersafe/app/table/TableMirror.h>
 #include <ripple/json/Output.h>
 #include <ripple/protocol/jss.h>
 #include <ripple/protocol/ErrorCodes.h>
@@ -123,12 +124,17 @@ TxStoreTransaction::~TxStoreTransaction() {
 //	databasecon_ = std::make_shared<DatabaseCon>(setup, database_name, nullptr, 0);
 //}
 
-TxStore::TxStore(DatabaseCon* dbconn, const Config& cfg, const beast::Journal& journal)
+TxStore::TxStore(
+    DatabaseCon* dbconn,
+    const Config& cfg,
+    const beast::Journal& journal,
+    TableMirror* mirror)
 : cfg_(cfg)
 , db_type_()
 , select_limit_(200)
 , databasecon_(dbconn)
-, journal_(journal) {
+, journal_(journal)
+, mirror_(mirror) {
 	const ripple::Section& sync_db = cfg_.section("sync_db");
 	std::pair<std::string, bool> result = sync_db.find("type");
 	if (result.second)
@@ -178,6 +184,8 @@ TxStore::Dispose(
 		} else {
 			JLOG(journal_.debug()) << "Execute success. " + result.second;
             ret = { true, "success" };
+            if (mirror_)
+                mirror_->stage(tx, param);
 		}
 	} while (0);
 	return ret;
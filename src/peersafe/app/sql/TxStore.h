@@ -33,6 +33,8 @@
 
 namespace ripple {
 
+class TableMirror;
+
 class TxStoreDBConn {
 public:
 	TxStoreDBConn(const Config& cfg);
@@ -74,7 +76,11 @@ private:
 class TxStore {
 public:
 	//TxStore(const Config& cfg);
-	TxStore(DatabaseCon* dbconn, const Config& cfg, const beast::Journal& journal);
+	TxStore(
+        DatabaseCon* dbconn,
+        const Config& cfg,
+        const beast::Journal& journal,
+        TableMirror* mirror = nullptr);
 	~TxStore();
 
 	// dispose one transaction
@@ -98,6 +104,9 @@ private:
 	int         select_limit_;
 	DatabaseCon* databasecon_;
 	beast::Journal journal_;
+    // Selects are answered from it when they can be, and disposed
+    // transactions staged into it
+    TableMirror* mirror_;
 };	// class TxStore
 
 }	// namespace ripple
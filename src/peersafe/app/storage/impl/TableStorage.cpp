@@ -27,6 +27,7 @@
 #include <peersafe/app/table/TableStatusDBMySQL.h>
 #include <peersafe/app/table/TableStatusDBSQLite.h>
 #include <peersafe/app/storage/TableStorage.h>
+#include <peersafe/app/ledger/LedgerTimeline.h>
 #include <peersafe/app/tx/ChainSqlTx.h>
 #include <peersafe/schema/Schema.h>
 #include <ripple/ledger/impl/Tuning.h>
@@ -258,6 +259,12 @@ namespace ripple {
     {
         auto validIndex = app_.getLedgerMaster().getValidLedgerIndex();
         auto mapTmp = m_map;
+        boost::optional<LedgerTimeline::Scope> timing;
+        if (!mapTmp.empty())
+            timing.emplace(
+                app_.getLedgerTimeline(),
+                validIndex,
+                LedgerTimeline::tableStorage);
 
         for(auto item : mapTmp)
         {
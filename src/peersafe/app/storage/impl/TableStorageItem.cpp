@@ -24,6 +24,8 @@
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/app/misc/Transaction.h>
 #include <peersafe/app/table/TableSync.h>
+#include <peersafe/app/table/QueryCache.h>
+#include <peersafe/app/table/TableMirror.h>
 #include <peersafe/app/table/TableStatusDBMySQL.h>
 #include <peersafe/app/table/TableStatusDBSQLite.h>
 #include <peersafe/protocol/TableDefines.h>
@@ -301,6 +303,7 @@ namespace ripple {
             stTran.rollback();
             JLOG(journal_.warn()) << " TableStorageItem::rollBack " << sTableName_;
         }
+        app_.getTableMirror().invalidate(from_hex_text<uint160>(sTableNameInDB_));
 
         app_.getTableSync().ReStartOneTable(accountID_, sTableNameInDB_, sTableName_, false, false);
         return true;
@@ -316,6 +319,8 @@ namespace ripple {
 				getTableStatusDB().UpdateSyncDB(to_string(accountID_), sTableNameInDB_, to_string(txnHash_), std::to_string(txnLedgerSeq_), to_string(ledgerHash_), std::to_string(LedgerSeq_), txUpdateHash_.isNonZero()?to_string(txUpdateHash_) : "", std::to_string(lastTxTm_),"");
             stTran.commit();
         }
+        app_.getQueryCache().invalidate(from_hex_text<uint160>(sTableNameInDB_));
+        app_.getTableMirror().commit(from_hex_text<uint160>(sTableNameInDB_));
 
         app_.getTableSync().ReStartOneTable(accountID_, sTableNameInDB_, sTableName_, bDropped_, true);
         
@@ -365,7 +370,8 @@ namespace ripple {
         if (pObjTxStore_ == NULL)
         {
             auto& conn = getTxStoreDBConn();
-            pObjTxStore_ = std::make_unique<TxStore>(conn.GetDBConn(), cfg_, journal_);
+            pObjTxStore_ = std::make_unique<TxStore>(
+                conn.GetDBConn(), cfg_, journal_, &app_.getTableMirror());
         }
         return *pObjTxStore_;
     }
@@ -0,0 +1,162 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifndef RIPPLE_APP_TABLE_QUERYCACHE_H_INCLUDED
+#define RIPPLE_APP_TABLE_QUERYCACHE_H_INCLUDED
+
+#include <ripple/basics/base_uint.h>
+#include <ripple/basics/Log.h>
+#include <ripple/json/json_value.h>
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ripple {
+
+class Config;
+
+/*
+Result cache for the table select RPCs (r_get, r_get_sql_admin,
+r_get_sql_user and the contract select path).
+
+A table's rows only change when the sync/storage layer commits a new
+TxnLedgerSeq for it, so a select result stays valid until one of the tables
+it reads is written again. Writers call invalidate() after committing; every
+entry reading that table is dropped and the table's generation is bumped so
+a query that raced with the commit can not be inserted afterwards.
+
+Authority and operation-rule checks are always done before the cache is
+consulted; the caller folds the account and the rule-rewritten query into
+the key.
+*/
+class QueryCache
+{
+public:
+    struct Setup
+    {
+        explicit Setup() = default;
+
+        bool enable = false;
+        std::size_t maxBytes = 64 * 1024 * 1024;
+        std::size_t maxEntries = 8192;
+    };
+
+    // Generations of the tables a query reads, taken before it executes.
+    using Generations = std::vector<std::pair<uint160, std::uint64_t>>;
+
+    QueryCache(Setup const& setup, beast::Journal journal);
+
+    bool
+    enabled() const
+    {
+        return setup_.enable;
+    }
+
+    /** Collapse whitespace outside of quoted literals and drop trailing ';'
+        so trivially different spellings of a query share an entry.
+    */
+    static std::string
+    normalize(std::string const& sql);
+
+    static std::string
+    makeKey(
+        std::string const& kind,
+        std::string const& account,
+        std::string const& query,
+        std::set<uint160> const& tables);
+
+    Generations
+    snapshot(std::set<uint160> const& tables);
+
+    boost::optional<Json::Value>
+    fetch(std::string const& key, std::set<uint160> const& tables);
+
+    /** Store a result. Ignored if any table moved since snapshot(). */
+    void
+    insert(
+        std::string const& key,
+        Generations const& generations,
+        Json::Value const& result);
+
+    /** A table's data changed: drop every entry that reads it. */
+    void
+    invalidate(uint160 const& nameInDB);
+
+    void
+    clear();
+
+    Json::Value
+    getJson() const;
+
+    static std::size_t
+    approximateSize(Json::Value const& v);
+
+private:
+    struct Entry
+    {
+        std::string key;
+        std::set<uint160> tables;
+        Json::Value result;
+        std::size_t bytes;
+    };
+    using LruList = std::list<Entry>;
+
+    struct TableStats
+    {
+        std::uint64_t generation = 0;
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t invalidations = 0;
+    };
+
+    void
+    eraseEntry(LruList::iterator it);
+
+    void
+    evict();
+
+    Setup const setup_;
+    beast::Journal journal_;
+
+    mutable std::mutex mutex_;
+    LruList lru_;
+    std::unordered_map<std::string, LruList::iterator> entries_;
+    std::map<uint160, std::set<std::string>> keysByTable_;
+    std::map<uint160, TableStats> tables_;
+    std::size_t bytes_ = 0;
+
+    std::uint64_t hits_ = 0;
+    std::uint64_t misses_ = 0;
+    std::uint64_t inserts_ = 0;
+    std::uint64_t staleInserts_ = 0;
+    std::uint64_t evictions_ = 0;
+};
+
+QueryCache::Setup
+setup_QueryCache(Config const& config);
+
+}  // namespace ripple
+
+#endif
@@ -0,0 +1,234 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifndef RIPPLE_APP_TABLE_TABLEMIRROR_H_INCLUDED
+#define RIPPLE_APP_TABLE_TABLEMIRROR_H_INCLUDED
+
+#include <ripple/basics/base_uint.h>
+#include <ripple/basics/Log.h>
+#include <ripple/json/json_value.h>
+#include <boost/optional.hpp>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+class Config;
+class DatabaseCon;
+class STTx;
+class conditionTree;
+struct SyncParam;
+
+/*
+In-memory copy of the tables named in [table_mirror], kept column by column
+so that selects on them are answered without going to the database.
+
+A table is read from the database by the first select on it. After that,
+the transactions TxStore disposes are staged here and applied when the
+sync/storage layer commits them, at the same points where it invalidates
+the QueryCache. Inserts are appended to the columns; any other change, or
+an insert whose values can't be reproduced exactly, drops the copy and the
+next select reads the table again. A rollback drops it as well.
+
+Selects are answered when every part of them is understood: one table,
+plain columns or count/sum/min/max/avg, conditions built from the
+operators conditionTree parses, $group, $order and $limit. Each condition
+is evaluated over a whole column at once into a row mask. Anything else,
+including $join and $having, returns nothing and the caller goes to the
+database as before.
+*/
+class TableMirror
+{
+public:
+    struct Setup
+    {
+        explicit Setup() = default;
+
+        std::set<uint160> tables;
+        std::size_t maxRows = 100000;
+        // Text comparisons, LIKE and the result types of sum and avg are
+        // those of SQLite. On other databases such selects are not answered.
+        bool sqlite = true;
+    };
+
+    enum class Kind { integer, real, text, date };
+
+    /** The rows of one table, stored column by column. */
+    class Columns
+    {
+    public:
+        void
+        addColumn(std::string const& name, Kind kind);
+
+        /** Append a row given as an object of column name to value.
+
+            @return `false`, leaving the columns unchanged, if the row
+                    misses a column or a value is not what the database
+                    would store in its column.
+
+            @param exactReals Whether values of real columns are stored
+                              as given. Otherwise rows with such values
+                              are refused.
+        */
+        bool
+        append(Json::Value const& row, bool exactReals = true);
+
+        std::size_t
+        size() const
+        {
+            return rows_;
+        }
+
+    private:
+        friend class TableMirror;
+
+        struct Column
+        {
+            std::string name;
+            Kind kind;
+            std::vector<std::int64_t> integers;
+            std::vector<double> reals;
+            // Also holds the formatted values of date columns
+            std::vector<std::string> texts;
+            std::vector<std::uint8_t> nulls;
+        };
+
+        // Index of the column, ignoring case, or -1
+        int
+        find(std::string const& name) const;
+
+        Json::Value
+        value(Column const& column, std::size_t row) const;
+
+        std::vector<Column> columns_;
+        std::size_t rows_ = 0;
+    };
+
+    TableMirror(Setup const& setup, beast::Journal journal);
+
+    bool
+    enabled() const
+    {
+        return !setup_.tables.empty();
+    }
+
+    /** Answer a select given as the tx_json of r_get.
+
+        @param conn Used to read the table if it is not in memory yet.
+        @return The result TxStore::txHistory would return, or nothing if
+                the query must go to the database.
+    */
+    boost::optional<Json::Value>
+    select(Json::Value const& txJson, int selectLimit, DatabaseCon* conn);
+
+    /** A transaction was disposed into the database, not yet committed. */
+    void
+    stage(STTx const& tx, SyncParam const& param);
+
+    /** The staged transactions of a table were committed. */
+    void
+    commit(uint160 const& nameInDB);
+
+    /** A table changed other than through staged transactions, or its
+        staged transactions were rolled back: forget its rows.
+    */
+    void
+    invalidate(uint160 const& nameInDB);
+
+    /** Use the given rows for a table, as if read from the database. */
+    void
+    install(uint160 const& nameInDB, Columns columns);
+
+    Json::Value
+    getJson() const;
+
+private:
+    struct Query;
+
+    struct Table
+    {
+        std::shared_ptr<Columns> columns;
+        // Rows of staged inserts, in the order they were disposed
+        std::vector<Json::Value> staged;
+        // Transactions staged since the last commit
+        std::size_t pending = 0;
+        // A staged transaction can't be applied to the columns
+        bool dirty = false;
+        bool loading = false;
+        // Too large or not readable, until the table is written again
+        bool skipped = false;
+        std::uint64_t generation = 0;
+
+        std::atomic<std::uint64_t> hits{0};
+        std::atomic<std::uint64_t> fallbacks{0};
+        std::uint64_t loads = 0;
+        std::uint64_t appended = 0;
+        std::uint64_t drops = 0;
+    };
+
+    // Requires the unique lock
+    void
+    drop(Table& table);
+
+    // Reads the table unless it is being written. Returns whether its
+    // columns are in memory.
+    bool
+    load(Table& table, uint160 const& nameInDB, DatabaseCon& conn);
+
+    std::shared_ptr<Columns>
+    read(DatabaseCon& conn, uint160 const& nameInDB);
+
+    static boost::optional<Query>
+    parse(Json::Value const& txJson);
+
+    boost::optional<Json::Value>
+    execute(Columns const& columns, Query const& query, int selectLimit)
+        const;
+
+    bool
+    evaluate(
+        Columns const& columns,
+        conditionTree& node,
+        std::vector<std::uint8_t>& mask) const;
+
+    bool
+    evaluateLeaf(
+        Columns const& columns,
+        conditionTree& node,
+        std::vector<std::uint8_t>& mask) const;
+
+    Setup const setup_;
+    beast::Journal journal_;
+
+    mutable std::shared_mutex mutex_;
+    std::map<uint160, Table> tables_;
+};
+
+TableMirror::Setup
+setup_TableMirror(Config const& config);
+
+}  // namespace ripple
+
+#endif
@@ -0,0 +1,312 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <peersafe/app/table/QueryCache.h>
+#include <ripple/core/Config.h>
+#include <ripple/core/ConfigSections.h>
+#include <cctype>
+#include <cstring>
+
+namespace ripple {
+
+QueryCache::QueryCache(Setup const& setup, beast::Journal journal)
+    : setup_(setup), journal_(journal)
+{
+}
+
+std::string
+QueryCache::normalize(std::string const& sql)
+{
+    std::string ret;
+    ret.reserve(sql.size());
+
+    char quote = 0;
+    bool pendingSpace = false;
+    for (auto const c : sql)
+    {
+        if (quote)
+        {
+            ret.push_back(c);
+            if (c == quote)
+                quote = 0;
+            continue;
+        }
+
+        if (std::isspace(static_cast<unsigned char>(c)))
+        {
+            pendingSpace = !ret.empty();
+            continue;
+        }
+
+        if (pendingSpace)
+        {
+            ret.push_back(' ');
+            pendingSpace = false;
+        }
+        if (c == '\'' || c == '"' || c == '`')
+            quote = c;
+        ret.push_back(c);
+    }
+
+    while (!quote && !ret.empty() && (ret.back() == ';' || ret.back() == ' '))
+        ret.pop_back();
+
+    return ret;
+}
+
+std::string
+QueryCache::makeKey(
+    std::string const& kind,
+    std::string const& account,
+    std::string const& query,
+    std::set<uint160> const& tables)
+{
+    std::string key = kind;
+    key += '|';
+    key += account;
+    for (auto const& t : tables)
+    {
+        key += '|';
+        key += to_string(t);
+    }
+    key += '|';
+    key += query;
+    return key;
+}
+
+QueryCache::Generations
+QueryCache::snapshot(std::set<uint160> const& tables)
+{
+    Generations ret;
+    ret.reserve(tables.size());
+
+    std::lock_guard lock(mutex_);
+    for (auto const& t : tables)
+        ret.emplace_back(t, tables_[t].generation);
+    return ret;
+}
+
+boost::optional<Json::Value>
+QueryCache::fetch(std::string const& key, std::set<uint160> const& tables)
+{
+    std::lock_guard lock(mutex_);
+
+    auto const it = entries_.find(key);
+    bool const hit = it != entries_.end();
+    for (auto const& t : tables)
+    {
+        auto& stats = tables_[t];
+        if (hit)
+            ++stats.hits;
+        else
+            ++stats.misses;
+    }
+
+    if (!hit)
+    {
+        ++misses_;
+        return boost::none;
+    }
+
+    ++hits_;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->result;
+}
+
+void
+QueryCache::insert(
+    std::string const& key,
+    Generations const& generations,
+    Json::Value const& result)
+{
+    auto const bytes = key.size() + approximateSize(result);
+    if (bytes > setup_.maxBytes)
+        return;
+
+    std::lock_guard lock(mutex_);
+
+    std::set<uint160> tables;
+    for (auto const& [t, generation] : generations)
+    {
+        if (tables_[t].generation != generation)
+        {
+            // The table was written while the query ran.
+            ++staleInserts_;
+            return;
+        }
+        tables.insert(t);
+    }
+
+    if (auto const it = entries_.find(key); it != entries_.end())
+        eraseEntry(it->second);
+
+    lru_.push_front(Entry{key, std::move(tables), result, bytes});
+    entries_.emplace(key, lru_.begin());
+    for (auto const& t : lru_.front().tables)
+        keysByTable_[t].insert(key);
+    bytes_ += bytes;
+    ++inserts_;
+
+    evict();
+}
+
+void
+QueryCache::invalidate(uint160 const& nameInDB)
+{
+    if (!enabled())
+        return;
+
+    std::lock_guard lock(mutex_);
+
+    auto& stats = tables_[nameInDB];
+    ++stats.generation;
+
+    auto const it = keysByTable_.find(nameInDB);
+    if (it == keysByTable_.end())
+        return;
+
+    auto const keys = std::move(it->second);
+    keysByTable_.erase(it);
+    for (auto const& key : keys)
+    {
+        if (auto const e = entries_.find(key); e != entries_.end())
+        {
+            eraseEntry(e->second);
+            ++stats.invalidations;
+        }
+    }
+
+    JLOG(journal_.trace()) << "invalidated " << keys.size()
+                           << " entries of " << to_string(nameInDB);
+}
+
+void
+QueryCache::clear()
+{
+    std::lock_guard lock(mutex_);
+    lru_.clear();
+    entries_.clear();
+    keysByTable_.clear();
+    bytes_ = 0;
+}
+
+Json::Value
+QueryCache::getJson() const
+{
+    Json::Value ret(Json::objectValue);
+
+    std::lock_guard lock(mutex_);
+    ret["enable"] = enabled();
+    ret["entries"] = static_cast<Json::UInt>(entries_.size());
+    ret["bytes"] = static_cast<Json::UInt>(bytes_);
+    ret["max_bytes"] = static_cast<Json::UInt>(setup_.maxBytes);
+    ret["hits"] = std::to_string(hits_);
+    ret["misses"] = std::to_string(misses_);
+    ret["inserts"] = std::to_string(inserts_);
+    ret["stale_inserts"] = std::to_string(staleInserts_);
+    ret["evictions"] = std::to_string(evictions_);
+    if (hits_ + misses_ > 0)
+        ret["hit_rate"] = static_cast<double>(hits_) / (hits_ + misses_);
+
+    Json::Value& tables = (ret["tables"] = Json::objectValue);
+    for (auto const& [t, stats] : tables_)
+    {
+        if (stats.hits + stats.misses == 0)
+            continue;
+
+        Json::Value& jt = (tables[to_string(t)] = Json::objectValue);
+        jt["hits"] = std::to_string(stats.hits);
+        jt["misses"] = std::to_string(stats.misses);
+        jt["invalidations"] = std::to_string(stats.invalidations);
+        jt["hit_rate"] =
+            static_cast<double>(stats.hits) / (stats.hits + stats.misses);
+    }
+    return ret;
+}
+
+std::size_t
+QueryCache::approximateSize(Json::Value const& v)
+{
+    // Rough per-node overhead of Json::Value plus owned string storage.
+    std::size_t size = sizeof(Json::Value);
+    switch (v.type())
+    {
+        case Json::stringValue:
+            size += v.asString().size();
+            break;
+        case Json::arrayValue:
+        case Json::objectValue:
+            for (auto it = v.begin(); it != v.end(); ++it)
+            {
+                if (v.isObject())
+                    size += std::strlen(it.memberName()) + 32;
+                size += approximateSize(*it);
+            }
+            break;
+        default:
+            break;
+    }
+    return size;
+}
+
+void
+QueryCache::eraseEntry(LruList::iterator it)
+{
+    for (auto const& t : it->tables)
+    {
+        auto const k = keysByTable_.find(t);
+        if (k == keysByTable_.end())
+            continue;
+        k->second.erase(it->key);
+        if (k->second.empty())
+            keysByTable_.erase(k);
+    }
+    bytes_ -= it->bytes;
+    entries_.erase(it->key);
+    lru_.erase(it);
+}
+
+void
+QueryCache::evict()
+{
+    while (!lru_.empty() &&
+           (bytes_ > setup_.maxBytes || entries_.size() > setup_.maxEntries))
+    {
+        eraseEntry(std::prev(lru_.end()));
+        ++evictions_;
+    }
+}
+
+QueryCache::Setup
+setup_QueryCache(Config const& config)
+{
+    QueryCache::Setup setup;
+
+    auto const& section = config.section(ConfigSection::queryCache());
+    set(setup.enable, "enable", section);
+
+    std::size_t maxMB = setup.maxBytes / (1024 * 1024);
+    set(maxMB, "max_memory_mb", section);
+    setup.maxBytes = maxMB * 1024 * 1024;
+
+    set(setup.maxEntries, "max_entries", section);
+    return setup;
+}
+
+}  // namespace ripple
@@ -0,0 +1,1433 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <peersafe/app/sql/SQLConditionTree.h>
+#include <peersafe/app/table/TableMirror.h>
+#include <peersafe/app/util/TableSyncUtil.h>
+#include <peersafe/protocol/TableDefines.h>
+#include <ripple/basics/StringUtilities.h>
+#include <ripple/core/Config.h>
+#include <ripple/core/ConfigSections.h>
+#include <ripple/core/DatabaseCon.h>
+#include <ripple/json/json_reader.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/protocol/jss.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <numeric>
+
+namespace ripple {
+
+struct TableMirror::Query
+{
+    uint160 table;
+    std::vector<std::string> fields;
+    Json::Value conditions{Json::arrayValue};
+    // Column, and whether it sorts descending
+    std::vector<std::pair<std::string, bool>> order;
+    std::vector<std::string> group;
+    // Offset and count
+    boost::optional<std::pair<int, int>> limit;
+};
+
+namespace {
+
+using Mask = std::vector<std::uint8_t>;
+
+bool
+isIdentifier(std::string const& s)
+{
+    if (s.empty() || std::isdigit(static_cast<unsigned char>(s[0])))
+        return false;
+    return std::all_of(s.begin(), s.end(), [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    });
+}
+
+// Whether a string is exactly an integer, as SQL would convert it
+bool
+parseInteger(std::string const& s, std::int64_t& value)
+{
+    if (s.empty() || std::isspace(static_cast<unsigned char>(s[0])))
+        return false;
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtoll(s.c_str(), &end, 10);
+    return errno == 0 && end == s.c_str() + s.size();
+}
+
+bool
+parseReal(std::string const& s, double& value)
+{
+    // Not "inf", "nan" or hexadecimal, which the database keeps as text
+    if (s.empty() ||
+        s.find_first_not_of("0123456789+-.eE") != std::string::npos)
+        return false;
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtod(s.c_str(), &end);
+    return errno == 0 && end == s.c_str() + s.size();
+}
+
+// SQLite's LIKE: ASCII letters match either case, '%' matches any run of
+// characters and '_' any one character.
+bool
+like(char const* s, char const* se, char const* p, char const* pe)
+{
+    auto const fold = [](char c) {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    };
+    // Skips one UTF-8 character
+    auto const next = [](char const* c, char const* e) {
+        ++c;
+        while (c != e && (static_cast<unsigned char>(*c) & 0xC0) == 0x80)
+            ++c;
+        return c;
+    };
+
+    char const* star = nullptr;
+    char const* resume = nullptr;
+    while (s != se)
+    {
+        if (p != pe && *p == '%')
+        {
+            star = ++p;
+            resume = s;
+        }
+        else if (p != pe && *p == '_')
+        {
+            s = next(s, se);
+            ++p;
+        }
+        else if (p != pe && fold(*p) == fold(*s))
+        {
+            ++s;
+            ++p;
+        }
+        else if (star)
+        {
+            p = star;
+            s = resume = next(resume, se);
+        }
+        else
+        {
+            return false;
+        }
+    }
+    while (p != pe && *p == '%')
+        ++p;
+    return p == pe;
+}
+
+// The LIKE pattern the SQL builder makes of a $regex value
+boost::optional<std::string>
+likePattern(std::string const& value)
+{
+    if (value.empty())
+        return boost::none;
+    // The builder works on the quoted literal
+    std::string const fv = "'" + value + "'";
+    auto const size = fv.size();
+    if (fv[1] == '/' && fv[2] == '^' && fv[size - 2] == '/')
+        return "%" + fv.substr(3, size - 5);
+    if (fv[1] == '/' && fv[size - 3] == '^' && fv[size - 2] == '/')
+        return fv.substr(2, size - 5) + "%";
+    if (fv[1] == '/' && fv[size - 2] == '/')
+        return "%" + fv.substr(2, size - 4) + "%";
+    return value;
+}
+
+template <class T, class Pred>
+void
+scan(std::vector<T> const& values, Mask const& nulls, Pred pred, Mask& mask)
+{
+    auto const n = values.size();
+    for (std::size_t i = 0; i < n; ++i)
+        mask[i] = static_cast<std::uint8_t>((nulls[i] == 0) & pred(values[i]));
+}
+
+template <class T, class V>
+bool
+compare(
+    std::string const& op,
+    std::vector<T> const& values,
+    Mask const& nulls,
+    V const& v,
+    Mask& mask)
+{
+    if (op == "$eq")
+        scan(values, nulls, [&](T const& x) { return x == v; }, mask);
+    else if (op == "$ne")
+        scan(values, nulls, [&](T const& x) { return x != v; }, mask);
+    else if (op == "$lt")
+        scan(values, nulls, [&](T const& x) { return x < v; }, mask);
+    else if (op == "$le")
+        scan(values, nulls, [&](T const& x) { return x <= v; }, mask);
+    else if (op == "$gt")
+        scan(values, nulls, [&](T const& x) { return x > v; }, mask);
+    else if (op == "$ge")
+        scan(values, nulls, [&](T const& x) { return x >= v; }, mask);
+    else
+        return false;
+    return true;
+}
+
+template <class T>
+void
+member(
+    std::vector<T> const& values,
+    Mask const& nulls,
+    std::vector<T> const& set,
+    bool in,
+    Mask& mask)
+{
+    scan(
+        values,
+        nulls,
+        [&](T const& x) {
+            return (std::find(set.begin(), set.end(), x) != set.end()) == in;
+        },
+        mask);
+}
+
+// Order of two rows of a column, NULL first
+int
+compareRows(
+    std::vector<std::int64_t> const& integers,
+    std::vector<double> const& reals,
+    std::vector<std::string> const& texts,
+    Mask const& nulls,
+    TableMirror::Kind kind,
+    std::size_t a,
+    std::size_t b)
+{
+    if (nulls[a] || nulls[b])
+        return static_cast<int>(nulls[b]) - static_cast<int>(nulls[a]);
+    switch (kind)
+    {
+        case TableMirror::Kind::integer:
+            return (integers[a] > integers[b]) - (integers[a] < integers[b]);
+        case TableMirror::Kind::real:
+            return (reals[a] > reals[b]) - (reals[a] < reals[b]);
+        default:
+            return texts[a].compare(texts[b]);
+    }
+}
+
+enum class Function { none, count, sum, min, max, avg };
+
+struct Output
+{
+    std::string name;
+    // -1 for count(*)
+    int column = -1;
+    Function function = Function::none;
+};
+
+// A selected field: a column or an aggregate of one
+boost::optional<Output>
+parseField(std::string const& field)
+{
+    Output output;
+    output.name = field;
+
+    auto const open = field.find('(');
+    if (open == std::string::npos)
+        return output;
+    if (field.back() != ')')
+        return boost::none;
+
+    auto const name = boost::algorithm::trim_copy(field.substr(0, open));
+    auto const argument = boost::algorithm::trim_copy(
+        field.substr(open + 1, field.size() - open - 2));
+    if (boost::iequals(name, "count"))
+        output.function = Function::count;
+    else if (boost::iequals(name, "sum"))
+        output.function = Function::sum;
+    else if (boost::iequals(name, "min"))
+        output.function = Function::min;
+    else if (boost::iequals(name, "max"))
+        output.function = Function::max;
+    else if (boost::iequals(name, "avg"))
+        output.function = Function::avg;
+    else
+        return boost::none;
+
+    if (argument == "*" && output.function == Function::count)
+        return output;
+    if (!isIdentifier(argument))
+        return boost::none;
+    // Resolved against the columns by the caller
+    output.name = field;
+    output.column = -2;
+    return output;
+}
+
+}  // namespace
+
+//------------------------------------------------------------------------------
+
+void
+TableMirror::Columns::addColumn(std::string const& name, Kind kind)
+{
+    Column column;
+    column.name = name;
+    column.kind = kind;
+    switch (kind)
+    {
+        case Kind::integer:
+            column.integers.resize(rows_);
+            break;
+        case Kind::real:
+            column.reals.resize(rows_);
+            break;
+        default:
+            column.texts.resize(rows_);
+            break;
+    }
+    column.nulls.resize(rows_, 1);
+    columns_.push_back(std::move(column));
+}
+
+int
+TableMirror::Columns::find(std::string const& name) const
+{
+    for (std::size_t i = 0; i < columns_.size(); ++i)
+    {
+        if (boost::iequals(columns_[i].name, name))
+            return static_cast<int>(i);
+    }
+    return -1;
+}
+
+bool
+TableMirror::Columns::append(Json::Value const& row, bool exactReals)
+{
+    if (!row.isObject() || row.size() != columns_.size())
+        return false;
+
+    struct Cell
+    {
+        bool null = true;
+        std::int64_t integer = 0;
+        double real = 0;
+        std::string text;
+    };
+    std::vector<Cell> cells(columns_.size());
+    std::vector<bool> seen(columns_.size(), false);
+
+    for (auto it = row.begin(); it != row.end(); ++it)
+    {
+        auto const index = find(it.memberName());
+        if (index < 0 || seen[index])
+            return false;
+        seen[index] = true;
+
+        auto const& v = *it;
+        auto& cell = cells[index];
+        if (v.isNull())
+            continue;
+        cell.null = false;
+        switch (columns_[index].kind)
+        {
+            case Kind::integer:
+                if (v.isInt())
+                    cell.integer = v.asInt();
+                else if (v.isUInt())
+                    cell.integer = v.asUInt();
+                else if (
+                    !v.isString() ||
+                    !parseInteger(v.asString(), cell.integer))
+                    return false;
+                break;
+            case Kind::real:
+                if (!exactReals)
+                    return false;
+                if (v.isInt())
+                    cell.real = v.asInt();
+                else if (v.isUInt())
+                    cell.real = v.asUInt();
+                else if (v.isDouble())
+                    cell.real = v.asDouble();
+                else if (!v.isString() || !parseReal(v.asString(), cell.real))
+                    return false;
+                break;
+            case Kind::text:
+                if (!v.isString())
+                    return false;
+                cell.text = v.asString();
+                break;
+            default:
+                // Dates are read back in a format of the database's own
+                return false;
+        }
+    }
+
+    for (std::size_t i = 0; i < columns_.size(); ++i)
+    {
+        auto& column = columns_[i];
+        auto& cell = cells[i];
+        column.nulls.push_back(cell.null ? 1 : 0);
+        switch (column.kind)
+        {
+            case Kind::integer:
+                column.integers.push_back(cell.integer);
+                break;
+            case Kind::real:
+                column.reals.push_back(cell.real);
+                break;
+            default:
+                column.texts.push_back(std::move(cell.text));
+                break;
+        }
+    }
+    ++rows_;
+    return true;
+}
+
+Json::Value
+TableMirror::Columns::value(Column const& column, std::size_t row) const
+{
+    if (column.nulls[row])
+        return column.kind == Kind::date ? Json::Value("NULL") : Json::Value();
+    switch (column.kind)
+    {
+        case Kind::integer:
+            // As the database results are read
+            return static_cast<int>(column.integers[row]);
+        case Kind::real:
+            return column.reals[row];
+        default:
+            return column.texts[row];
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TableMirror::TableMirror(Setup const& setup, beast::Journal journal)
+    : setup_(setup), journal_(journal)
+{
+    for (auto const& nameInDB : setup_.tables)
+        tables_[nameInDB];
+}
+
+boost::optional<TableMirror::Query>
+TableMirror::parse(Json::Value const& txJson)
+{
+    auto const& tables = txJson["Tables"];
+    if (!tables.isArray() || tables.size() != 1 || !tables[0u].isObject())
+        return boost::none;
+    auto const& table = tables[0u]["Table"];
+    if (!table.isObject() || !table["TableName"].isString())
+        return boost::none;
+
+    Query query;
+    if (!query.table.SetHexExact(table["TableName"].asString()))
+        return boost::none;
+
+    auto const& raw = txJson["Raw"];
+    Json::Value items;
+    if (!raw.isString() || !Json::Reader().parse(raw.asString(), items) ||
+        !items.isArray())
+        return boost::none;
+
+    for (Json::UInt idx = 0; idx < items.size(); ++idx)
+    {
+        auto const& v = items[idx];
+        if (idx == 0)
+        {
+            if (!v.isArray())
+                return boost::none;
+            for (auto const& field : v)
+            {
+                if (!field.isString())
+                    return boost::none;
+                query.fields.push_back(field.asString());
+            }
+            continue;
+        }
+
+        if (!v.isObject())
+            return boost::none;
+        auto const keys = v.getMemberNames();
+        bool extra = false;
+        for (auto const& key : keys)
+        {
+            // The builder rejects these, or mixes them into the conditions
+            if (key == "limit" || key == "order" || key == "join" ||
+                key == "group" || boost::iequals(key, "$join") ||
+                boost::iequals(key, "$having"))
+                return boost::none;
+            extra = extra || boost::iequals(key, "$limit") ||
+                boost::iequals(key, "$order") || boost::iequals(key, "$group");
+        }
+        if (!extra)
+        {
+            query.conditions.append(v);
+            continue;
+        }
+        if (keys.size() != 1)
+            return boost::none;
+
+        auto const& key = keys[0];
+        auto const& value = v[key];
+        if (boost::iequals(key, "$limit"))
+        {
+            if (!value.isObject() || !value["index"].isInt() ||
+                !value["total"].isInt())
+                return boost::none;
+            // Anything but exactly these two is silently not applied
+            if (value.size() == 2)
+            {
+                auto const index = value["index"].asInt();
+                auto const total = value["total"].asInt();
+                if (index < 0 || total < 0)
+                    return boost::none;
+                query.limit.emplace(index, total);
+            }
+        }
+        else if (boost::iequals(key, "$order"))
+        {
+            if (!value.isArray())
+                return boost::none;
+            for (auto const& order : value)
+            {
+                if (!order.isObject())
+                    break;
+                if (order.size() == 0)
+                    return boost::none;
+                auto const name = order.getMemberNames()[0];
+                if (!isIdentifier(name))
+                    return boost::none;
+                auto const& direction = order[name];
+                bool const descending =
+                    (direction.isString() &&
+                     boost::iequals(direction.asString(), "desc")) ||
+                    (direction.isNumeric() && direction.asInt() == -1);
+                query.order.emplace_back(name, descending);
+            }
+        }
+        else
+        {
+            if (!value.isArray())
+                return boost::none;
+            for (auto const& group : value)
+            {
+                if (!group.isString())
+                    continue;
+                if (!isIdentifier(group.asString()))
+                    return boost::none;
+                query.group.push_back(group.asString());
+            }
+        }
+    }
+    return query;
+}
+
+bool
+TableMirror::evaluateLeaf(
+    Columns const& columns,
+    conditionTree& node,
+    Mask& mask) const
+{
+    auto const expression = node.parse_expression();
+    auto const index = columns.find(std::get<0>(expression));
+    auto const& op = std::get<1>(expression);
+    auto const& values = std::get<2>(expression);
+    if (index < 0 || values.empty())
+        return false;
+
+    // The builder writes the values into the statement as literals, which
+    // are then searched for the limit clause
+    for (auto const& v : values)
+    {
+        if (v.isString() &&
+            (v.asString().find_first_of("';") != std::string::npos ||
+             boost::icontains(v.asString(), "limit")))
+            return false;
+        if (!v.isString() && !v.isInt() && !v.isUint() && !v.isDouble() &&
+            !v.isNull())
+            return false;
+    }
+
+    auto const& column = columns.columns_[index];
+    if (column.kind == Kind::date)
+        return false;
+
+    bool const isNull = values[0].isNull();
+    if (op == "$is" || op == "$isnot" || (op == "$eq" && isNull))
+    {
+        if (!isNull)
+            return false;
+        std::uint8_t const want = op == "$isnot" ? 0 : 1;
+        for (std::size_t i = 0; i < mask.size(); ++i)
+            mask[i] = static_cast<std::uint8_t>(column.nulls[i] == want);
+        return true;
+    }
+
+    bool const text = column.kind == Kind::text;
+    if (text && !setup_.sqlite)
+        return false;
+
+    if (op == "$in" || op == "$nin")
+    {
+        bool const in = op == "$in";
+        bool hasNull = false;
+        std::vector<std::int64_t> integers;
+        std::vector<double> reals;
+        std::vector<std::string> texts;
+        bool integral = true;
+        for (auto const& v : values)
+        {
+            if (v.isNull())
+                hasNull = true;
+            else if (text != v.isString())
+                return false;
+            else if (text)
+                texts.push_back(v.asString());
+            else if (v.isDouble())
+            {
+                integral = false;
+                reals.push_back(v.asDouble());
+            }
+            else
+            {
+                auto const i = v.isInt() ? std::int64_t{v.asInt()}
+                                         : std::int64_t{v.asUint()};
+                integers.push_back(i);
+                reals.push_back(static_cast<double>(i));
+            }
+        }
+
+        // x NOT IN (..., NULL) is never true
+        if (hasNull && !in)
+        {
+            std::fill(mask.begin(), mask.end(), 0);
+            return true;
+        }
+        if (text)
+            member(column.texts, column.nulls, texts, in, mask);
+        else if (column.kind == Kind::integer && integral)
+            member(column.integers, column.nulls, integers, in, mask);
+        else if (column.kind == Kind::integer)
+            scan(
+                column.integers,
+                column.nulls,
+                [&](std::int64_t x) {
+                    auto const d = static_cast<double>(x);
+                    bool const found =
+                        std::find(reals.begin(), reals.end(), d) != reals.end();
+                    return found == in;
+                },
+                mask);
+        else
+            member(column.reals, column.nulls, reals, in, mask);
+        return true;
+    }
+
+    auto const& v = values[0];
+    // Any comparison with NULL is not true
+    if (isNull)
+    {
+        std::fill(mask.begin(), mask.end(), 0);
+        return true;
+    }
+
+    if (op == "$regex")
+    {
+        if (!text || !v.isString())
+            return false;
+        auto const pattern = likePattern(v.asString());
+        if (!pattern)
+            return false;
+        auto const* p = pattern->data();
+        auto const* pe = p + pattern->size();
+        scan(
+            column.texts,
+            column.nulls,
+            [&](std::string const& x) {
+                return like(x.data(), x.data() + x.size(), p, pe);
+            },
+            mask);
+        return true;
+    }
+
+    if (text != v.isString())
+        return false;
+    if (text)
+        return compare(op, column.texts, column.nulls, v.asString(), mask);
+    if (v.isDouble())
+    {
+        if (column.kind == Kind::integer)
+            return compare(
+                op, column.integers, column.nulls, v.asDouble(), mask);
+        return compare(op, column.reals, column.nulls, v.asDouble(), mask);
+    }
+    auto const i = v.isInt() ? std::int64_t{v.asInt()}
+                             : std::int64_t{v.asUint()};
+    if (column.kind == Kind::integer)
+        return compare(op, column.integers, column.nulls, i, mask);
+    return compare(
+        op, column.reals, column.nulls, static_cast<double>(i), mask);
+}
+
+bool
+TableMirror::evaluate(Columns const& columns, conditionTree& node, Mask& mask)
+    const
+{
+    if (node.node_type() == conditionTree::NodeType::Expression)
+        return evaluateLeaf(columns, node, mask);
+
+    // The builder writes a group of fewer than two as "()"
+    if (node.size() < 2)
+        return false;
+
+    bool const conjunction =
+        node.node_type() == conditionTree::NodeType::Logical_And;
+    Mask child(mask.size());
+    bool first = true;
+    for (auto it = node.begin(); it != node.end(); ++it)
+    {
+        if (!evaluate(columns, *it, first ? mask : child))
+            return false;
+        if (!first)
+        {
+            auto const n = mask.size();
+            if (conjunction)
+                for (std::size_t i = 0; i < n; ++i)
+                    mask[i] &= child[i];
+            else
+                for (std::size_t i = 0; i < n; ++i)
+                    mask[i] |= child[i];
+        }
+        first = false;
+    }
+    return true;
+}
+
+boost::optional<Json::Value>
+TableMirror::execute(
+    Columns const& columns,
+    Query const& query,
+    int selectLimit) const
+{
+    auto const n = columns.size();
+    Mask mask(n, 1);
+    if (query.conditions.size() > 0)
+    {
+        auto root = conditionTree::createRoot(query.conditions);
+        if (root.first != 0 ||
+            conditionParse::parse_conditions(query.conditions, root.second)
+                    .first != 0)
+            return boost::none;
+        // The builder writes no condition at all for a lone group
+        if (root.second.node_type() == conditionTree::NodeType::Expression ||
+            root.second.size() >= 2)
+        {
+            if (!evaluate(columns, root.second, mask))
+                return boost::none;
+        }
+    }
+
+    // Columns used for ordering or grouping
+    auto const resolve = [&](std::string const& name) -> int {
+        auto const index = columns.find(name);
+        if (index < 0)
+            return -1;
+        auto const kind = columns.columns_[index].kind;
+        if (kind == Kind::date || (kind == Kind::text && !setup_.sqlite))
+            return -1;
+        return index;
+    };
+    auto const compareOn = [&](int index, std::size_t a, std::size_t b) {
+        auto const& c = columns.columns_[index];
+        return compareRows(
+            c.integers, c.reals, c.texts, c.nulls, c.kind, a, b);
+    };
+
+    std::vector<Output> outputs;
+    bool aggregate = !query.group.empty();
+    bool const all =
+        query.fields.empty() ||
+        (query.fields.size() == 1 && query.fields[0] == "*");
+    if (all)
+    {
+        for (std::size_t i = 0; i < columns.columns_.size(); ++i)
+        {
+            Output output;
+            output.name = columns.columns_[i].name;
+            output.column = static_cast<int>(i);
+            outputs.push_back(output);
+        }
+    }
+    else
+    {
+        for (auto const& field : query.fields)
+        {
+            auto output = parseField(field);
+            if (!output)
+                return boost::none;
+            if (output->function == Function::none)
+            {
+                if (!isIdentifier(field))
+                    return boost::none;
+                output->column = columns.find(field);
+            }
+            else if (output->column == -2)
+            {
+                auto const open = field.find('(');
+                output->column = columns.find(boost::algorithm::trim_copy(
+                    field.substr(open + 1, field.size() - open - 2)));
+                if (output->column < 0)
+                    return boost::none;
+            }
+            if (output->column < 0 && output->function != Function::count)
+                return boost::none;
+            aggregate = aggregate || output->function != Function::none;
+            outputs.push_back(*output);
+        }
+    }
+
+    std::vector<int> groups;
+    for (auto const& name : query.group)
+    {
+        auto const index = resolve(name);
+        if (index < 0)
+            return boost::none;
+        groups.push_back(index);
+    }
+    std::vector<std::pair<int, bool>> orders;
+    for (auto const& [name, descending] : query.order)
+    {
+        auto const index = resolve(name);
+        if (index < 0)
+            return boost::none;
+        // Ordering groups by anything but what they are grouped by would
+        // pick the value of an arbitrary row
+        if (aggregate &&
+            std::find(groups.begin(), groups.end(), index) == groups.end())
+            return boost::none;
+        orders.emplace_back(index, descending);
+    }
+
+    std::vector<std::size_t> rows;
+    rows.reserve(
+        std::accumulate(mask.begin(), mask.end(), std::size_t{0}));
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (mask[i])
+            rows.push_back(i);
+    }
+
+    // Runs of rows that make one line of the result each
+    std::vector<std::pair<std::size_t, std::size_t>> lines;
+    if (!aggregate)
+    {
+        if (!orders.empty())
+        {
+            std::stable_sort(
+                rows.begin(), rows.end(), [&](std::size_t a, std::size_t b) {
+                    for (auto const& [index, descending] : orders)
+                    {
+                        auto const c = compareOn(index, a, b);
+                        if (c != 0)
+                            return descending ? c > 0 : c < 0;
+                    }
+                    return false;
+                });
+        }
+        lines.reserve(rows.size());
+        for (std::size_t i = 0; i < rows.size(); ++i)
+            lines.emplace_back(i, i + 1);
+    }
+    else
+    {
+        for (auto const& output : outputs)
+        {
+            if (output.function == Function::none &&
+                std::find(groups.begin(), groups.end(), output.column) ==
+                    groups.end())
+                return boost::none;
+            if (output.column < 0)
+                continue;
+            auto const kind = columns.columns_[output.column].kind;
+            if (kind == Kind::date && output.function != Function::count &&
+                output.function != Function::none)
+                return boost::none;
+            if (kind == Kind::text &&
+                (output.function == Function::sum ||
+                 output.function == Function::avg ||
+                 (!setup_.sqlite && output.function != Function::count &&
+                  output.function != Function::none)))
+                return boost::none;
+            // Other databases sum and average into decimals
+            if (!setup_.sqlite &&
+                (output.function == Function::sum ||
+                 output.function == Function::avg))
+                return boost::none;
+        }
+
+        if (groups.empty())
+        {
+            lines.emplace_back(0, rows.size());
+        }
+        else
+        {
+            // Groups are few: find each row's in an ordered map rather
+            // than sorting all the rows by their group
+            auto const less = [&](std::size_t a, std::size_t b) {
+                for (auto const index : groups)
+                {
+                    auto const c = compareOn(index, a, b);
+                    if (c != 0)
+                        return c < 0;
+                }
+                return false;
+            };
+            std::map<std::size_t, std::vector<std::size_t>, decltype(less)>
+                members(less);
+            for (auto const row : rows)
+                members[row].push_back(row);
+
+            rows.clear();
+            for (auto const& [first, group] : members)
+            {
+                lines.emplace_back(rows.size(), rows.size() + group.size());
+                rows.insert(rows.end(), group.begin(), group.end());
+            }
+        }
+        if (!orders.empty())
+        {
+            std::stable_sort(
+                lines.begin(), lines.end(), [&](auto const& a, auto const& b) {
+                    for (auto const& [index, descending] : orders)
+                    {
+                        auto const c =
+                            compareOn(index, rows[a.first], rows[b.first]);
+                        if (c != 0)
+                            return descending ? c > 0 : c < 0;
+                    }
+                    return false;
+                });
+        }
+    }
+
+    // The database caps every select at select_limit rows
+    std::size_t offset = 0;
+    std::size_t count = selectLimit < 0 ? 0 : selectLimit;
+    if (query.limit)
+    {
+        offset = query.limit->first;
+        count = std::min<std::size_t>(count, query.limit->second);
+    }
+    offset = std::min(offset, lines.size());
+    count = std::min(count, lines.size() - offset);
+
+    Json::Value result(Json::objectValue);
+    Json::Value& out = (result[jss::lines] = Json::arrayValue);
+    for (std::size_t l = offset; l < offset + count; ++l)
+    {
+        auto const [first, last] = lines[l];
+        Json::Value line(Json::objectValue);
+        for (auto const& output : outputs)
+        {
+            if (output.function == Function::count && output.column < 0)
+            {
+                line[output.name] = static_cast<int>(last - first);
+                continue;
+            }
+
+            auto const& column = columns.columns_[output.column];
+            if (output.function == Function::none)
+            {
+                line[output.name] = columns.value(column, rows[first]);
+                continue;
+            }
+
+            std::size_t nonNull = 0;
+            std::size_t best = 0;
+            std::int64_t integerSum = 0;
+            // Neumaier summation, as SQLite sums reals
+            double realSum = 0;
+            double compensation = 0;
+            for (auto i = first; i < last; ++i)
+            {
+                auto const row = rows[i];
+                if (column.nulls[row])
+                    continue;
+                if (nonNull++ == 0)
+                    best = row;
+                switch (output.function)
+                {
+                    case Function::sum:
+                    case Function::avg:
+                        if (column.kind == Kind::integer)
+                        {
+                            using limits = std::numeric_limits<std::int64_t>;
+                            auto const x = column.integers[row];
+                            // The database fails the select instead
+                            if ((x > 0 && integerSum > limits::max() - x) ||
+                                (x < 0 && integerSum < limits::min() - x))
+                                return boost::none;
+                            integerSum += x;
+                        }
+                        else
+                        {
+                            auto const x = column.reals[row];
+                            auto const t = realSum + x;
+                            if (std::abs(realSum) >= std::abs(x))
+                                compensation += (realSum - t) + x;
+                            else
+                                compensation += (x - t) + realSum;
+                            realSum = t;
+                        }
+                        break;
+                    case Function::min:
+                        if (compareOn(output.column, row, best) < 0)
+                            best = row;
+                        break;
+                    case Function::max:
+                        if (compareOn(output.column, row, best) > 0)
+                            best = row;
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            auto& cell = line[output.name];
+            if (output.function == Function::count)
+                cell = static_cast<int>(nonNull);
+            else if (nonNull == 0)
+                cell = Json::Value();
+            else if (output.function == Function::min ||
+                     output.function == Function::max)
+                cell = columns.value(column, best);
+            else if (column.kind == Kind::integer)
+                cell = output.function == Function::sum
+                    ? Json::Value(static_cast<int>(integerSum))
+                    : Json::Value(
+                          static_cast<double>(integerSum) / nonNull);
+            else
+                cell = output.function == Function::sum
+                    ? realSum + compensation
+                    : (realSum + compensation) / nonNull;
+        }
+        out.append(line);
+    }
+    return result;
+}
+
+boost::optional<Json::Value>
+TableMirror::select(
+    Json::Value const& txJson,
+    int selectLimit,
+    DatabaseCon* conn)
+{
+    if (!enabled())
+        return boost::none;
+    auto const query = parse(txJson);
+    if (!query)
+        return boost::none;
+    // Tables are only added by the constructor
+    auto const it = tables_.find(query->table);
+    if (it == tables_.end())
+        return boost::none;
+    auto& table = it->second;
+
+    for (int attempt = 0; attempt < 2; ++attempt)
+    {
+        {
+            std::shared_lock lock(mutex_);
+            if (table.columns)
+            {
+                auto result = execute(*table.columns, *query, selectLimit);
+                if (result)
+                    ++table.hits;
+                else
+                    ++table.fallbacks;
+                return result;
+            }
+        }
+        if (attempt > 0 || !conn || !load(table, query->table, *conn))
+            break;
+    }
+    ++table.fallbacks;
+    return boost::none;
+}
+
+bool
+TableMirror::load(Table& table, uint160 const& nameInDB, DatabaseCon& conn)
+{
+    std::uint64_t generation;
+    {
+        std::unique_lock lock(mutex_);
+        if (table.columns)
+            return true;
+        // Rows staged but not committed may or may not be read
+        if (table.loading || table.skipped || table.pending != 0)
+            return false;
+        table.loading = true;
+        generation = table.generation;
+    }
+
+    auto columns = read(conn, nameInDB);
+
+    std::unique_lock lock(mutex_);
+    table.loading = false;
+    if (!columns)
+    {
+        table.skipped = true;
+        return false;
+    }
+    if (table.generation != generation || table.pending != 0)
+        return false;
+    table.columns = std::move(columns);
+    ++table.loads;
+    JLOG(journal_.debug()) << "Loaded " << table.columns->size()
+                           << " rows of " << nameInDB;
+    return true;
+}
+
+std::shared_ptr<TableMirror::Columns>
+TableMirror::read(DatabaseCon& conn, uint160 const& nameInDB)
+{
+    auto const kindOf = [](soci::data_type type) -> boost::optional<Kind> {
+        switch (type)
+        {
+            case soci::dt_string:
+            case soci::dt_blob:
+                return Kind::text;
+            case soci::dt_integer:
+            case soci::dt_long_long:
+            case soci::dt_unsigned_long_long:
+                return Kind::integer;
+            case soci::dt_double:
+                return Kind::real;
+            case soci::dt_date:
+                return Kind::date;
+            default:
+                return boost::none;
+        }
+    };
+
+    auto columns = std::make_shared<Columns>();
+    try
+    {
+        auto const sql = (boost::format("select * from t_%s limit %d") %
+                          to_string(nameInDB) % (setup_.maxRows + 1))
+                             .str();
+        LockedSociSession session = conn.checkoutDb();
+        soci::rowset<soci::row> rows = (session->prepare << sql);
+        for (auto const& row : rows)
+        {
+            if (columns->rows_ == setup_.maxRows)
+            {
+                JLOG(journal_.warn()) << nameInDB << " has more than "
+                                      << setup_.maxRows << " rows";
+                return nullptr;
+            }
+            if (columns->rows_ == 0)
+            {
+                for (std::size_t i = 0; i < row.size(); ++i)
+                {
+                    auto const& properties = row.get_properties(i);
+                    auto const kind = kindOf(properties.get_data_type());
+                    if (!kind)
+                        return nullptr;
+                    columns->addColumn(properties.get_name(), *kind);
+                }
+            }
+
+            for (std::size_t i = 0; i < row.size(); ++i)
+            {
+                auto& column = columns->columns_[i];
+                auto const type = row.get_properties(i).get_data_type();
+                if (kindOf(type) != column.kind)
+                    return nullptr;
+                bool const ok = row.get_indicator(i) == soci::i_ok;
+                column.nulls.push_back(ok ? 0 : 1);
+                switch (type)
+                {
+                    case soci::dt_integer:
+                        column.integers.push_back(ok ? row.get<int>(i) : 0);
+                        break;
+                    case soci::dt_long_long:
+                        column.integers.push_back(
+                            ok ? row.get<long long>(i) : 0);
+                        break;
+                    case soci::dt_unsigned_long_long:
+                        column.integers.push_back(
+                            ok ? row.get<unsigned long long>(i) : 0);
+                        break;
+                    case soci::dt_double:
+                        column.reals.push_back(ok ? row.get<double>(i) : 0);
+                        break;
+                    case soci::dt_date: {
+                        // Formatted as the database results are
+                        std::string datetime;
+                        if (ok)
+                        {
+                            auto const tm = row.get<std::tm>(i);
+                            datetime = (boost::format("%d/%d/%d %d:%d:%d") %
+                                        (tm.tm_year + 1900) % (tm.tm_mon + 1) %
+                                        tm.tm_mday % tm.tm_hour % tm.tm_min %
+                                        tm.tm_sec)
+                                           .str();
+                        }
+                        column.texts.push_back(std::move(datetime));
+                        break;
+                    }
+                    default:
+                        column.texts.push_back(
+                            ok ? row.get<std::string>(i) : std::string());
+                        break;
+                }
+            }
+            ++columns->rows_;
+        }
+    }
+    catch (soci::soci_error const& e)
+    {
+        JLOG(journal_.warn()) << "Reading " << nameInDB << ": " << e.what();
+        return nullptr;
+    }
+    return columns;
+}
+
+void
+TableMirror::stage(STTx const& tx, SyncParam const& param)
+{
+    auto const view = tx.view();
+    if (!view->opType || view->tables.empty())
+        return;
+    auto const it = tables_.find(view->tables[0].nameInDB);
+    if (it == tables_.end())
+        return;
+
+    // Decoded before taking the lock
+    std::vector<Json::Value> rows;
+    bool replayable = false;
+    switch (*view->opType)
+    {
+        case T_ASSERT:
+        case T_CREATE_INDEX:
+        case T_DELETE_INDEX:
+            // Leave the rows as they are
+            replayable = true;
+            break;
+        case R_INSERT: {
+            Json::Value raw;
+            if (!Json::Reader().parse(tx.buildRaw(param.rules), raw) ||
+                !raw.isArray())
+                break;
+
+            // The fields the transaction fills in, as STTx2SQL does
+            Json::Value filled(Json::objectValue);
+            for (auto const field :
+                 {&sfAutoFillField,
+                  &sfTxsHashFillField,
+                  &sfLedgerTimeField,
+                  &sfLedgerSeqField})
+            {
+                if (!tx.isFieldPresent(*field))
+                    continue;
+                auto const name = strCopy(tx.getFieldVL(*field));
+                if (*field == sfLedgerSeqField)
+                    filled[name] = std::to_string(param.ledgerSeq);
+                else if (*field == sfLedgerTimeField)
+                    filled[name] = param.ledgerTime;
+                else
+                    filled[name] = to_string(tx.getRealTxID());
+            }
+
+            replayable = true;
+            for (auto const& v : raw)
+            {
+                if (!v.isObject())
+                {
+                    replayable = false;
+                    break;
+                }
+                Json::Value row = v;
+                for (auto f = filled.begin(); f != filled.end(); ++f)
+                    row[f.memberName()] = *f;
+                rows.push_back(std::move(row));
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    std::unique_lock lock(mutex_);
+    auto& table = it->second;
+    ++table.pending;
+    if (!table.columns || table.dirty)
+        return;
+    if (!replayable)
+    {
+        table.dirty = true;
+        table.staged.clear();
+        return;
+    }
+    for (auto& row : rows)
+        table.staged.push_back(std::move(row));
+}
+
+void
+TableMirror::commit(uint160 const& nameInDB)
+{
+    auto const it = tables_.find(nameInDB);
+    if (it == tables_.end())
+        return;
+
+    std::unique_lock lock(mutex_);
+    auto& table = it->second;
+    ++table.generation;
+    if (table.dirty)
+    {
+        drop(table);
+        // Rows may have been deleted
+        table.skipped = false;
+    }
+    else if (table.columns)
+    {
+        if (table.columns->size() + table.staged.size() > setup_.maxRows)
+        {
+            drop(table);
+            table.skipped = true;
+        }
+        else
+        {
+            for (auto const& row : table.staged)
+            {
+                if (!table.columns->append(row, setup_.sqlite))
+                {
+                    JLOG(journal_.debug())
+                        << "Reloading " << nameInDB << " after an insert";
+                    drop(table);
+                    break;
+                }
+                ++table.appended;
+            }
+        }
+    }
+    table.staged.clear();
+    table.pending = 0;
+    table.dirty = false;
+}
+
+void
+TableMirror::invalidate(uint160 const& nameInDB)
+{
+    auto const it = tables_.find(nameInDB);
+    if (it == tables_.end())
+        return;
+
+    std::unique_lock lock(mutex_);
+    auto& table = it->second;
+    ++table.generation;
+    drop(table);
+    table.staged.clear();
+    table.pending = 0;
+    table.dirty = false;
+    table.skipped = false;
+}
+
+void
+TableMirror::install(uint160 const& nameInDB, Columns columns)
+{
+    auto const it = tables_.find(nameInDB);
+    if (it == tables_.end())
+        return;
+
+    std::unique_lock lock(mutex_);
+    it->second.columns = std::make_shared<Columns>(std::move(columns));
+    ++it->second.loads;
+}
+
+void
+TableMirror::drop(Table& table)
+{
+    if (table.columns)
+        ++table.drops;
+    table.columns.reset();
+}
+
+Json::Value
+TableMirror::getJson() const
+{
+    Json::Value ret(Json::objectValue);
+    std::uint64_t hits = 0;
+    std::uint64_t fallbacks = 0;
+
+    std::shared_lock lock(mutex_);
+    Json::Value& tables = (ret["tables"] = Json::objectValue);
+    for (auto const& [nameInDB, table] : tables_)
+    {
+        Json::Value& t = (tables[to_string(nameInDB)] = Json::objectValue);
+        t["loaded"] = static_cast<bool>(table.columns);
+        if (table.columns)
+            t["rows"] = static_cast<Json::UInt>(table.columns->size());
+        t["hits"] = std::to_string(table.hits);
+        t["fallbacks"] = std::to_string(table.fallbacks);
+        t["loads"] = std::to_string(table.loads);
+        t["appended"] = std::to_string(table.appended);
+        t["drops"] = std::to_string(table.drops);
+        hits += table.hits;
+        fallbacks += table.fallbacks;
+    }
+    ret["hits"] = std::to_string(hits);
+    ret["fallbacks"] = std::to_string(fallbacks);
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+
+TableMirror::Setup
+setup_TableMirror(Config const& config)
+{
+    TableMirror::Setup setup;
+
+    auto const& section = config.section(ConfigSection::tableMirror());
+    set(setup.maxRows, "max_rows", section);
+    for (auto const& line : section.values())
+    {
+        uint160 nameInDB;
+        if (!nameInDB.SetHexExact(boost::algorithm::trim_copy(line)))
+            Throw<std::runtime_error>(
+                "Invalid table in [" + ConfigSection::tableMirror() +
+                "]: " + line);
+        setup.tables.insert(nameInDB);
+    }
+
+    auto const type = config.section("sync_db").get<std::string>("type");
+    setup.sqlite = type && boost::iequals(*type, "sqlite");
+    return setup;
+}
+
+}  // namespace ripple
@@ -1803,14 +1803,14 @@ void TableSync::CheckSyncTableTxs(std::shared_ptr<Ledger const> const& ledger)
 
             for (auto& tx : vec)
             {
-                if (tx.isFieldPresent(sfOpType))
+                auto const view = tx.view();
+                if (view->opType)
                 {
-                    AccountID accountID = tx.getAccountID(sfAccount);
-                    auto tables = tx.getFieldArray(sfTables);
-                    uint160 uTxDBName = tables[0].getFieldH160(sfNameInDB);
-                    auto tableBlob = tables[0].getFieldVL(sfTableName);
-                    std::string tableName;
-                    tableName.assign(tableBlob.begin(), tableBlob.end());
+                    if (view->tables.empty())
+                        Throw<std::runtime_error>("Transaction has no tables");
+                    AccountID const& accountID = view->account;
+                    uint160 const& uTxDBName = view->tables[0].nameInDB;
+                    std::string tableName = view->tables[0].nameString();
 
                     if (!bIsHaveSync_)
                     {
@@ -1819,7 +1819,7 @@ void TableSync::CheckSyncTableTxs(std::shared_ptr<Ledger const> const& ledger)
                         break;
                     }
 
-                    auto opType = tx.getFieldU16(sfOpType);
+                    auto opType = *view->opType;
                     if (opType == T_CREATE)
                     {
                         std::string temKey = to_string(accountID) + tableName;
@@ -28,6 +28,8 @@
 #include <ripple/app/misc/NetworkOPs.h>
 #include <peersafe/crypto/AES.h>
 #include <peersafe/app/table/TableSyncItem.h>
+#include <peersafe/app/table/QueryCache.h>
+#include <peersafe/app/table/TableMirror.h>
 #include <peersafe/app/sql/TxStore.h>
 #include <peersafe/protocol/STEntry.h>
 #include <peersafe/protocol/TableDefines.h>
@@ -661,6 +663,8 @@ bool TableSyncItem::GetMaxTxnInfo(std::string TableName, std::string Owner, Ledg
 bool TableSyncItem::DeleteTable(std::string nameInDB)
 {
     auto ret = app_.getTxStore().DropTable(nameInDB);
+    app_.getQueryCache().invalidate(from_hex_text<uint160>(nameInDB));
+    app_.getTableMirror().invalidate(from_hex_text<uint160>(nameInDB));
     return ret.first;
 }
 
@@ -687,6 +691,11 @@ bool TableSyncItem::DoUpdateSyncDB(const std::string &Owner, const std::string &
 	if (ret == soci_exception) {
 		SetSyncState(SYNC_STOP);
 	}
+	if (bDel)
+	{
+		app_.getQueryCache().invalidate(from_hex_text<uint160>(TableNameInDB));
+		app_.getTableMirror().invalidate(from_hex_text<uint160>(TableNameInDB));
+	}
 	return ret == soci_success;
 }
 
@@ -1082,6 +1091,8 @@ bool TableSyncItem::DealWithEveryLedgerData(const std::vector<protocol::TMTableD
                     if (isSQLTransaction && ret.first == false) {
                         stTran->rollback();
                         stTran.reset();
+                        app_.getTableMirror().invalidate(
+                            from_hex_text<uint160>(sTableNameInDB_));
                     }
 
                     if (app_.getOPs().hasChainSQLTxListener())
@@ -1100,6 +1111,8 @@ bool TableSyncItem::DealWithEveryLedgerData(const std::vector<protocol::TMTableD
                     if (isSQLTransaction) {
                         stTran->rollback();
                         stTran.reset();
+                        app_.getTableMirror().invalidate(
+                            from_hex_text<uint160>(sTableNameInDB_));
                         continue;
                     }
                 }
@@ -1137,6 +1150,11 @@ bool TableSyncItem::DealWithEveryLedgerData(const std::vector<protocol::TMTableD
                 to_string(uTxDBUpdateHash_),
                 std::to_string(iter->closetime()),
                 PreviousCommit);
+            // rows of this table are committed, cached selects are stale
+            app_.getQueryCache().invalidate(
+                from_hex_text<uint160>(sTableNameInDB_));
+            app_.getTableMirror().commit(
+                from_hex_text<uint160>(sTableNameInDB_));
             if (ret == soci_exception)
             {
                 SetSyncState(SYNC_STOP);
@@ -1146,6 +1164,9 @@ bool TableSyncItem::DealWithEveryLedgerData(const std::vector<protocol::TMTableD
         catch (soci::soci_error& e) {
 
             JLOG(journal_.error()) << "soci::soci_error : " << std::string(e.what());
+            // the open transaction is rolled back
+            app_.getTableMirror().invalidate(
+                from_hex_text<uint160>(sTableNameInDB_));
             SetSyncState(SYNC_STOP);
             break;
         }
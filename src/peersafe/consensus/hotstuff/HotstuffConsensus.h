@@ -24,6 +24,7 @@
 #include <peersafe/consensus/LedgerTiming.h>
 #include <peersafe/consensus/hotstuff/Hotstuff.h>
 #include <peersafe/consensus/hotstuff/HotstuffAdaptor.h>
+#include <peersafe/consensus/hotstuff/impl/CertVerifier.h>
 #include <peersafe/protocol/STEpochChange.h>
 #include <peersafe/protocol/STProposal.h>
 #include <peersafe/protocol/STVote.h>
@@ -152,6 +153,11 @@ public:
     bool
     checkVotingPower(const std::map<hotstuff::Author, hotstuff::Signature>&
                          signatures) const override final;
+    bool
+    verifySignatures(
+        const hotstuff::HashValue& digest,
+        const std::map<hotstuff::Author, hotstuff::Signature>& signatures)
+        const override final;
 
     // Overwrite NetWork interfaces.
     void
@@ -251,8 +257,8 @@ private:
     NetClock::time_point initAnnounceTime_;
     NetClock::time_point now_;
     NetClock::time_point consensusTime_;
-    uint64_t openTime_;
-    uint64_t consensusTimeMil_;
+    uint64_t openTime_ = 0;
+    uint64_t consensusTimeMil_ = 0;
 
     uint64_t txQueuedCount_;
 
@@ -260,6 +266,9 @@ private:
     bool configChanged_ = false;
     TxSet_t::ID epochChangeHash_;
 
+    // Verifies signatures of quorum certificates, remembers verified ones
+    mutable hotstuff::CertVerifier certVerifier_;
+
     hotstuff::Round newRound_ = 0;
 
     bool waitingConsensusReach_ = true;
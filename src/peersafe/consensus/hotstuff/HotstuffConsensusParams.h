@@ -2,6 +2,7 @@
 #ifndef PEERSAFE_CONSENSUS_HOTSTUFF_PARAMS_H_INCLUDE
 #define PEERSAFE_CONSENSUS_HOTSTUFF_PARAMS_H_INCLUDE
 
+#include <string>
 
 namespace ripple {
 
@@ -16,6 +17,8 @@ namespace ripple {
  * time_out = 5000
  * omit_empty_block = false
  * init_time = 90
+ * persist_blocks = true
+ * cert_verify_threads = 2
  */
 
 struct HotstuffConsensusParms
@@ -37,6 +40,19 @@ struct HotstuffConsensusParms
     std::chrono::milliseconds extractINTERVAL =
         std::chrono::milliseconds{200};
 
+    // Keep blocks and certificates in a local block log, so that a
+    // restarted validator doesn't sync them from peers again
+    bool persistBLOCKS = true;
+
+    // Directory of the block log, empty if not persisted
+    std::string blockLogPATH;
+
+    // Workers helping to verify the signatures of a certificate
+    unsigned certVerifyTHREADS = 2;
+
+    // Verified certificates remembered so that they aren't verified again
+    const std::size_t certCACHE_SIZE = 4096;
+
     // The minimum tx limit for leader to propose a tx-set after
     // half-MinBlockTime
     const unsigned minTXS_IN_LEDGER_ADVANCE = 5000;
@@ -58,6 +74,8 @@ struct HotstuffConsensusParms
         ret["time_out"] = static_cast<Int>(consensusTIMEOUT.count());
         ret["omit_empty_block"] = omitEMPTY;
         ret["init_time"] = static_cast<Int>(initTIME.count());
+        ret["persist_blocks"] = persistBLOCKS;
+        ret["cert_verify_threads"] = certVerifyTHREADS;
 
         return ret;
     }
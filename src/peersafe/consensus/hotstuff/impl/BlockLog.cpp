@@ -0,0 +1,460 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <boost/crc.hpp>
+#include <boost/serialization/utility.hpp>
+
+#include <peersafe/consensus/hotstuff/impl/BlockLog.h>
+#include <peersafe/consensus/hotstuff/impl/BlockStorage.h>
+
+#include <peersafe/serialization/Serialization.h>
+#include <peersafe/serialization/hotstuff/Block.h>
+#include <peersafe/serialization/hotstuff/ExecutedBlock.h>
+#include <peersafe/serialization/hotstuff/QuorumCert.h>
+#include <peersafe/serialization/hotstuff/SafetyData.h>
+
+namespace ripple { namespace hotstuff {
+
+namespace {
+
+// type + size + crc32
+constexpr std::size_t blockLogHeaderSize = 9;
+// anything larger is a corrupted size field rather than a real record
+constexpr std::uint32_t blockLogMaxRecordSize = 256 * 1024 * 1024;
+
+void
+putLogUInt32(std::uint8_t* p, std::uint32_t v) {
+	p[0] = static_cast<std::uint8_t>(v);
+	p[1] = static_cast<std::uint8_t>(v >> 8);
+	p[2] = static_cast<std::uint8_t>(v >> 16);
+	p[3] = static_cast<std::uint8_t>(v >> 24);
+}
+
+std::uint32_t
+getLogUInt32(const std::uint8_t* p) {
+	return static_cast<std::uint32_t>(p[0])
+		| (static_cast<std::uint32_t>(p[1]) << 8)
+		| (static_cast<std::uint32_t>(p[2]) << 16)
+		| (static_cast<std::uint32_t>(p[3]) << 24);
+}
+
+std::uint32_t
+recordChecksum(std::uint8_t type, const ripple::Buffer& payload) {
+	boost::crc_32_type crc;
+	crc.process_byte(type);
+	crc.process_bytes(payload.data(), payload.size());
+	return crc.checksum();
+}
+
+int
+openForSync(const boost::filesystem::path& path) {
+#ifdef _WIN32
+	return ::_open(path.string().c_str(), _O_WRONLY | _O_BINARY);
+#else
+	return ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+}
+
+void
+closeForSync(int fd) {
+#ifdef _WIN32
+	::_close(fd);
+#else
+	::close(fd);
+#endif
+}
+
+// Flush what was written to `fd` down to the disk
+bool
+syncData(int fd) {
+#if defined(_WIN32)
+	return ::_commit(fd) == 0;
+#elif defined(__APPLE__)
+	return ::fsync(fd) == 0;
+#else
+	return ::fdatasync(fd) == 0;
+#endif
+}
+
+bool
+syncFile(const boost::filesystem::path& path) {
+	int fd = openForSync(path);
+	if (fd < 0)
+		return false;
+#ifdef _WIN32
+	bool synced = ::_commit(fd) == 0;
+#else
+	bool synced = ::fsync(fd) == 0;
+#endif
+	closeForSync(fd);
+	return synced;
+}
+
+// Make a rename within `dir` durable
+bool
+syncDirectory(const boost::filesystem::path& dir) {
+#ifdef _WIN32
+	// there is no handle to flush a directory through
+	return true;
+#else
+	int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (fd < 0)
+		return false;
+	bool synced = ::fsync(fd) == 0;
+	::close(fd);
+	return synced;
+#endif
+}
+
+} // namespace
+
+BlockLog::BlockLog(
+	beast::Journal journal,
+	const boost::filesystem::path& dir,
+	std::size_t snapshot_interval)
+: journal_(journal)
+, dir_(dir)
+, log_path_(dir / "block.log")
+, snapshot_path_(dir / "block.snapshot")
+, snapshot_interval_(snapshot_interval)
+, mutex_()
+, log_()
+, log_fd_(-1)
+, appended_records_(0) {
+	boost::system::error_code ec;
+	boost::filesystem::create_directories(dir_, ec);
+	if (ec) {
+		JLOG(journal_.error())
+			<< "create block log directory " << dir_ << " failed: " << ec.message();
+	}
+}
+
+BlockLog::~BlockLog() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	closeLog();
+}
+
+bool BlockLog::load(State& state) {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	State loaded;
+	bool ended = false;
+	boost::system::error_code ec;
+
+	if (boost::filesystem::exists(snapshot_path_, ec)) {
+		std::ifstream is(snapshot_path_.string(), std::ios::binary);
+		std::size_t unused = 0;
+		readRecords(is, loaded, ended, unused);
+		if (ended == false) {
+			JLOG(journal_.warn())
+				<< "block log snapshot " << snapshot_path_ << " is incomplete, ignored";
+			loaded = State();
+		}
+	}
+
+	std::size_t records = 0;
+	if (boost::filesystem::exists(log_path_, ec)) {
+		std::uint64_t size = boost::filesystem::file_size(log_path_, ec);
+		std::uint64_t valid = 0;
+		{
+			std::ifstream is(log_path_.string(), std::ios::binary);
+			bool unused = false;
+			valid = readRecords(is, loaded, unused, records);
+		}
+		if (!ec && valid < size) {
+			// a crash tore the last write, drop it
+			JLOG(journal_.warn())
+				<< "block log " << log_path_ << " truncated from "
+				<< size << " to " << valid << " bytes";
+			boost::filesystem::resize_file(log_path_, valid, ec);
+		}
+	}
+
+	openLog(false);
+	appended_records_ = records;
+
+	if (loaded.genesis_block.id().isZero())
+		return false;
+
+	state = std::move(loaded);
+	JLOG(journal_.info())
+		<< "loaded " << state.blocks.size() << " blocks from block log, "
+		<< "highest quorum round " << state.highest_quorum_cert.certified_block().round
+		<< ", committed round " << state.committed_round;
+	return true;
+}
+
+void BlockLog::reset(const State& state) {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	boost::filesystem::path tmp_path = snapshot_path_;
+	tmp_path += ".tmp";
+	{
+		std::ofstream os(tmp_path.string(), std::ios::binary | std::ios::trunc);
+		writeRecord(os, rtGENESIS, serialization::serialize(state.genesis_block));
+		writeRecord(os, rtCOMMITTED, serialization::serialize(state.committed_round));
+		for (auto it = state.blocks.begin(); it != state.blocks.end(); it++) {
+			writeRecord(os, rtBLOCK, serialization::serialize(it->second));
+		}
+		writeRecord(os, rtQUORUM_CERT, serialization::serialize(state.highest_quorum_cert));
+		writeRecord(os, rtCOMMIT_CERT, serialization::serialize(state.highest_commit_cert));
+		if (state.highest_timeout_cert) {
+			writeRecord(os, rtTIMEOUT_CERT, serialization::serialize(*state.highest_timeout_cert));
+		}
+		if (state.safety_data) {
+			writeRecord(os, rtSAFETY_DATA, serialization::serialize(*state.safety_data));
+		}
+		writeRecord(os, rtEND, ripple::Buffer());
+		os.close();
+		if (!os) {
+			JLOG(journal_.error())
+				<< "write block log snapshot " << tmp_path << " failed";
+			return;
+		}
+	}
+	// The log is only truncated below once the snapshot is on the disk
+	if (syncFile(tmp_path) == false) {
+		JLOG(journal_.error())
+			<< "sync block log snapshot " << tmp_path << " failed";
+		return;
+	}
+
+	boost::system::error_code ec;
+	boost::filesystem::rename(tmp_path, snapshot_path_, ec);
+	if (ec) {
+		JLOG(journal_.error())
+			<< "rename block log snapshot failed: " << ec.message();
+		return;
+	}
+	if (syncDirectory(dir_) == false) {
+		JLOG(journal_.error())
+			<< "sync block log directory " << dir_ << " failed";
+		return;
+	}
+
+	// Everything in the log is covered by the snapshot now
+	openLog(true);
+	appended_records_ = 0;
+}
+
+bool BlockLog::appendBlock(const ExecutedBlock& executed_block) {
+	return append(rtBLOCK, serialization::serialize(executed_block));
+}
+
+bool BlockLog::appendQuorumCert(const QuorumCertificate& quorum_cert) {
+	return append(rtQUORUM_CERT, serialization::serialize(quorum_cert));
+}
+
+bool BlockLog::appendCommitCert(const QuorumCertificate& commit_cert) {
+	return append(rtCOMMIT_CERT, serialization::serialize(commit_cert));
+}
+
+bool BlockLog::appendTimeoutCert(const TimeoutCertificate& timeout_cert) {
+	return append(rtTIMEOUT_CERT, serialization::serialize(timeout_cert));
+}
+
+bool BlockLog::appendCommitted(Round round) {
+	return append(rtCOMMITTED, serialization::serialize(round));
+}
+
+bool BlockLog::appendPrune(Epoch epoch, Round round) {
+	return append(rtPRUNE, serialization::serialize(std::make_pair(epoch, round)));
+}
+
+bool BlockLog::appendSafetyData(const SafetyData& safety_data) {
+	return append(rtSAFETY_DATA, serialization::serialize(safety_data), true);
+}
+
+bool BlockLog::shouldSnapshot() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return appended_records_ >= snapshot_interval_;
+}
+
+bool BlockLog::append(RecordType type, const ripple::Buffer& payload, bool sync) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (!log_.is_open())
+		return false;
+
+	writeRecord(log_, type, payload);
+	log_.flush();
+	if (!log_) {
+		JLOG(journal_.error()) << "append to block log " << log_path_ << " failed";
+		log_.clear();
+		return false;
+	}
+	// The record counts as appended either way, a later one may sync it.
+	appended_records_++;
+
+	if (sync && (log_fd_ < 0 || syncData(log_fd_) == false)) {
+		JLOG(journal_.error()) << "sync block log " << log_path_ << " failed";
+		return false;
+	}
+	return true;
+}
+
+void BlockLog::openLog(bool truncate) {
+	closeLog();
+	log_.clear();
+	log_.open(
+		log_path_.string(),
+		std::ios::binary | std::ios::out | (truncate ? std::ios::trunc : std::ios::app));
+	if (!log_.is_open()) {
+		JLOG(journal_.error()) << "open block log " << log_path_ << " failed";
+		return;
+	}
+	log_fd_ = openForSync(log_path_);
+	if (log_fd_ < 0) {
+		JLOG(journal_.error()) << "open block log " << log_path_ << " for sync failed";
+	}
+}
+
+void BlockLog::closeLog() {
+	if (log_.is_open())
+		log_.close();
+	if (log_fd_ >= 0) {
+		closeForSync(log_fd_);
+		log_fd_ = -1;
+	}
+}
+
+void BlockLog::writeRecord(
+	std::ostream& os,
+	RecordType type,
+	const ripple::Buffer& payload) {
+	std::uint8_t header[blockLogHeaderSize];
+	header[0] = type;
+	putLogUInt32(header + 1, static_cast<std::uint32_t>(payload.size()));
+	putLogUInt32(header + 5, recordChecksum(type, payload));
+
+	os.write(reinterpret_cast<const char*>(header), blockLogHeaderSize);
+	if (payload.size() > 0)
+		os.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+}
+
+std::uint64_t BlockLog::readRecords(
+	std::istream& is,
+	State& state,
+	bool& ended,
+	std::size_t& records) {
+	std::uint64_t valid = 0;
+	ended = false;
+	records = 0;
+
+	while (ended == false) {
+		std::uint8_t header[blockLogHeaderSize];
+		if (!is.read(reinterpret_cast<char*>(header), blockLogHeaderSize))
+			break;
+
+		RecordType type = static_cast<RecordType>(header[0]);
+		std::uint32_t size = getLogUInt32(header + 1);
+		if (type < rtGENESIS || type > rtSAFETY_DATA || size > blockLogMaxRecordSize)
+			break;
+
+		ripple::Buffer payload(size);
+		if (size > 0 && !is.read(reinterpret_cast<char*>(payload.data()), size))
+			break;
+
+		if (recordChecksum(type, payload) != getLogUInt32(header + 5)) {
+			JLOG(journal_.warn()) << "block log record checksum mismatch at " << valid;
+			break;
+		}
+
+		if (applyRecord(type, payload, state, ended) == false)
+			break;
+
+		valid += blockLogHeaderSize + size;
+		records++;
+	}
+	return valid;
+}
+
+bool BlockLog::applyRecord(
+	RecordType type,
+	const ripple::Buffer& payload,
+	State& state,
+	bool& ended) {
+	try {
+		switch (type) {
+		case rtGENESIS:
+			state = State();
+			state.genesis_block = serialization::deserialize<Block>(payload);
+			state.highest_quorum_cert = state.genesis_block.block_data().quorum_cert;
+			state.highest_commit_cert = state.genesis_block.block_data().quorum_cert;
+			state.committed_round = state.genesis_block.block_data().round;
+			break;
+		case rtBLOCK: {
+			ExecutedBlock executed_block = serialization::deserialize<ExecutedBlock>(payload);
+			state.blocks.emplace(executed_block.block.id(), executed_block);
+			break;
+		}
+		case rtQUORUM_CERT: {
+			QuorumCertificate qc = serialization::deserialize<QuorumCertificate>(payload);
+			if (qc.certified_block().round > state.highest_quorum_cert.certified_block().round)
+				state.highest_quorum_cert = qc;
+			break;
+		}
+		case rtCOMMIT_CERT: {
+			QuorumCertificate qc = serialization::deserialize<QuorumCertificate>(payload);
+			if (qc.commit_info().round > state.highest_commit_cert.commit_info().round)
+				state.highest_commit_cert = qc;
+			break;
+		}
+		case rtTIMEOUT_CERT: {
+			TimeoutCertificate tc = serialization::deserialize<TimeoutCertificate>(payload);
+			if (!state.highest_timeout_cert
+				|| state.highest_timeout_cert->timeout().round < tc.timeout().round)
+				state.highest_timeout_cert = tc;
+			break;
+		}
+		case rtCOMMITTED: {
+			Round round = serialization::deserialize<Round>(payload);
+			state.committed_round = std::max(state.committed_round, round);
+			break;
+		}
+		case rtPRUNE: {
+			auto prune = serialization::deserialize<std::pair<Epoch, Round>>(payload);
+			BlockStorage::pruneBlocks(state.blocks, prune.first, prune.second);
+			break;
+		}
+		case rtSAFETY_DATA:
+			// the latest vote is the one to keep to
+			state.safety_data = serialization::deserialize<SafetyData>(payload);
+			break;
+		case rtEND:
+			ended = true;
+			break;
+		}
+	}
+	catch (std::exception const& e) {
+		JLOG(journal_.warn()) << "decode block log record failed: " << e.what();
+		return false;
+	}
+	return true;
+}
+
+} // namespace hotstuff
+} // namespace ripple
@@ -0,0 +1,166 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifndef RIPPLE_CONSENSUS_HOTSTUFF_BLOCKLOG_H
+#define RIPPLE_CONSENSUS_HOTSTUFF_BLOCKLOG_H
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <boost/optional.hpp>
+
+#include <ripple/basics/Log.h>
+
+#include <peersafe/consensus/hotstuff/impl/ExecuteBlock.h>
+#include <peersafe/consensus/hotstuff/impl/HotstuffCore.h>
+
+namespace ripple { namespace hotstuff {
+
+// An append-only local log of the consensus state kept by BlockStorage.
+//
+// Every change of BlockStorage (a stored block, a higher certificate,
+// a committed round, a gc) and the safety data of every vote sent are
+// appended as one record:
+//
+//   | type (1) | size (4) | crc32 of type and payload (4) | payload (size) |
+//
+// A torn record at the tail, left by a crash in the middle of a write,
+// fails its checksum; loading stops there and cuts it off. When enough
+// records have been appended, the whole state is written to a snapshot
+// and the log is truncated, so its length is bounded by the blocks
+// gcBlocks keeps plus the snapshot interval. The snapshot is synced,
+// along with its directory, before the log is truncated.
+class BlockLog {
+public:
+	enum RecordType : std::uint8_t {
+		rtGENESIS = 1,
+		rtBLOCK,
+		rtQUORUM_CERT,
+		rtCOMMIT_CERT,
+		rtTIMEOUT_CERT,
+		rtCOMMITTED,
+		rtPRUNE,
+		// terminates a complete snapshot
+		rtEND,
+		rtSAFETY_DATA
+	};
+
+	struct State {
+		Block genesis_block;
+		Round committed_round;
+		std::map<HashValue, ExecutedBlock> blocks;
+		QuorumCertificate highest_quorum_cert;
+		QuorumCertificate highest_commit_cert;
+		boost::optional<TimeoutCertificate> highest_timeout_cert;
+		// as of the last vote sent
+		boost::optional<SafetyData> safety_data;
+
+		State()
+		: genesis_block(Block::empty())
+		, committed_round(0)
+		, blocks()
+		, highest_quorum_cert()
+		, highest_commit_cert()
+		, highest_timeout_cert()
+		, safety_data() {
+		}
+	};
+
+	BlockLog(
+		beast::Journal journal,
+		const boost::filesystem::path& dir,
+		std::size_t snapshot_interval);
+	~BlockLog();
+
+	// Rebuild the state from the snapshot and the records appended after it.
+	// Returns false when nothing usable is on disk.
+	bool load(State& state);
+
+	// Replace everything on disk by `state`
+	void reset(const State& state);
+
+	// Each returns false when the record could not be written.
+	bool appendBlock(const ExecutedBlock& executed_block);
+	bool appendQuorumCert(const QuorumCertificate& quorum_cert);
+	bool appendCommitCert(const QuorumCertificate& commit_cert);
+	bool appendTimeoutCert(const TimeoutCertificate& timeout_cert);
+	bool appendCommitted(Round round);
+	bool appendPrune(Epoch epoch, Round round);
+	// Also flushed to the disk before returning, since a vote must never
+	// be sent unless it survives a crash.
+	bool appendSafetyData(const SafetyData& safety_data);
+
+	// Whether enough records were appended since the last snapshot
+	bool shouldSnapshot() const;
+
+	std::size_t appendedRecords() const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return appended_records_;
+	}
+
+	const boost::filesystem::path& logPath() const {
+		return log_path_;
+	}
+
+	const boost::filesystem::path& snapshotPath() const {
+		return snapshot_path_;
+	}
+
+private:
+	bool append(RecordType type, const ripple::Buffer& payload, bool sync = false);
+	void openLog(bool truncate);
+	void closeLog();
+
+	static void writeRecord(
+		std::ostream& os,
+		RecordType type,
+		const ripple::Buffer& payload);
+	// Returns the number of bytes of `is` holding valid records
+	std::uint64_t readRecords(
+		std::istream& is,
+		State& state,
+		bool& ended,
+		std::size_t& records);
+	bool applyRecord(
+		RecordType type,
+		const ripple::Buffer& payload,
+		State& state,
+		bool& ended);
+
+	beast::Journal journal_;
+	boost::filesystem::path dir_;
+	boost::filesystem::path log_path_;
+	boost::filesystem::path snapshot_path_;
+	std::size_t snapshot_interval_;
+
+	mutable std::mutex mutex_;
+	std::ofstream log_;
+	// The same file as log_, opened only to flush it to the disk
+	int log_fd_;
+	std::size_t appended_records_;
+};
+
+} // namespace hotstuff
+} // namespace ripple
+
+#endif // RIPPLE_CONSENSUS_HOTSTUFF_BLOCKLOG_H
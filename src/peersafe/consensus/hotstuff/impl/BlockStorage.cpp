@@ -20,6 +20,7 @@
 #include <algorithm>
 
 #include <peersafe/consensus/hotstuff/impl/BlockStorage.h>
+#include <peersafe/consensus/hotstuff/impl/BlockLog.h>
 #include <peersafe/consensus/hotstuff/impl/StateCompute.h>
 #include <peersafe/consensus/hotstuff/impl/EpochChange.h>
 #include <peersafe/consensus/hotstuff/impl/ProposerElection.h>
@@ -35,14 +36,16 @@ BlockStorage::BlockStorage(
 , state_compute_(state_compute)
 , verifier_(nullptr)
 , proposer_election_(nullptr)
-, genesis_block_id_()
+, genesis_block_(Block::empty())
 , cache_blocks_mutex_()
 , cache_blocks_()
 , quorum_cert_mutex_()
 , highest_quorum_cert_()
 , highest_commit_cert_()
 , highest_timeout_cert_()
-, committed_round_(0) {
+, committed_round_(0)
+, safety_data_()
+, block_log_() {
 
 }
 
@@ -54,14 +57,16 @@ BlockStorage::BlockStorage(
 , state_compute_(state_compute)
 , verifier_(nullptr)
 , proposer_election_(nullptr)
-, genesis_block_id_()
+, genesis_block_(Block::empty())
 , cache_blocks_mutex_()
 , cache_blocks_()
 , quorum_cert_mutex_()
 , highest_quorum_cert_()
 , highest_commit_cert_()
 , highest_timeout_cert_() 
-, committed_round_(0) {
+, committed_round_(0)
+, safety_data_()
+, block_log_() {
 	updateCeritificates(genesis_block);
 }
 
@@ -71,12 +76,82 @@ BlockStorage::~BlockStorage() {
 void BlockStorage::updateCeritificates(const Block& block) {
 	cache_blocks_.clear();
 	committed_round_ = block.block_data().round;
-	genesis_block_id_  = block.id();
+	genesis_block_  = block;
 	highest_quorum_cert_ = QuorumCertificate(block.block_data().quorum_cert);
 	highest_commit_cert_  = QuorumCertificate(block.block_data().quorum_cert);
+	{
+		// rounds start over from the new genesis
+		std::lock_guard<std::mutex> lock(quorum_cert_mutex_);
+		safety_data_.reset();
+	}
+	// start the block log over from the new genesis
+	if (block_log_)
+		snapshot();
 	executeAndAddBlock(block);
 }
 
+void BlockStorage::blockLog(std::unique_ptr<BlockLog> block_log) {
+	block_log_ = std::move(block_log);
+}
+
+bool BlockStorage::saveSafetyData(const SafetyData& safety_data) {
+	std::lock_guard<std::mutex> lock(quorum_cert_mutex_);
+	safety_data_ = safety_data;
+	if (block_log_)
+		return block_log_->appendSafetyData(safety_data);
+	return true;
+}
+
+bool BlockStorage::recover(const ripple::LedgerInfo& ledger_info, Epoch epoch) {
+	if (!block_log_)
+		return false;
+
+	BlockLog::State state;
+	if (block_log_->load(state) == false)
+		return false;
+
+	// The committed ledger in the block log must be the one we restart from,
+	// otherwise the blocks in it are of no use.
+	const ripple::LedgerInfo& committed =
+		state.highest_commit_cert.commit_info().ledger_info;
+	if (state.genesis_block.block_data().epoch != epoch
+		|| committed.seq != ledger_info.seq
+		|| committed.hash != ledger_info.hash) {
+		JLOG(journal_.warn())
+			<< "block log committed ledger " << committed.seq
+			<< " of epoch " << state.genesis_block.block_data().epoch
+			<< " doesn't match ledger " << ledger_info.seq
+			<< " of epoch " << epoch;
+		return false;
+	}
+
+	// verifier isn't serialized with the epoch state
+	for (auto it = state.blocks.begin(); it != state.blocks.end(); it++) {
+		if (it->second.state_compute_result.epoch_state)
+			it->second.state_compute_result.epoch_state->verifier = verifier_;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(cache_blocks_mutex_);
+		cache_blocks_ = std::move(state.blocks);
+	}
+	{
+		std::lock_guard<std::mutex> lock(quorum_cert_mutex_);
+		highest_quorum_cert_ = state.highest_quorum_cert;
+		highest_commit_cert_ = state.highest_commit_cert;
+		highest_timeout_cert_ = state.highest_timeout_cert;
+		safety_data_ = state.safety_data;
+	}
+	genesis_block_ = state.genesis_block;
+	committed_round_ = state.committed_round;
+
+	JLOG(journal_.info())
+		<< "recovered from block log, highest quorum round "
+		<< highest_quorum_cert_.certified_block().round
+		<< ", committed round " << committed_round_;
+	return true;
+}
+
 ExecutedBlock BlockStorage::executeAndAddBlock(const Block& block) {
 	ExecutedBlock executed_block;
 	{
@@ -97,7 +172,9 @@ ExecutedBlock BlockStorage::executeAndAddBlock(const Block& block) {
 void BlockStorage::addExecutedBlock(const ExecutedBlock& executed_block) {
     JLOG(debugLog().info()) << "store block: " << executed_block.block.id();
 	std::lock_guard<std::mutex> lock(cache_blocks_mutex_);
-	cache_blocks_.emplace(std::make_pair(executed_block.block.id(), executed_block));
+	auto result = cache_blocks_.emplace(std::make_pair(executed_block.block.id(), executed_block));
+	if (result.second && block_log_)
+		block_log_->appendBlock(executed_block);
 }
 
 bool BlockStorage::existsBlock(const HashValue& hash) {
@@ -138,6 +215,8 @@ bool BlockStorage::expectBlock(
 
 		if (state_compute_->syncBlock(hash, author, block)) {
 			cache_blocks_.emplace(std::make_pair(block.block.id(), block));
+			if (block_log_)
+				block_log_->appendBlock(block);
 			JLOG(debugLog().info()) << "Store an executed block after sync: " << hash;
 			exists = true;
 			break;
@@ -186,10 +265,14 @@ void BlockStorage::updateQuorumCert(const Round round, const QuorumCertificate&
 	std::lock_guard<std::mutex> lock(quorum_cert_mutex_);
 	if (round > HighestQuorumCert().certified_block().round) {
 		highest_quorum_cert_ = quorumCert;
+		if (block_log_)
+			block_log_->appendQuorumCert(quorumCert);
 	}
 
 	if (highest_commit_cert_.commit_info().round < quorumCert.commit_info().round) {
 		highest_commit_cert_ = quorumCert;
+		if (block_log_)
+			block_log_->appendCommitCert(quorumCert);
 	}
 }
 
@@ -227,13 +310,14 @@ void BlockStorage::preCommit(const QuorumCertificate& quorumCert, NetWork* netwo
 
 int BlockStorage::insertTimeoutCert(const TimeoutCertificate& timeoutCeret) {
 	std::lock_guard<std::mutex> lock(quorum_cert_mutex_);
-	if (highest_timeout_cert_) {
-		if (highest_timeout_cert_->timeout().round < timeoutCeret.timeout().round) {
-			highest_timeout_cert_ = timeoutCeret;
-		}
-	} else {
-		highest_timeout_cert_ = timeoutCeret;
+	if (highest_timeout_cert_
+		&& highest_timeout_cert_->timeout().round >= timeoutCeret.timeout().round) {
+		return 0;
 	}
+
+	highest_timeout_cert_ = timeoutCeret;
+	if (block_log_)
+		block_log_->appendTimeoutCert(timeoutCeret);
 	return 0;
 }
 
@@ -242,7 +326,7 @@ void BlockStorage::commit(const LedgerInfoWithSignatures& ledger_info_with_sigs)
 	if (block_hash.isZero() 
 		&& ledger_info_with_sigs.ledger_info.commit_info.empty() == false) {
 		// handle genesis block info
-		block_hash = genesis_block_id_;
+		block_hash = genesis_block_.id();
 	}
 
 	if (block_hash.isZero())
@@ -251,21 +335,39 @@ void BlockStorage::commit(const LedgerInfoWithSignatures& ledger_info_with_sigs)
 	ExecutedBlock executed_block;
 	if (safetyBlockOf(block_hash, executed_block)) {
 		state_compute_->commit(executed_block);
+
+		// snapshot() holds this lock too, so the record can't go to a log
+		// it is truncating after reading the previous round
+		std::lock_guard<std::mutex> lock(cache_blocks_mutex_);
 		committed_round_ = executed_block.block.block_data().round;
+		if (block_log_)
+			block_log_->appendCommitted(committed_round_);
 	}
 }
 
 void BlockStorage::gcBlocks(Epoch epoch, Round round) {
 	{
 		std::lock_guard<std::mutex> lock(cache_blocks_mutex_);
-		// remove all blocks which are older epoch than current epoch
-		for (auto it = cache_blocks_.begin(); it != cache_blocks_.end();) {
-			if (it->second.block.block_data().epoch < epoch) {
-				it = cache_blocks_.erase(it);
-			}
-			else {
-				it++;
-			}
+		pruneBlocks(cache_blocks_, epoch, round);
+		if (block_log_)
+			block_log_->appendPrune(epoch, round);
+	}
+
+	if (block_log_ && block_log_->shouldSnapshot())
+		snapshot();
+}
+
+void BlockStorage::pruneBlocks(
+	std::map<HashValue, ExecutedBlock>& blocks,
+	Epoch epoch,
+	Round round) {
+	// remove all blocks which are older epoch than current epoch
+	for (auto it = blocks.begin(); it != blocks.end();) {
+		if (it->second.block.block_data().epoch < epoch) {
+			it = blocks.erase(it);
+		}
+		else {
+			it++;
 		}
 	}
 
@@ -277,22 +379,38 @@ void BlockStorage::gcBlocks(Epoch epoch, Round round) {
 	if (begin_round < 0)
 		return;
 
-	{
-		std::lock_guard<std::mutex> lock(cache_blocks_mutex_);
-		for (Round r = begin_round; r != end_round; r++) {
-			for (auto it = cache_blocks_.begin(); it != cache_blocks_.end();) {
-				if (it->second.block.block_data().epoch == epoch
-					&& it->second.block.block_data().round == r) {
-					it = cache_blocks_.erase(it);
-					break;
-				}
-				else {
-					it++;
-				}
+	for (Round r = begin_round; r != end_round; r++) {
+		for (auto it = blocks.begin(); it != blocks.end();) {
+			if (it->second.block.block_data().epoch == epoch
+				&& it->second.block.block_data().round == r) {
+				it = blocks.erase(it);
+				break;
+			}
+			else {
+				it++;
 			}
 		}
 	}
 }
 
+// Write the whole state as a snapshot and truncate the block log.
+// Every record is appended under one of these locks (committed rounds and
+// blocks under cache_blocks_mutex_, certificates and safety data under
+// quorum_cert_mutex_), so none appended meanwhile is lost with the log.
+void BlockStorage::snapshot() {
+	std::lock_guard<std::mutex> blocks_lock(cache_blocks_mutex_);
+	std::lock_guard<std::mutex> certs_lock(quorum_cert_mutex_);
+
+	BlockLog::State state;
+	state.genesis_block = genesis_block_;
+	state.committed_round = committed_round_;
+	state.blocks = cache_blocks_;
+	state.highest_quorum_cert = highest_quorum_cert_;
+	state.highest_commit_cert = highest_commit_cert_;
+	state.highest_timeout_cert = highest_timeout_cert_;
+	state.safety_data = safety_data_;
+	block_log_->reset(state);
+}
+
 } // hotstuff
-} // ripple
\ No newline at end of file
+} // ripple
@@ -23,6 +23,7 @@
 #include <atomic>
 #include <mutex>
 #include <map>
+#include <memory>
 
 #include <peersafe/consensus/hotstuff/impl/HotstuffCore.h>
 #include <peersafe/consensus/hotstuff/impl/ExecuteBlock.h>
@@ -34,6 +35,7 @@ class ValidatorVerifier;
 class ProposerElection;
 class StateCompute;
 class NetWork;
+class BlockLog;
 
 class BlockStorage {
 public:
@@ -122,18 +124,44 @@ public:
 	void proposerElection(ProposerElection* proposer_election) {
 		proposer_election_ = proposer_election;
 	}
+
+	// Persist blocks and certificates into `block_log` from now on
+	void blockLog(std::unique_ptr<BlockLog> block_log);
+
+	// Persist the safety rules of a vote before it is sent, a restarted
+	// replica must not vote against them. Returns false when they could
+	// not be written to the block log, the vote must not be sent then.
+	bool saveSafetyData(const SafetyData& safety_data);
+
+	// The safety rules of the last vote, as recovered or saved
+	boost::optional<SafetyData> safetyData() {
+		std::lock_guard<std::mutex> lock(quorum_cert_mutex_);
+		return safety_data_;
+	}
+
+	// Reload blocks and certificates from the block log. Fails when there is
+	// no block log, nothing usable in it, or it doesn't continue from
+	// `ledger_info` in `epoch`.
+	bool recover(const ripple::LedgerInfo& ledger_info, Epoch epoch);
+
+	// Drop blocks which are no longer needed after committing `round` of `epoch`
+	static void pruneBlocks(
+		std::map<HashValue, ExecutedBlock>& blocks,
+		Epoch epoch,
+		Round round);
 	
 private:
 	void updateQuorumCert(const Round round, const QuorumCertificate& quorumCert);
 	void preCommit(const QuorumCertificate& quorumCert, NetWork* network);
 	void commit(const LedgerInfoWithSignatures& ledger_info_with_sigs);
 	void gcBlocks(Epoch epoch, Round round);
+	void snapshot();
 
 	beast::Journal journal_;
 	StateCompute* state_compute_;
 	ValidatorVerifier* verifier_;
 	ProposerElection* proposer_election_;
-	HashValue genesis_block_id_;
+	Block genesis_block_;
 	std::mutex cache_blocks_mutex_;
     std::map<HashValue, ExecutedBlock> cache_blocks_;
 
@@ -142,6 +170,9 @@ private:
 	QuorumCertificate highest_commit_cert_;
 	boost::optional<TimeoutCertificate> highest_timeout_cert_;
 	std::atomic<Round> committed_round_;
+	// guarded by quorum_cert_mutex_
+	boost::optional<SafetyData> safety_data_;
+	std::unique_ptr<BlockLog> block_log_;
 };
 
 } // namespace hotstuff
@@ -0,0 +1,263 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <algorithm>
+
+#include <ripple/beast/core/CurrentThreadName.h>
+
+#include <peersafe/consensus/hotstuff/impl/CertVerifier.h>
+
+namespace ripple { namespace hotstuff {
+
+// The signatures of one certificate, shared by the caller and the workers
+// helping it. Each signature is claimed by exactly one thread; once one
+// fails, the rest are claimed but not verified.
+struct CertVerifier::Batch {
+	std::vector<std::pair<const Author*, const Signature*>> items;
+	const VerifyOne* verify_one;
+	std::atomic<std::size_t> next;
+	std::atomic<bool> failed;
+
+	std::mutex mutex;
+	std::condition_variable cond;
+	std::size_t finished;
+	std::size_t verified;
+
+	Batch(const Signatures& signatures, const VerifyOne& verify)
+	: items()
+	, verify_one(&verify)
+	, next(0)
+	, failed(false)
+	, mutex()
+	, cond()
+	, finished(0)
+	, verified(0) {
+		items.reserve(signatures.size());
+		for (auto it = signatures.begin(); it != signatures.end(); it++) {
+			items.emplace_back(&it->first, &it->second);
+		}
+	}
+
+	void run() {
+		std::size_t done = 0;
+		std::size_t checked = 0;
+		for (;;) {
+			std::size_t i = next.fetch_add(1);
+			// a late worker finds nothing left, and must not touch
+			// `items` since the caller may have returned already
+			if (i >= items.size())
+				break;
+
+			if (failed == false) {
+				checked++;
+				if ((*verify_one)(*items[i].first, *items[i].second) == false)
+					failed = true;
+			}
+			done++;
+		}
+
+		if (done == 0)
+			return;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		finished += done;
+		verified += checked;
+		if (finished == items.size())
+			cond.notify_all();
+	}
+
+	void wait() {
+		std::unique_lock<std::mutex> lock(mutex);
+		cond.wait(lock, [this]() { return finished == items.size(); });
+	}
+};
+
+CertVerifier::CertVerifier(std::size_t cache_size, std::size_t threads)
+: cache_size_(cache_size)
+, cache_mutex_()
+, lru_()
+, cache_()
+, pool_mutex_()
+, pool_cond_()
+, pending_()
+, workers_()
+, stopping_(false)
+, verified_certs_(0)
+, cache_hits_(0)
+, failed_certs_(0)
+, verified_signatures_(0)
+, saved_signatures_(0) {
+	workers_.reserve(threads);
+	for (std::size_t i = 0; i < threads; i++) {
+		workers_.emplace_back(&CertVerifier::work, this);
+	}
+}
+
+CertVerifier::~CertVerifier() {
+	{
+		std::lock_guard<std::mutex> lock(pool_mutex_);
+		stopping_ = true;
+	}
+	pool_cond_.notify_all();
+	for (auto& worker : workers_) {
+		worker.join();
+	}
+}
+
+bool CertVerifier::verify(
+	const HashValue& message,
+	const Signatures& signatures,
+	const VerifyOne& verify_one) {
+	if (signatures.empty())
+		return true;
+
+	HashValue key = certKey(message, signatures);
+	if (cached(key)) {
+		cache_hits_++;
+		saved_signatures_ += signatures.size();
+		return true;
+	}
+
+	if (verifySignatures(signatures, verify_one) == false) {
+		failed_certs_++;
+		return false;
+	}
+
+	verified_certs_++;
+	remember(key);
+	return true;
+}
+
+void CertVerifier::clear() {
+	std::lock_guard<std::mutex> lock(cache_mutex_);
+	lru_.clear();
+	cache_.clear();
+}
+
+Json::Value CertVerifier::getJson() const {
+	Json::Value ret(Json::objectValue);
+	ret["verified_certs"] = static_cast<Json::UInt>(verified_certs_);
+	ret["failed_certs"] = static_cast<Json::UInt>(failed_certs_);
+	ret["cache_hits"] = static_cast<Json::UInt>(cache_hits_);
+	ret["verified_signatures"] = static_cast<Json::UInt>(verified_signatures_);
+	ret["saved_signatures"] = static_cast<Json::UInt>(saved_signatures_);
+	ret["threads"] = static_cast<Json::UInt>(workers_.size());
+	return ret;
+}
+
+HashValue CertVerifier::certKey(
+	const HashValue& message,
+	const Signatures& signatures) {
+	using beast::hash_append;
+	sha512_half_hasher h;
+	hash_append(h, message);
+	for (auto it = signatures.begin(); it != signatures.end(); it++) {
+		hash_append(h, it->first);
+		hash_append(h, it->second.size());
+		h(it->second.data(), it->second.size());
+	}
+	return static_cast<typename sha512_half_hasher::result_type>(h);
+}
+
+bool CertVerifier::cached(const HashValue& key) {
+	std::lock_guard<std::mutex> lock(cache_mutex_);
+	auto it = cache_.find(key);
+	if (it == cache_.end())
+		return false;
+
+	lru_.splice(lru_.begin(), lru_, it->second);
+	return true;
+}
+
+void CertVerifier::remember(const HashValue& key) {
+	if (cache_size_ == 0)
+		return;
+
+	std::lock_guard<std::mutex> lock(cache_mutex_);
+	auto it = cache_.find(key);
+	if (it != cache_.end()) {
+		lru_.splice(lru_.begin(), lru_, it->second);
+		return;
+	}
+
+	lru_.push_front(key);
+	cache_.emplace(key, lru_.begin());
+	if (cache_.size() > cache_size_) {
+		cache_.erase(lru_.back());
+		lru_.pop_back();
+	}
+}
+
+bool CertVerifier::verifySignatures(
+	const Signatures& signatures,
+	const VerifyOne& verify_one) {
+	if (workers_.empty() || signatures.size() < 2) {
+		std::size_t checked = 0;
+		for (auto it = signatures.begin(); it != signatures.end(); it++) {
+			checked++;
+			if (verify_one(it->first, it->second) == false) {
+				verified_signatures_ += checked;
+				saved_signatures_ += signatures.size() - checked;
+				return false;
+			}
+		}
+		verified_signatures_ += checked;
+		return true;
+	}
+
+	auto batch = std::make_shared<Batch>(signatures, verify_one);
+	std::size_t helpers = std::min(workers_.size(), signatures.size() - 1);
+	{
+		std::lock_guard<std::mutex> lock(pool_mutex_);
+		for (std::size_t i = 0; i < helpers; i++) {
+			pending_.push_back(batch);
+		}
+	}
+	pool_cond_.notify_all();
+
+	// The caller works too, so it never waits on busy workers alone
+	batch->run();
+	batch->wait();
+
+	verified_signatures_ += batch->verified;
+	saved_signatures_ += signatures.size() - batch->verified;
+	return batch->failed == false;
+}
+
+void CertVerifier::work() {
+	beast::setCurrentThreadName("hotstuff verify");
+	for (;;) {
+		std::shared_ptr<Batch> batch;
+		{
+			std::unique_lock<std::mutex> lock(pool_mutex_);
+			pool_cond_.wait(lock, [this]() {
+				return stopping_ || pending_.empty() == false;
+			});
+			if (stopping_)
+				return;
+
+			batch = pending_.front();
+			pending_.pop_front();
+		}
+		batch->run();
+	}
+}
+
+} // namespace hotstuff
+} // namespace ripple
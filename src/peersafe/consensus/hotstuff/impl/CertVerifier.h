@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifndef RIPPLE_CONSENSUS_HOTSTUFF_CERTVERIFIER_H
+#define RIPPLE_CONSENSUS_HOTSTUFF_CERTVERIFIER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <ripple/beast/hash/uhash.h>
+#include <ripple/json/json_value.h>
+
+#include <peersafe/consensus/hotstuff/impl/Types.h>
+
+namespace ripple { namespace hotstuff {
+
+// Verifies all signatures of a certificate.
+//
+// A quorum or commit certificate is embedded in proposals, in the sync info
+// of votes and in sync info messages, so we see the same one many times.
+// Certificates which verified are remembered by the hash of their message
+// and signer set in a bounded LRU cache and are not verified again.
+//
+// The signatures of a certificate not in the cache are verified by the
+// calling thread together with a small pool of workers. Verification stops
+// as soon as one signature fails.
+class CertVerifier {
+public:
+	using Signatures = std::map<Author, Signature>;
+	using VerifyOne = std::function<bool(const Author&, const Signature&)>;
+
+	// `threads` workers help the caller, none for verifying serially
+	CertVerifier(std::size_t cache_size, std::size_t threads);
+	~CertVerifier();
+
+	CertVerifier(const CertVerifier&) = delete;
+	CertVerifier& operator=(const CertVerifier&) = delete;
+
+	bool verify(
+		const HashValue& message,
+		const Signatures& signatures,
+		const VerifyOne& verify_one);
+
+	void clear();
+
+	Json::Value getJson() const;
+
+	std::uint64_t verifiedSignatures() const {
+		return verified_signatures_;
+	}
+
+	std::uint64_t savedSignatures() const {
+		return saved_signatures_;
+	}
+
+	std::uint64_t cacheHits() const {
+		return cache_hits_;
+	}
+
+private:
+	struct Batch;
+
+	static HashValue certKey(
+		const HashValue& message,
+		const Signatures& signatures);
+
+	bool cached(const HashValue& key);
+	void remember(const HashValue& key);
+
+	bool verifySignatures(
+		const Signatures& signatures,
+		const VerifyOne& verify_one);
+	void work();
+
+	std::size_t cache_size_;
+	std::mutex cache_mutex_;
+	std::list<HashValue> lru_;
+	std::unordered_map<
+		HashValue,
+		std::list<HashValue>::iterator,
+		beast::uhash<>> cache_;
+
+	std::mutex pool_mutex_;
+	std::condition_variable pool_cond_;
+	std::deque<std::shared_ptr<Batch>> pending_;
+	std::vector<std::thread> workers_;
+	bool stopping_;
+
+	std::atomic<std::uint64_t> verified_certs_;
+	std::atomic<std::uint64_t> cache_hits_;
+	std::atomic<std::uint64_t> failed_certs_;
+	std::atomic<std::uint64_t> verified_signatures_;
+	// signatures not verified thanks to a cache hit or an early abort
+	std::atomic<std::uint64_t> saved_signatures_;
+};
+
+} // namespace hotstuff
+} // namespace ripple
+
+#endif // RIPPLE_CONSENSUS_HOTSTUFF_CERTVERIFIER_H
@@ -20,6 +20,8 @@
 #ifndef RIPPLE_CONSENSUS_HOTSTUFF_CONFIG_H
 #define RIPPLE_CONSENSUS_HOTSTUFF_CONFIG_H
 
+#include <string>
+
 #include <peersafe/consensus/hotstuff/impl/Types.h>
 
 namespace ripple { namespace hotstuff {
@@ -35,13 +37,19 @@ struct Config {
 	int interval_extract;
 	// whether we should generate a dummy block or shouldn't
 	bool disable_nil_block;
+	// directory of the local block log, blocks are kept only in memory if empty
+	std::string block_log_path;
+	// records appended to the block log between two snapshots
+	int block_log_snapshot_interval;
 
 	Config()
 	: id()
 	, epoch(0)
 	, timeout(60)
 	, interval_extract(200)
-	, disable_nil_block(false) {
+	, disable_nil_block(false)
+	, block_log_path()
+	, block_log_snapshot_interval(256) {
 
 	}
 };
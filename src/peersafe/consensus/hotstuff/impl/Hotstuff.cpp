@@ -19,6 +19,7 @@
 
 #include <peersafe/consensus/hotstuff/Hotstuff.h>
 #include <peersafe/consensus/hotstuff/impl/Block.h>
+#include <peersafe/consensus/hotstuff/impl/BlockLog.h>
 
 namespace ripple { namespace hotstuff {
 
@@ -102,7 +103,12 @@ Hotstuff::Hotstuff(
 , network_(network)
 , hotstuff_core_(journal_, state_compute, &epoch_state_)
 , round_manager_(nullptr) {
-
+	if (config_.block_log_path.empty() == false) {
+		storage_.blockLog(std::make_unique<BlockLog>(
+			journal_,
+			config_.block_log_path,
+			config_.block_log_snapshot_interval));
+	}
 }
 
 Hotstuff::~Hotstuff() {
@@ -110,12 +116,25 @@ Hotstuff::~Hotstuff() {
 }
 
 int Hotstuff::start(const RecoverData& recover_data) {
-	storage_.updateCeritificates(Block::new_genesis_block(
-		recover_data.init_ledger_info, recover_data.epoch_state.epoch));
 	storage_.verifier(recover_data.epoch_state.verifier);
 	storage_.proposerElection(proposer_election_);
+	// Continue from the local block log if it holds the state after
+	// `init_ledger_info`, otherwise start over from a genesis block
+	// and sync the rest from peers.
+	Round recovered_round = 0;
+	if (storage_.recover(
+			recover_data.init_ledger_info,
+			recover_data.epoch_state.epoch)) {
+		recovered_round = storage_.HighestQuorumCert().certified_block().round;
+	}
+	else {
+		storage_.updateCeritificates(Block::new_genesis_block(
+			recover_data.init_ledger_info, recover_data.epoch_state.epoch));
+	}
 	epoch_state_ = recover_data.epoch_state;
-	hotstuff_core_.Initialize(recover_data.epoch_state.epoch, 0);
+	hotstuff_core_.Initialize(recover_data.epoch_state.epoch, recovered_round);
+	if (auto safety_data = storage_.safetyData())
+		hotstuff_core_.restore(*safety_data);
 	round_state_.reset();
 	proposal_generator_.reset();
 
@@ -96,6 +96,23 @@ HotstuffAdaptor::HotstuffAdaptor(
             SECTION_CONSENSUS, "omit_empty_block", parms_.omitEMPTY);
 
         parms_.extractINTERVAL = consensusParms.ledgerGRANULARITY;
+
+        parms_.persistBLOCKS = app.config().loadConfig(
+            SECTION_CONSENSUS, "persist_blocks", parms_.persistBLOCKS);
+
+        parms_.certVerifyTHREADS = std::min(
+            app.config().loadConfig(
+                SECTION_CONSENSUS,
+                "cert_verify_threads",
+                parms_.certVerifyTHREADS),
+            16u);
+    }
+
+    std::string const dbPath = app_.config().legacy("database_path");
+    if (parms_.persistBLOCKS && !dbPath.empty())
+    {
+        parms_.blockLogPATH =
+            (boost::filesystem::path(dbPath) / "hotstuff").string();
     }
 }
 
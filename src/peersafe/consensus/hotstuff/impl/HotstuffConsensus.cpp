@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <chrono>
+#include <peersafe/app/prometh/PrometheusClient.h>
 #include <peersafe/app/util/Common.h>
 #include <peersafe/consensus/hotstuff/HotstuffConsensus.h>
 #include <peersafe/consensus/hotstuff/impl/Config.h>
@@ -32,6 +33,9 @@ HotstuffConsensus::HotstuffConsensus(
     beast::Journal j)
     : ConsensusBase(clock, j)
     , adaptor_(*(HotstuffAdaptor*)(&adaptor))
+    , certVerifier_(
+          adaptor_.parms().certCACHE_SIZE,
+          adaptor_.parms().certVerifyTHREADS)
     , blockAcquiring_(
           "blockAcquiring",
           256,
@@ -50,6 +54,7 @@ HotstuffConsensus::HotstuffConsensus(
     config.timeout =
         std::ceil(adaptor_.parms().consensusTIMEOUT.count() / 1000.0);
     config.interval_extract = adaptor_.parms().extractINTERVAL.count();
+    config.block_log_path = adaptor_.parms().blockLogPATH;
 
     hotstuff_ = hotstuff::Hotstuff::Builder(adaptor_.getIOService(), j)
                     .setConfig(config)
@@ -281,6 +286,8 @@ HotstuffConsensus::getJson(bool full) const
 
     ret["parms"] = adaptor_.parms().getJson();
 
+    ret["cert_verifier"] = certVerifier_.getJson();
+
     if (full)
     {
         if (!acquired_.empty())
@@ -625,6 +632,9 @@ HotstuffConsensus::syncState(const hotstuff::BlockInfo& prevInfo)
 
     consensusTime_ = now_;
     consensusTimeMil_ = utcTime();
+    if (openTime_ > 0 && consensusTimeMil_ > openTime_)
+        adaptor_.app_.getPrometheusClient().onConsensusRound(
+            std::chrono::milliseconds{consensusTimeMil_ - openTime_});
 
     ScopedLockType sl(lock_);
 
@@ -760,25 +770,12 @@ HotstuffConsensus::verifyLedgerInfo(
     const std::map<hotstuff::Author, hotstuff::Signature>& signatures)
 {
     // 1. Check previous vote whether the consensus threshold has been reached
-    for (auto iter = signatures.begin(); iter != signatures.end(); iter++)
+    if (signatures.size() < adaptor_.getQuorum())
     {
-        boost::optional<PublicKey> pubKey = adaptor_.getTrustedKey(iter->first);
-        if (!pubKey)
-        {
-            return false;
-        }
-
-        if (!verifyDigest(
-                iter->first,
-                consensus_data_hash,
-                Slice(iter->second.data(), iter->second.size()),
-                false))
-        {
-            return false;
-        }
+        return false;
     }
 
-    if (signatures.size() < adaptor_.getQuorum())
+    if (!verifySignatures(consensus_data_hash, signatures))
     {
         return false;
     }
@@ -795,6 +792,34 @@ HotstuffConsensus::checkVotingPower(
     return signatures.size() >= adaptor_.getQuorum();
 }
 
+bool
+HotstuffConsensus::verifySignatures(
+    const hotstuff::HashValue& digest,
+    const std::map<hotstuff::Author, hotstuff::Signature>& signatures) const
+{
+    // Trust may change, so it is checked even for a remembered certificate
+    for (auto iter = signatures.begin(); iter != signatures.end(); iter++)
+    {
+        if (!adaptor_.getTrustedKey(iter->first))
+        {
+            return false;
+        }
+    }
+
+    return certVerifier_.verify(
+        digest,
+        signatures,
+        [&digest](
+            const hotstuff::Author& author,
+            const hotstuff::Signature& signature) {
+            return verifyDigest(
+                author,
+                digest,
+                Slice(signature.data(), signature.size()),
+                false);
+        });
+}
+
 void
 HotstuffConsensus::broadcast(
     const hotstuff::Block& block,
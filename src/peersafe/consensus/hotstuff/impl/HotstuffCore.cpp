@@ -44,6 +44,13 @@ void HotstuffCore::Initialize(Epoch epoch, Round round) {
 	safety_data_.last_vote = boost::optional<Vote>();
 }
 
+void HotstuffCore::restore(const SafetyData& safety_data) {
+	if (safety_data.epoch != safety_data_.epoch
+		|| safety_data.last_voted_round < safety_data_.last_voted_round)
+		return;
+	safety_data_ = safety_data;
+}
+
 Block HotstuffCore::SignProposal(const BlockData& proposal) {
 	// verify author
 	//if (VerifyAuthor(proposal.author()) == false) {
@@ -207,15 +214,7 @@ bool HotstuffCore::VerifyQC(const QuorumCertificate& qc) {
         }
     }
 
-	for (auto it = signatures.begin(); it != signatures.end(); it++) {
-		if (epoch_state_->verifier->verifySignature(
-			it->first,
-			it->second,
-			hash) == false)
-			return false;
-	}
-
-	return true;
+	return epoch_state_->verifier->verifySignatures(hash, signatures);
 }
 
 bool HotstuffCore::VerifyAndUpdatePreferredRound(const QuorumCertificate& qc) {
@@ -62,6 +62,15 @@ public:
 
     void
     Initialize(Epoch epoch, Round round);
+    // Keep to the voting rules persisted before a restart
+    void
+    restore(const SafetyData& safety_data);
+
+    const SafetyData&
+    safetyData() const
+    {
+        return safety_data_;
+    }
 
     Block
     SignProposal(const BlockData& proposal);
@@ -638,6 +638,14 @@ RoundManager::ExecuteAndVote(const Block& proposal, Vote& vote)
             << toBase58(TokenType::NodePublic, proposal_generator_->author());
         return false;
     }
+    // persist the vote before anyone can see it
+    if (block_store_->saveSafetyData(hotstuff_core_->safetyData()) == false)
+    {
+        JLOG(journal_.error())
+            << "Persist safety data failed, don't vote for proposal, round: "
+            << proposal.block_data().round;
+        return false;
+    }
     return true;
 }
 
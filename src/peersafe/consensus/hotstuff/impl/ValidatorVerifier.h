@@ -63,6 +63,17 @@ public:
 
 	virtual bool checkVotingPower(const std::map<Author, Signature>& signatures) const = 0;
 
+	// Verify the signatures of all signers of a certificate on `message`
+	virtual bool verifySignatures(
+		const HashValue& message,
+		const std::map<Author, Signature>& signatures) const {
+		for (auto it = signatures.begin(); it != signatures.end(); it++) {
+			if (verifySignature(it->first, it->second, message) == false)
+				return false;
+		}
+		return true;
+	}
+
 protected:
     ValidatorVerifier(){}
 };    
@@ -34,6 +34,8 @@
 #include <peersafe/consensus/Adaptor.h>
 #include <peersafe/consensus/ConsensusBase.h>
 #include <peersafe/app/misc/TxPool.h>
+#include <peersafe/app/ledger/LedgerTimeline.h>
+#include <peersafe/app/prometh/PrometheusClient.h>
 #include <peersafe/app/util/Common.h>
 
 
@@ -234,8 +236,13 @@ Adaptor::acquireTxSet(RCLTxSet::ID const& setId)
 {
     if (auto txns = inboundTransactions_.getSet(setId, true))
     {
+        app_.getLedgerTimeline().txSetAcquired(setId);
         return RCLTxSet{std::move(txns)};
     }
+    auto& timeline = app_.getLedgerTimeline();
+    if (timeline.enabled())
+        timeline.txSetRequested(
+            setId, app_.openLedger().current()->info().seq);
     return boost::none;
 }
 
@@ -295,6 +302,13 @@ Adaptor::buildLCL(
     std::chrono::milliseconds roundTime,
     std::set<TxID>& failedTxs)
 {
+    LedgerTimeline::Scope timing(
+        app_.getLedgerTimeline(),
+        previousLedger.seq() + 1,
+        LedgerTimeline::build);
+    if (roundTime > std::chrono::milliseconds{0})
+        app_.getPrometheusClient().onConsensusRound(roundTime);
+
     std::shared_ptr<Ledger> built = [&]() {
         if (auto const replayData = ledgerMaster_.releaseReplay())
         {
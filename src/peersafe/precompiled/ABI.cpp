@@ -178,12 +178,23 @@ ContractABI::deserialise(string32& _out, std::size_t _offset)
 void
 ContractABI::deserialise(std::string& _out, std::size_t _offset)
 {
-    validOffset(_offset + MAX_BYTE_LENGTH - 1);
+    if (!checkedSizes_)
+    {
+        validOffset(_offset + MAX_BYTE_LENGTH - 1);
+        u256 len = fromBigEndian<u256>(data.cropped(_offset, MAX_BYTE_LENGTH));
+        validOffset(_offset + MAX_BYTE_LENGTH + (std::size_t)len - 1);
+        auto result =
+            data.cropped(_offset + MAX_BYTE_LENGTH, static_cast<size_t>(len));
+        _out.assign((const char*)result.data(), result.size());
+        return;
+    }
 
-    u256 len = fromBigEndian<u256>(data.cropped(_offset, MAX_BYTE_LENGTH));
-    validOffset(_offset + MAX_BYTE_LENGTH + (std::size_t)len - 1);
-    auto result =
-        data.cropped(_offset + MAX_BYTE_LENGTH, static_cast<size_t>(len));
+    std::size_t const len = readSize(_offset);
+    if (len > data.size())
+        throw std::length_error("deserialise failed, invalid string length");
+    if (len != 0)
+        validOffset(_offset + MAX_BYTE_LENGTH + len - 1);
+    auto result = data.cropped(_offset + MAX_BYTE_LENGTH, len);
     _out.assign((const char*)result.data(), result.size());
 }
 }  // namespace ripple
\ No newline at end of file
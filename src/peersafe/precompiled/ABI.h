@@ -207,8 +207,18 @@ operator+(std::vector<T> const& _a, std::vector<T> const& _b)
  */
 class ContractABI
 {
+public:
+    // checkedSizes: read offset and length words as size_t and reject
+    // lengths the data can't hold. Decoding differs from the default on
+    // malformed input, so it's only used once featureTypedTableRows is on.
+    explicit ContractABI(bool checkedSizes = false)
+        : checkedSizes_(checkedSizes)
+    {
+    }
+
 private:
     static const int MAX_BYTE_LENGTH = 32;
+    bool const checkedSizes_;
     // encode or decode offset
     std::size_t offset{0};
     // encode temp bytes
@@ -238,6 +248,29 @@ private:
         }
     }
 
+    // Read an offset or length word. They index into the call data, so
+    // anything that doesn't fit a size_t is invalid; skipping u256 here keeps
+    // decoding of long dynamic arrays cheap.
+    std::size_t
+    readSize(std::size_t _offset)
+    {
+        validOffset(_offset + MAX_BYTE_LENGTH - 1);
+        auto const* p = data.data() + _offset;
+        std::size_t size = 0;
+        for (int i = 0; i < MAX_BYTE_LENGTH; ++i)
+        {
+            if (i < MAX_BYTE_LENGTH - (int)sizeof(std::size_t))
+            {
+                if (p[i] != 0)
+                    throw std::length_error(
+                        "deserialise failed, size out of range");
+                continue;
+            }
+            size = (size << 8) | p[i];
+        }
+        return size;
+    }
+
     template <class T>
     std::string
     toString(const T& _t)
@@ -373,9 +406,14 @@ private:
         // dynamic type, offset position
         if (ABIDynamicType<T>::value)
         {
-            u256 dynamicOffset;
-            deserialise(dynamicOffset, offset);
-            _offset = static_cast<std::size_t>(dynamicOffset);
+            if (checkedSizes_)
+                _offset = readSize(offset);
+            else
+            {
+                u256 dynamicOffset;
+                deserialise(dynamicOffset, offset);
+                _offset = static_cast<std::size_t>(dynamicOffset);
+            }
         }
 
         deserialise(_t, _offset);
@@ -519,24 +557,56 @@ template <class T>
 void
 ContractABI::deserialise(std::vector<T>& _out, std::size_t _offset)
 {
-    u256 length;
+    if (!checkedSizes_)
+    {
+        // vector length
+        u256 length;
+        deserialise(length, _offset);
+        _offset += MAX_BYTE_LENGTH;
+        _out.resize(static_cast<std::size_t>(length));
+
+        for (std::size_t u = 0; u < static_cast<std::size_t>(length); ++u)
+        {
+            std::size_t thisOffset = _offset;
+
+            if (ABIDynamicType<T>::value)
+            {  // dynamic type
+                // N element offset
+                u256 thisEleOffset;
+                deserialise(
+                    thisEleOffset,
+                    _offset + u * Offset<T>::value * MAX_BYTE_LENGTH);
+                thisOffset += static_cast<std::size_t>(thisEleOffset);
+            }
+            else
+            {
+                thisOffset = _offset + u * Offset<T>::value * MAX_BYTE_LENGTH;
+            }
+            deserialise(_out[u], thisOffset);
+        }
+        return;
+    }
+
     // vector length
-    deserialise(length, _offset);
+    std::size_t const length = readSize(_offset);
     _offset += MAX_BYTE_LENGTH;
-    _out.resize(static_cast<std::size_t>(length));
-
-    for (std::size_t u = 0; u < static_cast<std::size_t>(length); ++u)
+    // every element takes at least one word, reject lengths the data can't
+    // hold before allocating for them
+    if (length > data.size() / MAX_BYTE_LENGTH)
+        throw std::length_error("deserialise failed, invalid array length");
+    if (length != 0)
+        validOffset(_offset + length * MAX_BYTE_LENGTH - 1);
+    _out.resize(length);
+
+    for (std::size_t u = 0; u < length; ++u)
     {
         std::size_t thisOffset = _offset;
 
         if (ABIDynamicType<T>::value)
         {  // dynamic type
             // N element offset
-            u256 thisEleOffset;
-            deserialise(
-                thisEleOffset,
+            thisOffset += readSize(
                 _offset + u * Offset<T>::value * MAX_BYTE_LENGTH);
-            thisOffset += static_cast<std::size_t>(thisEleOffset);
         }
         else
         {
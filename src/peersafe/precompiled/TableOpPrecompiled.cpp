@@ -1,7 +1,9 @@
 #include <peersafe/precompiled/TableOpPrecompiled.h>
 #include <peersafe/precompiled/Utils.h>
 #include <peersafe/precompiled/ABI.h>
+#include <peersafe/precompiled/TableRows.h>
 #include <ripple/basics/StringUtilities.h>
+#include <ripple/protocol/Feature.h>
 
 namespace ripple {
 const char* const TABLE_METHOD_CREATE_TABLE_STR =
@@ -60,6 +62,19 @@ const char* const TABLE_METHOD_DELETE_INDEX_STR =
     "deleteIndex(string,string)";
 const char* const TABLE_METHOD_DELETE_INDEX_BY_CONTRACT_STR =
     "deleteIndexByContract(string,string)";
+// Typed rows: string[] fields, string[] values (row-major)
+const char* const TABLE_METHOD_INSERT_ROWS_STR =
+    "insertRows(address,string,string[],string[])";
+const char* const TABLE_METHOD_INSERT_ROWS_BY_CONTRACT_STR =
+    "insertRowsByContract(address,string,string[],string[])";
+const char* const TABLE_METHOD_UPDATE_ROWS_STR =
+    "updateRows(address,string,string[],string[],string[],string[])";
+const char* const TABLE_METHOD_UPDATE_ROWS_BY_CONTRACT_STR =
+    "updateRowsByContract(address,string,string[],string[],string[],string[])";
+const char* const TABLE_METHOD_DELETE_ROWS_STR =
+    "deleteRows(address,string,string[],string[])";
+const char* const TABLE_METHOD_DELETE_ROWS_BY_CONTRACT_STR =
+    "deleteRowsByContract(address,string,string[],string[])";
 const char* const TABLE_METHOD_GET_DATA_HANDLE_STR =
     "getDataHandle(address,string,string)";
 const char* const TABLE_METHOD_GET_DATA_HANDLE_BY_CONTRACT_STR =
@@ -123,6 +138,18 @@ TableOpPrecompiled::TableOpPrecompiled()
         getFuncSelector(TABLE_METHOD_DELETE_INDEX_STR);
     name2Selector_[TABLE_METHOD_DELETE_INDEX_BY_CONTRACT_STR] =
         getFuncSelector(TABLE_METHOD_DELETE_INDEX_BY_CONTRACT_STR);
+    name2Selector_[TABLE_METHOD_INSERT_ROWS_STR] =
+        getFuncSelector(TABLE_METHOD_INSERT_ROWS_STR);
+    name2Selector_[TABLE_METHOD_INSERT_ROWS_BY_CONTRACT_STR] =
+        getFuncSelector(TABLE_METHOD_INSERT_ROWS_BY_CONTRACT_STR);
+    name2Selector_[TABLE_METHOD_UPDATE_ROWS_STR] =
+        getFuncSelector(TABLE_METHOD_UPDATE_ROWS_STR);
+    name2Selector_[TABLE_METHOD_UPDATE_ROWS_BY_CONTRACT_STR] =
+        getFuncSelector(TABLE_METHOD_UPDATE_ROWS_BY_CONTRACT_STR);
+    name2Selector_[TABLE_METHOD_DELETE_ROWS_STR] =
+        getFuncSelector(TABLE_METHOD_DELETE_ROWS_STR);
+    name2Selector_[TABLE_METHOD_DELETE_ROWS_BY_CONTRACT_STR] =
+        getFuncSelector(TABLE_METHOD_DELETE_ROWS_BY_CONTRACT_STR);
     name2Selector_[TABLE_METHOD_GET_DATA_HANDLE_STR] =
         getFuncSelector(TABLE_METHOD_GET_DATA_HANDLE_STR);
     name2Selector_[TABLE_METHOD_GET_DATA_HANDLE_BY_CONTRACT_STR] =
@@ -144,7 +171,9 @@ TableOpPrecompiled::execute(
 {
     uint32_t func = getParamFunc(_in);
     bytesConstRef data = getParamData(_in);
-    ContractABI abi;
+    bool const typedRows =
+        _s.ctx().view().rules().enabled(featureTypedTableRows);
+    ContractABI abi(typedRows);
     if (func)
     {
         AccountID owner, destAddr;
@@ -242,6 +271,55 @@ TableOpPrecompiled::execute(
             abi.abiOut(data, owner, tableName, raw);
             ret = _s.deleteData(caller, owner, tableName, raw);
         }
+        if (typedRows &&
+            (func == name2Selector_[TABLE_METHOD_INSERT_ROWS_STR] ||
+             func == name2Selector_[TABLE_METHOD_INSERT_ROWS_BY_CONTRACT_STR]))
+        {
+            TableRows rows;
+            if (!abi.abiOut(data, owner, tableName, rows.fields, rows.values) ||
+                !rows.valid())
+                return std::make_tuple(temBAD_RAW, strCopy(""), 0);
+            raw = rows.toRaw();
+            auto const& account =
+                func == name2Selector_[TABLE_METHOD_INSERT_ROWS_STR] ? origin
+                                                                     : caller;
+            ret = _s.insertData(account, owner, tableName, raw);
+        }
+        if (typedRows &&
+            (func == name2Selector_[TABLE_METHOD_UPDATE_ROWS_STR] ||
+             func == name2Selector_[TABLE_METHOD_UPDATE_ROWS_BY_CONTRACT_STR]))
+        {
+            TableRows set, where;
+            if (!abi.abiOut(
+                    data,
+                    owner,
+                    tableName,
+                    set.fields,
+                    set.values,
+                    where.fields,
+                    where.values) ||
+                !validUpdate(set, where))
+                return std::make_tuple(temBAD_RAW, strCopy(""), 0);
+            raw = toUpdateRaw(set, where);
+            auto const& account =
+                func == name2Selector_[TABLE_METHOD_UPDATE_ROWS_STR] ? origin
+                                                                     : caller;
+            ret = _s.updateData(account, owner, tableName, raw);
+        }
+        if (typedRows &&
+            (func == name2Selector_[TABLE_METHOD_DELETE_ROWS_STR] ||
+             func == name2Selector_[TABLE_METHOD_DELETE_ROWS_BY_CONTRACT_STR]))
+        {
+            TableRows where;
+            if (!abi.abiOut(data, owner, tableName, where.fields, where.values) ||
+                !where.valid())
+                return std::make_tuple(temBAD_RAW, strCopy(""), 0);
+            raw = where.toRaw();
+            auto const& account =
+                func == name2Selector_[TABLE_METHOD_DELETE_ROWS_STR] ? origin
+                                                                     : caller;
+            ret = _s.deleteData(account, owner, tableName, raw);
+        }
         if (func == name2Selector_[TABLE_METHOD_ADD_FIELDS_STR])
         {
             abi.abiOut(data, tableName, raw);
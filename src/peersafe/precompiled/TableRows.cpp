@@ -0,0 +1,129 @@
+#include <peersafe/precompiled/TableRows.h>
+#include <ripple/json/json_writer.h>
+#include <algorithm>
+#include <numeric>
+
+namespace ripple {
+
+// Json::valueToQuotedString without the temporary for the common case of a
+// value that needs no escaping.
+static void
+appendQuoted(std::string& out, std::string const& value)
+{
+    auto const* const begin = value.c_str();
+    auto const* end = begin;
+    for (; *end; ++end)
+    {
+        if ((*end > 0 && *end <= 0x1F) || *end == '"' || *end == '\\')
+        {
+            out += Json::valueToQuotedString(begin);
+            return;
+        }
+    }
+    out += '"';
+    out.append(begin, end);
+    out += '"';
+}
+
+bool
+TableRows::valid() const
+{
+    if (fields.empty() || values.empty() ||
+        values.size() % fields.size() != 0)
+        return false;
+
+    std::vector<std::string const*> names;
+    names.reserve(fields.size());
+    for (auto const& f : fields)
+    {
+        if (f.empty())
+            return false;
+        names.push_back(&f);
+    }
+    std::sort(names.begin(), names.end(), [](auto const* a, auto const* b) {
+        return *a < *b;
+    });
+    return std::adjacent_find(
+               names.begin(), names.end(), [](auto const* a, auto const* b) {
+                   return *a == *b;
+               }) == names.end();
+}
+
+void
+TableRows::appendObjects(std::string& out) const
+{
+    if (fields.empty())
+        return;
+
+    // Json::Value keeps object members ordered by name; write them the same
+    // way. Names are quoted once, not once per row.
+    std::vector<std::size_t> order(fields.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](auto a, auto b) {
+        return fields[a] < fields[b];
+    });
+
+    std::vector<std::string> names;
+    names.reserve(order.size());
+    for (auto const i : order)
+        names.push_back(Json::valueToQuotedString(fields[i].c_str()) + ':');
+
+    std::size_t bytes = values.size() * 3 + rowCount() * 3;
+    for (auto const& v : values)
+        bytes += v.size();
+    for (auto const& n : names)
+        bytes += n.size() * rowCount();
+    out.reserve(out.size() + bytes);
+
+    auto const rows = rowCount();
+    for (std::size_t r = 0; r < rows; ++r)
+    {
+        if (r != 0)
+            out += ',';
+        out += '{';
+        auto const* row = &values[r * fields.size()];
+        for (std::size_t c = 0; c < order.size(); ++c)
+        {
+            if (c != 0)
+                out += ',';
+            out += names[c];
+            appendQuoted(out, row[order[c]]);
+        }
+        out += '}';
+    }
+}
+
+std::string
+TableRows::toRaw() const
+{
+    std::string raw("[");
+    appendObjects(raw);
+    raw += ']';
+    return raw;
+}
+
+bool
+validUpdate(TableRows const& set, TableRows const& where)
+{
+    if (!set.valid() || set.rowCount() != 1)
+        return false;
+    if (where.fields.empty() && where.values.empty())
+        return true;
+    return where.valid();
+}
+
+std::string
+toUpdateRaw(TableRows const& set, TableRows const& where)
+{
+    std::string raw("[");
+    set.appendObjects(raw);
+    if (where.rowCount() != 0)
+    {
+        raw += ',';
+        where.appendObjects(raw);
+    }
+    raw += ']';
+    return raw;
+}
+
+}  // namespace ripple
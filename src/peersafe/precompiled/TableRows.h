@@ -0,0 +1,67 @@
+#ifndef PRECOMPILED_TABLE_ROWS_H_INCLUDE
+#define PRECOMPILED_TABLE_ROWS_H_INCLUDE
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+/*
+Rows handed to the table precompiles as ABI arrays instead of a JSON text.
+
+`fields` names the columns once and `values` holds fields.size() entries per
+row, row-major. Contracts fill two string[] instead of concatenating a JSON
+document in Solidity, and the node writes the sfRaw text straight from the
+arrays without building a Json::Value.
+
+The text produced is exactly what Json::FastWriter writes for the equivalent
+array of objects, so the sub-transaction, its fee and what STTx2SQL executes
+are the same as with the JSON string methods.
+
+Every value is written as a JSON string, numbers included: `values` is a
+string[] and its entries carry no column type. STTx2SQL quotes string values
+into the SQL, so int, float and decimal columns get the decimal text and the
+database converts it, as it does for a JSON string method given "1" rather
+than 1. A value which isn't a number fails that conversion in the database,
+not here.
+*/
+struct TableRows
+{
+    std::vector<std::string> fields;
+    std::vector<std::string> values;
+
+    std::size_t
+    rowCount() const
+    {
+        return fields.empty() ? 0 : values.size() / fields.size();
+    }
+
+    /** At least one row, complete rows, non-empty and distinct field names. */
+    bool
+    valid() const;
+
+    /** Append `{"f1":"v1",...}` for every row, separated by ','. */
+    void
+    appendObjects(std::string& out) const;
+
+    /** `[{"f1":"v1",...},...]`, the sfRaw of insert and delete. */
+    std::string
+    toRaw() const;
+};
+
+/** Whether `set` and `where` make an update: exactly one set row, and
+    either no condition at all or valid condition rows. Condition fields
+    without values are rejected rather than dropped, which would update
+    every row of the table.
+*/
+bool
+validUpdate(TableRows const& set, TableRows const& where);
+
+/** `[{set},{where},...]`, the sfRaw of update. */
+std::string
+toUpdateRaw(TableRows const& set, TableRows const& where);
+
+}  // namespace ripple
+
+#endif
@@ -1,4 +1,5 @@
 #include <ripple/basics/StringUtilities.h>
+#include <ripple/protocol/Feature.h>
 #include <peersafe/precompiled/ABI.h>
 #include <peersafe/precompiled/ToolsPrecompiled.h>
 #include <peersafe/precompiled/Utils.h>
@@ -10,6 +11,27 @@ const char* const PUBLIC_TO_ADDRESS = "publicToAddress(string)";
 const char* const STRING_CONCAT = "stringConcat(string[])";
 const char* const SHA256_COMMON = "eth_sha256(bytes)";
 const char* const RIPEMD160 = "eth_ripemd160(bytes)";
+const char* const SHA256_BATCH = "eth_sha256Batch(bytes[])";
+const char* const KECCAK256_BATCH = "keccak256Batch(bytes[])";
+
+// A batch costs what hashing each message alone does: the sha256
+// precompile and the KECCAK256 opcode charge a base and a per word gas.
+static constexpr int64_t SHA256_GAS = 60;
+static constexpr int64_t SHA256_WORD_GAS = 12;
+static constexpr int64_t KECCAK256_GAS = 30;
+static constexpr int64_t KECCAK256_WORD_GAS = 6;
+
+static int64_t
+batchGas(
+    std::vector<std::string> const& messages,
+    int64_t baseGas,
+    int64_t wordGas)
+{
+    int64_t gas = 0;
+    for (auto const& message : messages)
+        gas += baseGas + (int64_t(message.size()) + 31) / 32 * wordGas;
+    return gas;
+}
 
 ToolsPrecompiled::ToolsPrecompiled()
 {
@@ -19,6 +41,8 @@ ToolsPrecompiled::ToolsPrecompiled()
     name2Selector_[STRING_CONCAT] = getFuncSelector(STRING_CONCAT);
     name2Selector_[SHA256_COMMON] = getFuncSelector(SHA256_COMMON);
     name2Selector_[RIPEMD160] = getFuncSelector(RIPEMD160);
+    name2Selector_[SHA256_BATCH] = getFuncSelector(SHA256_BATCH);
+    name2Selector_[KECCAK256_BATCH] = getFuncSelector(KECCAK256_BATCH);
 }
 
 std::string
@@ -36,7 +60,9 @@ ToolsPrecompiled::execute(
 {
     uint32_t func = getParamFunc(_in);
     bytesConstRef data = getParamData(_in);
-    ContractABI abi;
+    auto const& rules = _s.ctx().view().rules();
+    ContractABI abi(rules.enabled(featureTypedTableRows));
+    bool const batchHash = rules.enabled(featureBatchHash);
     if (func)
     {
         int64_t ter(0), runGas(0);
@@ -109,6 +135,44 @@ ToolsPrecompiled::execute(
                 retValue.begin());
             ret = Blob(retValue.begin(), retValue.end());
         }
+        else if (batchHash && func == name2Selector_[SHA256_BATCH])
+        {
+            // Hashes every message in one call, a Merkle proof costs one
+            // precompile call per level instead of one per node
+            std::vector<std::string> params;
+            abi.abiOut(data, params);
+            runGas = batchGas(params, SHA256_GAS, SHA256_WORD_GAS);
+            std::vector<string32> hashes(params.size());
+            for (std::size_t i = 0; i < params.size(); ++i)
+            {
+                auto const h = eth_sha256(makeSlice(params[i]));
+                std::copy(h.begin(), h.end(), hashes[i].begin());
+            }
+            ret = abi.abiIn("", hashes);
+        }
+        else if (batchHash && func == name2Selector_[KECCAK256_BATCH])
+        {
+            std::vector<std::string> params;
+            abi.abiOut(data, params);
+            runGas = batchGas(params, KECCAK256_GAS, KECCAK256_WORD_GAS);
+            std::vector<uint8_t const*> messages;
+            std::vector<uint64_t> sizes;
+            for (auto const& param : params)
+            {
+                messages.push_back((uint8_t const*)param.data());
+                sizes.push_back(param.size());
+            }
+            Blob digests(32 * params.size());
+            eth::keccak(
+                messages.data(), sizes.data(), params.size(), digests.data());
+            std::vector<string32> hashes(params.size());
+            for (std::size_t i = 0; i < params.size(); ++i)
+                std::copy(
+                    digests.begin() + 32 * i,
+                    digests.begin() + 32 * (i + 1),
+                    hashes[i].begin());
+            ret = abi.abiIn("", hashes);
+        }
 
         return std::make_tuple(
             TER::fromInt(ter), ret, runGas);
@@ -1,4 +1,5 @@
 #include <peersafe/precompiled/Utils.h>
+#include <ripple/protocol/digest.h>
 
 using namespace eth;
 namespace ripple {
@@ -37,9 +38,20 @@ getFuncSelectorByFunctionName(std::string const& _functionName)
 uint256
 eth_sha256(Slice const& slice)
 {
-    uint256 ret;
-    picosha2::hash256(slice.begin(), slice.end(), ret.data(), ret.data() + 32);
-    return ret;
+    // OpenSSL picks the SHA extensions or AVX2 code for the CPU at runtime
+    sha256_hasher h;
+    h(slice.data(), slice.size());
+    auto const digest = static_cast<sha256_hasher::result_type>(h);
+    return uint256::fromVoid(digest.data());
+}
+
+Blob
+eth_ripemd160(Slice const& slice)
+{
+    ripemd160_hasher h;
+    h(slice.data(), slice.size());
+    auto const digest = static_cast<ripemd160_hasher::result_type>(h);
+    return Blob(digest.begin(), digest.end());
 }
 
 }  // namespace ripple
\ No newline at end of file
@@ -4,7 +4,6 @@
 #include <eth/evmc/include/evmc/evmc.h>
 #include <eth/vm/Common.h>
 #include <eth/vm/utils/keccak.h>
-#include <peersafe/precompiled/picosha2.h>
 #include <ripple/basics/Slice.h>
 #include <ripple/basics/base_uint.h>
 #include <ripple/basics/Blob.h>
@@ -17,8 +17,11 @@
 */
 //==============================================================================
 
+#include <peersafe/app/ledger/LedgerObjectCounter.h>
+#include <peersafe/schema/Schema.h>
 #include <ripple/app/ledger/LedgerToJson.h>
 #include <ripple/ledger/ReadView.h>
+#include <ripple/net/RPCErr.h>
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/protocol/jss.h>
 #include <ripple/protocol/LedgerFormats.h>
@@ -33,7 +36,13 @@ namespace ripple {
 	//   Inputs:
 	//		ledger_hash :  <ledger>
 	//		ledger_index : <ledger_index>
+	//		verify : <bool>    // admin only, cross-check with a full scan
 	//   Outputs:
+	//
+	// Counts are carried forward from ledger to ledger by
+	// LedgerObjectCounter; a full scan is only done when they aren't known
+	// yet or when asked to verify them. Only an admin's scan is kept as the
+	// counts of the ledger, others just get the scanned counts back.
 
 	Json::Value doLedgerObjects(RPC::JsonContext& context)
 	{
@@ -43,34 +52,69 @@ namespace ripple {
 		if (!lpLedger)
 			return jvResult;
 
+		bool const verify = context.params.isMember("verify") &&
+			context.params["verify"].asBool();
+		if (verify && context.role != Role::ADMIN)
+			return rpcError(rpcNO_PERMISSION);
+
 		jvResult[jss::ledger_hash] = to_string(lpLedger->info().hash);
 		jvResult[jss::ledger_index] = lpLedger->info().seq;
 
-		Json::Value& nodes = jvResult[jss::state];
-
-		std::map< LedgerEntryType, uint32_t> mapCount;
-		for (auto sle:lpLedger->sles)
+		auto& counter = context.app.getLedgerObjectCounter();
+		auto mapCount = counter.get(*lpLedger);
+		jvResult["incremental"] = static_cast<bool>(mapCount);
+		if (!mapCount || verify)
 		{
-		//	auto sle = //lpLedger->read(keylet::unchecked((*i)->key()));
-			mapCount[sle->getType()] ++;
+			auto const scanned = LedgerObjectCounter::scan(*lpLedger);
+			if (verify && mapCount)
+			{
+				jvResult["verified"] = (*mapCount == scanned);
+				if (*mapCount != scanned)
+				{
+					Json::Value& mismatch = (jvResult["mismatch"] = Json::objectValue);
+					auto diff = [&](LedgerObjectCounter::Counts const& counts) {
+						for (auto const& [type, count] : counts)
+						{
+							(void)count;
+							auto const format = LedgerFormats::getInstance().findByType(type);
+							auto const name = format ? format->getName() : std::to_string(type);
+							auto const incremental = mapCount->find(type);
+							auto const full = scanned.find(type);
+							mismatch[name]["incremental"] = incremental == mapCount->end() ? 0 : incremental->second;
+							mismatch[name]["scan"] = full == scanned.end() ? 0 : full->second;
+						}
+					};
+					diff(*mapCount);
+					diff(scanned);
+				}
+			}
+			if (!lpLedger->open() && context.role == Role::ADMIN)
+				counter.seed(lpLedger->info(), scanned);
+			mapCount = scanned;
 		}
 
-		nodes[jss::account] = mapCount[ltACCOUNT_ROOT];
-		nodes[jss::amendments] = mapCount[ltAMENDMENTS];
-		nodes[jss::directory] = mapCount[ltDIR_NODE];
-		nodes[jss::fee] = mapCount[ltFEE_SETTINGS];
-		nodes[jss::hashes] = mapCount[ltLEDGER_HASHES];
-		nodes[jss::offer] = mapCount[ltOFFER];
-		nodes[jss::signer_list] = mapCount[ltSIGNER_LIST];
-		nodes[jss::state] = mapCount[ltRIPPLE_STATE];
-		nodes[jss::escrow] = mapCount[ltESCROW];
-		nodes[jss::ticket] = mapCount[ltTICKET];
-		nodes[jss::payment_channel] = mapCount[ltPAYCHAN];
-		nodes[jss::table] = mapCount[ltTABLE];
-        nodes[jss::tablelist] = mapCount[ltTABLELIST];
-		nodes[jss::schema] = mapCount[ltSCHEMA];
-		nodes[jss::statis] = mapCount[ltSTATIS];
-        nodes[jss::tablegrant] = mapCount[ltTABLEGRANT];
+		auto count = [&](LedgerEntryType type) -> std::uint32_t {
+			auto const it = mapCount->find(type);
+			return it == mapCount->end() ? 0 : it->second;
+		};
+
+		Json::Value& nodes = jvResult[jss::state];
+		nodes[jss::account] = count(ltACCOUNT_ROOT);
+		nodes[jss::amendments] = count(ltAMENDMENTS);
+		nodes[jss::directory] = count(ltDIR_NODE);
+		nodes[jss::fee] = count(ltFEE_SETTINGS);
+		nodes[jss::hashes] = count(ltLEDGER_HASHES);
+		nodes[jss::offer] = count(ltOFFER);
+		nodes[jss::signer_list] = count(ltSIGNER_LIST);
+		nodes[jss::state] = count(ltRIPPLE_STATE);
+		nodes[jss::escrow] = count(ltESCROW);
+		nodes[jss::ticket] = count(ltTICKET);
+		nodes[jss::payment_channel] = count(ltPAYCHAN);
+		nodes[jss::table] = count(ltTABLE);
+		nodes[jss::tablelist] = count(ltTABLELIST);
+		nodes[jss::schema] = count(ltSCHEMA);
+		nodes[jss::statis] = count(ltSTATIS);
+		nodes[jss::tablegrant] = count(ltTABLEGRANT);
 
 		int txCount = 0;
 		for (auto const& tx : lpLedger->txs)
@@ -80,9 +124,6 @@ namespace ripple {
 		}
 		jvResult[jss::tx] = txCount;
 
-		//auto j = context.app.journal("RPCHandler");
-		//JLOG(j.info())<<"ledger_objects:"<<jvResult.toStyledString();
-
 		return jvResult;
 	}
 
@@ -0,0 +1,63 @@
+//------------------------------------------------------------------------------
+/*
+This file is part of chainsqld: https://github.com/chainsql/chainsqld
+Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+chainsqld is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+chainsqld is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//==============================================================================
+
+#include <peersafe/app/ledger/LedgerTimeline.h>
+#include <peersafe/schema/Schema.h>
+#include <ripple/json/json_value.h>
+#include <ripple/net/RPCErr.h>
+#include <ripple/protocol/ErrorCodes.h>
+#include <ripple/protocol/jss.h>
+#include <ripple/rpc/Context.h>
+
+namespace ripple {
+
+// {
+//   limit: <number>         // optional, most recent ledgers, defaults to 10
+//   ledger_index: <number>  // optional, just this ledger
+// }
+Json::Value
+doLedgerTimeline(RPC::JsonContext& context)
+{
+    auto& timeline = context.app.getLedgerTimeline();
+    if (!timeline.enabled())
+        return rpcError(rpcNOT_ENABLED);
+
+    std::size_t limit = 10;
+    if (context.params.isMember(jss::limit))
+    {
+        if (!context.params[jss::limit].isIntegral())
+            return RPC::expected_field_error(jss::limit, "unsigned integer");
+        limit = context.params[jss::limit].asUInt();
+    }
+
+    boost::optional<LedgerIndex> seq;
+    if (context.params.isMember(jss::ledger_index))
+    {
+        if (!context.params[jss::ledger_index].isIntegral())
+            return RPC::expected_field_error(
+                jss::ledger_index, "unsigned integer");
+        seq = context.params[jss::ledger_index].asUInt();
+    }
+
+    Json::Value ret(Json::objectValue);
+    ret["ledgers"] = timeline.getJson(limit, seq);
+    return ret;
+}
+
+}  // namespace ripple
@@ -26,7 +26,7 @@
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/app/main/Application.h>
 #include <peersafe/app/ledger/LedgerAdjust.h>
-#include <peersafe/app/sql/TxnDBConn.h>
+#include <peersafe/app/ledger/StatisStore.h>
 
 namespace ripple {
 
@@ -52,17 +52,21 @@ doMonitorStatis(RPC::JsonContext& context)
         }
         else
         {
-            TxnDBCon& connection = context.app.getTxnDB();
-            
-            auto countSucc = LedgerAdjust::getTxSucessCount(connection.checkoutDbRead());
-            auto countFail = LedgerAdjust::getTxFailCount(connection.checkoutDb());
-            ret["txn_count"] = countSucc + countFail;
-            int contractCount = LedgerAdjust::getContractCreateCount(connection.checkoutDbRead());
-            ret["contract_count"] = contractCount;
-            int accountCount = LedgerAdjust::getAccountCount(connection.checkoutDbRead());
-            if (accountCount > 1)
-                accountCount = accountCount - contractCount;
-            ret["account_count"] = accountCount;
+            // Never count the transaction tables from an RPC thread
+            auto& store = context.app.getStatisStore();
+            auto statis = store.totals();
+            if (!statis)
+            {
+                if (!context.app.config().useTxTables())
+                    return rpcError(rpcNOT_ENABLED);
+                store.scheduleRebuild();
+                return rpcError(rpcNOT_READY);
+            }
+            ret["txn_count"] =
+                static_cast<Json::UInt>(statis->txSuccess + statis->txFailure);
+            ret["contract_count"] =
+                static_cast<Json::UInt>(statis->contractCreate);
+            ret["account_count"] = LedgerAdjust::getAccountCount(*statis);
         }
     }
 
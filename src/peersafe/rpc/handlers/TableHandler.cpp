@@ -29,6 +29,7 @@
 #include <ripple/rpc/impl/RPCHelpers.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/json/json_reader.h>
+#include <ripple/json/to_string.h>
 #include <ripple/protocol/SecretKey.h>
 #include <peersafe/schema/Schema.h>
 
@@ -38,6 +39,7 @@
 #include <peersafe/rpc/impl/TableAssistant.h>
 #include <peersafe/rpc/TableUtils.h>
 #include <peersafe/app/table/TableStatusDB.h>
+#include <peersafe/app/table/QueryCache.h>
 #include <peersafe/app/misc/ConnectionPool.h>
 #include <iostream> 
 #include <fstream>
@@ -725,6 +727,39 @@ checkOperationRuleForSqlUser(RPC::JsonContext& context,const AccountID& accountI
 }
 
 
+// Cache key of a select described by tx_json, after checkForSelect has
+// replaced the table names by their NameInDB and applied the operation rule.
+static std::string
+getQueryCacheKey(
+    std::string const& kind,
+    Json::Value const& tx_json,
+    std::set<uint160>& tables)
+{
+    Json::Value const& tables_json = tx_json[jss::Tables];
+    for (Json::UInt idx = 0; idx < tables_json.size(); idx++)
+    {
+        auto const& v = tables_json[idx]["Table"];
+        tables.insert(from_hex_text<uint160>(v["TableName"].asString()));
+    }
+
+    Json::Value const& raw = tx_json[jss::Raw];
+    return QueryCache::makeKey(
+        kind,
+        tx_json[jss::Account].asString(),
+        Json::to_string(tables_json) +
+            (raw.isString() ? raw.asString() : Json::to_string(raw)),
+        tables);
+}
+
+static std::set<uint160>
+getQueryCacheTables(std::set<std::string> const& setNameInDB)
+{
+    std::set<uint160> tables;
+    for (auto const& nameInDB : setNameInDB)
+        tables.insert(from_hex_text<uint160>(nameInDB));
+    return tables;
+}
+
 Json::Value
 doGetRecord(RPC::JsonContext& context)
 {
@@ -755,7 +790,29 @@ doGetRecord(RPC::JsonContext& context)
     //}
     try
     {
-        ret = pTxStore->txHistory(context);
+        auto& queryCache = context.app.getQueryCache();
+        std::set<uint160> tables;
+        std::string cacheKey;
+        boost::optional<Json::Value> cached;
+        // Streamed reads are bulk reads, not worth caching
+        if (queryCache.enabled() && !context.rowSink)
+        {
+            cacheKey = getQueryCacheKey(
+                "r_get", context.params[jss::tx_json], tables);
+            cached = queryCache.fetch(cacheKey, tables);
+        }
+
+        if (cached)
+            ret = std::move(*cached);
+        else
+        {
+            auto const generations = queryCache.snapshot(tables);
+            ret = pTxStore->txHistory(context);
+            if (queryCache.enabled() && !context.rowSink &&
+                !ret.isMember(jss::error))
+                queryCache.insert(cacheKey, generations, ret);
+        }
+
         if (!ret.isMember(jss::error))
         {
             // diff between the latest ledgerseq in db and the real newest
@@ -771,6 +828,19 @@ doGetRecord(RPC::JsonContext& context)
         context.app.getConnectionPool().releaseConnection(unit);
     }
 
+    // The rows are read before any is sent: sending may suspend this
+    // coroutine, which must not happen while holding the database.
+    if (context.rowSink && ret.isMember(jss::lines))
+    {
+        Json::Value lines = std::move(ret[jss::lines]);
+        ret.removeMember(jss::lines);
+        for (auto const& line : lines)
+        {
+            if (!context.rowSink(line))
+                break;
+        }
+    }
+
     return ret;
 }
 
@@ -855,12 +925,34 @@ Json::Value doGetRecordBySql(RPC::JsonContext&  context)
             return ret;
         }
 
-        ret = queryBySql(txStore, catenatedSql);
+        auto& queryCache = context.app.getQueryCache();
+        auto const tables = getQueryCacheTables(setNameInDB);
+        std::string cacheKey;
+        boost::optional<Json::Value> cached;
+        if (queryCache.enabled())
+        {
+            cacheKey = QueryCache::makeKey(
+                "r_get_sql_admin",
+                "",
+                QueryCache::normalize(catenatedSql),
+                tables);
+            cached = queryCache.fetch(cacheKey, tables);
+        }
 
-        if (ret.isMember(jss::error))
+        if (cached)
+            ret = std::move(*cached);
+        else
         {
-            context.app.getConnectionPool().releaseConnection(unit);
-            return ret;
+            auto const generations = queryCache.snapshot(tables);
+            ret = queryBySql(txStore, catenatedSql);
+
+            if (ret.isMember(jss::error))
+            {
+                context.app.getConnectionPool().releaseConnection(unit);
+                return ret;
+            }
+            if (queryCache.enabled())
+                queryCache.insert(cacheKey, generations, ret);
         }
 
         // diff between the latest ledgerseq in db and the real newest ledgerseq
@@ -931,11 +1023,33 @@ Json::Value doGetRecordBySqlUser(RPC::JsonContext& context)
             return ret;
         }
 
-        ret = queryBySql(txStore, catenatedSql);
-        if (ret.isMember(jss::error))
+        auto& queryCache = context.app.getQueryCache();
+        auto const tables = getQueryCacheTables(setNameInDB);
+        std::string cacheKey;
+        boost::optional<Json::Value> cached;
+        if (queryCache.enabled())
         {
-            context.app.getConnectionPool().releaseConnection(unit);
-            return ret;
+            cacheKey = QueryCache::makeKey(
+                "r_get_sql_user",
+                to_string(accountID),
+                QueryCache::normalize(catenatedSql),
+                tables);
+            cached = queryCache.fetch(cacheKey, tables);
+        }
+
+        if (cached)
+            ret = std::move(*cached);
+        else
+        {
+            auto const generations = queryCache.snapshot(tables);
+            ret = queryBySql(txStore, catenatedSql);
+            if (ret.isMember(jss::error))
+            {
+                context.app.getConnectionPool().releaseConnection(unit);
+                return ret;
+            }
+            if (queryCache.enabled())
+                queryCache.insert(cacheKey, generations, ret);
         }
 
         // diff between the latest ledgerseq in db and the real newest ledgerseq
@@ -987,8 +1101,40 @@ std::pair<std::vector<std::vector<Json::Value>>,std::string> doGetRecord2D(RPC::
 	//}
     try
     {
+        auto& queryCache = context.app.getQueryCache();
+        std::set<uint160> tables;
+        std::string cacheKey;
+        if (queryCache.enabled())
+        {
+            cacheKey = getQueryCacheKey(
+                "r_get_2d", context.params[jss::tx_json], tables);
+            if (auto cached = queryCache.fetch(cacheKey, tables))
+            {
+                context.app.getConnectionPool().releaseConnection(unit);
+                for (auto const& row : *cached)
+                {
+                    result.emplace_back();
+                    for (auto const& v : row)
+                        result.back().push_back(v);
+                }
+                return std::make_pair(std::move(result), std::string());
+            }
+        }
+
+        auto const generations = queryCache.snapshot(tables);
         auto retVec = pTxStore->txHistory2d(context);
         context.app.getConnectionPool().releaseConnection(unit);
+        if (queryCache.enabled() && retVec.second.empty())
+        {
+            Json::Value rows(Json::arrayValue);
+            for (auto const& row : retVec.first)
+            {
+                Json::Value& jvRow = rows.append(Json::arrayValue);
+                for (auto const& v : row)
+                    jvRow.append(v);
+            }
+            queryCache.insert(cacheKey, generations, rows);
+        }
         return retVec;
     }
     catch (std::exception const& e)
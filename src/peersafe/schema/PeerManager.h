@@ -3,6 +3,7 @@
 #include <ripple/json/json_value.h>
 #include <ripple/overlay/Peer.h>
 #include <ripple/overlay/PeerSet.h>
+#include <set>
 
 namespace ripple {
 
@@ -81,6 +82,35 @@ public:
     virtual void
     relay(protocol::TMConsensus& m, uint256 const& uid) = 0;
 
+    /** Relay a transaction to the peers not in `toSkip`.
+            Unless `local`, only a share of them get it once squelching
+            started; the others get it from other relays.
+    */
+    virtual void
+    relay(
+        protocol::TMTransaction& m,
+        uint256 const& txID,
+        std::set<Peer::id_t> const& toSkip,
+        bool local) = 0;
+
+    /** Count a message of `key` received from peer `id`, and squelch the
+            peers not selected as its sources once there are enough of them.
+            @param uid the unique id of the message
+    */
+    virtual void
+    updateSlotAndSquelch(
+        uint256 const& uid,
+        PublicKey const& key,
+        Peer::id_t id) = 0;
+
+    /** Forget a disconnected peer as a source. */
+    virtual void
+    deletePeer(Peer::id_t id) = 0;
+
+    /** Forget the sources which stopped relaying. Called periodically. */
+    virtual void
+    deleteIdlePeers() = 0;
+
     ///** Visit every active peer and return a value
     //	The functor must:
     //	- Be callable as:
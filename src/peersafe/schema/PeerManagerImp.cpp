@@ -23,6 +23,7 @@
 #include <ripple/app/misc/ValidatorList.h>
 #include <ripple/app/misc/ValidatorSite.h>
 #include <ripple/basics/base64.h>
+#include <ripple/basics/random.h>
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/core/SociDB.h>
 #include <ripple/overlay/impl/OverlayImpl.h>
@@ -34,8 +35,19 @@
 
 namespace ripple {
 
+// Only trusted validators get a slot, this caps a very large UNL
+static constexpr std::size_t maxSquelchSlots = 1024;
+
 PeerManagerImpl::PeerManagerImpl(Schema& app)
-    : app_(app), journal_(app_.journal("PeerManager"))
+    : app_(app)
+    , journal_(app_.journal("PeerManager"))
+    , reduceRelay_(app_.config().REDUCE_RELAY_ENABLE)
+    , created_(clock_type::now())
+    , slots_(
+          *this,
+          app_.config().REDUCE_RELAY_PEERS,
+          maxSquelchSlots,
+          app_.journal("Slots"))
 {
 }
 
@@ -478,13 +490,146 @@ PeerManagerImpl::relay(protocol::TMConsensus& m, uint256 const& uid)
     if (auto const toSkip = app_.getHashRouter().shouldRelay(uid))
     {
         auto const sm = std::make_shared<Message>(m, protocol::mtCONSENSUS);
+        PublicKey const key{makeSlice(m.signerpubkey())};
+        // The message is verified by now, so the peers it came from count
+        // as sources of its validator
+        bool const trusted = app_.validators().trusted(key);
         for_each([&](std::shared_ptr<PeerImp>&& p) {
             if (toSkip->find(p->id()) == toSkip->end())
-                p->send(sm);
+                p->relay(sm, app_.schemaId(), key);
+            else if (trusted)
+                p->updateSlotAndSquelch(app_.schemaId(), uid, key);
         });
     }
 }
 
+void
+PeerManagerImpl::relay(
+    protocol::TMTransaction& m,
+    uint256 const& txID,
+    std::set<Peer::id_t> const& toSkip,
+    bool local)
+{
+    auto const sm = std::make_shared<Message>(m, protocol::mtTRANSACTION);
+    std::vector<std::shared_ptr<PeerImp>> peers;
+    for_each([&](std::shared_ptr<PeerImp>&& p) {
+        if (toSkip.find(p->id()) == toSkip.end())
+            peers.push_back(std::move(p));
+    });
+
+    // Every node relays what it gets, so a random share of the peers is
+    // enough for a transaction to reach them all
+    std::size_t toSend = peers.size();
+    if (!local && reduceRelayReady())
+    {
+        toSend = std::min(
+            peers.size(),
+            std::max(
+                squelch::MIN_TX_RELAY_PEERS,
+                peers.size() * app_.config().REDUCE_RELAY_TX_PERCENT / 100));
+        std::shuffle(peers.begin(), peers.end(), default_prng());
+    }
+
+    auto& router = app_.getHashRouter();
+    for (std::size_t i = 0; i < peers.size(); ++i)
+    {
+        auto const& p = peers[i];
+        if (i < toSend)
+        {
+            // The next relay of this transaction skips the peers which
+            // have it, and goes to the ones left out this time
+            router.addSuppressionPeer(txID, p->id());
+            p->send(sm);
+        }
+        else
+        {
+            p->overlay_.reportTraffic(
+                TrafficCount::category::transaction_suppressed,
+                false,
+                static_cast<int>(sm->getBuffer(p->compressionEnabled_).size()));
+        }
+    }
+}
+
+bool
+PeerManagerImpl::reduceRelayReady() const
+{
+    return reduceRelay_ &&
+        clock_type::now() - created_ > squelch::WAIT_ON_BOOTUP;
+}
+
+void
+PeerManagerImpl::updateSlotAndSquelch(
+    uint256 const& uid,
+    PublicKey const& key,
+    Peer::id_t id)
+{
+    if (!reduceRelayReady())
+        return;
+
+    slots_.updateSlotAndSquelch(uid, key, id);
+}
+
+void
+PeerManagerImpl::deletePeer(Peer::id_t id)
+{
+    if (!reduceRelay_)
+        return;
+
+    slots_.deletePeer(id, true);
+}
+
+void
+PeerManagerImpl::deleteIdlePeers()
+{
+    if (!reduceRelay_)
+        return;
+
+    slots_.deleteIdlePeers();
+}
+
+void
+PeerManagerImpl::squelch(
+    PublicKey const& key,
+    Peer::id_t id,
+    std::uint32_t duration) const
+{
+    sendSquelch(key, id, true, duration);
+}
+
+void
+PeerManagerImpl::unsquelch(PublicKey const& key, Peer::id_t id) const
+{
+    sendSquelch(key, id, false, 0);
+}
+
+void
+PeerManagerImpl::sendSquelch(
+    PublicKey const& key,
+    Peer::id_t id,
+    bool squelch,
+    std::uint32_t duration) const
+{
+    std::shared_ptr<PeerImp> peer;
+    {
+        std::lock_guard lock{mutex_};
+        auto const it = ids_.find(id);
+        if (it == ids_.end())
+            return;
+        peer = it->second.lock();
+    }
+    if (!peer)
+        return;
+
+    protocol::TMSquelch m;
+    m.set_squelch(squelch);
+    m.set_publickey(key.data(), key.size());
+    if (squelch)
+        m.set_squelchduration(duration);
+    m.set_schemaid(app_.schemaId().begin(), uint256::size());
+    peer->send(std::make_shared<Message>(m, protocol::mtSQUELCH));
+}
+
 std::unique_ptr<PeerManager>
 make_PeerManager(Schema& schema)
 {
@@ -21,6 +21,7 @@
 #include <ripple/core/Job.h>
 #include <peersafe/schema/Schema.h>
 #include <peersafe/schema/PeerManager.h>
+#include <ripple/overlay/Slot.h>
 #include <set>
 #include <atomic>
 #include <cassert>
@@ -36,7 +37,7 @@ namespace ripple {
 class PeerImp;
 class BasicConfig;
 
-class PeerManagerImpl : public PeerManager
+class PeerManagerImpl : public PeerManager, public squelch::SquelchHandler
 {
 private:
     using clock_type = std::chrono::steady_clock;
@@ -53,6 +54,11 @@ private:
     // Peer IDs expecting to receive a last link notification
     std::set<std::uint32_t> csIDs_;
 
+    // Selected sources of the trusted validators of this schema
+    bool const reduceRelay_;
+    clock_type::time_point const created_;
+    squelch::Slots<clock_type> slots_;
+
     friend class PeerImp;
     //--------------------------------------------------------------------------
 public:
@@ -97,6 +103,33 @@ public:
     void
     relay(protocol::TMConsensus& m, uint256 const& uid) override;
 
+    void
+    relay(
+        protocol::TMTransaction& m,
+        uint256 const& txID,
+        std::set<Peer::id_t> const& toSkip,
+        bool local) override;
+
+    void
+    updateSlotAndSquelch(
+        uint256 const& uid,
+        PublicKey const& key,
+        Peer::id_t id) override;
+
+    void
+    deletePeer(Peer::id_t id) override;
+
+    void
+    deleteIdlePeers() override;
+
+    // SquelchHandler
+    void
+    squelch(PublicKey const& key, Peer::id_t id, std::uint32_t duration)
+        const override;
+
+    void
+    unsquelch(PublicKey const& key, Peer::id_t id) const override;
+
     //--------------------------------------------------------------------------
     //
     // PeerManagerImpl
@@ -167,5 +200,17 @@ public:
     */
     Json::Value
     getUnlInfo();
+
+private:
+    /** Squelching starts once the server had the time to connect. */
+    bool
+    reduceRelayReady() const;
+
+    void
+    sendSquelch(
+        PublicKey const& key,
+        Peer::id_t id,
+        bool squelch,
+        std::uint32_t duration) const;
 };
 }  // namespace ripple
\ No newline at end of file
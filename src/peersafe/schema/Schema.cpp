@@ -53,6 +53,12 @@
 #include <peersafe/app/misc/CertList.h>
 #include <peersafe/app/table/TableTxAccumulator.h>
 #include <peersafe/app/table/TableSync.h>
+#include <peersafe/app/table/QueryCache.h>
+#include <peersafe/app/table/TableMirror.h>
+#include <peersafe/app/ledger/LedgerTimeline.h>
+#include <peersafe/app/ledger/TxSetPreflight.h>
+#include <peersafe/app/ledger/LedgerObjectCounter.h>
+#include <peersafe/app/ledger/StatisStore.h>
 #include <peersafe/app/table/TableStatusDBMySQL.h>
 #include <peersafe/app/table/TableStatusDBSQLite.h>
 #include <peersafe/app/misc/TxPool.h>
@@ -157,6 +163,8 @@ private:
     RCLValidations mValidations;
     std::unique_ptr<TxQ> txQ_;
     std::unique_ptr<TxStoreDBConn> m_pTxStoreDBConn;
+    // Written through the TxStores, so it outlives them
+    std::unique_ptr<TableMirror> m_pTableMirror;
     std::unique_ptr<TxStore> m_pTxStore;
     std::unique_ptr<TableStatusDB> m_pTableStatusDB;
     std::unique_ptr<TableSync> m_pTableSync;
@@ -173,7 +181,12 @@ private:
     std::unique_ptr<DatabaseCon> mLedgerDB;
     std::unique_ptr<DatabaseCon> mWalletDB;
     std::unique_ptr<PeerManager> m_peerManager;
+    std::unique_ptr<LedgerTimeline> m_pLedgerTimeline;
+    std::unique_ptr<TxSetPreflight> m_pTxSetPreflight;
+    std::unique_ptr<LedgerObjectCounter> m_pLedgerObjectCounter;
+    std::unique_ptr<StatisStore> m_pStatisStore;
     std::unique_ptr<PrometheusClient> m_pPrometheusClient;
+    std::unique_ptr<QueryCache> m_pQueryCache;
 
 public:
     SchemaImp(
@@ -324,10 +337,15 @@ public:
 
         , m_pTxStoreDBConn(std::make_unique<TxStoreDBConn>(*config_))
 
+        , m_pTableMirror(std::make_unique<TableMirror>(
+              setup_TableMirror(*config_),
+              SchemaImp::journal("TableMirror")))
+
         , m_pTxStore(std::make_unique<TxStore>(
               m_pTxStoreDBConn->GetDBConn(),
               *config_,
-              SchemaImp::journal("TxStore")))
+              SchemaImp::journal("TxStore"),
+              m_pTableMirror.get()))
 
         , m_pTableSync(std::make_unique<TableSync>(
               *this,
@@ -358,11 +376,27 @@ public:
         , m_pConnectionPool(std::make_unique<ConnectionPool>(*this))
 
         , m_peerManager(make_PeerManager(*this))
+        , m_pLedgerTimeline(std::make_unique<LedgerTimeline>(
+              setup_LedgerTimeline(*config_),
+              SchemaImp::journal("LedgerTimeline")))
+        , m_pTxSetPreflight(std::make_unique<TxSetPreflight>(
+              *this,
+              setup_TxSetPreflight(*config_),
+              SchemaImp::journal("TxSetPreflight")))
+        , m_pLedgerObjectCounter(std::make_unique<LedgerObjectCounter>(
+              *this,
+              SchemaImp::journal("LedgerObjectCounter")))
+        , m_pStatisStore(std::make_unique<StatisStore>(
+              *this,
+              SchemaImp::journal("StatisStore")))
         , m_pPrometheusClient(std::make_unique<PrometheusClient>(
               *this,
               *config_,
               app.getPromethExposer(),
               SchemaImp::journal("PrometheusClient")))
+        , m_pQueryCache(std::make_unique<QueryCache>(
+              setup_QueryCache(*config_),
+              SchemaImp::journal("QueryCache")))
 
     {
     }
@@ -601,6 +635,42 @@ public:
         return *m_pPrometheusClient;
     }
 
+    QueryCache&
+    getQueryCache() override
+    {
+        return *m_pQueryCache;
+    }
+
+    TableMirror&
+    getTableMirror() override
+    {
+        return *m_pTableMirror;
+    }
+
+    LedgerTimeline&
+    getLedgerTimeline() override
+    {
+        return *m_pLedgerTimeline;
+    }
+
+    TxSetPreflight&
+    getTxSetPreflight() override
+    {
+        return *m_pTxSetPreflight;
+    }
+
+    LedgerObjectCounter&
+    getLedgerObjectCounter() override
+    {
+        return *m_pLedgerObjectCounter;
+    }
+
+    StatisStore&
+    getStatisStore() override
+    {
+        return *m_pStatisStore;
+    }
+
     RPC::ShardArchiveHandler*
     getShardArchiveHandler(bool tryRecovery) override
     {
@@ -77,6 +77,12 @@ class SHAMapStore;
 class SchemaManager;
 class ConnectionPool;
 class PrometheusClient;
+class QueryCache;
+class TableMirror;
+class LedgerTimeline;
+class TxSetPreflight;
+class LedgerObjectCounter;
+class StatisStore;
 using NodeCache = TaggedCache<SHAMapHash, Blob>;
 
 template <class StalePolicy, class Adaptor>
@@ -223,6 +229,18 @@ public:
     getConnectionPool() = 0;
     virtual PrometheusClient&
     getPrometheusClient() = 0;
+    virtual QueryCache&
+    getQueryCache() = 0;
+    virtual TableMirror&
+    getTableMirror() = 0;
+    virtual LedgerTimeline&
+    getLedgerTimeline() = 0;
+    virtual TxSetPreflight&
+    getTxSetPreflight() = 0;
+    virtual LedgerObjectCounter&
+    getLedgerObjectCounter() = 0;
+    virtual StatisStore&
+    getStatisStore() = 0;
 
     virtual PathRequests&
     getPathRequests() = 0;
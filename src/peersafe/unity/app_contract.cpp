@@ -7,5 +7,6 @@
 #include <peersafe/app/misc/impl/ExtVM.cpp>
 #include <peersafe/app/misc/impl/SleOps.cpp>
 #include <peersafe/app/misc/impl/ContractHelper.cpp>
+#include <peersafe/app/misc/impl/StoragePrefetch.cpp>
 #include <peersafe/app/misc/impl/PreContractRegister.cpp>
 #include <peersafe/app/misc/impl/PreContractFace.cpp>
@@ -178,8 +178,12 @@ private:
     bool
     takeHeader(std::string const& data);
 
+    // Nodes other than the root come decoded, in the order of the packet
     void
-    receiveNode(protocol::TMLedgerData& packet, SHAMapAddNode&);
+    receiveNode(
+        protocol::TMLedgerData& packet,
+        std::vector<std::shared_ptr<SHAMapAbstractNode>> const& decoded,
+        SHAMapAddNode&);
 
     bool
     takeTxRootNode(Slice const& data, SHAMapAddNode&);
@@ -231,7 +235,8 @@ private:
     // Data we have received from peers
     std::mutex mReceivedDataLock;
     std::vector<PeerDataPairType> mReceivedData;
-    bool mReceiveDispatched;
+    // Jobs running or queued to process the received data
+    int mReceiveJobs;
     std::atomic_bool mContractRootLoaded;
     std::map<uint256, std::shared_ptr<SHAMap>> mContractMapInfo;
     std::atomic_bool mCheckingContract{false};
@@ -57,6 +57,18 @@ public:
     virtual void
     gotStaleData(std::shared_ptr<protocol::TMLedgerData> packet) = 0;
 
+    /** Removes the state nodes another ledger asked for recently.
+
+        Ledgers acquired together, as when catching up, share most of
+        their state: once one of them receives a node, the others find it
+        in the node caches. The nodes left are noted as asked for by this
+        ledger.
+    */
+    virtual void
+    filterStateNodes(
+        LedgerHash const& ledgerHash,
+        std::vector<std::pair<SHAMapNodeID, uint256>>& nodes) = 0;
+
     virtual void
     logFailure(uint256 const& h, std::uint32_t seq) = 0;
 
@@ -54,6 +54,10 @@
 #include <peersafe/protocol/Contract.h>
 #include <peersafe/schema/Schema.h>
 #include <peersafe/app/sql/TxnDBConn.h>
+#include <peersafe/app/ledger/LedgerObjectCounter.h>
+#include <peersafe/app/ledger/StatisStore.h>
+#include <peersafe/app/ledger/LedgerTimeline.h>
+#include <peersafe/app/prometh/PrometheusClient.h>
 #include <peersafe/protocol/STMap256.h>
 #include <boost/optional.hpp>
 #include <cassert>
@@ -1060,6 +1064,8 @@ saveValidatedLedger(
 
     // Save the ledger header in the hashed object store
     {
+        LedgerTimeline::Scope timing(
+            app.getLedgerTimeline(), seq, LedgerTimeline::nodestoreWrite);
         Serializer s(128);
         s.add32(HashPrefix::ledgerMaster);
         addRaw(ledger->info(), s);
@@ -1089,6 +1095,10 @@ saveValidatedLedger(
         return false;
     }
 
+    LedgerTimeline::Scope timing(
+        app.getLedgerTimeline(), seq, LedgerTimeline::sqlCommit);
+    auto const sqlStart = std::chrono::steady_clock::now();
+
     {
         auto db = app.getLedgerDB().checkoutDb();
         *db << boost::str(deleteLedger % seq);
@@ -1106,6 +1116,8 @@ saveValidatedLedger(
         std::string const ledgerSeq(std::to_string(seq));
 		
         std::uint64_t iTxSeq = uint64_t(seq) * 100000;
+        std::uint64_t txSuccess = 0;
+        std::uint64_t txFailure = 0;
         for (auto const& [_, acceptedLedgerTx] : aLedger->getMap())
         {
             (void)_;
@@ -1172,6 +1184,10 @@ saveValidatedLedger(
             }
 			std::string token, human;
             transResultInfo(acceptedLedgerTx->getResult(), token, human);
+            if (acceptedLedgerTx->getResult() == tesSUCCESS)
+                ++txSuccess;
+            else
+                ++txFailure;
 
             if (app.getTxnDB().hasTxResult())
             {
@@ -1205,6 +1221,7 @@ saveValidatedLedger(
 			iTxSeq++;
         }
 
+        app.getStatisStore().onLedgerSaved(*db, seq, txSuccess, txFailure);
         tr.commit();
     }
 
@@ -1241,6 +1258,11 @@ saveValidatedLedger(
 
         tr.commit();
     }
+    app.getPrometheusClient().onSqlCommit(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - sqlStart));
+
+    app.getLedgerObjectCounter().onLedgerSaved(ledger);
 
     // Clients can now trust the database for
     // information about this ledger sequence.
@@ -28,7 +28,10 @@
 #include <ripple/core/Config.h>
 #include <ripple/ledger/CachedSLEs.h>
 #include <ripple/ledger/OpenView.h>
+#include <ripple/json/json_value.h>
 #include <cassert>
+#include <chrono>
+#include <deque>
 #include <mutex>
 
 namespace ripple {
@@ -49,12 +52,30 @@ using OrderedTxs = CanonicalTXSet;
 class OpenLedger
 {
 private:
+    using clock_type = std::chrono::steady_clock;
+
+    // A snapshot replaced by a newer one, possibly still held by readers
+    struct Retired
+    {
+        std::weak_ptr<OpenView const> view;
+        clock_type::time_point when;
+    };
+
     beast::Journal const j_;
     CachedSLEs& cache_;
     std::mutex mutable modify_mutex_;
+    // Held only to copy or replace current_, never while a view is built,
+    // so readers don't wait for modify() or accept(). A snapshot is freed
+    // when the last reader holding it lets go.
     std::mutex mutable current_mutex_;
     std::shared_ptr<OpenView const> current_;
 
+    std::mutex mutable stats_mutex_;
+    clock_type::time_point published_;
+    std::deque<Retired> retired_;
+    std::uint64_t publishes_ = 0;
+    std::uint64_t reclaimed_ = 0;
+
 public:
     /** Signature for modification functions.
 
@@ -102,7 +123,8 @@ public:
     /** Returns a view to the current open ledger.
 
         Thread safety:
-            Can be called concurrently from any thread.
+            Can be called concurrently from any thread,
+            without waiting for modify() or accept().
 
         Effects:
             The caller is given ownership of a
@@ -170,7 +192,19 @@ public:
         std::string const& suffix = "",
         modify_type const& f = {});
 
+    /** Statistics of the published snapshots.
+
+        Reports the age of the current snapshot and how many replaced
+        snapshots are still held by readers, and since when.
+    */
+    Json::Value
+    getJson() const;
+
 private:
+    // Requires the modify lock
+    void
+    publish(std::shared_ptr<OpenView const> next);
+
     /** Algorithm for applying transactions.
 
         This has the retry logic and ordering semantics
@@ -24,9 +24,11 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/CanonicalTXSet.h>
 #include <ripple/app/tx/apply.h>
+#include <ripple/ledger/ApplyArena.h>
 #include <ripple/protocol/Feature.h>
 #include <peersafe/schema/Schema.h>
 #include <peersafe/app/ledger/LedgerAdjust.h>
+#include <peersafe/app/ledger/LedgerTimeline.h>
 #include <peersafe/app/misc/ContractHelper.h>
 
 namespace ripple {
@@ -59,6 +61,8 @@ buildLedgerImpl(
     //   perform updates, extract changes
 
     {
+        // The state tables of the transactions go away with the ledger
+        ApplyArena::Scope arena;
         OpenView accum(&*built);
         assert(!accum.open());
         app.getContractHelper().clearCache();
@@ -73,6 +77,10 @@ buildLedgerImpl(
     {
         // Write the final version of all modified SHAMap
         // nodes to the node store to preserve the new LCL
+        LedgerTimeline::Scope timing(
+            app.getLedgerTimeline(),
+            built->info().seq,
+            LedgerTimeline::shamapFlush);
 
         int const asf =
             built->stateMap().flushDirty(hotACCOUNT_NODE, built->info().seq);
@@ -118,6 +126,10 @@ applyTransactions(
         JLOG(j.debug()) << (certainRetry ? "Pass: " : "Final pass: ") << pass
                         << " begins (" << txns.size() << " transactions)";
         int changes = 0;
+        LedgerTimeline::Scope timing(
+            app.getLedgerTimeline(),
+            built->info().seq,
+            LedgerTimeline::applyTxs);
 
         auto it = txns.begin();
 
@@ -197,6 +209,8 @@ buildLedger(
                     << closeTime.time_since_epoch().count()
                     << (closeTimeCorrect ? "" : " (incorrect)");
 
+    app.getContractHelper().prefetch().prefetch(*parent, txns);
+
     return buildLedgerImpl(
         parent,
         closeTime,
@@ -232,6 +246,9 @@ buildLedger(
 
     JLOG(j.debug()) << "Report: Replay Ledger " << replayLedger->info().hash;
 
+    app.getContractHelper().prefetch().prefetch(
+        *replayData.parent(), replayData.orderedTxns());
+
     return buildLedgerImpl(
         replayData.parent(),
         replayLedger->info().closeTime,
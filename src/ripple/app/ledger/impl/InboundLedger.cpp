@@ -80,6 +80,10 @@ enum {
 // millisecond for each ledger timeout
 auto constexpr ledgerAcquireTimeout = 2500ms;
 
+// Jobs that may process received data for one ledger at the same time.
+// Nodes are decoded concurrently; they are added to the maps one at a time.
+int constexpr maxReceiveJobs = 2;
+
 InboundLedger::InboundLedger(
     Schema& app,
     uint256 const& hash,
@@ -97,7 +101,7 @@ InboundLedger::InboundLedger(
     , mByHash(true)
     , mSeq(seq)
     , mReason(reason)
-    , mReceiveDispatched(false)
+    , mReceiveJobs(0)
     , mContractRootLoaded(false)
 {
     JLOG(m_journal.trace()) << "Acquiring ledger " << mHash;
@@ -794,6 +798,13 @@ InboundLedger::trigger(std::shared_ptr<Peer> const& peer, TriggerReason reason)
                 {
                     filterNodes(nodes, reason);
 
+                    // Shards are kept apart from the other ledgers' nodes.
+                    // On a timeout we ask for everything we still need.
+                    if (mReason != Reason::SHARD &&
+                        reason != TriggerReason::timeout)
+                        app_.getInboundLedgers().filterStateNodes(
+                            mHash, nodes);
+
                     if (!nodes.empty())
                     {
                         tmGL.set_itype(protocol::liAS_NODE);
@@ -1177,7 +1188,10 @@ InboundLedger::takeHeader(std::string const& data)
     Call with a lock
 */
 void
-InboundLedger::receiveNode(protocol::TMLedgerData& packet, SHAMapAddNode& san)
+InboundLedger::receiveNode(
+    protocol::TMLedgerData& packet,
+    std::vector<std::shared_ptr<SHAMapAbstractNode>> const& decoded,
+    SHAMapAddNode& san)
 {
     if (!mHaveHeader)
     {
@@ -1249,16 +1263,16 @@ InboundLedger::receiveNode(protocol::TMLedgerData& packet, SHAMapAddNode& san)
     auto& map = *pMap;
     try
     {
-        for (auto const& node : packet.nodes())
+        for (int i = 0; i < packet.nodes_size(); ++i)
         {
+            auto const& node = packet.nodes(i);
             SHAMapNodeID const nodeID(
                 node.nodeid().data(), node.nodeid().size());
             if (nodeID.isRoot())
                 san += map.addRootNode(
                     rootHash, makeSlice(node.nodedata()), filter.get());
             else
-                san += map.addKnownNode(
-                    nodeID, makeSlice(node.nodedata()), filter.get());
+                san += map.addKnownNode(nodeID, decoded[i], filter.get());
 
             if (!san.isGood())
             {
@@ -1432,10 +1446,12 @@ InboundLedger::gotData(
 
     mReceivedData.emplace_back(peer, data);
 
-    if (mReceiveDispatched)
+    // Running jobs pick up data queued behind what they took; another job
+    // is only needed when they all took theirs and there is room for more.
+    if (mReceivedData.size() > 1 || mReceiveJobs >= maxReceiveJobs)
         return false;
 
-    mReceiveDispatched = true;
+    ++mReceiveJobs;
     return true;
 }
 
@@ -1452,10 +1468,10 @@ InboundLedger::processData(
     std::shared_ptr<Peer> peer,
     protocol::TMLedgerData& packet)
 {
-    ScopedLockType sl(mLock);
-    
     if (packet.type() == protocol::liBASE)
     {
+        ScopedLockType sl(mLock);
+
         if (packet.nodes_size() < 1)
         {
             JLOG(m_journal.warn()) << "Got empty header data";
@@ -1528,8 +1544,36 @@ InboundLedger::processData(
             }
         }
 
+        // Decoding hashes each node. Do it before taking the lock, so that
+        // other jobs can add their nodes to this ledger meanwhile.
+        std::vector<std::shared_ptr<SHAMapAbstractNode>> decoded;
+        decoded.reserve(packet.nodes_size());
+        bool corrupt = false;
+        try
+        {
+            for (auto const& node : packet.nodes())
+            {
+                SHAMapNodeID const nodeID(
+                    node.nodeid().data(), node.nodeid().size());
+                decoded.push_back(
+                    nodeID.isRoot() ? nullptr
+                                    : SHAMapAbstractNode::makeFromWire(
+                                          makeSlice(node.nodedata())));
+            }
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(m_journal.error()) << "Received bad node data: " << e.what();
+            corrupt = true;
+        }
+
+        ScopedLockType sl(mLock);
+
         SHAMapAddNode san;
-        receiveNode(packet, san);
+        if (corrupt)
+            san.incInvalid();
+        else
+            receiveNode(packet, decoded, san);
 
         if (packet.type() == protocol::liTX_NODE)
         {
@@ -1559,14 +1603,11 @@ InboundLedger::processData(
 }
 
 /** Process pending TMLedgerData
-    Query the 'best' peer
+    Query the 'best' peer of each batch, as soon as the batch is in
 */
 void
 InboundLedger::runData()
 {
-    std::shared_ptr<Peer> chosenPeer;
-    int chosenPeerCount = -1;
-
     std::vector<PeerDataPairType> data;
 
     for (;;)
@@ -1577,7 +1618,7 @@ InboundLedger::runData()
 
             if (mReceivedData.empty())
             {
-                mReceiveDispatched = false;
+                --mReceiveJobs;
                 break;
             }
 
@@ -1586,6 +1627,8 @@ InboundLedger::runData()
 
         // Select the peer that gives us the most nodes that are useful,
         // breaking ties in favor of the peer that responded first.
+        std::shared_ptr<Peer> chosenPeer;
+        int chosenPeerCount = -1;
         for (auto& entry : data)
         {
             if (auto peer = entry.first.lock())
@@ -1598,10 +1641,12 @@ InboundLedger::runData()
                 }
             }
         }
-    }
 
-    if (chosenPeer)
-        trigger(chosenPeer, TriggerReason::reply);
+        // Ask for the nodes now known to be missing right away, rather
+        // than once all the data queued meanwhile is processed
+        if (chosenPeer)
+            trigger(chosenPeer, TriggerReason::reply);
+    }
 }
 
 Json::Value
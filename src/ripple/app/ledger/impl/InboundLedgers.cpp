@@ -28,6 +28,7 @@
 #include <ripple/core/JobQueue.h>
 #include <ripple/nodestore/DatabaseShard.h>
 #include <ripple/protocol/jss.h>
+#include <algorithm>
 #include <memory>
 #include <mutex>
 
@@ -48,6 +49,10 @@ public:
     // How long before we try again to acquire the same ledger
     static const std::chrono::minutes kReacquireInterval;
 
+    // How long a state node asked for by one ledger isn't asked for by
+    // the others
+    static const std::chrono::seconds kSharedNodeInterval;
+
     InboundLedgersImp(
         Schema& app,
         clock_type& clock,
@@ -59,6 +64,7 @@ public:
         , j_(app.journal("InboundLedger"))
         , m_clock(clock)
         , mRecentFailures(clock)
+        , mRequestedNodes(clock)
         , mCounter(collector->make_counter("ledger_fetches"))
         , mCount(0)
     {
@@ -268,6 +274,27 @@ public:
         }
     }
 
+    void
+    filterStateNodes(
+        LedgerHash const& ledgerHash,
+        std::vector<std::pair<SHAMapNodeID, uint256>>& nodes) override
+    {
+        std::lock_guard lock(mRequestedNodesLock);
+        beast::expire(mRequestedNodes, kSharedNodeInterval);
+
+        nodes.erase(
+            std::remove_if(
+                nodes.begin(),
+                nodes.end(),
+                [&](auto const& node) {
+                    auto const result =
+                        mRequestedNodes.emplace(node.second, ledgerHash);
+                    return !result.second &&
+                        result.first->second != ledgerHash;
+                }),
+            nodes.end());
+    }
+
     void
     clearFailures() override
     {
@@ -447,6 +474,10 @@ private:
 
     beast::aged_map<uint256, std::uint32_t> mRecentFailures;
 
+    // State node hash -> the ledger that asked for it
+    std::mutex mRequestedNodesLock;
+    beast::aged_map<uint256, uint256> mRequestedNodes;
+
     beast::insight::Counter mCounter;
     uint64_t mCount;
 };
@@ -456,6 +487,9 @@ private:
 decltype(InboundLedgersImp::kReacquireInterval)
     InboundLedgersImp::kReacquireInterval{5};
 
+decltype(InboundLedgersImp::kSharedNodeInterval)
+    InboundLedgersImp::kSharedNodeInterval{2};
+
 InboundLedgers::~InboundLedgers() = default;
 
 std::unique_ptr<InboundLedgers>
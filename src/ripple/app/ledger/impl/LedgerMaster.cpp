@@ -64,6 +64,7 @@
 #include <peersafe/gmencrypt/GmCheck.h>
 #include <peersafe/consensus/ConsensusBase.h>
 #include <peersafe/rpc/TableUtils.h>
+#include <peersafe/app/ledger/LedgerTimeline.h>
 #include <algorithm>
 #include <cassert>
 #include <limits>
@@ -2304,6 +2305,10 @@ LedgerMaster::doAdvance(std::unique_lock<std::recursive_mutex>& sl)
 
                 {
                     ScopedUnlock sul{sl};
+                    LedgerTimeline::Scope timing(
+                        app_.getLedgerTimeline(),
+                        ledger->info().seq,
+                        LedgerTimeline::publish);
                     app_.getOPs().pubLedger(ledger);
                 }
 
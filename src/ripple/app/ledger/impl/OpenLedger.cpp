@@ -27,7 +27,10 @@
 #include <ripple/protocol/Feature.h>
 #include <peersafe/schema/Schema.h>
 #include <peersafe/schema/PeerManager.h>
+#include <boost/optional.hpp>
 #include <boost/range/adaptor/transformed.hpp>
+#include <algorithm>
+#include <utility>
 
 namespace ripple {
 
@@ -35,15 +38,17 @@ OpenLedger::OpenLedger(
     std::shared_ptr<Ledger const> const& ledger,
     CachedSLEs& cache,
     beast::Journal journal)
-    : j_(journal), cache_(cache), current_(create(ledger->rules(), ledger))
+    : j_(journal)
+    , cache_(cache)
+    , current_(create(ledger->rules(), ledger))
+    , published_(clock_type::now())
 {
 }
 
 bool
 OpenLedger::empty() const
 {
-    std::lock_guard lock(modify_mutex_);
-    return current_->txCount() == 0;
+    return current()->txCount() == 0;
 }
 
 std::shared_ptr<OpenView const>
@@ -56,15 +61,67 @@ OpenLedger::current() const
 bool
 OpenLedger::modify(modify_type const& f)
 {
-    std::lock_guard lock1(modify_mutex_);
+    std::lock_guard lock(modify_mutex_);
     auto next = std::make_shared<OpenView>(*current_);
     auto const changed = f(*next, j_);
     if (changed)
+        publish(std::move(next));
+    return changed;
+}
+
+void
+OpenLedger::publish(std::shared_ptr<OpenView const> next)
+{
+    auto const now = clock_type::now();
+    // Freed, if no reader holds it, once the stats lock is released
+    std::shared_ptr<OpenView const> previous;
     {
-        std::lock_guard lock2(current_mutex_);
-        current_ = std::move(next);
+        std::lock_guard lock(current_mutex_);
+        previous = std::exchange(current_, std::move(next));
     }
-    return changed;
+
+    std::lock_guard lock(stats_mutex_);
+    ++publishes_;
+    published_ = now;
+    retired_.push_back({previous, now});
+
+    auto const held = std::remove_if(
+        retired_.begin(), retired_.end(), [](Retired const& r) {
+            return r.view.expired();
+        });
+    reclaimed_ += std::distance(held, retired_.end());
+    retired_.erase(held, retired_.end());
+}
+
+Json::Value
+OpenLedger::getJson() const
+{
+    using namespace std::chrono;
+    auto const now = clock_type::now();
+
+    Json::Value ret(Json::objectValue);
+    std::lock_guard lock(stats_mutex_);
+    ret["snapshots_published"] = std::to_string(publishes_);
+    ret["snapshots_reclaimed"] = std::to_string(reclaimed_);
+    ret["snapshot_age_ms"] = static_cast<Json::UInt>(
+        duration_cast<milliseconds>(now - published_).count());
+
+    // Readers may have let go since the last publish
+    Json::UInt held = 0;
+    boost::optional<clock_type::time_point> oldest;
+    for (auto const& r : retired_)
+    {
+        if (r.view.expired())
+            continue;
+        ++held;
+        if (!oldest)
+            oldest = r.when;
+    }
+    ret["snapshots_held"] = held;
+    if (oldest)
+        ret["oldest_held_ms"] = static_cast<Json::UInt>(
+            duration_cast<milliseconds>(now - *oldest).count());
+    return ret;
 }
 
 void
@@ -158,8 +215,7 @@ OpenLedger::accept(
     }
 
     // Switch to the new open view
-    std::lock_guard lock2(current_mutex_);
-    current_ = std::move(next);
+    publish(std::move(next));
 }
 
 //------------------------------------------------------------------------------
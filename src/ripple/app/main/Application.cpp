@@ -336,6 +336,8 @@ public:
 
         // VFALCO HACK
         m_nodeStoreScheduler->setJobQueue(*m_jobQueue);
+        m_nodeStoreScheduler->setPromethExposer(*m_promethExposer);
+        m_jobQueue->setPromethExposer(*m_promethExposer);
 
         // add (m_ledgerMaster->getPropertySource ());
     }
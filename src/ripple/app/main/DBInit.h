@@ -45,7 +45,7 @@ inline constexpr auto LgrDBName{"ledger.db"};
 inline constexpr std::array<char const*, 1> LgrDBPragma{
     {"PRAGMA journal_size_limit=1582080;"}};
 
-inline constexpr std::array<char const*, 9> LgrDBInit{
+inline constexpr std::array<char const*, 11> LgrDBInit{
     {"BEGIN TRANSACTION;",
 
      "CREATE TABLE IF NOT EXISTS Ledgers (           \
@@ -79,6 +79,13 @@ inline constexpr std::array<char const*, 9> LgrDBInit{
      "CREATE INDEX IF NOT EXISTS ValidationsByTime ON          \
         Validations(SignTime);",
 
+     "CREATE TABLE IF NOT EXISTS LedgerObjects (     \
+        LedgerHash      CHARACTER(64) PRIMARY KEY,  \
+        LedgerSeq       BIGINT UNSIGNED,            \
+        Counts          TEXT                        \
+    );",
+     "CREATE INDEX IF NOT EXISTS SeqLedgerObjects ON LedgerObjects(LedgerSeq);",
+
      "END TRANSACTION;"}};
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -95,7 +102,7 @@ inline constexpr std::array TxDBPragma
 #endif
 };
 
-inline constexpr std::array<char const*, 13> TxDBInit{
+inline constexpr std::array<char const*, 17> TxDBInit{
     {"BEGIN TRANSACTION;",
 
      "CREATE TABLE IF NOT EXISTS Transactions (          \
@@ -142,6 +149,32 @@ inline constexpr std::array<char const*, 13> TxDBInit{
      "CREATE INDEX IF NOT EXISTS AcctLgrIndex ON         \
         AccountTransactions(LedgerSeq, Account, TransID);",
 
+     "CREATE TABLE IF NOT EXISTS StatisDeltas (          \
+        StartSeq        BIGINT UNSIGNED PRIMARY KEY,    \
+        EndSeq          BIGINT UNSIGNED,                \
+        TxSuccess       BIGINT UNSIGNED,                \
+        TxFailure       BIGINT UNSIGNED,                \
+        ContractCreate  BIGINT UNSIGNED,                \
+        ContractCall    BIGINT UNSIGNED,                \
+        Accounts        BIGINT UNSIGNED                 \
+     );",
+     "CREATE TABLE IF NOT EXISTS StatisTotals (          \
+        Id              INTEGER PRIMARY KEY,            \
+        TxSuccess       BIGINT UNSIGNED,                \
+        TxFailure       BIGINT UNSIGNED,                \
+        ContractCreate  BIGINT UNSIGNED,                \
+        ContractCall    BIGINT UNSIGNED,                \
+        Accounts        BIGINT UNSIGNED                 \
+     );",
+     "CREATE TABLE IF NOT EXISTS StatisFirstSeen (       \
+        Kind            INTEGER,                        \
+        Id              CHARACTER(64),                  \
+        LedgerSeq       BIGINT UNSIGNED,                \
+        PRIMARY KEY (Kind, Id)                          \
+     );",
+     "CREATE INDEX IF NOT EXISTS StatisFirstSeenLgrIndex ON \
+        StatisFirstSeen(Kind, LedgerSeq);",
+
      "END TRANSACTION;"}};
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <ripple/app/main/GRPCServer.h>
+#include <ripple/beast/rfc2616.h>
 #include <ripple/resource/Fees.h>
 
 namespace ripple {
@@ -203,6 +204,274 @@ GRPCServerImpl::CallData<Request, Response>::getUsage()
     return app_.getResourceManager().newInboundEndpoint(endpoint.get());
 }
 
+template <class Request, class Response>
+GRPCServerImpl::StreamCallData<Request, Response>::StreamCallData(
+    org::zxcl::rpc::v1::ZXCLedgerAPIService::AsyncService& service,
+    grpc::ServerCompletionQueue& cq,
+    Application& app,
+    BindStreamListener<Request, Response> bindListener,
+    StreamHandler<Request, Response> handler,
+    RPC::Condition requiredCondition,
+    Resource::Charge loadType,
+    std::vector<beast::IP::Address> const& secureGatewayIPs)
+    : service_(service)
+    , cq_(cq)
+    , finished_(false)
+    , started_(false)
+    , app_(app)
+    , writer_(&ctx_)
+    , bindListener_(std::move(bindListener))
+    , handler_(std::move(handler))
+    , requiredCondition_(std::move(requiredCondition))
+    , loadType_(std::move(loadType))
+    , secureGatewayIPs_(secureGatewayIPs)
+{
+    bindListener_(service_, &ctx_, &request_, &writer_, &cq_, &cq_, this);
+}
+
+template <class Request, class Response>
+std::shared_ptr<Processor>
+GRPCServerImpl::StreamCallData<Request, Response>::clone()
+{
+    return std::make_shared<StreamCallData<Request, Response>>(
+        service_,
+        cq_,
+        app_,
+        bindListener_,
+        handler_,
+        requiredCondition_,
+        loadType_,
+        secureGatewayIPs_);
+}
+
+template <class Request, class Response>
+void
+GRPCServerImpl::StreamCallData<Request, Response>::process()
+{
+    // sanity check
+    BOOST_ASSERT(!started_);
+
+    std::shared_ptr<StreamCallData<Request, Response>> thisShared =
+        this->shared_from_this();
+
+    // Unlike CallData, events follow the request until the call is finished.
+    // Each is the completion of a write, see writeDone()
+    started_ = true;
+    auto coro = app_.getJobQueue().postCoro(
+        JobType::jtRPC,
+        "gRPC-Stream",
+        [thisShared](std::shared_ptr<JobQueue::Coro> coro) {
+            thisShared->process(coro);
+        });
+
+    // If coro is null, then the JobQueue has already been shutdown
+    if (!coro)
+    {
+        finish(grpc::Status{
+            grpc::StatusCode::INTERNAL, "Job Queue is already stopped"});
+    }
+}
+
+template <class Request, class Response>
+void
+GRPCServerImpl::StreamCallData<Request, Response>::process(
+    std::shared_ptr<JobQueue::Coro> coro)
+{
+    {
+        std::lock_guard lock(mutex_);
+        coro_ = coro;
+    }
+
+    try
+    {
+        auto usage = getUsage();
+        if (usage.disconnect())
+        {
+            finish(grpc::Status{
+                grpc::StatusCode::RESOURCE_EXHAUSTED,
+                "usage balance exceeds threshhold"});
+            return;
+        }
+
+        usage.charge(loadType_);
+
+        RPC::GRPCContext<Request> context{
+            {app_.journal("gRPCServer"),
+             app_.getSchema(),
+             loadType_,
+             app_.getOPs(),
+             app_.getLedgerMaster(),
+             usage,
+             getRole(),
+             coro,
+             InfoSub::pointer(),
+             apiVersion},
+            request_};
+
+        // Make sure we can currently handle the rpc
+        error_code_i conditionMetRes =
+            RPC::conditionMet(requiredCondition_, context);
+
+        if (conditionMetRes != rpcSUCCESS)
+        {
+            RPC::ErrorInfo errorInfo = RPC::get_error_info(conditionMetRes);
+            finish(grpc::Status{
+                grpc::StatusCode::FAILED_PRECONDITION,
+                errorInfo.message.c_str()});
+            return;
+        }
+
+        finish(handler_(context, [this](Response&& response) {
+            return send(std::move(response));
+        }));
+    }
+    catch (std::exception const& ex)
+    {
+        finish(grpc::Status{grpc::StatusCode::INTERNAL, ex.what()});
+    }
+}
+
+template <class Request, class Response>
+bool
+GRPCServerImpl::StreamCallData<Request, Response>::send(Response&& response)
+{
+    std::unique_lock lock(mutex_);
+    if (cancelled_)
+        return false;
+
+    // Only one write may be outstanding at a time
+    if (!writing_)
+    {
+        writing_.emplace(std::move(response));
+        writer_.Write(*writing_, this);
+        return true;
+    }
+
+    pending_.push_back(std::move(response));
+    if (pending_.size() < RPC::Tuning::grpcStreamPending)
+        return true;
+
+    // writeDone() or cancel() posts the coroutine when it may go on. If that
+    // happens before we yield, the resumption waits for the yield.
+    waiting_ = true;
+    auto const coro = coro_;
+    lock.unlock();
+    coro->yield();
+    lock.lock();
+    return !cancelled_;
+}
+
+template <class Request, class Response>
+void
+GRPCServerImpl::StreamCallData<Request, Response>::finish(
+    grpc::Status const& status)
+{
+    std::lock_guard lock(mutex_);
+    // The coroutine holds this object, so it must not be held in turn
+    coro_.reset();
+    if (cancelled_)
+        return;
+
+    if (writing_)
+    {
+        status_ = status;
+        return;
+    }
+
+    // As in CallData::process(), set before the event can be returned
+    finished_ = true;
+    writer_.Finish(status, this);
+}
+
+template <class Request, class Response>
+void
+GRPCServerImpl::StreamCallData<Request, Response>::writeDone()
+{
+    std::shared_ptr<JobQueue::Coro> wake;
+    {
+        std::lock_guard lock(mutex_);
+        writing_.reset();
+        if (!pending_.empty())
+        {
+            writing_.emplace(std::move(pending_.front()));
+            pending_.pop_front();
+            writer_.Write(*writing_, this);
+
+            if (waiting_ &&
+                pending_.size() <= RPC::Tuning::grpcStreamPending / 2)
+            {
+                waiting_ = false;
+                wake = coro_;
+            }
+        }
+        else if (status_)
+        {
+            finished_ = true;
+            writer_.Finish(*status_, this);
+        }
+    }
+    if (wake)
+        wake->post();
+}
+
+template <class Request, class Response>
+void
+GRPCServerImpl::StreamCallData<Request, Response>::cancel()
+{
+    std::shared_ptr<JobQueue::Coro> wake;
+    {
+        std::lock_guard lock(mutex_);
+        cancelled_ = true;
+        pending_.clear();
+        if (waiting_)
+        {
+            waiting_ = false;
+            wake = coro_;
+        }
+    }
+    if (wake)
+        wake->post();
+}
+
+template <class Request, class Response>
+bool
+GRPCServerImpl::StreamCallData<Request, Response>::isFinished()
+{
+    return finished_;
+}
+
+template <class Request, class Response>
+bool
+GRPCServerImpl::StreamCallData<Request, Response>::isStreaming()
+{
+    return started_;
+}
+
+template <class Request, class Response>
+Role
+GRPCServerImpl::StreamCallData<Request, Response>::getRole()
+{
+    boost::optional<beast::IP::Endpoint> endpoint =
+        beast::IP::Endpoint::from_string_checked(getEndpoint(ctx_.peer()));
+    if (endpoint &&
+        std::find(
+            secureGatewayIPs_.begin(),
+            secureGatewayIPs_.end(),
+            endpoint->address()) != secureGatewayIPs_.end())
+        return Role::IDENTIFIED;
+    return Role::USER;
+}
+
+template <class Request, class Response>
+Resource::Consumer
+GRPCServerImpl::StreamCallData<Request, Response>::getUsage()
+{
+    std::string peer = getEndpoint(ctx_.peer());
+    boost::optional<beast::IP::Endpoint> endpoint =
+        beast::IP::Endpoint::from_string_checked(peer);
+    return app_.getResourceManager().newInboundEndpoint(endpoint.get());
+}
+
 GRPCServerImpl::GRPCServerImpl(Application& app)
     : app_(app), journal_(app_.journal("gRPC Server"))
 {
@@ -229,6 +498,26 @@ GRPCServerImpl::GRPCServerImpl(Application& app)
         catch (std::exception const&)
         {
         }
+
+        std::pair<std::string, bool> gatewayPair =
+            section.find("secure_gateway");
+        if (gatewayPair.second)
+        {
+            for (auto const& ip : beast::rfc2616::split_commas(
+                     gatewayPair.first.begin(), gatewayPair.first.end()))
+            {
+                boost::system::error_code ec;
+                auto const address = boost::asio::ip::make_address(ip, ec);
+                if (ec)
+                {
+                    JLOG(journal_.error())
+                        << "Invalid secure_gateway address " << ip
+                        << " in [port_grpc]";
+                    continue;
+                }
+                secureGatewayIPs_.push_back(address);
+            }
+        }
     }
 }
 
@@ -300,11 +589,17 @@ GRPCServerImpl::handleRpcs()
         {
             JLOG(journal_.debug()) << "Request listener cancelled. "
                                    << "Destroying object";
+            ptr->cancel();
             erase(ptr);
         }
         else
         {
-            if (!ptr->isFinished())
+            if (ptr->isStreaming() && !ptr->isFinished())
+            {
+                // A message of a streamed response has been written
+                ptr->writeDone();
+            }
+            else if (!ptr->isFinished())
             {
                 JLOG(journal_.debug()) << "Received new request. Processing";
                 // ptr is now processing a request, so create a new CallData
@@ -410,6 +705,55 @@ GRPCServerImpl::setupListeners()
             RPC::NO_CONDITION,
             Resource::feeMediumBurdenRPC));
     }
+
+    {
+        using cd = StreamCallData<
+            org::zxcl::rpc::v1::StreamLedgerDataRequest,
+            org::zxcl::rpc::v1::StreamLedgerDataResponse>;
+
+        addToRequests(std::make_shared<cd>(
+            service_,
+            *cq_,
+            app_,
+            &org::zxcl::rpc::v1::ZXCLedgerAPIService::AsyncService::
+                RequestStreamLedgerData,
+            doLedgerDataStreamGrpc,
+            RPC::NO_CONDITION,
+            Resource::feeHighBurdenRPC,
+            secureGatewayIPs_));
+    }
+    {
+        using cd = StreamCallData<
+            org::zxcl::rpc::v1::StreamAccountTransactionHistoryRequest,
+            org::zxcl::rpc::v1::StreamAccountTransactionHistoryResponse>;
+
+        addToRequests(std::make_shared<cd>(
+            service_,
+            *cq_,
+            app_,
+            &org::zxcl::rpc::v1::ZXCLedgerAPIService::AsyncService::
+                RequestStreamAccountTransactionHistory,
+            doAccountTxStreamGrpc,
+            RPC::NO_CONDITION,
+            Resource::feeHighBurdenRPC,
+            secureGatewayIPs_));
+    }
+    {
+        using cd = StreamCallData<
+            org::zxcl::rpc::v1::StreamTransactionHistoryRequest,
+            org::zxcl::rpc::v1::StreamTransactionHistoryResponse>;
+
+        addToRequests(std::make_shared<cd>(
+            service_,
+            *cq_,
+            app_,
+            &org::zxcl::rpc::v1::ZXCLedgerAPIService::AsyncService::
+                RequestStreamTransactionHistory,
+            doTxHistoryStreamGrpc,
+            RPC::NO_CONDITION,
+            Resource::feeHighBurdenRPC,
+            secureGatewayIPs_));
+    }
     return requests;
 };
 
@@ -35,6 +35,10 @@
 #include "org/zxcl/rpc/v1/zxc_ledger.grpc.pb.h"
 #include <grpcpp/grpcpp.h>
 
+#include <deque>
+#include <mutex>
+#include <optional>
+
 namespace ripple {
 
 // Interface that CallData implements
@@ -65,6 +69,27 @@ public:
     // deleted once this function returns true
     virtual bool
     isFinished() = 0;
+
+    // true if this object streams its response and is processing a request.
+    // Later events are then the completion of a write, see writeDone()
+    virtual bool
+    isStreaming()
+    {
+        return false;
+    }
+
+    // a write of a streamed response has completed
+    virtual void
+    writeDone()
+    {
+    }
+
+    // the call has been cancelled, or a write of a streamed response failed.
+    // The object is deleted once this function returns
+    virtual void
+    cancel()
+    {
+    }
 };
 
 class GRPCServerImpl final
@@ -85,6 +110,9 @@ private:
 
     std::string serverAddress_;
 
+    // Clients of streaming RPCs read past the usual page only from these
+    std::vector<beast::IP::Address> secureGatewayIPs_;
+
     beast::Journal journal_;
 
     // typedef for function to bind a listener
@@ -105,6 +133,23 @@ private:
     template <class Request, class Response>
     using Handler = std::function<std::pair<Response, grpc::Status>(
         RPC::GRPCContext<Request>&)>;
+
+    // As above, for server streaming RPCs
+    template <class Request, class Response>
+    using BindStreamListener = std::function<void(
+        org::zxcl::rpc::v1::ZXCLedgerAPIService::AsyncService&,
+        grpc::ServerContext*,
+        Request*,
+        grpc::ServerAsyncWriter<Response>*,
+        grpc::CompletionQueue*,
+        grpc::ServerCompletionQueue*,
+        void*)>;
+
+    // A streaming handler passes each message to the function it is given
+    template <class Request, class Response>
+    using StreamHandler = std::function<grpc::Status(
+        RPC::GRPCContext<Request>&,
+        std::function<bool(Response&&)> const&)>;
     // This implementation is currently limited to v1 of the API
     static unsigned constexpr apiVersion = 1;
 
@@ -232,6 +277,117 @@ private:
 
     };  // CallData
 
+    // As CallData, for server streaming RPCs. The handler runs in a
+    // coroutine, which is suspended while Tuning::grpcStreamPending messages
+    // wait to be written.
+    template <class Request, class Response>
+    class StreamCallData
+        : public Processor,
+          public std::enable_shared_from_this<StreamCallData<Request, Response>>
+    {
+    private:
+        org::zxcl::rpc::v1::ZXCLedgerAPIService::AsyncService& service_;
+
+        grpc::ServerCompletionQueue& cq_;
+
+        grpc::ServerContext ctx_;
+
+        // true once Finish has been called. The event it causes is the last
+        std::atomic_bool finished_;
+
+        // true once the request has arrived
+        std::atomic_bool started_;
+
+        Application& app_;
+
+        Request request_;
+
+        grpc::ServerAsyncWriter<Response> writer_;
+
+        BindStreamListener<Request, Response> bindListener_;
+
+        StreamHandler<Request, Response> handler_;
+
+        RPC::Condition requiredCondition_;
+
+        Resource::Charge loadType_;
+
+        std::vector<beast::IP::Address> const& secureGatewayIPs_;
+
+        std::mutex mutex_;
+
+        std::shared_ptr<JobQueue::Coro> coro_;
+
+        // The message being written, and those waiting to be
+        std::optional<Response> writing_;
+        std::deque<Response> pending_;
+
+        // Set when the handler has returned, to end the call with
+        std::optional<grpc::Status> status_;
+
+        bool cancelled_ = false;
+
+        // The coroutine is suspended until the pending messages are written
+        bool waiting_ = false;
+
+    public:
+        virtual ~StreamCallData() = default;
+
+        explicit StreamCallData(
+            org::zxcl::rpc::v1::ZXCLedgerAPIService::AsyncService& service,
+            grpc::ServerCompletionQueue& cq,
+            Application& app,
+            BindStreamListener<Request, Response> bindListener,
+            StreamHandler<Request, Response> handler,
+            RPC::Condition requiredCondition,
+            Resource::Charge loadType,
+            std::vector<beast::IP::Address> const& secureGatewayIPs);
+
+        StreamCallData(const StreamCallData&) = delete;
+
+        StreamCallData&
+        operator=(const StreamCallData&) = delete;
+
+        virtual void
+        process() override;
+
+        virtual bool
+        isFinished() override;
+
+        std::shared_ptr<Processor>
+        clone() override;
+
+        bool
+        isStreaming() override;
+
+        void
+        writeDone() override;
+
+        void
+        cancel() override;
+
+    private:
+        void
+        process(std::shared_ptr<JobQueue::Coro> coro);
+
+        // Called from the coroutine. Returns false if the call is over
+        bool
+        send(Response&& response);
+
+        // End the call with the given status once every message is written
+        void
+        finish(grpc::Status const& status);
+
+        // Role::IDENTIFIED for a client at a secure_gateway address, which
+        // may read past the usual page, otherwise Role::USER
+        Role
+        getRole();
+
+        Resource::Consumer
+        getUsage();
+
+    };  // StreamCallData
+
 };  // GRPCServerImpl
 
 class GRPCServer
@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <ripple/app/main/NodeStoreScheduler.h>
+#include <peersafe/app/prometh/PrometheusClient.h>
 #include <cassert>
 
 namespace ripple {
@@ -33,6 +34,12 @@ NodeStoreScheduler::setJobQueue(JobQueue& jobQueue)
     m_jobQueue = &jobQueue;
 }
 
+void
+NodeStoreScheduler::setPromethExposer(PromethExposer& exposer)
+{
+    m_promethExposer = &exposer;
+}
+
 void
 NodeStoreScheduler::onStop()
 {
@@ -79,16 +86,22 @@ void
 NodeStoreScheduler::onFetch(NodeStore::FetchReport const& report)
 {
     if (report.wentToDisk)
+    {
         m_jobQueue->addLoadEvents(
             report.isAsync ? jtNS_ASYNC_READ : jtNS_SYNC_READ,
             1,
             report.elapsed);
+        if (m_promethExposer)
+            m_promethExposer->onNodeStoreFetch(report.isAsync, report.elapsed);
+    }
 }
 
 void
 NodeStoreScheduler::onBatchWrite(NodeStore::BatchWriteReport const& report)
 {
     m_jobQueue->addLoadEvents(jtNS_WRITE, report.writeCount, report.elapsed);
+    if (m_promethExposer)
+        m_promethExposer->onNodeStoreWrite(report.elapsed);
 }
 
 }  // namespace ripple
@@ -27,6 +27,8 @@
 
 namespace ripple {
 
+class PromethExposer;
+
 /** A NodeStore::Scheduler which uses the JobQueue and implements the Stoppable
  * API. */
 class NodeStoreScheduler : public NodeStore::Scheduler, public Stoppable
@@ -40,6 +42,9 @@ public:
     void
     setJobQueue(JobQueue& jobQueue);
 
+    void
+    setPromethExposer(PromethExposer& exposer);
+
     void
     onStop() override;
     void
@@ -56,6 +61,7 @@ private:
     doTask(NodeStore::Task& task);
 
     JobQueue* m_jobQueue{nullptr};
+    PromethExposer* m_promethExposer{nullptr};
     std::atomic<int> m_taskCount{0};
 };
 
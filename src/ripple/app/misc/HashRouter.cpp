@@ -68,6 +68,16 @@ HashRouter::addSuppressionPeer(uint256 const& key, PeerShortID peer, int& flags)
     return created;
 }
 
+std::pair<bool, boost::optional<Stopwatch::time_point>>
+HashRouter::addSuppressionPeerWithStatus(uint256 const& key, PeerShortID peer)
+{
+    std::lock_guard lock(mutex_);
+
+    auto [s, created] = emplace(key);
+    s.addPeer(peer);
+    return {created, s.relayed()};
+}
+
 bool
 HashRouter::shouldProcess(
     uint256 const& key,
@@ -108,6 +118,17 @@ HashRouter::setFlags(uint256 const& key, int flags)
     return true;
 }
 
+void
+HashRouter::clearFlags(int flags)
+{
+    assert(flags != 0);
+
+    std::lock_guard lock(mutex_);
+
+    for (auto& entry : suppressionMap_)
+        entry.second.clearFlags(flags);
+}
+
 auto
 HashRouter::shouldRelay(uint256 const& key)
     -> boost::optional<std::set<PeerShortID>>
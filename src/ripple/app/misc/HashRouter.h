@@ -42,6 +42,7 @@ namespace ripple {
 #define SF_PRIVATE4 0x0800
 #define SF_PRIVATE5 0x1000
 #define SF_PRIVATE6 0x2000
+#define SF_PRIVATE7 0x4000
 
 /** Routing table for objects identified by hash.
 
@@ -90,6 +91,12 @@ private:
             flags_ |= flagsToSet;
         }
 
+        void
+        clearFlags(int flagsToClear)
+        {
+            flags_ &= ~flagsToClear;
+        }
+
         /** Return set of peers we've relayed to and reset tracking */
         std::set<PeerShortID>
         releasePeerSet()
@@ -114,6 +121,13 @@ private:
             return true;
         }
 
+        /** When the item was last relayed, if ever. */
+        boost::optional<Stopwatch::time_point>
+        relayed() const
+        {
+            return relayed_;
+        }
+
         /** Determines if this item should be recovered from the open ledger.
 
             Counts the number of times the item has been recovered.
@@ -188,6 +202,14 @@ public:
     bool
     addSuppressionPeer(uint256 const& key, PeerShortID peer, int& flags);
 
+    /** Add a peer suppression.
+
+        @return Whether the entry was created, and when the item was last
+            relayed, if ever.
+    */
+    std::pair<bool, boost::optional<Stopwatch::time_point>>
+    addSuppressionPeerWithStatus(uint256 const& key, PeerShortID peer);
+
     // Add a peer suppression and return whether the entry should be processed
     bool
     shouldProcess(
@@ -206,6 +228,10 @@ public:
     int
     getFlags(uint256 const& key);
 
+    /** Clear the flags on every hash. */
+    void
+    clearFlags(int flags);
+
     /** Determines whether the hashed item should be relayed.
 
         Effects:
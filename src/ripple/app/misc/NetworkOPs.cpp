@@ -41,6 +41,7 @@
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/Transaction.h>
+#include <ripple/app/misc/TxBatcher.h>
 #include <ripple/app/misc/TxQ.h>
 #include <ripple/app/misc/ValidatorKeys.h>
 #include <ripple/app/misc/ValidatorList.h>
@@ -79,6 +80,8 @@
 #include <peersafe/app/tx/impl/Tuning.h>
 #include <peersafe/app/sql/TxnDBConn.h>
 #include <peersafe/app/prometh/PrometheusClient.h>
+#include <peersafe/app/ledger/LedgerTimeline.h>
+#include <peersafe/app/ledger/TxSetPreflight.h>
 #include <boost/asio/ip/host_name.hpp>
 #include <string>
 #include <tuple>
@@ -108,13 +111,18 @@ class NetworkOPsImp final : public NetworkOPs
         FailHard failType;
         bool applied;
         STer result;
+        TxBatcher::clock_type::time_point queued;
 
         TransactionStatus(
             std::shared_ptr<Transaction> t,
             bool a,
             bool l,
             FailHard f)
-            : transaction(t), admin(a), local(l), failType(f)
+            : transaction(t)
+            , admin(a)
+            , local(l)
+            , failType(f)
+            , queued(TxBatcher::clock_type::now())
         {
             assert(local || failType == FailHard::no);
         }
@@ -125,6 +133,7 @@ class NetworkOPsImp final : public NetworkOPs
      */
     enum class DispatchState : unsigned char {
         none,
+        waiting,  // for more transactions, until batchTimer_ expires
         scheduled,
         running,
     };
@@ -263,6 +272,7 @@ public:
         // OperatingMode::DISCONNECTED)
         , heartbeatTimer_(io_svc)
         , clusterTimer_(io_svc)
+        , batchTimer_(io_svc)
         , mConsensus(
               app,
               make_FeeVote(
@@ -357,9 +367,12 @@ public:
         bool bUnlimited,
         FailHard failtype);
 
-    std::pair<STer, bool>
+    /**
+     * Check a transaction before it goes into the TxPool.
+     */
+    STer
     doTransactionCheck(
-        std::shared_ptr<Transaction> transaction,
+        std::shared_ptr<Transaction> const& transaction,
         ApplyFlags flags,
         OpenView const& view);
 
@@ -374,6 +387,22 @@ public:
     void
     transactionBatch();
 
+    /**
+     * Schedule a job to apply the queued transactions, now or when the
+     * batcher expects enough of them to have arrived. Requires mMutex.
+     */
+    void
+    dispatchBatch();
+
+    /**
+     * Schedule a job to apply the queued transactions now. Requires mMutex.
+     */
+    void
+    scheduleBatch();
+
+    void
+    setBatchTimer(std::chrono::microseconds wait);
+
     /**
      * Attempt to apply transactions and post-process based on the results.
      *
@@ -513,6 +542,8 @@ public:
     clearLedgerFetch() override;
     Json::Value
     getLedgerFetchInfo() override;
+    Json::Value
+    getTxBatchInfo() override;
     bool
     checkLedgerAccept(std::shared_ptr<Ledger const> const& ledger) override;
     std::uint32_t
@@ -789,6 +820,15 @@ public:
                     << "NetworkOPs: clusterTimer cancel error: "
                     << ec.message();
             }
+
+            ec.clear();
+            batchTimer_.cancel(ec);
+            if (ec)
+            {
+                JLOG(m_journal.error())
+                    << "NetworkOPs: batchTimer cancel error: "
+                    << ec.message();
+            }
         }
         // Make sure that any waitHandlers pending in our timers are done
         // before we declare ourselves stopped.
@@ -893,6 +933,7 @@ private:
     ClosureCounter<void, boost::system::error_code const&> waitHandlerCounter_;
     boost::asio::steady_timer heartbeatTimer_;
     boost::asio::steady_timer clusterTimer_;
+    boost::asio::steady_timer batchTimer_;
 
     RCLConsensus mConsensus;
 
@@ -955,6 +996,7 @@ private:
     std::mutex mMutex;
     DispatchState mDispatchState = DispatchState::none;
     std::vector<TransactionStatus> mTransactions;
+    TxBatcher batcher_;
 
     StateAccounting accounting_{};
 
@@ -1547,6 +1589,7 @@ NetworkOPsImp::processTransaction(
     FailHard failType)
 {
     auto ev = m_job_queue.makeLoadEvent(jtTXN_PROC, "ProcessTXN");
+    app_.getPrometheusClient().onTxReceived(bLocal);
     auto const newFlags = app_.getHashRouter().getFlags(transaction->getID());
 
     if ((newFlags & SF_BAD) != 0)
@@ -1588,9 +1631,9 @@ NetworkOPsImp::processTransaction(
         doTransactionAsync(transaction, bUnlimited, failType);
 }
 
-std::pair<STer, bool>
+STer
 NetworkOPsImp::doTransactionCheck(
-    std::shared_ptr<Transaction> transaction,
+    std::shared_ptr<Transaction> const& transaction,
     ApplyFlags flags,
     OpenView const& view)
 {
@@ -1602,7 +1645,7 @@ NetworkOPsImp::doTransactionCheck(
         JLOG(m_journal.info()) << "Tx: " << txCur->getTransactionID()
                                << " already in Tx pool from " << from;
 
-        return {tefALREADY, false};
+        return tefALREADY;
     }
 
     PreflightContext const pfctx(
@@ -1610,26 +1653,14 @@ NetworkOPsImp::doTransactionCheck(
 
     auto ter = check(pfctx, view);
 
-    if (ter.ter == tesSUCCESS)
-    {
-        // after check and transaction's check result is tesSUCCESS add it to
-        // TxPool:
-        ter = app_.getTxPool().insertTx(transaction, view.seq());
-        if (ter.ter != tesSUCCESS)
-        {
-            return {ter, false};
-        }
-
-        app_.getStateManager().onTxCheckSuccess(txCur->getAccountID(sfAccount));
-        return {tesSUCCESS, true};
-    }
-    else if (ter.ter != terPRE_SEQ && ter.ter != tefPAST_SEQ)
+    if (ter.ter != tesSUCCESS && ter.ter != terPRE_SEQ &&
+        ter.ter != tefPAST_SEQ)
     {
         app_.getStateManager().addFailedSeq(
             txCur->getAccountID(sfAccount), txCur->getSequence());
     }
 
-    return {ter, false};
+    return ter;
 }
 
 STer
@@ -1732,16 +1763,9 @@ NetworkOPsImp::doTransactionAsync(
     mTransactions.push_back(
         TransactionStatus(transaction, bUnlimited, false, failType));
     transaction->setApplying();
+    batcher_.arrived(mTransactions.back().queued);
 
-    if (mDispatchState == DispatchState::none)
-    {
-        if (m_job_queue.addJob(jtBATCH, "transactionBatch", [this](Job&) {
-                transactionBatch();
-            }, app_.doJobCounter()))
-        {
-            mDispatchState = DispatchState::scheduled;
-        }
-    }
+    dispatchBatch();
 }
 
 void
@@ -1781,17 +1805,8 @@ NetworkOPsImp::doTransactionSync(
         {
             apply(lock);
 
-            if (mTransactions.size())
-            {
-                // More transactions need to be applied, but by another job.
-                if (m_job_queue.addJob(
-                        jtBATCH, "transactionBatch", [this](Job&) {
-                            transactionBatch();
-                        }, app_.doJobCounter()))
-                {
-                    mDispatchState = DispatchState::scheduled;
-                }
-            }
+            // More transactions need to be applied, but by another job.
+            dispatchBatch();
         }
     } while (transaction->getApplying());
 }
@@ -1807,6 +1822,79 @@ NetworkOPsImp::transactionBatch()
     while (mTransactions.size())
     {
         apply(lock);
+
+        // What arrived meanwhile may be worth waiting on to fill out
+        if (batcher_
+                .wait(mTransactions.size(), TxBatcher::clock_type::now())
+                .count() > 0)
+            break;
+    }
+
+    dispatchBatch();
+}
+
+void
+NetworkOPsImp::dispatchBatch()
+{
+    if (mTransactions.empty() ||
+        mDispatchState == DispatchState::scheduled ||
+        mDispatchState == DispatchState::running)
+        return;
+
+    auto const wait =
+        batcher_.wait(mTransactions.size(), TxBatcher::clock_type::now());
+    if (wait.count() == 0)
+    {
+        if (mDispatchState == DispatchState::waiting)
+        {
+            // The handler finds the batch scheduled and does nothing
+            boost::system::error_code ec;
+            batchTimer_.cancel(ec);
+        }
+        scheduleBatch();
+    }
+    else if (mDispatchState == DispatchState::none)
+    {
+        setBatchTimer(wait);
+    }
+}
+
+void
+NetworkOPsImp::scheduleBatch()
+{
+    if (m_job_queue.addJob(jtBATCH, "transactionBatch", [this](Job&) {
+            transactionBatch();
+        }, app_.doJobCounter()))
+    {
+        mDispatchState = DispatchState::scheduled;
+    }
+}
+
+void
+NetworkOPsImp::setBatchTimer(std::chrono::microseconds wait)
+{
+    // Only start the timer if waitHandlerCounter_ is not yet joined.
+    if (auto optionalCountedHandler = waitHandlerCounter_.wrap(
+            [this](boost::system::error_code const& e) {
+                if (e == boost::asio::error::operation_aborted)
+                    return;
+
+                std::lock_guard lock(mMutex);
+                // Already applied, or scheduled because the batch filled
+                if (mDispatchState != DispatchState::waiting)
+                    return;
+                mDispatchState = DispatchState::none;
+                if (!mTransactions.empty() && !app_.isShutdown())
+                    scheduleBatch();
+            }))
+    {
+        batchTimer_.expires_from_now(wait);
+        batchTimer_.async_wait(std::move(*optionalCountedHandler));
+        mDispatchState = DispatchState::waiting;
+    }
+    else
+    {
+        scheduleBatch();
     }
 }
 
@@ -1828,6 +1916,8 @@ NetworkOPsImp::apply(std::unique_lock<std::mutex>& batchLock)
 
     batchLock.unlock();
 
+    auto const start = TxBatcher::clock_type::now();
+
     {
         std::unique_lock masterLock{app_.getMasterMutex(), std::defer_lock};
         bool changed = false;
@@ -1838,6 +1928,39 @@ NetworkOPsImp::apply(std::unique_lock<std::mutex>& batchLock)
             // app_.openLedger().modify(
             //    [&](OpenView& view, beast::Journal j)
             //{
+
+            // Transactions that passed their checks go into the TxPool
+            // together, under one lock. A transaction whose account has one
+            // waiting can't be checked until that one is in: its sequence
+            // follows on.
+            std::vector<TransactionStatus*> checked;
+            std::vector<std::shared_ptr<Transaction>> toInsert;
+            hash_set<AccountID> accounts;
+            LedgerIndex checkedSeq = 0;
+            auto const insert = [&] {
+                if (checked.empty())
+                    return;
+                auto const results =
+                    app_.getTxPool().insertTxs(toInsert, checkedSeq);
+                for (std::size_t i = 0; i < checked.size(); ++i)
+                {
+                    auto& e = *checked[i];
+                    e.result = results[i];
+                    e.applied = results[i] == tesSUCCESS;
+                    if (e.applied)
+                    {
+                        app_.getStateManager().onTxCheckSuccess(
+                            e.transaction->getSTransaction()
+                                ->view()
+                                ->account);
+                    }
+                    changed = changed || e.applied;
+                }
+                checked.clear();
+                toInsert.clear();
+                accounts.clear();
+            };
+
             for (TransactionStatus& e : transactions)
             {
                 // we check before adding to the batch
@@ -1853,10 +1976,15 @@ NetworkOPsImp::apply(std::unique_lock<std::mutex>& batchLock)
                 if (e.failType == FailHard::yes)
                     flags |= tapFAIL_HARD;
 
+                auto const account =
+                    e.transaction->getSTransaction()->view()->account;
+                if (accounts.count(account))
+                    insert();
+
                 // if (mConsensus.adaptor_.getUseNewConsensus())
                 //{
-                auto const result = doTransactionCheck(
-                    e.transaction, flags, *app_.checkedOpenLedger().current());
+                auto const view = app_.checkedOpenLedger().current();
+                e.result = doTransactionCheck(e.transaction, flags, *view);
                 //}
                 // else
                 //{
@@ -1864,13 +1992,19 @@ NetworkOPsImp::apply(std::unique_lock<std::mutex>& batchLock)
                 //    //    app_, view, e.transaction->getSTransaction(),
                 //    //    flags, j);
                 //}
-                e.result = result.first;
-                e.applied = result.second;
+                e.applied = false;
+                if (e.result.ter == tesSUCCESS)
+                {
+                    checked.push_back(&e);
+                    toInsert.push_back(e.transaction);
+                    accounts.insert(account);
+                    checkedSeq = view->seq();
+                }
 
                 if (e.result.ter == tefTABLE_STORAGEERROR)
                     e.failType = FailHard::yes;
-                changed = changed || result.second;
             }
+            insert();
             // return changed;
             //});
         }
@@ -2031,9 +2165,8 @@ NetworkOPsImp::apply(std::unique_lock<std::mutex>& batchLock)
                        tx.set_deferred(e.result.ter == terQUEUED);
                        tx.set_schemaid(app_.schemaId().begin(), uint256::size());
                        // FIXME: This should be when we received it
-                       app_.peerManager().foreach(send_if_not(
-                           std::make_shared<Message>(tx, protocol::mtTRANSACTION),
-                           peer_in_set(*toSkip)));
+                       app_.peerManager().relay(
+                           tx, e.transaction->getID(), *toSkip, e.local);
                        e.transaction->setBroadcast();
                     }
                 }
@@ -2054,8 +2187,18 @@ NetworkOPsImp::apply(std::unique_lock<std::mutex>& batchLock)
 
     batchLock.lock();
 
+    auto const now = TxBatcher::clock_type::now();
+    batcher_.applied(
+        transactions.size(),
+        std::chrono::duration_cast<std::chrono::microseconds>(now - start));
+
     for (TransactionStatus& e : transactions)
+    {
         e.transaction->clearApplying();
+        batcher_.waited(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                now - e.queued));
+    }
 
     if (!submit_held.empty())
     {
@@ -2604,9 +2747,16 @@ NetworkOPsImp::mapComplete(std::shared_ptr<SHAMap> const& map, bool fromAcquire)
     app_.peerManager().foreach(
         send_always(std::make_shared<Message>(msg, protocol::mtHAVE_SET)));
 
+    // Check its transactions while consensus goes on, to skip the checks
+    // if the set is accepted
+    app_.getTxSetPreflight().verify(map, m_ledgerMaster.getClosedLedger());
+
     // We acquired it because consensus asked us to
     if (fromAcquire)
+    {
+        app_.getLedgerTimeline().txSetAcquired(map->getHash().as_uint256());
         mConsensus.gotTxSet(app_.timeKeeper().closeTime(), RCLTxSet{map});
+    }
 }
 
 void
@@ -3722,6 +3872,15 @@ NetworkOPsImp::getLedgerFetchInfo()
     return app_.getInboundLedgers().getInfo();
 }
 
+Json::Value
+NetworkOPsImp::getTxBatchInfo()
+{
+    std::lock_guard lock(mMutex);
+    auto ret = batcher_.getJson(TxBatcher::clock_type::now());
+    ret["queued"] = static_cast<Json::UInt>(mTransactions.size());
+    return ret;
+}
+
 bool
 NetworkOPsImp::checkLedgerAccept(std::shared_ptr<Ledger const> const& ledger)
 {
@@ -4279,7 +4438,7 @@ NetworkOPsImp::get_res(TER ter, std::string const& contracDetailMsg)
 void
 NetworkOPsImp::PubValidatedTxForTable(const AcceptedLedgerTx& alTx)
 {
-    auto tx = *alTx.getTxn();
+    auto const& tx = *alTx.getTxn();
     auto res = get_res(alTx.getResult(), alTx.getContractDetailMsg());
 
     auto ledger = app_.getLedgerMaster().getPublishedLedger();
@@ -4287,19 +4446,13 @@ NetworkOPsImp::PubValidatedTxForTable(const AcceptedLedgerTx& alTx)
     if (vecTxs.size() > 1)
     {
         std::list<std::pair<AccountID, std::string>> listPair;
-        for (auto& tx : vecTxs)
+        for (auto const& subTx : vecTxs)
         {
-            if (tx.isFieldPresent(sfTables))
+            auto const view = subTx.view();
+            if (!view->tables.empty())
             {
-                auto const& sTxTables = tx.getFieldArray(sfTables);
-                Blob vTableName = sTxTables[0].getFieldVL(sfTableName);
-                auto sTableName = strCopy(vTableName);
-
-                AccountID owner = beast::zero;
-                if (tx.isFieldPresent(sfOwner))
-                    owner = tx.getAccountID(sfOwner);
-                else if (tx.isFieldPresent(sfAccount))
-                    owner = tx.getAccountID(sfAccount);
+                auto sTableName = view->tables[0].nameString();
+                AccountID const& owner = view->tableOwner();
 
                 auto it = std::find_if(
                     listPair.begin(),
@@ -4313,7 +4466,7 @@ NetworkOPsImp::PubValidatedTxForTable(const AcceptedLedgerTx& alTx)
                     listPair.push_back(std::make_pair(owner, sTableName));
             }
         }
-        for (auto item : listPair)
+        for (auto const& item : listPair)
         {
             pubChainSqlTableTxs(item.first, item.second, tx, res);
         }
@@ -4324,19 +4477,11 @@ NetworkOPsImp::PubValidatedTxForTable(const AcceptedLedgerTx& alTx)
     }
     else if (vecTxs.size() == 1)
     {
-        auto txFinal = vecTxs[0];
-        if (txFinal.isFieldPresent(sfTables))
+        auto const view = vecTxs[0].view();
+        if (!view->tables.empty())
         {
-            auto const& sTxTables = txFinal.getFieldArray(sfTables);
-            auto sTableName = strCopy(sTxTables[0].getFieldVL(sfTableName));
-
-            AccountID owner = beast::zero;
-            if (txFinal.isFieldPresent(sfOwner))
-                owner = txFinal.getAccountID(sfOwner);
-            else if (txFinal.isFieldPresent(sfAccount))
-                owner = txFinal.getAccountID(sfAccount);
-
-            pubTableTxs(owner, sTableName, tx, res, true);
+            pubTableTxs(
+                view->tableOwner(), view->tables[0].nameString(), tx, res, true);
         }
     }
     else
@@ -233,6 +233,9 @@ public:
     clearLedgerFetch() = 0;
     virtual Json::Value
     getLedgerFetchInfo() = 0;
+    /** Returns the sizes and latencies of transaction batches. */
+    virtual Json::Value
+    getTxBatchInfo() = 0;
     virtual bool
     checkLedgerAccept(std::shared_ptr<Ledger const> const& ledger) = 0;
 
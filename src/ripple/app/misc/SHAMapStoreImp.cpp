@@ -670,6 +670,14 @@ SHAMapStoreImp::clearPrior(LedgerIndex lastRotated)
     if (health())
         return;
 
+    clearSql(
+        *ledgerDb_,
+        lastRotated,
+        "SELECT MIN(LedgerSeq) FROM LedgerObjects;",
+        "DELETE FROM LedgerObjects WHERE LedgerSeq < %u;");
+    if (health())
+        return;
+
     if (!app_.config().useTxTables())
         return;
     clearSql(
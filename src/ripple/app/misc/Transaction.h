@@ -223,6 +223,13 @@ public:
         mApplying = false;
     }
 
+    /** When this node first saw the transaction, in UTC milliseconds. */
+    std::uint64_t
+    getTimeCreate() const
+    {
+        return mTimeCreate;
+    }
+
     struct SubmitResult
     {
         /**
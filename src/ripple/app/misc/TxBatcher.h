@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_MISC_TXBATCHER_H_INCLUDED
+#define RIPPLE_APP_MISC_TXBATCHER_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace ripple {
+
+/** Decides how many transactions NetworkOPs applies in one batch.
+
+    Every batch has a fixed cost, from scheduling the job to taking the
+    TxPool lock, on top of the cost of each transaction in it. The batcher
+    estimates both from the batches it is told about, and the arrival rate
+    from the transactions it is told about. From these it picks the batch
+    size at which the fixed cost adds no more than a small share to each
+    transaction, as long as that many arrive within the longest delay
+    allowed. At low load this is one, so nothing waits.
+
+    Not synchronized: NetworkOPs calls it under its batch mutex.
+*/
+class TxBatcher
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    struct Setup
+    {
+        // The longest a transaction waits for its batch to fill
+        std::chrono::microseconds maxDelay{2000};
+        std::size_t maxBatch = 10000;
+        // The share of a transaction's own cost its part of the fixed
+        // cost of its batch may add
+        double overheadShare = 0.1;
+    };
+
+    /** Counts values in power of two buckets. */
+    class Histogram
+    {
+    public:
+        void
+        insert(std::uint64_t value);
+
+        std::uint64_t
+        count() const;
+
+        /** Returns the non-empty buckets, keyed by their largest value. */
+        Json::Value
+        getJson() const;
+
+    private:
+        // Bucket i holds the values below 2^i not held by bucket i - 1
+        std::array<std::uint64_t, 40> buckets_{};
+    };
+
+    TxBatcher();
+
+    explicit TxBatcher(Setup const& setup);
+
+    /** Called as each transaction is queued. */
+    void
+    arrived(clock_type::time_point now);
+
+    /** Returns how many transactions to wait for before applying. */
+    std::size_t
+    target(clock_type::time_point now) const;
+
+    /** Returns how long to wait for the rest of a batch.
+
+        Zero if the batch should be applied now.
+    */
+    std::chrono::microseconds
+    wait(std::size_t queued, clock_type::time_point now) const;
+
+    /** Called after a batch has been applied. */
+    void
+    applied(std::size_t size, std::chrono::microseconds took);
+
+    /** Called for each transaction applied, with the time since queued. */
+    void
+    waited(std::chrono::microseconds latency);
+
+    Json::Value
+    getJson(clock_type::time_point now) const;
+
+private:
+    double
+    rate(clock_type::time_point now) const;
+
+    Setup const setup_;
+
+    // Arrival rate, in transactions a second, updated once a window
+    double rate_ = 0;
+    clock_type::time_point windowStart_;
+    std::size_t windowArrivals_ = 0;
+
+    // Moving averages of batch sizes and apply times, for the fit
+    // took = overhead_ + cost_ * size
+    double meanSize_ = 0;
+    double meanTook_ = 0;
+    double meanSize2_ = 0;
+    double meanSizeTook_ = 0;
+    bool fitted_ = false;
+    // In microseconds
+    double overhead_ = 0;
+    double cost_ = 0;
+
+    std::uint64_t batches_ = 0;
+    Histogram sizes_;
+    Histogram latencies_;
+};
+
+}  // namespace ripple
+
+#endif
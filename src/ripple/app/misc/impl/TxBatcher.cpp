@@ -0,0 +1,209 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/misc/TxBatcher.h>
+#include <algorithm>
+#include <cmath>
+
+namespace ripple {
+
+namespace {
+
+// Arrivals are counted over windows this long
+constexpr std::chrono::milliseconds rateWindow{100};
+
+// Weights of the newest sample in the moving averages
+constexpr double rateWeight = 0.25;
+constexpr double fitWeight = 0.1;
+
+double
+seconds(std::chrono::steady_clock::duration d)
+{
+    return std::chrono::duration<double>(d).count();
+}
+
+}  // namespace
+
+void
+TxBatcher::Histogram::insert(std::uint64_t value)
+{
+    std::size_t bucket = 0;
+    while (value != 0 && bucket + 1 < buckets_.size())
+    {
+        value >>= 1;
+        ++bucket;
+    }
+    ++buckets_[bucket];
+}
+
+std::uint64_t
+TxBatcher::Histogram::count() const
+{
+    std::uint64_t n = 0;
+    for (auto const c : buckets_)
+        n += c;
+    return n;
+}
+
+Json::Value
+TxBatcher::Histogram::getJson() const
+{
+    Json::Value ret(Json::objectValue);
+    for (std::size_t i = 0; i < buckets_.size(); ++i)
+    {
+        if (buckets_[i] != 0)
+        {
+            auto const largest = (std::uint64_t(1) << i) - 1;
+            ret[std::to_string(largest)] =
+                static_cast<Json::UInt>(buckets_[i]);
+        }
+    }
+    return ret;
+}
+
+TxBatcher::TxBatcher() : TxBatcher(Setup{})
+{
+}
+
+TxBatcher::TxBatcher(Setup const& setup) : setup_(setup)
+{
+}
+
+void
+TxBatcher::arrived(clock_type::time_point now)
+{
+    if (windowStart_ == clock_type::time_point{})
+        windowStart_ = now;
+    ++windowArrivals_;
+
+    auto const elapsed = now - windowStart_;
+    if (elapsed < rateWindow)
+        return;
+
+    auto const observed = windowArrivals_ / seconds(elapsed);
+    // After a quiet spell the old rate says nothing about the new one
+    if (rate_ == 0 || elapsed >= 2 * rateWindow)
+        rate_ = observed;
+    else
+        rate_ += rateWeight * (observed - rate_);
+    windowStart_ = now;
+    windowArrivals_ = 0;
+}
+
+double
+TxBatcher::rate(clock_type::time_point now) const
+{
+    auto const elapsed = now - windowStart_;
+    if (elapsed >= 2 * rateWindow)
+        return windowArrivals_ / seconds(elapsed);
+    return rate_;
+}
+
+std::size_t
+TxBatcher::target(clock_type::time_point now) const
+{
+    // How many arrive while the first of them waits as long as it may
+    auto const fill = rate(now) * seconds(setup_.maxDelay);
+    if (fill < 2)
+        return 1;
+
+    auto want = static_cast<double>(setup_.maxBatch);
+    if (cost_ > 0)
+        want = overhead_ / (setup_.overheadShare * cost_);
+    else if (overhead_ <= 0)
+        want = 1;
+
+    auto const size =
+        std::min({fill, want, static_cast<double>(setup_.maxBatch)});
+    return std::max<std::size_t>(1, std::lround(size));
+}
+
+std::chrono::microseconds
+TxBatcher::wait(std::size_t queued, clock_type::time_point now) const
+{
+    auto const size = target(now);
+    if (queued >= size)
+        return std::chrono::microseconds{0};
+
+    auto const r = rate(now);
+    if (r <= 0)
+        return std::chrono::microseconds{0};
+
+    auto const us = (size - queued) / r * 1e6;
+    return std::chrono::microseconds{static_cast<std::int64_t>(
+        std::min(us, static_cast<double>(setup_.maxDelay.count())))};
+}
+
+void
+TxBatcher::applied(std::size_t size, std::chrono::microseconds took)
+{
+    if (size == 0)
+        return;
+
+    sizes_.insert(size);
+
+    double const s = size;
+    double const t = took.count();
+    auto const weight = batches_++ == 0 ? 1.0 : fitWeight;
+    meanSize_ += weight * (s - meanSize_);
+    meanTook_ += weight * (t - meanTook_);
+    meanSize2_ += weight * (s * s - meanSize2_);
+    meanSizeTook_ += weight * (s * t - meanSizeTook_);
+
+    auto const variance = meanSize2_ - meanSize_ * meanSize_;
+    if (variance >= 1)
+    {
+        cost_ = std::max(
+            0.0, (meanSizeTook_ - meanSize_ * meanTook_) / variance);
+        overhead_ = std::max(0.0, meanTook_ - cost_ * meanSize_);
+        fitted_ = true;
+    }
+    else if (!fitted_)
+    {
+        // Until the sizes vary enough to tell the two apart, take half
+        // of each batch's time to be fixed. Batching on that estimate
+        // makes the sizes vary.
+        overhead_ = meanTook_ / 2;
+        cost_ = meanTook_ / (2 * meanSize_);
+    }
+}
+
+void
+TxBatcher::waited(std::chrono::microseconds latency)
+{
+    latencies_.insert(static_cast<std::uint64_t>(
+        std::max<std::int64_t>(0, latency.count())));
+}
+
+Json::Value
+TxBatcher::getJson(clock_type::time_point now) const
+{
+    Json::Value ret(Json::objectValue);
+    ret["arrival_rate"] = static_cast<Json::UInt>(rate(now));
+    ret["target"] = static_cast<Json::UInt>(target(now));
+    ret["batches"] = static_cast<Json::UInt>(batches_);
+    ret["transactions"] = static_cast<Json::UInt>(latencies_.count());
+    ret["batch_cost_us"] = static_cast<Json::UInt>(std::lround(overhead_));
+    ret["tx_cost_us"] = cost_;
+    ret["batch_size"] = sizes_.getJson();
+    ret["latency_us"] = latencies_.getJson();
+    return ret;
+}
+
+}  // namespace ripple
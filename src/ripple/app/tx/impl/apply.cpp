@@ -20,10 +20,12 @@
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/tx/apply.h>
 #include <ripple/app/tx/applySteps.h>
+#include <ripple/app/tx/impl/Transactor.h>
 #include <ripple/basics/Log.h>
 #include <ripple/protocol/Feature.h>
 #include <ripple/app/misc/HashRouter.h>
 #include <peersafe/schema/Schema.h>
+#include <peersafe/app/ledger/TxSetPreflight.h>
 
 namespace ripple {
 
@@ -116,7 +118,13 @@ apply(
     ApplyFlags flags,
     beast::Journal j)
 {
-    auto pfresult = preflight(app, view.rules(), tx, flags, j);
+    auto pfresult = [&]() {
+        // Already checked when its consensus set was complete
+        if (app.getTxSetPreflight().passed(tx, view.rules(), flags))
+            return PreflightResult{
+                PreflightContext{app, tx, view.rules(), flags, j}, tesSUCCESS};
+        return preflight(app, view.rules(), tx, flags, j);
+    }();
     auto pcresult = preclaim(pfresult, app, view);
     return doApply(pcresult, app, view);
 }
@@ -67,6 +67,9 @@ private:
 
     block* used_ = nullptr;
     block* free_ = nullptr;
+    std::size_t allocations_ = 0;
+    std::size_t bytes_ = 0;
+    std::size_t blocks_ = 0;
 
 public:
     static constexpr auto block_size = kilobytes(256);
@@ -83,6 +86,27 @@ public:
 
     void
     deallocate(void* p);
+
+    /** Number of allocations served */
+    std::size_t
+    allocations() const
+    {
+        return allocations_;
+    }
+
+    /** Bytes requested by the allocations */
+    std::size_t
+    bytes() const
+    {
+        return bytes_;
+    }
+
+    /** Blocks obtained from the heap */
+    std::size_t
+    blocks() const
+    {
+        return blocks_;
+    }
 };
 
 }  // namespace detail
@@ -149,6 +173,13 @@ public:
     qalloc_type
     select_on_container_copy_construction() const;
 
+    /** The arena shared by this allocator and its copies */
+    detail::qalloc_impl<> const&
+    arena() const
+    {
+        return *impl_;
+    }
+
 private:
     qalloc_type select_on_copy(std::true_type) const;
 
@@ -235,6 +266,8 @@ template <class _>
 void*
 qalloc_impl<_>::allocate(std::size_t bytes, std::size_t align)
 {
+    ++allocations_;
+    bytes_ += bytes;
     if (used_)
     {
         auto const p = used_->allocate(bytes, align);
@@ -261,6 +294,7 @@ qalloc_impl<_>::allocate(std::size_t bytes, std::size_t align)
     block* const b = new (std::malloc(n)) block(n);
     if (!b)
         Throw<std::bad_alloc>();
+    ++blocks_;
     used_ = b;
     // VFALCO This has to succeed
     return used_->allocate(bytes, align);
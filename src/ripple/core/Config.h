@@ -209,6 +209,14 @@ public:
     // Compression
     bool COMPRESSION = false;
 
+    // Squelch peers relaying the messages of a validator which other peers
+    // relay already, and relay the transactions of others to fewer peers
+    bool REDUCE_RELAY_ENABLE = false;
+    // Peers kept relaying the messages of each validator
+    std::size_t REDUCE_RELAY_PEERS = 3;
+    // Percentage of the peers the transactions of others are relayed to
+    std::size_t REDUCE_RELAY_TX_PERCENT = 25;
+
     // Amendment majority time
     std::chrono::seconds AMENDMENT_MAJORITY_TIME = defaultAmendmentMajorityTime;
 
@@ -75,6 +75,31 @@ struct ConfigSection
     {
         return "remote_sync";
     }
+    static std::string
+    queryCache()
+    {
+        return "query_cache";
+    }
+    static std::string
+    tableMirror()
+    {
+        return "table_mirror";
+    }
+    static std::string
+    ledgerTimeline()
+    {
+        return "ledger_timeline";
+    }
+    static std::string
+    contractPrefetch()
+    {
+        return "contract_prefetch";
+    }
+    static std::string
+    consensusPreflight()
+    {
+        return "consensus_preflight";
+    }
 };
 
 // VFALCO TODO Rename and replace these macros with variables.
@@ -101,6 +126,7 @@ struct ConfigSection
 #define SECTION_PATH_SEARCH_MAX "path_search_max"
 #define SECTION_PEER_PRIVATE "peer_private"
 #define SECTION_PEERS_MAX "peers_max"
+#define SECTION_REDUCE_RELAY "reduce_relay"
 #define SECTION_RELAY_PROPOSALS "relay_proposals"
 #define SECTION_RELAY_VALIDATIONS "relay_validations"
 #define SECTION_RPC_STARTUP "rpc_startup"
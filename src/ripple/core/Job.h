@@ -58,6 +58,7 @@ enum JobType {
     jtBATCH,         // Apply batched transactions
 
     jtCREATE_PROMETH_SLE, // Build prometh's sle
+    jtLEDGER_OBJECTS, // Count ledger objects by type
 
     jtTABLESTORAGE,  // storage tables
     jtTableCheckHash,// check tx hash
@@ -77,6 +78,8 @@ enum JobType {
     jtTXN_DATA,      // Fetch a proposed set
     jtWAL,           // Write-ahead logging
     jtWRITE,         // Write out hashed objects
+    jtSTORAGE_PREFETCH, // Warm contract storage for a ledger being built
+    jtTX_PREFLIGHT,  // Check the transactions of a consensus set
     jtACCEPT,        // Accept a consensus ledger
     jtSWEEP,         // Sweep for stale structures
     jtMALLOC_TRIM,   // TRIM G_LIBC memory
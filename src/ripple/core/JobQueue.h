@@ -24,11 +24,13 @@
 #include <ripple/core/JobTypeData.h>
 #include <ripple/core/JobTypes.h>
 #include <ripple/core/Stoppable.h>
+#include <ripple/core/impl/JobLanes.h>
 #include <ripple/core/impl/Workers.h>
 #include <ripple/json/json_value.h>
 #include <boost/coroutine/all.hpp>
 #include <boost/range/begin.hpp>  // workaround for boost 1.72 bug
 #include <boost/range/end.hpp>    // workaround for boost 1.72 bug
+#include <atomic>
 #include <peersafe/schema/Schema.h>
 namespace ripple {
 
@@ -37,6 +39,7 @@ class PerfLog;
 }
 
 class Logs;
+class PromethExposer;
 struct Coro_create_t
 {
     explicit Coro_create_t() = default;
@@ -243,20 +246,27 @@ public:
     void
     rendezvous();
 
+    /** Report queue and run times of every job to Prometheus. */
+    void
+    setPromethExposer(PromethExposer& exposer);
+
 private:
     friend class Coro;
 
     using JobDataMap = std::map<JobType, JobTypeData>;
 
     beast::Journal m_journal;
+    // Guards adding jobs against stopping, rendezvous and suspended
+    // coroutines. Workers taking and running jobs only lock the lane of
+    // their job type.
     mutable std::mutex m_mutex;
-    std::uint64_t m_lastJob;
-    std::set<Job> m_jobSet;
+    std::atomic<std::uint64_t> m_lastJob;
+    JobLanes m_lanes;
     JobDataMap m_jobData;
     JobTypeData m_invalidJobData;
 
     // The number of jobs currently in processTask()
-    int m_processCount;
+    std::atomic<int> m_processCount;
 
     // The number of suspended coroutines
     int nSuspend_ = 0;
@@ -266,6 +276,7 @@ private:
 
     // Statistics tracking
     perf::PerfLog& perfLog_;
+    std::atomic<PromethExposer*> promethExposer_{nullptr};
     beast::insight::Collector::ptr m_collector;
     beast::insight::Gauge job_count;
     beast::insight::Hook hook;
@@ -298,78 +309,33 @@ private:
         std::string const& name,
         JobFunction const& func);
 
-    // Signals an added Job for processing.
+    // Queues a Job in the lane of its type and signals a worker if the
+    // type is below its limit.
     //
     // Pre-conditions:
     //  The JobType must be valid.
-    //  The Job must exist in mJobSet.
-    //  The Job must not have previously been queued.
+    //  m_mutex is held.
     //
     // Post-conditions:
     //  Count of waiting jobs of that type will be incremented.
     //  If JobQueue exists, and has at least one thread, Job will eventually
     //  run.
-    //
-    // Invariants:
-    //  The calling thread owns the JobLock
-    void
-    queueJob(Job const& job, std::lock_guard<std::mutex> const& lock);
-
-    // Returns the next Job we should run now.
-    //
-    // RunnableJob:
-    //  A Job in the JobSet whose slots count for its type is greater than zero.
-    //
-    // Pre-conditions:
-    //  mJobSet must not be empty.
-    //  mJobSet holds at least one RunnableJob
-    //
-    // Post-conditions:
-    //  job is a valid Job object.
-    //  job is removed from mJobQueue.
-    //  Waiting job count of its type is decremented
-    //  Running job count of its type is incremented
-    //
-    // Invariants:
-    //  The calling thread owns the JobLock
-    void
-    getNextJob(Job& job);
-
-    // Indicates that a running Job has completed its task.
-    //
-    // Pre-conditions:
-    //  Job must not exist in mJobSet.
-    //  The JobType must not be invalid.
-    //
-    // Post-conditions:
-    //  The running count of that JobType is decremented
-    //  A new task is signaled if there are more waiting Jobs than the limit, if
-    //  any.
-    //
-    // Invariants:
-    //  <none>
     void
-    finishJob(JobType type);
+    queueJob(Job&& job);
 
     // Runs the next appropriate waiting Job.
     //
     // Pre-conditions:
-    //  A RunnableJob must exist in the JobSet
+    //  A worker was signaled for a Job in the lanes
     //
     // Post-conditions:
-    //  The chosen RunnableJob will have Job::doJob() called.
+    //  The highest priority signaled Job will have Job::doJob() called.
     //
     // Invariants:
     //  <none>
     void
     processTask(int instance) override;
 
-    // Returns the limit of running jobs for the given job type.
-    // For jobs with no limit, we return the largest int. Hopefully that
-    // will be enough.
-    int
-    getJobLimit(JobType type);
-
     void
     onChildrenStopped() override;
 };
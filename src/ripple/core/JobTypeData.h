@@ -38,15 +38,6 @@ public:
     /* The job category which we represent */
     JobTypeInfo const& info;
 
-    /* The number of jobs waiting */
-    int waiting;
-
-    /* The number presently running */
-    int running;
-
-    /* And the number we deferred executing because of job limits */
-    int deferred;
-
     /* Notification callbacks */
     beast::insight::Event dequeue;
     beast::insight::Event execute;
@@ -58,9 +49,6 @@ public:
         : m_load(logs.journal("LoadMonitor"))
         , m_collector(collector)
         , info(info_)
-        , waiting(0)
-        , running(0)
-        , deferred(0)
     {
         m_load.setTargetLatency(
             info.getAverageLatency(), info.getPeakLatency());
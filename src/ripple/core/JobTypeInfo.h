@@ -41,6 +41,10 @@ private:
     std::chrono::milliseconds const m_avgLatency;
     std::chrono::milliseconds const m_peakLatency;
 
+    /** How long a job may wait in the queue before lower priority job
+        types are throttled in its favor. 0 is none specified */
+    std::chrono::milliseconds const m_queueTarget;
+
 public:
     // Not default constructible
     JobTypeInfo() = delete;
@@ -51,13 +55,15 @@ public:
         int limit,
         bool special,
         std::chrono::milliseconds avgLatency,
-        std::chrono::milliseconds peakLatency)
+        std::chrono::milliseconds peakLatency,
+        std::chrono::milliseconds queueTarget = std::chrono::milliseconds{0})
         : m_type(type)
         , m_name(std::move(name))
         , m_limit(limit)
         , m_special(special)
         , m_avgLatency(avgLatency)
         , m_peakLatency(peakLatency)
+        , m_queueTarget(queueTarget)
     {
     }
 
@@ -96,6 +102,12 @@ public:
     {
         return m_peakLatency;
     }
+
+    std::chrono::milliseconds
+    getQueueTarget() const
+    {
+        return m_queueTarget;
+    }
 };
 
 }  // namespace ripple
@@ -48,21 +48,23 @@ add(    jtPUBOLDLEDGER,  "publishAcqLedger",        2,        false, 10000ms, 15
 add(    jtCONSENSUS_ut,  "untrustedConsensus",      maxLimit, false, 2000ms,  5000ms);
 add(    jtTRANSACTION_l, "localTransaction",        maxLimit, false, 100ms,   500ms);
 add(    jtLEDGER_REQ,    "ledgerRequest",           2,        false, 0ms,     0ms);
-add(    jtLEDGER_DATA,   "ledgerData",              2,        false, 0ms,     0ms);
+add(    jtLEDGER_DATA,   "ledgerData",              4,        false, 0ms,     0ms);
 add(    jtCLIENT,        "clientCommand",           maxLimit, false, 2000ms,  5000ms);
 add(    jtRPC,           "RPC",                     maxLimit, false, 0ms,     0ms);
 add(    jtUPDATE_PF,     "updatePaths",             maxLimit, false, 0ms,     0ms);
 add(    jtTRANSACTION,   "transaction",             maxLimit, false, 250ms,   1000ms);
 add(    jtBROADCASTBATCH,"transaction_batch",       1,        false, 250ms,   1000ms);
 add(    jtBATCH,         "batch",                   maxLimit, false, 250ms,   1000ms);
-add(    jtADVANCE,       "advanceLedger",           maxLimit, false, 0ms,     0ms);
-add(    jtPUBLEDGER,     "publishNewLedger",        maxLimit, false, 3000ms,  4500ms);
+add(    jtADVANCE,       "advanceLedger",           maxLimit, false, 0ms,     0ms,     250ms);
+add(    jtPUBLEDGER,     "publishNewLedger",        maxLimit, false, 3000ms,  4500ms,  250ms);
 add(	jtSYNC_SCHEMA,	 "syncSchema",				1,        false, 500ms,   1500ms);
 add(    jtTXN_DATA,      "fetchTxnData",            1,        false, 0ms,     0ms);
 add(    jtWAL,           "writeAhead",              maxLimit, false, 1000ms,  2500ms);
-add(    jtCONSENSUS_t,   "trustedConsensus",        2,        false, 500ms,  1500ms);
+add(    jtCONSENSUS_t,   "trustedConsensus",        2,        false, 500ms,  1500ms,   100ms);
 add(    jtWRITE,         "writeObjects",            maxLimit, false, 1750ms,  2500ms);
-add(    jtACCEPT,        "acceptLedger",            maxLimit, false, 0ms,     0ms);
+add(    jtSTORAGE_PREFETCH, "storagePrefetch",      4,        false, 0ms,     0ms);
+add(    jtTX_PREFLIGHT,  "txSetPreflight",          maxLimit, false, 0ms,     0ms);
+add(    jtACCEPT,        "acceptLedger",            maxLimit, false, 0ms,     0ms,     100ms);
 add(    jtSWEEP,         "sweep",                   maxLimit, false, 0ms,     0ms);
 add(    jtMALLOC_TRIM,   "malloc_trim",             1,        false, 0ms,     0ms);
 add(    jtNETOP_CLUSTER, "clusterReport",           1,        false, 9999ms,  9999ms);
@@ -91,6 +93,7 @@ add(    jtNS_ASYNC_READ, "AsyncReadNode",           0,        true,  0ms,     0m
 add(    jtNS_WRITE,      "WriteNode",               0,        true,  0ms,     0ms);
 add(    jtSTOP_SCHEMA,   "StopSchema",              maxLimit, false, 0ms,     15000ms);
 add(    jtCREATE_PROMETH_SLE, "CreatePromethSle",   1,        false, 250ms,   15000ms);
+add(    jtLEDGER_OBJECTS, "countLedgerObjects",     1,        false, 0ms,     0ms);
     }
 
 public:
@@ -155,7 +158,8 @@ private:
         int limit,
         bool special,
         std::chrono::milliseconds avgLatency,
-        std::chrono::milliseconds peakLatency)
+        std::chrono::milliseconds peakLatency,
+        std::chrono::milliseconds queueTarget = std::chrono::milliseconds{0})
     {
         assert(m_map.find(jt) == m_map.end());
 
@@ -163,7 +167,13 @@ private:
             std::piecewise_construct,
             std::forward_as_tuple(jt),
             std::forward_as_tuple(
-                jt, name, limit, special, avgLatency, peakLatency));
+                jt,
+                name,
+                limit,
+                special,
+                avgLatency,
+                peakLatency,
+                queueTarget));
 
         assert(inserted == true);
         (void)_;
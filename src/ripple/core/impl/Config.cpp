@@ -785,6 +785,22 @@ Config::loadFromString(std::string const& fileContents)
     if (getSingleSection(secConfig, SECTION_COMPRESSION, strTemp, j_))
         COMPRESSION = beast::lexicalCastThrow<bool>(strTemp);
 
+    if (exists(SECTION_REDUCE_RELAY))
+    {
+        auto const& sec = section(SECTION_REDUCE_RELAY);
+        set(REDUCE_RELAY_ENABLE, "enable", sec);
+        set(REDUCE_RELAY_PEERS, "selected_peers", sec);
+        if (REDUCE_RELAY_PEERS < 1 || REDUCE_RELAY_PEERS > 10)
+            Throw<std::runtime_error>(
+                "Invalid " SECTION_REDUCE_RELAY
+                ", selected_peers must be between 1 and 10");
+        set(REDUCE_RELAY_TX_PERCENT, "tx_relay_percentage", sec);
+        if (REDUCE_RELAY_TX_PERCENT < 10 || REDUCE_RELAY_TX_PERCENT > 100)
+            Throw<std::runtime_error>(
+                "Invalid " SECTION_REDUCE_RELAY
+                ", tx_relay_percentage must be between 10 and 100");
+    }
+
     if (getSingleSection(
             secConfig, SECTION_AMENDMENT_MAJORITY_TIME, strTemp, j_))
     {
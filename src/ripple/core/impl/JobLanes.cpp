@@ -0,0 +1,332 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <ripple/core/JobTypes.h>
+#include <ripple/core/impl/JobLanes.h>
+#include <boost/optional.hpp>
+#include <algorithm>
+#include <cassert>
+#include <thread>
+
+namespace ripple {
+
+// The worker thread instance running on this thread, if any
+static thread_local int workerInstance = -1;
+
+// Job types whose jobs don't depend on each other and may start in any
+// order. Every other type keeps one shard, so its jobs start in the order
+// they were queued: ledger data, transactions and the batches of a peer
+// rely on that.
+static bool
+unordered(JobType type)
+{
+    switch (type)
+    {
+        case jtTX_PREFLIGHT:  // chunks of one transaction set
+        case jtUPDATE_PF:     // path requests, each on its own
+            return true;
+        default:
+            return false;
+    }
+}
+
+static std::size_t const maxShards = 16;
+
+JobLanes::Lane::Lane(
+    JobType type_,
+    int limit_,
+    clock_type::duration target_,
+    std::size_t shardCount)
+    : type(type_), staticLimit(limit_), target(target_), limit(limit_)
+{
+    if (!unordered(type))
+        shardCount = 1;
+    shards.reserve(shardCount);
+    for (std::size_t i = 0; i < shardCount; ++i)
+        shards.push_back(std::make_unique<Shard>());
+}
+
+std::size_t
+JobLanes::defaultShards()
+{
+    return std::clamp<std::size_t>(
+        std::thread::hardware_concurrency(), 1, maxShards);
+}
+
+JobLanes::JobLanes(std::size_t shards)
+    : shardCount_(std::max<std::size_t>(shards, 1))
+{
+    for (auto const& x : JobTypes::instance())
+    {
+        JobTypeInfo const& info = x.second;
+        if (info.special())
+            continue;
+        auto const index = static_cast<std::size_t>(info.type());
+        if (lanes_.size() <= index)
+            lanes_.resize(index + 1);
+        lanes_[index] = std::make_unique<Lane>(
+            info.type(), info.limit(), info.getQueueTarget(), shardCount_);
+    }
+}
+
+JobLanes::Lane*
+JobLanes::lane(JobType type) const
+{
+    auto const index = static_cast<std::size_t>(type);
+    if (type == jtINVALID || index >= lanes_.size())
+        return nullptr;
+    return lanes_[index].get();
+}
+
+bool
+JobLanes::push(Job&& job)
+{
+    Lane* const l = lane(job.getType());
+    assert(l);
+    auto const& shards = l->shards;
+    auto const shard = workerInstance >= 0
+        ? static_cast<std::size_t>(workerInstance) % shards.size()
+        : nextShard_++ % shards.size();
+    {
+        std::lock_guard lock(shards[shard]->mutex);
+        shards[shard]->jobs.push_back(std::move(job));
+    }
+
+    {
+        std::lock_guard lock(l->mutex);
+        if (l->takers > 0)
+            l->queued.notify_all();
+        if (l->waiting++ == 0)
+            l->waitingSince = clock_type::now();
+        ++size_;
+        if (l->ready + l->running >= l->limit)
+        {
+            ++l->deferred;
+            return false;
+        }
+        l->readyHint = ++l->ready;
+    }
+    signalReady();
+    return true;
+}
+
+Job
+JobLanes::pop(int instance)
+{
+    workerInstance = instance;
+    for (;;)
+    {
+        // A ready count that grows after this is seen is also signaled
+        auto const generation = readyGeneration_.load();
+        for (auto it = lanes_.rbegin(); it != lanes_.rend(); ++it)
+        {
+            Lane* const l = it->get();
+            if (!l || l->readyHint.load(std::memory_order_relaxed) <= 0)
+                continue;
+            {
+                std::lock_guard lock(l->mutex);
+                if (l->ready == 0)
+                    continue;
+                l->readyHint = --l->ready;
+                --l->waiting;
+                ++l->running;
+                --size_;
+                l->lastPop = clock_type::now();
+            }
+            return take(*l, instance);
+        }
+        // The job we were signaled for was claimed by a worker that got
+        // here first; the one it was signaled for shows up shortly.
+        std::unique_lock lock(sleepMutex_);
+        ++sleepers_;
+        readyCond_.wait(
+            lock, [&] { return readyGeneration_.load() != generation; });
+        --sleepers_;
+    }
+}
+
+Job
+JobLanes::take(Lane& lane, int instance)
+{
+    // Own shard first, then steal. A claimed job is in some shard already.
+    auto const& shards = lane.shards;
+    auto const first = static_cast<std::size_t>(std::max(instance, 0));
+    auto const steal = [&]() -> boost::optional<Job> {
+        for (std::size_t i = 0; i < shards.size(); ++i)
+        {
+            auto& shard = *shards[(first + i) % shards.size()];
+            std::lock_guard lock(shard.mutex);
+            if (!shard.jobs.empty())
+            {
+                Job job = std::move(shard.jobs.front());
+                shard.jobs.pop_front();
+                return job;
+            }
+        }
+        return boost::none;
+    };
+    if (auto job = steal())
+        return std::move(*job);
+
+    // Another worker took the job from a shard we hadn't reached yet, and
+    // ours went to a shard we already passed. Jobs are added to a shard
+    // before the lane mutex is taken to count them, so a scan under that
+    // mutex can't miss one without being notified.
+    std::unique_lock lock(lane.mutex);
+    ++lane.takers;
+    boost::optional<Job> job;
+    lane.queued.wait(lock, [&] { return (job = steal()).is_initialized(); });
+    --lane.takers;
+    return std::move(*job);
+}
+
+int
+JobLanes::finish(JobType type, std::chrono::microseconds queueTime)
+{
+    Lane* const l = lane(type);
+    assert(l);
+    int released;
+    {
+        std::lock_guard lock(l->mutex);
+        --l->running;
+        l->waitSum += queueTime;
+        ++l->waitCount;
+        released = release(*l);
+    }
+
+    if (adaptive_.load(std::memory_order_relaxed))
+    {
+        auto const now = clock_type::now();
+        auto next = nextAdapt_.load(std::memory_order_relaxed);
+        if (now.time_since_epoch().count() >= next &&
+            nextAdapt_.compare_exchange_strong(
+                next, (now + adaptInterval).time_since_epoch().count()))
+            released += adapt(now);
+    }
+    if (released > 0)
+        signalReady();
+    return released;
+}
+
+int
+JobLanes::release(Lane& lane)
+{
+    int released = 0;
+    while (lane.deferred > 0 && lane.ready + lane.running < lane.limit)
+    {
+        --lane.deferred;
+        ++lane.ready;
+        ++released;
+    }
+    lane.readyHint = lane.ready;
+    return released;
+}
+
+int
+JobLanes::adapt(clock_type::time_point now)
+{
+    // The highest priority lane whose jobs wait longer than its target
+    auto missed = lanes_.size();
+    for (std::size_t i = 0; i < lanes_.size(); ++i)
+    {
+        Lane* const l = lanes_[i].get();
+        if (!l || l->target == clock_type::duration::zero())
+            continue;
+        std::lock_guard lock(l->mutex);
+        auto const waited =
+            l->waitCount ? l->waitSum / l->waitCount : clock_type::duration{};
+        // Jobs that can't get a thread at all leave no samples
+        auto const stalled = l->waiting > 0 &&
+            now - std::max(l->waitingSince, l->lastPop) > l->target;
+        if (waited > l->target || stalled)
+            missed = i;
+        l->waitSum = {};
+        l->waitCount = 0;
+    }
+
+    int const threads = threads_.load();
+    int released = 0;
+    for (std::size_t i = 0; i < lanes_.size(); ++i)
+    {
+        Lane* const l = lanes_[i].get();
+        if (!l || l->staticLimit <= 1)
+            continue;
+        std::lock_guard lock(l->mutex);
+        if (missed != lanes_.size() && i < missed)
+        {
+            l->limit = std::max(1, std::min(l->limit, threads) / 2);
+        }
+        else if (l->limit < l->staticLimit)
+        {
+            l->limit = l->limit + 1 >= threads ? l->staticLimit : l->limit + 1;
+            released += release(*l);
+        }
+    }
+    return released;
+}
+
+void
+JobLanes::signalReady()
+{
+    ++readyGeneration_;
+    if (sleepers_.load() > 0)
+    {
+        // Taking the mutex orders this after a sleeper's predicate check
+        std::lock_guard lock(sleepMutex_);
+        readyCond_.notify_all();
+    }
+}
+
+void
+JobLanes::setThreadCount(int threads)
+{
+    threads_ = std::max(threads, 1);
+}
+
+void
+JobLanes::setAdaptive(bool adaptive)
+{
+    adaptive_ = adaptive;
+}
+
+int
+JobLanes::waiting(JobType type) const
+{
+    Lane* const l = lane(type);
+    return l ? l->waiting.load() : 0;
+}
+
+int
+JobLanes::running(JobType type) const
+{
+    Lane* const l = lane(type);
+    return l ? l->running.load() : 0;
+}
+
+int
+JobLanes::limit(JobType type) const
+{
+    Lane* const l = lane(type);
+    if (!l)
+        return 0;
+    std::lock_guard lock(l->mutex);
+    return l->limit;
+}
+
+}  // namespace ripple
@@ -0,0 +1,205 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifndef RIPPLE_CORE_JOBLANES_H_INCLUDED
+#define RIPPLE_CORE_JOBLANES_H_INCLUDED
+
+#include <ripple/core/Job.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+/** The queues behind the JobQueue's worker threads.
+
+    Every job type has its own lane, so job types don't contend on a
+    common lock. Workers always take from the highest priority lane that
+    has a job they were signaled for.
+
+    Lanes of the few job types whose jobs may start in any order are
+    split into shards, one per worker thread: a job queued from a worker
+    goes to that worker's shard, which the worker drains first before
+    stealing from the others. All other lanes keep a single shard and
+    start their jobs in the order they were queued, as the single
+    queue did.
+
+    Besides the static limits of JobTypes, the number of running jobs of
+    a type adapts to the queue targets of higher priority types: when
+    jobs of a type with a target wait longer than it, job types of lower
+    priority get their limit halved, and it grows back once no target is
+    missed.
+
+    Each job queued or released for running is signaled exactly once to
+    the worker threads, which then call pop() once per signal. A worker
+    whose job was claimed by another one sleeps until a job is made ready
+    again rather than spinning.
+*/
+class JobLanes
+{
+public:
+    using clock_type = Job::clock_type;
+
+    // How often limits are adjusted to the queue targets
+    static constexpr std::chrono::milliseconds adaptInterval{100};
+
+    explicit JobLanes(std::size_t shards = defaultShards());
+
+    JobLanes(JobLanes const&) = delete;
+    JobLanes&
+    operator=(JobLanes const&) = delete;
+
+    /** Queues a job.
+
+        @return true if a worker must be signaled to run it, false if it
+                waits for its job type to drop below its limit.
+    */
+    bool
+    push(Job&& job);
+
+    /** Removes the job to run next, for a signaled worker. */
+    Job
+    pop(int instance);
+
+    /** Records that a job popped earlier has finished.
+
+        @return The number of waiting jobs now allowed to run. Each needs a
+                worker to be signaled.
+    */
+    int
+    finish(JobType type, std::chrono::microseconds queueTime);
+
+    /** Sets the number of worker threads that limits are scaled to. */
+    void
+    setThreadCount(int threads);
+
+    /** Turns limits adapting to queue targets on or off.
+        Call before any job is queued.
+    */
+    void
+    setAdaptive(bool adaptive);
+
+    /** Jobs of this type waiting to run. */
+    int
+    waiting(JobType type) const;
+
+    /** Jobs of this type running. */
+    int
+    running(JobType type) const;
+
+    /** The number of jobs of this type that may run at once. */
+    int
+    limit(JobType type) const;
+
+    /** Jobs of all types waiting to run. */
+    std::size_t
+    size() const
+    {
+        return size_.load();
+    }
+
+    static std::size_t
+    defaultShards();
+
+private:
+    struct Shard
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    struct Lane
+    {
+        Lane(
+            JobType type,
+            int limit,
+            clock_type::duration target,
+            std::size_t shards);
+
+        JobType const type;
+        int const staticLimit;
+        clock_type::duration const target;
+        std::vector<std::unique_ptr<Shard>> shards;
+
+        // Guards the counts and statistics below
+        std::mutex mutable mutex;
+        // Signaled with `mutex` when a job is added to a shard that a
+        // worker found empty
+        std::condition_variable queued;
+        int takers = 0;
+
+        // Jobs signaled to a worker but not yet popped
+        int ready = 0;
+        // Jobs held back by the limit
+        int deferred = 0;
+        int limit;
+
+        // Also read without the lock
+        std::atomic<int> waiting{0};
+        std::atomic<int> running{0};
+        std::atomic<int> readyHint{0};
+
+        clock_type::duration waitSum{0};
+        int waitCount = 0;
+        clock_type::time_point waitingSince;
+        clock_type::time_point lastPop;
+    };
+
+    Lane*
+    lane(JobType type) const;
+
+    Job
+    take(Lane& lane, int instance);
+
+    // Lets deferred jobs run while the lane is below its limit.
+    // Requires the lane mutex.
+    static int
+    release(Lane& lane);
+
+    int
+    adapt(clock_type::time_point now);
+
+    // Wakes workers sleeping in pop() after a lane's ready count grew
+    void
+    signalReady();
+
+    std::size_t const shardCount_;
+    // Indexed by job type
+    std::vector<std::unique_ptr<Lane>> lanes_;
+    std::atomic<std::size_t> size_{0};
+    std::atomic<std::size_t> nextShard_{0};
+    std::atomic<int> threads_{1};
+    std::atomic<bool> adaptive_{true};
+    std::atomic<clock_type::rep> nextAdapt_{0};
+
+    // Bumped whenever a lane's ready count grows
+    std::atomic<std::uint64_t> readyGeneration_{0};
+    std::atomic<int> sleepers_{0};
+    std::mutex sleepMutex_;
+    std::condition_variable readyCond_;
+};
+
+}  // namespace ripple
+
+#endif
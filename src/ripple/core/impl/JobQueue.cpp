@@ -20,6 +20,7 @@
 #include <ripple/basics/PerfLog.h>
 #include <ripple/basics/contract.h>
 #include <ripple/core/JobQueue.h>
+#include <peersafe/app/prometh/PrometheusClient.h>
 
 namespace ripple {
 
@@ -69,8 +70,7 @@ JobQueue::~JobQueue()
 void
 JobQueue::collect()
 {
-    std::lock_guard lock(m_mutex);
-    job_count = m_jobSet.size();
+    job_count = m_lanes.size();
 }
 
 bool
@@ -93,6 +93,8 @@ JobQueue::addRefCountedJob(
     assert(type == jtCLIENT || m_workers.getNumberOfThreads() > 0);
 
     {
+        // Checked and queued together, so checkStopped() can't stop the
+        // queue in between
         std::lock_guard lock(m_mutex);
 
         // If this goes off it means that a child didn't follow
@@ -108,11 +110,11 @@ JobQueue::addRefCountedJob(
         //
         assert(
             !isStopped() &&
-            (m_processCount > 0 || !m_jobSet.empty() || !areChildrenStopped()));
+            (m_processCount > 0 || m_lanes.size() > 0 ||
+             !areChildrenStopped()));
 
-        std::pair<std::set<Job>::iterator, bool> result(m_jobSet.insert(
-            Job(type, name, ++m_lastJob, data.load(), func, m_cancelCallback)));
-        queueJob(*result.first, lock);
+        queueJob(
+            Job(type, name, ++m_lastJob, data.load(), func, m_cancelCallback));
     }
     return true;
 }
@@ -120,21 +122,13 @@ JobQueue::addRefCountedJob(
 int
 JobQueue::getJobCount(JobType t) const
 {
-    std::lock_guard lock(m_mutex);
-
-    JobDataMap::const_iterator c = m_jobData.find(t);
-
-    return (c == m_jobData.end()) ? 0 : c->second.waiting;
+    return m_lanes.waiting(t);
 }
 
 int
 JobQueue::getJobCountTotal(JobType t) const
 {
-    std::lock_guard lock(m_mutex);
-
-    JobDataMap::const_iterator c = m_jobData.find(t);
-
-    return (c == m_jobData.end()) ? 0 : (c->second.waiting + c->second.running);
+    return m_lanes.waiting(t) + m_lanes.running(t);
 }
 
 int
@@ -143,12 +137,10 @@ JobQueue::getJobCountGE(JobType t) const
     // return the number of jobs at this priority level or greater
     int ret = 0;
 
-    std::lock_guard lock(m_mutex);
-
     for (auto const& x : m_jobData)
     {
         if (x.first >= t)
-            ret += x.second.waiting;
+            ret += m_lanes.waiting(x.first);
     }
 
     return ret;
@@ -174,6 +166,7 @@ JobQueue::setThreadCount(int c, bool const standaloneMode)
                                << " validation/transaction/proposal threads.";
     }
 
+    m_lanes.setThreadCount(c);
     m_workers.setNumberOfThreads(c);
 }
 
@@ -224,8 +217,6 @@ JobQueue::getJson(int c)
 
     Json::Value priorities = Json::arrayValue;
 
-    std::lock_guard lock(m_mutex);
-
     for (auto& x : m_jobData)
     {
         assert(x.first != jtINVALID);
@@ -237,8 +228,9 @@ JobQueue::getJson(int c)
 
         LoadMonitor::Stats stats(data.stats());
 
-        int waiting(data.waiting);
-        int running(data.running);
+        int waiting(m_lanes.waiting(x.first));
+        int running(m_lanes.running(x.first));
+        int limit(m_lanes.limit(x.first));
 
         if ((stats.count != 0) || (waiting != 0) ||
             (stats.latencyPeak != 0ms) || (running != 0))
@@ -264,6 +256,9 @@ JobQueue::getJson(int c)
 
             if (running != 0)
                 pri["in_progress"] = running;
+
+            if (limit < data.info.limit())
+                pri["limit"] = limit;
         }
     }
 
@@ -276,7 +271,14 @@ void
 JobQueue::rendezvous()
 {
     std::unique_lock<std::mutex> lock(m_mutex);
-    cv_.wait(lock, [&] { return m_processCount == 0 && m_jobSet.empty(); });
+    cv_.wait(
+        lock, [&] { return m_processCount == 0 && m_lanes.size() == 0; });
+}
+
+void
+JobQueue::setPromethExposer(PromethExposer& exposer)
+{
+    promethExposer_.store(&exposer, std::memory_order_relaxed);
 }
 
 JobTypeData&
@@ -312,103 +314,35 @@ JobQueue::checkStopped(std::lock_guard<std::mutex> const& lock)
     //  5. There are no suspended coroutines
     //
     if (isStopping() && areChildrenStopped() && (m_processCount == 0) &&
-        m_jobSet.empty() && nSuspend_ == 0)
+        m_lanes.size() == 0 && nSuspend_ == 0)
     {
         stopped();
     }
 }
 
 void
-JobQueue::queueJob(Job const& job, std::lock_guard<std::mutex> const& lock)
+JobQueue::queueJob(Job&& job)
 {
     JobType const type(job.getType());
     assert(type != jtINVALID);
-    assert(m_jobSet.find(job) != m_jobSet.end());
     perfLog_.jobQueue(type);
 
-    JobTypeData& data(getJobTypeData(type));
-
-    if (data.waiting + data.running < getJobLimit(type))
-    {
-        m_workers.addTask();
-    }
-    else
-    {
-        // defer the task until we go below the limit
-        //
-        ++data.deferred;
-    }
-    ++data.waiting;
-}
-
-void
-JobQueue::getNextJob(Job& job)
-{
-    assert(!m_jobSet.empty());
-
-    std::set<Job>::const_iterator iter;
-    for (iter = m_jobSet.begin(); iter != m_jobSet.end(); ++iter)
-    {
-        JobTypeData& data(getJobTypeData(iter->getType()));
-
-        assert(data.running <= getJobLimit(data.type()));
-
-        // Run this job if we're running below the limit.
-        if (data.running < getJobLimit(data.type()))
-        {
-            assert(data.waiting > 0);
-            break;
-        }
-    }
-
-    assert(iter != m_jobSet.end());
-
-    JobType const type = iter->getType();
-    JobTypeData& data(getJobTypeData(type));
-
-    assert(type != jtINVALID);
-
-    job = *iter;
-    m_jobSet.erase(iter);
-
-    --data.waiting;
-    ++data.running;
-}
-
-void
-JobQueue::finishJob(JobType type)
-{
-    assert(type != jtINVALID);
-
-    JobTypeData& data = getJobTypeData(type);
-
-    // Queue a deferred task if possible
-    if (data.deferred > 0)
-    {
-        assert(data.running + data.waiting >= getJobLimit(type));
-
-        --data.deferred;
+    if (m_lanes.push(std::move(job)))
         m_workers.addTask();
-    }
-
-    --data.running;
 }
 
 void
 JobQueue::processTask(int instance)
 {
     JobType type;
+    std::chrono::microseconds queueTime;
 
     {
         using namespace std::chrono;
         Job::clock_type::time_point const start_time(Job::clock_type::now());
         {
-            Job job;
-            {
-                std::lock_guard lock(m_mutex);
-                getNextJob(job);
-                ++m_processCount;
-            }
+            ++m_processCount;
+            Job job = m_lanes.pop(instance);
             type = job.getType();
             JobTypeData& data(getJobTypeData(type));
             JLOG(m_journal.trace()) << "Doing " << data.name() << "job";
@@ -416,6 +350,7 @@ JobQueue::processTask(int instance)
             // The amount of time that the job was in the queue
             auto const q_time =
                 date::ceil<microseconds>(start_time - job.queue_time());
+            queueTime = q_time;
             perfLog_.jobStart(type, q_time, start_time, instance);
 
             job.doJob();
@@ -430,17 +365,26 @@ JobQueue::processTask(int instance)
                 getJobTypeData(type).execute.notify(x_time);
             }
             perfLog_.jobFinish(type, x_time, instance);
+            if (auto exposer = promethExposer_.load(std::memory_order_relaxed))
+                exposer->onJob(type, q_time, x_time);
         }
     }
 
+    // Job should be destroyed before calling checkStopped
+    // otherwise destructors with side effects can access
+    // parent objects that are already destroyed.
+    for (auto released = m_lanes.finish(type, queueTime); released > 0;
+         --released)
+        m_workers.addTask();
+
+    if (--m_processCount == 0 && m_lanes.size() == 0)
+    {
+        std::lock_guard lock(m_mutex);
+        cv_.notify_all();
+    }
+    if (isStopping())
     {
         std::lock_guard lock(m_mutex);
-        // Job should be destroyed before calling checkStopped
-        // otherwise destructors with side effects can access
-        // parent objects that are already destroyed.
-        finishJob(type);
-        if (--m_processCount == 0 && m_jobSet.empty())
-            cv_.notify_all();
         checkStopped(lock);
     }
 
@@ -448,15 +392,6 @@ JobQueue::processTask(int instance)
     // to the associated LoadEvent object (in the Job) may be destroyed.
 }
 
-int
-JobQueue::getJobLimit(JobType type)
-{
-    JobTypeInfo const& j(JobTypes::instance().get(type));
-    assert(j.type() != jtINVALID);
-
-    return j.limit();
-}
-
 void
 JobQueue::onChildrenStopped()
 {
@@ -0,0 +1,72 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_LEDGER_APPLYARENA_H_INCLUDED
+#define RIPPLE_LEDGER_APPLYARENA_H_INCLUDED
+
+#include <ripple/basics/qalloc.h>
+#include <ripple/json/json_value.h>
+
+namespace ripple {
+
+/** The arena the state tables of the transactions a thread applies
+    are allocated from.
+
+    A state table lives no longer than the transaction or sandbox it
+    buffers the changes of, so its nodes are freed in about the order
+    they were allocated, which is what qalloc is made for. While a
+    ledger is built, a Scope gives the thread a new arena, whose blocks
+    all go back to the heap with the ledger. Otherwise the thread keeps
+    reusing the blocks of an arena of its own.
+
+    Thread Safety:
+
+        A state table must be destroyed by the thread which created it.
+*/
+class ApplyArena
+{
+public:
+    /** Makes a new arena the one of the calling thread, until destroyed */
+    class Scope
+    {
+    public:
+        Scope();
+        ~Scope();
+
+        Scope(Scope const&) = delete;
+        Scope&
+        operator=(Scope const&) = delete;
+
+    private:
+        qalloc arena_;
+        qalloc const* previous_;
+    };
+
+    /** The arena of the calling thread */
+    static qalloc const&
+    current();
+
+    /** Allocations served by the arenas of the ledgers built so far */
+    static Json::Value
+    getJson();
+};
+
+}  // namespace ripple
+
+#endif
@@ -25,7 +25,9 @@
 #include <ripple/ledger/RawView.h>
 #include <ripple/ledger/ReadView.h>
 #include <ripple/ledger/detail/RawStateTable.h>
+#include <cstdint>
 #include <functional>
+#include <map>
 #include <utility>
 
 namespace ripple {
@@ -167,6 +169,10 @@ public:
     std::size_t
     newAccountCount(TxsRawView& to) const;
 
+    /** Net objects created (positive) or deleted (negative) by type. */
+    std::map<LedgerEntryType, std::int64_t>
+    objectCountDeltas() const;
+
     /** Apply changes. */
     void
     apply(TxsRawView& to) const;
@@ -22,6 +22,7 @@
 
 #include <ripple/basics/ZXCAmount.h>
 #include <ripple/beast/utility/Journal.h>
+#include <ripple/ledger/ApplyArena.h>
 #include <ripple/ledger/OpenView.h>
 #include <ripple/ledger/RawView.h>
 #include <ripple/ledger/ReadView.h>
@@ -46,13 +47,22 @@ private:
         modify,
     };
 
-    using items_t = std::map<key_type, std::pair<Action, std::shared_ptr<SLE>>>;
+    using items_t = std::map<
+        key_type,
+        std::pair<Action, std::shared_ptr<SLE>>,
+        std::less<key_type>,
+        qalloc_type<
+            std::pair<key_type const, std::pair<Action, std::shared_ptr<SLE>>>,
+            true>>;
 
     items_t items_;
     ZXCAmount dropsDestroyed_{0};
 
 public:
-    ApplyStateTable() = default;
+    ApplyStateTable()
+        : items_(items_t::allocator_type(ApplyArena::current()))
+    {
+    }
     ApplyStateTable(ApplyStateTable&&) = default;
 
     ApplyStateTable(ApplyStateTable const&) = delete;
@@ -126,7 +136,12 @@ public:
 
 	void clear();
 private:
-    using Mods = hash_map<key_type, std::shared_ptr<SLE>>;
+    using Mods = hash_map<
+        key_type,
+        std::shared_ptr<SLE>,
+        beast::uhash<>,
+        std::equal_to<key_type>,
+        qalloc_type<std::pair<key_type const, std::shared_ptr<SLE>>, true>>;
 
     static void
     threadItem(TxMeta& meta, std::shared_ptr<SLE> const& to);
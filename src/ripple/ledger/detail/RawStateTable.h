@@ -23,6 +23,7 @@
 #include <ripple/basics/qalloc.h>
 #include <ripple/ledger/RawView.h>
 #include <ripple/ledger/ReadView.h>
+#include <cstdint>
 #include <map>
 #include <utility>
 
@@ -83,6 +84,9 @@ public:
     std::size_t
     accountCount() const;
 
+    std::map<LedgerEntryType, std::int64_t>
+    objectCountDeltas() const;
+
 private:
     enum class Action {
         erase,
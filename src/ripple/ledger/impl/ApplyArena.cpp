@@ -0,0 +1,75 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/ledger/ApplyArena.h>
+#include <atomic>
+#include <cstdint>
+
+namespace ripple {
+
+namespace {
+
+thread_local qalloc const* scoped = nullptr;
+
+std::atomic<std::uint64_t> ledgers{0};
+std::atomic<std::uint64_t> allocations{0};
+std::atomic<std::uint64_t> bytes{0};
+std::atomic<std::uint64_t> blocks{0};
+
+}  // namespace
+
+ApplyArena::Scope::Scope() : previous_(scoped)
+{
+    scoped = &arena_;
+}
+
+ApplyArena::Scope::~Scope()
+{
+    scoped = previous_;
+
+    auto const& arena = arena_.arena();
+    ++ledgers;
+    allocations += arena.allocations();
+    bytes += arena.bytes();
+    blocks += arena.blocks();
+}
+
+qalloc const&
+ApplyArena::current()
+{
+    if (scoped)
+        return *scoped;
+
+    thread_local qalloc const arena;
+    return arena;
+}
+
+Json::Value
+ApplyArena::getJson()
+{
+    Json::Value ret(Json::objectValue);
+    ret["ledgers"] = static_cast<Json::UInt>(ledgers);
+    ret["allocations"] = static_cast<Json::UInt>(allocations);
+    ret["bytes"] = static_cast<Json::UInt>(bytes);
+    // Each block is one allocation from the heap
+    ret["blocks"] = static_cast<Json::UInt>(blocks);
+    return ret;
+}
+
+}  // namespace ripple
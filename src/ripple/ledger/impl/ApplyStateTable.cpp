@@ -126,7 +126,7 @@ ApplyStateTable::apply(
         TxMeta meta(tx.getTransactionID(), to.seq());
         if (deliver)
             meta.setDeliveredAmount(*deliver);
-        Mods newMod;
+        Mods newMod{Mods::allocator_type(ApplyArena::current())};
         for (auto& item : items_)
         {
             SField const* type;
@@ -109,6 +109,12 @@ OpenView::newAccountCount(TxsRawView& to) const
     return items_.accountCount();
 }
 
+std::map<LedgerEntryType, std::int64_t>
+OpenView::objectCountDeltas() const
+{
+    return items_.objectCountDeltas();
+}
+
 void
 OpenView::apply(TxsRawView& to) const
 {
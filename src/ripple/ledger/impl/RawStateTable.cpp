@@ -196,6 +196,28 @@ RawStateTable::accountCount() const
     return count;
 }
 
+std::map<LedgerEntryType, std::int64_t>
+RawStateTable::objectCountDeltas() const
+{
+    std::map<LedgerEntryType, std::int64_t> deltas;
+    for (auto const& elem : items_)
+    {
+        auto const& item = elem.second;
+        switch (item.first)
+        {
+            case Action::erase:
+                --deltas[item.second->getType()];
+                break;
+            case Action::insert:
+                ++deltas[item.second->getType()];
+                break;
+            case Action::replace:
+                break;
+        }
+    }
+    return deltas;
+}
+
 bool
 RawStateTable::exists(ReadView const& base, Keylet const& k) const
 {
@@ -815,6 +815,17 @@ private:
         return jvRequest;
     }
 
+    // ledger_timeline [<limit>]
+    Json::Value parseLedgerTimeline(Json::Value const& jvParams)
+    {
+        Json::Value     jvRequest(Json::objectValue);
+
+        if (jvParams.size() == 1)
+            jvRequest[jss::limit] = jvParams[0u].asUInt();
+
+        return jvRequest;
+    }
+
     // log_level:                           Get log levels
     // log_level <severity>:                Set master log level to the
     // specified severity log_level <partition> <severity>:    Set specified
@@ -1748,6 +1759,7 @@ public:
 			{	"ledger_objects",	   &RPCParser::parseLedgerId,			   1,  1 },
             {   "node_size",		   &RPCParser::parseNodeSize, 			   0,  1 },
             {   "malloc_trim",		   &RPCParser::parseAsIs, 			       0,  0 },
+            {   "ledger_timeline",     &RPCParser::parseLedgerTimeline,        0,  1 },
 			{   "schema_list",		   &RPCParser::parseSchemaList,  	       0,  2 },
 			{   "schema_info",		   &RPCParser::parseSchemaID,    	       1,  1 },
 			{   "schema_accept",	   &RPCParser::parseSchemaID,		       1,  1 },
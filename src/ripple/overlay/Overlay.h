@@ -34,6 +34,7 @@
 #include <boost/beast/http/message.hpp>
 #include <boost/beast/ssl/ssl_stream.hpp>
 #include <boost/optional.hpp>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <type_traits>
@@ -78,6 +79,9 @@ public:
         std::uint32_t crawlOptions = 0;
         boost::optional<std::uint32_t> networkID;
         bool vlEnabled = true;
+        // How long a small consensus message waits for company before
+        // being written, zero to write at once
+        std::chrono::microseconds writeDelay{0};
     };
 
     using PeerSequence = std::vector<std::shared_ptr<Peer>>;
@@ -0,0 +1,536 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_OVERLAY_SLOT_H_INCLUDED
+#define RIPPLE_OVERLAY_SLOT_H_INCLUDED
+
+#include <ripple/basics/Log.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/basics/hardened_hash.h>
+#include <ripple/basics/random.h>
+#include <ripple/beast/container/aged_container_utility.h>
+#include <ripple/beast/container/aged_unordered_map.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/json/json_value.h>
+#include <ripple/overlay/Peer.h>
+#include <ripple/overlay/Squelch.h>
+#include <ripple/protocol/PublicKey.h>
+
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace ripple {
+
+namespace squelch {
+
+/** A peer's part in relaying the messages of one key */
+enum class PeerState : std::uint8_t {
+    Counting,   // counting the messages it relays
+    Selected,   // one of the sources
+    Squelched,  // asked to stop relaying
+};
+
+/** Whether the sources of a key are selected */
+enum class SlotState : std::uint8_t {
+    Counting,  // counting the messages relayed by each peer
+    Selected,  // sources selected, the other peers squelched
+};
+
+/** Sends the squelch decisions to the peers. */
+class SquelchHandler
+{
+public:
+    virtual ~SquelchHandler() = default;
+
+    /** Ask a peer to stop relaying the messages of `key`
+        @param duration seconds the squelch lasts
+     */
+    virtual void
+    squelch(PublicKey const& key, Peer::id_t id, std::uint32_t duration)
+        const = 0;
+
+    /** Ask a peer to relay the messages of `key` again */
+    virtual void
+    unsquelch(PublicKey const& key, Peer::id_t id) const = 0;
+};
+
+template <typename clock_type>
+class Slots;
+
+/** The peers relaying the messages of one key.
+
+    Every peer relaying a message of the key is counted. Once
+    `maxSelectedPeers` of them relayed MAX_MESSAGE_THRESHOLD messages,
+    that many sources are picked at random among the peers above
+    MIN_MESSAGE_THRESHOLD, and every other peer is squelched. When a
+    source goes idle or away, the other peers are unsquelched and counting
+    starts over. A peer turning up once the sources are selected, or whose
+    squelch ran out, is squelched as soon as it relays.
+*/
+template <typename clock_type>
+class Slot final
+{
+private:
+    friend class Slots<clock_type>;
+    using id_t = Peer::id_t;
+    using time_point = typename clock_type::time_point;
+
+    struct PeerInfo
+    {
+        PeerState state;
+        std::size_t count;
+        time_point expire;
+        time_point lastMessage;
+    };
+
+    Slot(
+        SquelchHandler const& handler,
+        std::size_t maxSelectedPeers,
+        beast::Journal journal)
+        : reachedThreshold_(0)
+        , lastSelected_(clock_type::now())
+        , state_(SlotState::Counting)
+        , handler_(handler)
+        , maxSelectedPeers_(maxSelectedPeers)
+        , journal_(journal)
+    {
+    }
+
+    /** A peer relayed a message of `key` we hadn't got from it yet. */
+    void
+    update(PublicKey const& key, id_t id);
+
+    /** Forget what a peer relayed, if it was a source the other peers
+        are unsquelched and counting starts over.
+        @param erase remove the peer, it is gone
+     */
+    void
+    deletePeer(PublicKey const& key, id_t id, bool erase);
+
+    /** Forget peers which relayed nothing for IDLED */
+    void
+    deleteIdlePeers(PublicKey const& key);
+
+    /** Whether nothing was relayed for IDLED and nobody is squelched */
+    bool
+    idle() const;
+
+    std::size_t
+    inState(PeerState state) const
+    {
+        return std::count_if(peers_.begin(), peers_.end(), [&](auto const& it) {
+            return it.second.state == state;
+        });
+    }
+
+    void
+    initCounting();
+
+    std::uint32_t
+    squelchDuration() const
+    {
+        return rand_int(
+            static_cast<std::uint32_t>(MIN_UNSQUELCH_EXPIRE.count()),
+            static_cast<std::uint32_t>(MAX_UNSQUELCH_EXPIRE.count()));
+    }
+
+    hash_map<id_t, PeerInfo> peers_;
+    // Peers above MIN_MESSAGE_THRESHOLD, candidates to be sources
+    std::unordered_set<id_t> considered_;
+    // Peers above MAX_MESSAGE_THRESHOLD
+    std::size_t reachedThreshold_;
+    time_point lastSelected_;
+    SlotState state_;
+    SquelchHandler const& handler_;
+    std::size_t const maxSelectedPeers_;
+    beast::Journal const journal_;
+};
+
+template <typename clock_type>
+void
+Slot<clock_type>::update(PublicKey const& key, id_t id)
+{
+    auto const now = clock_type::now();
+    auto const [it, inserted] =
+        peers_.try_emplace(id, PeerInfo{PeerState::Counting, 0, now, now});
+    if (inserted)
+    {
+        JLOG(journal_.trace()) << "update: adding peer " << id;
+    }
+
+    auto& peer = it->second;
+    peer.lastMessage = now;
+
+    if (state_ == SlotState::Selected)
+    {
+        // A squelched peer may still relay what was in flight
+        if (peer.state == PeerState::Counting ||
+            (peer.state == PeerState::Squelched && now > peer.expire))
+        {
+            auto const duration = squelchDuration();
+            peer.state = PeerState::Squelched;
+            peer.expire = now + std::chrono::seconds(duration);
+            handler_.squelch(key, id, duration);
+        }
+        return;
+    }
+
+    if (peer.state != PeerState::Counting)
+        return;
+
+    if (++peer.count > MIN_MESSAGE_THRESHOLD)
+        considered_.insert(id);
+    if (peer.count == MAX_MESSAGE_THRESHOLD + 1)
+        ++reachedThreshold_;
+
+    // Selecting takes too long, the peers are too slow or go away
+    if (now - lastSelected_ > 2 * MAX_UNSQUELCH_EXPIRE)
+    {
+        JLOG(journal_.debug()) << "update: resetting slot, selection timed out";
+        initCounting();
+        return;
+    }
+
+    if (reachedThreshold_ < maxSelectedPeers_ ||
+        considered_.size() < maxSelectedPeers_)
+        return;
+
+    std::vector<id_t> candidates(considered_.begin(), considered_.end());
+    std::shuffle(candidates.begin(), candidates.end(), default_prng());
+    std::unordered_set<id_t> const selected(
+        candidates.begin(), candidates.begin() + maxSelectedPeers_);
+
+    JLOG(journal_.debug()) << "update: selected " << selected.size()
+                           << " of " << peers_.size() << " peers";
+
+    for (auto& [pid, info] : peers_)
+    {
+        info.count = 0;
+        if (selected.count(pid))
+        {
+            info.state = PeerState::Selected;
+        }
+        else if (info.state == PeerState::Counting)
+        {
+            auto const duration = squelchDuration();
+            info.state = PeerState::Squelched;
+            info.expire = now + std::chrono::seconds(duration);
+            handler_.squelch(key, pid, duration);
+        }
+    }
+
+    considered_.clear();
+    reachedThreshold_ = 0;
+    lastSelected_ = now;
+    state_ = SlotState::Selected;
+}
+
+template <typename clock_type>
+void
+Slot<clock_type>::deletePeer(PublicKey const& key, id_t id, bool erase)
+{
+    auto it = peers_.find(id);
+    if (it == peers_.end())
+        return;
+
+    auto const now = clock_type::now();
+    if (it->second.state == PeerState::Selected)
+    {
+        JLOG(journal_.debug()) << "deletePeer: source " << id
+                               << " lost, unsquelching";
+        for (auto& [pid, info] : peers_)
+        {
+            if (info.state == PeerState::Squelched)
+                handler_.unsquelch(key, pid);
+            info.state = PeerState::Counting;
+            info.count = 0;
+            info.expire = now;
+        }
+        considered_.clear();
+        reachedThreshold_ = 0;
+        state_ = SlotState::Counting;
+    }
+    else if (considered_.erase(id) && it->second.count > MAX_MESSAGE_THRESHOLD)
+    {
+        --reachedThreshold_;
+    }
+
+    it->second.lastMessage = now;
+    it->second.count = 0;
+
+    if (erase)
+        peers_.erase(it);
+}
+
+template <typename clock_type>
+void
+Slot<clock_type>::deleteIdlePeers(PublicKey const& key)
+{
+    auto const now = clock_type::now();
+    for (auto it = peers_.begin(); it != peers_.end();)
+    {
+        auto const id = it->first;
+        auto const idle = now - it->second.lastMessage > IDLED;
+        ++it;
+        if (idle)
+            deletePeer(key, id, false);
+    }
+}
+
+template <typename clock_type>
+bool
+Slot<clock_type>::idle() const
+{
+    auto const now = clock_type::now();
+    return std::all_of(peers_.begin(), peers_.end(), [&](auto const& it) {
+        return now - it.second.lastMessage > IDLED &&
+            !(it.second.state == PeerState::Squelched &&
+              it.second.expire > now);
+    });
+}
+
+template <typename clock_type>
+void
+Slot<clock_type>::initCounting()
+{
+    state_ = SlotState::Counting;
+    considered_.clear();
+    reachedThreshold_ = 0;
+    lastSelected_ = clock_type::now();
+    for (auto& [_, info] : peers_)
+    {
+        (void)_;
+        info.count = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+/** The slots of every key whose messages are relayed to us.
+
+    A message relayed by several peers is counted once for each of them.
+*/
+template <typename clock_type>
+class Slots final
+{
+    using id_t = Peer::id_t;
+    using messages = beast::aged_unordered_map<
+        uint256,
+        std::unordered_set<id_t>,
+        clock_type,
+        hardened_hash<strong_hash>>;
+
+public:
+    /**
+        @param maxSelectedPeers peers kept as the sources of a key
+        @param maxSlots keys tracked at most
+     */
+    Slots(
+        SquelchHandler const& handler,
+        std::size_t maxSelectedPeers,
+        std::size_t maxSlots,
+        beast::Journal journal)
+        : handler_(handler)
+        , maxSelectedPeers_(maxSelectedPeers)
+        , maxSlots_(maxSlots)
+        , journal_(journal)
+    {
+    }
+
+    /** A peer relayed the message `uid` of `key`. */
+    void
+    updateSlotAndSquelch(uint256 const& uid, PublicKey const& key, id_t id);
+
+    /** A peer is gone, or stopped relaying anything. */
+    void
+    deletePeer(id_t id, bool erase);
+
+    /** Forget idle peers and slots. Called periodically. */
+    void
+    deleteIdlePeers();
+
+    std::size_t
+    size() const
+    {
+        std::lock_guard lock(mutex_);
+        return slots_.size();
+    }
+
+    /** The state of a peer in the slot of `key`, if any */
+    boost::optional<PeerState>
+    peerState(PublicKey const& key, id_t id) const;
+
+    boost::optional<SlotState>
+    slotState(PublicKey const& key) const;
+
+    Json::Value
+    getJson() const;
+
+private:
+    /** Whether `id` hadn't relayed `uid` yet */
+    bool
+    addPeerMessage(uint256 const& uid, id_t id);
+
+    mutable std::mutex mutex_;
+    hash_map<PublicKey, Slot<clock_type>> slots_;
+    messages peersWithMessage_{beast::get_abstract_clock<clock_type>()};
+    SquelchHandler const& handler_;
+    std::size_t const maxSelectedPeers_;
+    std::size_t const maxSlots_;
+    beast::Journal const journal_;
+};
+
+template <typename clock_type>
+bool
+Slots<clock_type>::addPeerMessage(uint256 const& uid, id_t id)
+{
+    beast::expire(peersWithMessage_, IDLED);
+
+    auto it = peersWithMessage_.find(uid);
+    if (it == peersWithMessage_.end())
+    {
+        peersWithMessage_.emplace(uid, std::unordered_set<id_t>{id});
+        return true;
+    }
+
+    return it->second.insert(id).second;
+}
+
+template <typename clock_type>
+void
+Slots<clock_type>::updateSlotAndSquelch(
+    uint256 const& uid,
+    PublicKey const& key,
+    id_t id)
+{
+    std::lock_guard lock(mutex_);
+
+    if (!addPeerMessage(uid, id))
+        return;
+
+    auto it = slots_.find(key);
+    if (it == slots_.end())
+    {
+        if (slots_.size() >= maxSlots_)
+            return;
+        it = slots_
+                 .emplace(
+                     key,
+                     Slot<clock_type>(handler_, maxSelectedPeers_, journal_))
+                 .first;
+    }
+
+    it->second.update(key, id);
+}
+
+template <typename clock_type>
+void
+Slots<clock_type>::deletePeer(id_t id, bool erase)
+{
+    std::lock_guard lock(mutex_);
+    for (auto& [key, slot] : slots_)
+        slot.deletePeer(key, id, erase);
+}
+
+template <typename clock_type>
+void
+Slots<clock_type>::deleteIdlePeers()
+{
+    std::lock_guard lock(mutex_);
+
+    for (auto it = slots_.begin(); it != slots_.end();)
+    {
+        if (it->second.idle())
+        {
+            JLOG(journal_.trace()) << "deleteIdlePeers: slot "
+                                   << toBase58(TokenType::NodePublic, it->first)
+                                   << " idled";
+            it = slots_.erase(it);
+            continue;
+        }
+
+        it->second.deleteIdlePeers(it->first);
+        ++it;
+    }
+
+    beast::expire(peersWithMessage_, IDLED);
+}
+
+template <typename clock_type>
+boost::optional<PeerState>
+Slots<clock_type>::peerState(PublicKey const& key, id_t id) const
+{
+    std::lock_guard lock(mutex_);
+    auto const it = slots_.find(key);
+    if (it == slots_.end())
+        return boost::none;
+
+    auto const pit = it->second.peers_.find(id);
+    if (pit == it->second.peers_.end())
+        return boost::none;
+    return pit->second.state;
+}
+
+template <typename clock_type>
+boost::optional<SlotState>
+Slots<clock_type>::slotState(PublicKey const& key) const
+{
+    std::lock_guard lock(mutex_);
+    auto const it = slots_.find(key);
+    if (it == slots_.end())
+        return boost::none;
+    return it->second.state_;
+}
+
+template <typename clock_type>
+Json::Value
+Slots<clock_type>::getJson() const
+{
+    std::lock_guard lock(mutex_);
+
+    std::size_t selected = 0;
+    std::size_t sources = 0;
+    std::size_t squelched = 0;
+    for (auto const& [_, slot] : slots_)
+    {
+        (void)_;
+        if (slot.state_ == SlotState::Selected)
+            ++selected;
+        sources += slot.inState(PeerState::Selected);
+        squelched += slot.inState(PeerState::Squelched);
+    }
+
+    Json::Value ret(Json::objectValue);
+    ret["slots"] = static_cast<Json::UInt>(slots_.size());
+    ret["selected_slots"] = static_cast<Json::UInt>(selected);
+    ret["sources"] = static_cast<Json::UInt>(sources);
+    ret["squelched"] = static_cast<Json::UInt>(squelched);
+    return ret;
+}
+
+}  // namespace squelch
+
+}  // namespace ripple
+
+#endif
@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_OVERLAY_SQUELCH_H_INCLUDED
+#define RIPPLE_OVERLAY_SQUELCH_H_INCLUDED
+
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/protocol/PublicKey.h>
+
+#include <chrono>
+#include <cstdint>
+
+namespace ripple {
+
+namespace squelch {
+
+// A squelch lasts a random duration in this range, so that the peers
+// squelched by one node don't all come back at once
+static constexpr std::chrono::seconds MIN_UNSQUELCH_EXPIRE{300};
+static constexpr std::chrono::seconds MAX_UNSQUELCH_EXPIRE{600};
+// A peer which relayed nothing for a key this long is no longer a source
+static constexpr std::chrono::seconds IDLED{8};
+// Peers which relayed more than MIN_MESSAGE_THRESHOLD unique messages of
+// a key are considered as sources. Sources are selected among them once
+// enough peers relayed more than MAX_MESSAGE_THRESHOLD.
+static constexpr std::uint16_t MIN_MESSAGE_THRESHOLD = 9;
+static constexpr std::uint16_t MAX_MESSAGE_THRESHOLD = 10;
+// Default number of peers kept as the sources of a key
+static constexpr std::uint16_t MAX_SELECTED_PEERS = 3;
+// Nothing is squelched until the server had the time to connect its peers
+static constexpr std::chrono::minutes WAIT_ON_BOOTUP{2};
+// Transactions relayed for others go to a share of the peers, but never
+// to fewer than this
+static constexpr std::size_t MIN_TX_RELAY_PEERS = 10;
+
+/** The keys a peer asked us not to relay the messages of.
+
+    A key is a trusted validator of the schema, only its consensus messages
+    are squelched. Every squelch expires on its own, so a peer which never
+    lifts it can't cut a source off for good.
+
+    Not synchronized: PeerImp holds its own lock.
+*/
+template <typename clock_type>
+class Squelch
+{
+    using time_point = typename clock_type::time_point;
+
+public:
+    /** Stop relaying the messages of `key` for `duration`.
+        @return false if the duration is out of range, nothing is squelched
+     */
+    bool
+    addSquelch(PublicKey const& key, std::chrono::seconds const& duration)
+    {
+        if (duration < MIN_UNSQUELCH_EXPIRE || duration > MAX_UNSQUELCH_EXPIRE)
+            return false;
+
+        squelched_[key] = clock_type::now() + duration;
+        return true;
+    }
+
+    void
+    removeSquelch(PublicKey const& key)
+    {
+        squelched_.erase(key);
+    }
+
+    /** Whether the messages of `key` must not be relayed to the peer.
+        An expired squelch is removed.
+     */
+    bool
+    isSquelched(PublicKey const& key)
+    {
+        auto const it = squelched_.find(key);
+        if (it == squelched_.end())
+            return false;
+
+        if (it->second > clock_type::now())
+            return true;
+
+        squelched_.erase(it);
+        return false;
+    }
+
+    std::size_t
+    size() const
+    {
+        return squelched_.size();
+    }
+
+private:
+    hash_map<PublicKey, time_point> squelched_;
+};
+
+}  // namespace squelch
+
+}  // namespace ripple
+
+#endif
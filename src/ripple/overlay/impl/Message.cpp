@@ -76,6 +76,7 @@ Message::compress()
             case protocol::mtSHARD_INFO:
             case protocol::mtGET_PEER_SHARD_INFO:
             case protocol::mtPEER_SHARD_INFO:
+            case protocol::mtSQUELCH:
                 break;
         }
         return false;
@@ -30,6 +30,7 @@
 #include <ripple/overlay/Cluster.h>
 #include <ripple/overlay/impl/ConnectAttempt.h>
 #include <ripple/overlay/impl/PeerImp.h>
+#include <ripple/overlay/impl/Tuning.h>
 #include <ripple/overlay/predicates.h>
 #include <ripple/overlay/impl/OverlayImpl.h>
 #include <ripple/overlay/PeerReservationTable.h>
@@ -39,6 +40,8 @@
 #include <ripple/rpc/handlers/GetCounts.h>
 #include <ripple/server/SimpleWriter.h>
 #include <peersafe/schema/PeerManager.h>
+#include <peersafe/schema/Schema.h>
+#include <peersafe/schema/SchemaManager.h>
 #include <peersafe/schema/SchemaParams.h>
 
 #include <boost/algorithm/string/predicate.hpp>
@@ -108,6 +111,8 @@ OverlayImpl::Timer::on_timer(error_code ec)
     if ((++overlay_.timer_count_ % Tuning::checkSeconds) == 0)
         overlay_.check();
 
+    overlay_.deleteIdlePeers();
+
     timer_.expires_from_now(std::chrono::seconds(1));
     timer_.async_wait(overlay_.strand_.wrap(std::bind(
         &Timer::on_timer, shared_from_this(), std::placeholders::_1)));
@@ -672,20 +677,34 @@ OverlayImpl::onChildrenStopped()
 void
 OverlayImpl::onWrite(beast::PropertyStream::Map& stream)
 {
-    beast::PropertyStream::Set set("traffic", stream);
-    auto const stats = m_traffic.getCounts();
-    for (auto const& i : stats)
     {
-        if (i)
+        beast::PropertyStream::Set set("traffic", stream);
+        auto const stats = m_traffic.getCounts();
+        for (auto const& i : stats)
         {
-            beast::PropertyStream::Map item(set);
-            item["category"] = i.name;
-            item["bytes_in"] = std::to_string(i.bytesIn.load());
-            item["messages_in"] = std::to_string(i.messagesIn.load());
-            item["bytes_out"] = std::to_string(i.bytesOut.load());
-            item["messages_out"] = std::to_string(i.messagesOut.load());
+            if (i)
+            {
+                beast::PropertyStream::Map item(set);
+                item["category"] = i.name;
+                item["bytes_in"] = std::to_string(i.bytesIn.load());
+                item["messages_in"] = std::to_string(i.messagesIn.load());
+                item["bytes_out"] = std::to_string(i.bytesOut.load());
+                item["messages_out"] = std::to_string(i.messagesOut.load());
+            }
         }
     }
+
+    beast::PropertyStream::Map item("writes", stream);
+    auto const writes = writes_.load();
+    item["writes"] = std::to_string(writes);
+    item["messages"] = std::to_string(writtenMessages_.load());
+    item["bytes"] = std::to_string(writtenBytes_.load());
+    if (writes != 0)
+    {
+        item["messages_per_write"] =
+            std::to_string(writtenMessages_.load() / writes);
+        item["bytes_per_write"] = std::to_string(writtenBytes_.load() / writes);
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -721,8 +740,31 @@ OverlayImpl::activate(std::shared_ptr<PeerImp> const& peer)
 void
 OverlayImpl::onPeerDeactivate(Peer::id_t id)
 {
-    std::lock_guard lock(mutex_);
-    ids_.erase(id);
+    {
+        std::lock_guard lock(mutex_);
+        ids_.erase(id);
+    }
+
+    // A selected source is gone, let the squelched peers relay again
+    app_.getSchemaManager().foreach([id](std::shared_ptr<Schema> schema) {
+        schema->peerManager().deletePeer(id);
+    });
+}
+
+void
+OverlayImpl::deleteIdlePeers()
+{
+    app_.getSchemaManager().foreach([](std::shared_ptr<Schema> schema) {
+        schema->peerManager().deleteIdlePeers();
+    });
+}
+
+void
+OverlayImpl::reportWrite(std::size_t messages, std::size_t bytes)
+{
+    ++writes_;
+    writtenMessages_ += messages;
+    writtenBytes_ += bytes;
 }
 
 void
@@ -1112,6 +1154,12 @@ setup_Overlay(BasicConfig const& config)
             if (ec || beast::IP::is_private(setup.public_ip))
                 Throw<std::runtime_error>("Configured public IP is invalid");
         }
+
+        std::uint32_t writeDelay = 0;
+        set(writeDelay, "write_delay", section);
+        setup.writeDelay = std::chrono::microseconds(writeDelay);
+        if (setup.writeDelay > Tuning::maxWriteDelay)
+            Throw<std::runtime_error>("Configured write delay is invalid");
     }
 
     {
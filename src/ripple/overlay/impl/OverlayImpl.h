@@ -131,6 +131,10 @@ private:
     Resource::Manager& m_resourceManager;
     std::unique_ptr<PeerFinder::Manager> m_peerFinder;
     TrafficCount m_traffic;
+    // Writes to peers and what they carried, see PeerImp::writeQueued
+    std::atomic<std::uint64_t> writes_{0};
+    std::atomic<std::uint64_t> writtenMessages_{0};
+    std::atomic<std::uint64_t> writtenBytes_{0};
     hash_map<std::shared_ptr<PeerFinder::Slot>, std::weak_ptr<PeerImp>> m_peers;
     hash_map<Peer::id_t, std::weak_ptr<PeerImp>> ids_;
     Resolver& m_resolver;
@@ -248,6 +252,10 @@ public:
     void
     onPeerDeactivate(Peer::id_t id);
 
+    // Forget the relay sources which went idle, in every schema.
+    void
+    deleteIdlePeers();
+
     //// UnaryFunc will be called as
     ////  void(std::shared_ptr<PeerImp>&&)
     ////
@@ -329,6 +337,10 @@ public:
     void
     reportTraffic(TrafficCount::category cat, bool isInbound, int bytes);
 
+    /** A peer wrote `messages` gathered in `bytes` with a single write */
+    void
+    reportWrite(std::size_t messages, std::size_t bytes);
+
     void
     incJqTransOverflow() override
     {
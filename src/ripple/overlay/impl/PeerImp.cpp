@@ -48,6 +48,7 @@
 #include <memory>
 #include <numeric>
 #include <peersafe/app/misc/TxPool.h>
+#include <peersafe/app/prometh/PrometheusClient.h>
 #include <peersafe/app/table/TableSync.h>
 #include <peersafe/consensus/Adaptor.h>
 #include <peersafe/schema/PeerManager.h>
@@ -83,6 +84,7 @@ PeerImp::PeerImp(
     , stream_(*stream_ptr_)
     , strand_(socket_.get_executor())
     , timer_(waitable_timer{socket_.get_executor()})
+    , writeTimer_(waitable_timer{socket_.get_executor()})
     , remote_address_(slot->remote_endpoint())
     , overlay_(overlay)
     , m_inbound(true)
@@ -99,6 +101,9 @@ PeerImp::PeerImp(
     , compressionEnabled_(
           headers_["X-Offer-Compression"] == "lz4" ? Compressed::On
                                                    : Compressed::Off)
+    , squelchEnabled_(
+          headers_["X-Offer-Squelch"] == "1" &&
+          app_.config().REDUCE_RELAY_ENABLE)
 {
 }
 
@@ -111,6 +116,11 @@ PeerImp::~PeerImp()
     overlay_.peerFinder().on_closed(slot_);
     overlay_.remove(slot_);
 
+    if (trafficRecv_)
+        app_.getPromethExposer().removePeerTraffic(*trafficRecv_);
+    if (trafficSent_)
+        app_.getPromethExposer().removePeerTraffic(*trafficSent_);
+
     if (inCluster)
     {
         JLOG(journal_.warn()) << getName() << " left cluster";
@@ -315,15 +325,88 @@ PeerImp::send(std::shared_ptr<Message> const& m)
             << " sendq: " << sendq_size;
     }
 
-    send_queue_.push(m);
+    send_queue_.push_back(m);
 
+    // A write in progress or due takes this message along
     if (sendq_size != 0)
         return;
 
+    if (delayWrite(*m))
+    {
+        writeTimer_.expires_from_now(overlay_.setup().writeDelay);
+        writeTimer_.async_wait(bind_executor(
+            strand_,
+            std::bind(
+                &PeerImp::onWriteTimer,
+                shared_from_this(),
+                std::placeholders::_1)));
+        return;
+    }
+
+    writeQueued();
+}
+
+bool
+PeerImp::delayWrite(Message& m)
+{
+    if (overlay_.setup().writeDelay == std::chrono::microseconds::zero())
+        return false;
+
+    // Consensus messages come in bursts, one to each peer for each
+    // validator. Anything else, or anything large, goes at once.
+    if (m.getCategory() != TrafficCount::category::consensus ||
+        m.getBuffer(compressionEnabled_).size() > Tuning::smallWriteBytes)
+        return false;
+
+    // Don't make a slow link slower
+    std::lock_guard sl(recentLock_);
+    return !latency_ ||
+        *latency_ + std::chrono::duration_cast<std::chrono::milliseconds>(
+                        overlay_.setup().writeDelay) <
+        Tuning::peerHighLatency;
+}
+
+void
+PeerImp::onWriteTimer(error_code ec)
+{
+    if (ec == boost::asio::error::operation_aborted)
+        return;
+    if (!socket_.is_open())
+        return;
+    if (ec)
+        return fail("onWriteTimer", ec);
+
+    if (writing_ == 0 && !send_queue_.empty())
+        writeQueued();
+}
+
+void
+PeerImp::writeQueued()
+{
+    assert(strand_.running_in_this_thread());
+    assert(writing_ == 0 && !send_queue_.empty());
+
+    // The messages stay in the queue, and so their buffers stay valid,
+    // until the write completes
+    std::vector<boost::asio::const_buffer> buffers;
+    buffers.reserve(
+        std::min<std::size_t>(send_queue_.size(), Tuning::maxWriteMessages));
+    std::size_t bytes = 0;
+    for (auto const& m : send_queue_)
+    {
+        auto const& buffer = m->getBuffer(compressionEnabled_);
+        if (!buffers.empty() &&
+            (buffers.size() == Tuning::maxWriteMessages ||
+             bytes + buffer.size() > Tuning::maxWriteBytes))
+            break;
+        buffers.emplace_back(buffer.data(), buffer.size());
+        bytes += buffer.size();
+    }
+    writing_ = buffers.size();
+
     boost::asio::async_write(
         stream_,
-        boost::asio::buffer(
-            send_queue_.front()->getBuffer(compressionEnabled_)),
+        buffers,
         bind_executor(
             strand_,
             std::bind(
@@ -333,6 +416,32 @@ PeerImp::send(std::shared_ptr<Message> const& m)
                 std::placeholders::_2)));
 }
 
+void
+PeerImp::relay(
+    std::shared_ptr<Message> const& m,
+    uint256 const& schemaId,
+    PublicKey const& key)
+{
+    if (isSquelched(schemaId, key))
+    {
+        overlay_.reportTraffic(
+            TrafficCount::category::squelch_suppressed,
+            false,
+            static_cast<int>(m->getBuffer(compressionEnabled_).size()));
+        return;
+    }
+
+    send(m);
+}
+
+bool
+PeerImp::isSquelched(uint256 const& schemaId, PublicKey const& key) const
+{
+    std::lock_guard sl(squelchMutex_);
+    auto const it = squelch_.find(schemaId);
+    return it != squelch_.end() && it->second.isSquelched(key);
+}
+
 void
 PeerImp::charge(Resource::Charge const& fee)
 {
@@ -503,6 +612,8 @@ PeerImp::supportsFeature(ProtocolFeature f) const
     {
         case ProtocolFeature::ValidatorListPropagation:
             return protocol_ >= make_protocol(2, 1);
+        case ProtocolFeature::Squelch:
+            return squelchEnabled_;
     }
     return false;
 }
@@ -632,6 +743,7 @@ PeerImp::close()
         detaching_ = true;  // DEPRECATED
         error_code ec;
         timer_.cancel(ec);
+        writeTimer_.cancel(ec);
         socket_.close(ec);
         overlay_.incPeerDisconnect();
         if (m_inbound)
@@ -713,6 +825,11 @@ PeerImp::getPeerShardInfo(uint256 const& schemaId) const
 void
 PeerImp::removeSchemaInfo(uint256 const& schemaId)
 {
+    {
+        std::lock_guard sl(squelchMutex_);
+        squelch_.erase(schemaId);
+    }
+
     std::lock_guard sl(schemaInfoMutex_);
     if (schemaInfo_.find(schemaId) != schemaInfo_.end())
     {
@@ -958,6 +1075,8 @@ PeerImp::makeResponse(
     resp.insert("Crawl", crawl ? "public" : "private");
     if (req["X-Offer-Compression"] == "lz4" && app_.config().COMPRESSION)
         resp.insert("X-Offer-Compression", "lz4");
+    if (req["X-Offer-Squelch"] == "1" && app_.config().REDUCE_RELAY_ENABLE)
+        resp.insert("X-Offer-Squelch", "1");
 
     buildHandshake(
         resp,
@@ -1017,6 +1136,10 @@ PeerImp::getName() const
 void
 PeerImp::doProtocolStart()
 {
+    auto const peer = toBase58(TokenType::NodePublic, publicKey_);
+    trafficRecv_ = &app_.getPromethExposer().addPeerTraffic(peer, "recv");
+    trafficSent_ = &app_.getPromethExposer().addPeerTraffic(peer, "sent");
+
     onReadMessage(error_code(), 0);
 
     std::lock_guard sl(schemaInfoMutex_);
@@ -1095,6 +1218,8 @@ PeerImp::onReadMessage(error_code ec, std::size_t bytes_transferred)
     }
 
     metrics_.recv.add_message(bytes_transferred);
+    if (trafficRecv_)
+        trafficRecv_->Increment(bytes_transferred);
 
     read_buffer_.commit(bytes_transferred);
 
@@ -1143,23 +1268,17 @@ PeerImp::onWriteMessage(error_code ec, std::size_t bytes_transferred)
     }
 
     metrics_.sent.add_message(bytes_transferred);
+    if (trafficSent_)
+        trafficSent_->Increment(bytes_transferred);
+    overlay_.reportWrite(writing_, bytes_transferred);
 
-    assert(!send_queue_.empty());
-    send_queue_.pop();
+    assert(writing_ != 0 && writing_ <= send_queue_.size());
+    send_queue_.erase(send_queue_.begin(), send_queue_.begin() + writing_);
+    writing_ = 0;
     if (!send_queue_.empty())
     {
         // Timeout on writes only
-        return boost::asio::async_write(
-            stream_,
-            boost::asio::buffer(
-                send_queue_.front()->getBuffer(compressionEnabled_)),
-            bind_executor(
-                strand_,
-                std::bind(
-                    &PeerImp::onWriteMessage,
-                    shared_from_this(),
-                    std::placeholders::_1,
-                    std::placeholders::_2)));
+        return writeQueued();
     }
 
     if (gracefulClose_)
@@ -1679,8 +1798,13 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMTransaction> const& m)
     {
         auto stx = std::make_shared<STTx const>(sit);
         uint256 txID = stx->getTransactionID();
+
         if (app_.getTxPool(schemaId).txExists(txID))
         {
+            overlay_.reportTraffic(
+                TrafficCount::category::transaction_duplicate,
+                true,
+                static_cast<int>(m->ByteSizeLong()));
             return;
         }
         int flags;
@@ -1689,6 +1813,11 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMTransaction> const& m)
         if (!app_.getHashRouter(schemaId).shouldProcess(
                 txID, id_, flags, tx_interval))
         {
+            overlay_.reportTraffic(
+                TrafficCount::category::transaction_duplicate,
+                true,
+                static_cast<int>(m->ByteSizeLong()));
+
             // we have seen this transaction recently
             if (flags & SF_BAD)
             {
@@ -2616,10 +2745,26 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMConsensus> const& m)
     }
 
     uint256 schemaId = get<1>(tup);
+    uint256 const uid = consensusMessageUniqueId(*m);
+    auto const isTrusted = app_.validators(schemaId).trusted(publicKey);
 
-    if (!app_.getHashRouter(schemaId).addSuppressionPeer(
-            consensusMessageUniqueId(*m), id_))
+    auto const [added, relayed] =
+        app_.getHashRouter(schemaId).addSuppressionPeerWithStatus(uid, id_);
+    if (!added)
     {
+        // Only the sources of trusted validators are worth selecting, and
+        // only for copies of a message we verified and relayed lately: a
+        // peer can't win the slot with messages forged under the key. The
+        // peers which sent it before it was verified are counted by relay.
+        if (isTrusted && relayed &&
+            stopwatch().now() - *relayed < squelch::IDLED)
+            updateSlotAndSquelch(schemaId, uid, publicKey);
+
+        overlay_.reportTraffic(
+            TrafficCount::category::consensus_duplicate,
+            true,
+            static_cast<int>(m->ByteSizeLong()));
+
         auto dmp = [&](beast::Journal::Stream s, std::uint32_t type) {
             s << "Consensus message mt(" << type << ")"
               << RCLConsensus::conMsgTypeToStr((ConsensusMessageType)type)
@@ -2632,8 +2777,6 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMConsensus> const& m)
         return;
     }
 
-    auto const isTrusted = app_.validators(schemaId).trusted(publicKey);
-
     if (!isTrusted)
     {
         if (get<2>(tup)->sanity_.load() == Sanity::insane)
@@ -2916,6 +3059,80 @@ PeerImp::checkConsensus(
         shared_from_this(), isTrusted, packet);
 }
 
+void
+PeerImp::onMessage(std::shared_ptr<protocol::TMSquelch> const& m)
+{
+    if (!squelchEnabled_)
+    {
+        JLOG(p_journal_.debug()) << "TMSquelch: not offered";
+        charge(Resource::feeUnwantedData);
+        return;
+    }
+
+    auto tup = getSchemaInfo("TMSquelch:", m->schemaid());
+    if (!get<0>(tup))
+        return;
+    uint256 schemaId = get<1>(tup);
+
+    auto const slice = makeSlice(m->publickey());
+    if (!publicKeyType(slice))
+    {
+        JLOG(p_journal_.debug()) << "TMSquelch: invalid public key";
+        charge(Resource::feeBadData);
+        return;
+    }
+    PublicKey const key{slice};
+
+    // We send our own messages to every peer, there's nothing to squelch
+    if (!app_.getValidationPublicKey().empty() &&
+        key == app_.getValidationPublicKey())
+    {
+        JLOG(p_journal_.debug()) << "TMSquelch: own key";
+        return;
+    }
+
+    // Only the messages of trusted validators are squelched
+    if (!app_.validators(schemaId).trusted(key))
+    {
+        JLOG(p_journal_.debug()) << "TMSquelch: not a trusted validator";
+        return;
+    }
+
+    std::lock_guard sl(squelchMutex_);
+    auto& squelch = squelch_[schemaId];
+    if (!m->squelch())
+    {
+        squelch.removeSquelch(key);
+    }
+    else if (!squelch.addSquelch(
+                 key, std::chrono::seconds{m->squelchduration()}))
+    {
+        JLOG(p_journal_.debug())
+            << "TMSquelch: invalid duration " << m->squelchduration();
+        charge(Resource::feeBadData);
+        return;
+    }
+
+    JLOG(p_journal_.trace())
+        << "TMSquelch: " << (m->squelch() ? "squelch " : "unsquelch ")
+        << toBase58(TokenType::NodePublic, key) << " "
+        << m->squelchduration();
+}
+
+void
+PeerImp::updateSlotAndSquelch(
+    uint256 const& schemaId,
+    uint256 const& uid,
+    PublicKey const& key)
+{
+    // The link to a validator always carries its own messages
+    if (!squelchEnabled_ || (publicValidate_ && *publicValidate_ == key))
+        return;
+
+    if (auto schema = app_.getSchemaManager().getSchema(schemaId))
+        schema->peerManager().updateSlotAndSquelch(uid, key, id_);
+}
+
 void
 PeerImp::syncSchema(
     uint256 schemaId,
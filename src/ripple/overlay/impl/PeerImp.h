@@ -24,6 +24,7 @@
 #include <ripple/basics/Log.h>
 #include <ripple/basics/RangeSet.h>
 #include <ripple/beast/utility/WrappedSink.h>
+#include <ripple/overlay/Squelch.h>
 #include <ripple/overlay/impl/OverlayImpl.h>
 #include <ripple/overlay/impl/ProtocolMessage.h>
 #include <ripple/overlay/impl/ProtocolVersion.h>
@@ -40,9 +41,13 @@
 #include <boost/endian/conversion.hpp>
 #include <boost/optional.hpp>
 #include <cstdint>
-#include <queue>
+#include <deque>
 #include <shared_mutex>
 
+namespace prometheus {
+class Counter;
+}
+
 namespace ripple {
 
 class PeerImp : public Peer,
@@ -133,6 +138,8 @@ private:
     stream_type& stream_;
     boost::asio::strand<boost::asio::executor> strand_;
     waitable_timer timer_;
+    // Delays a write so that it gathers more messages
+    waitable_timer writeTimer_;
 
     // Type type_ = Type::legacy;
 
@@ -213,7 +220,9 @@ private:
     http_response_type response_;
     boost::beast::http::fields const& headers_;
     boost::beast::multi_buffer write_buffer_;
-    std::queue<std::shared_ptr<Message>> send_queue_;
+    std::deque<std::shared_ptr<Message>> send_queue_;
+    // Messages at the front of send_queue_ being written
+    std::size_t writing_ = 0;
     bool gracefulClose_ = false;
     int large_sendq_ = 0;
     int no_ping_ = 0;
@@ -227,6 +236,12 @@ private:
 
     Compressed compressionEnabled_ = Compressed::Off;
 
+    // Both sides offered squelching
+    bool const squelchEnabled_;
+    // Validators this peer asked us not to relay, per schema
+    std::mutex mutable squelchMutex_;
+    hash_map<uint256, squelch::Squelch<clock_type>> mutable squelch_;
+
     friend class OverlayImpl;
 	friend class PeerManagerImpl;
 
@@ -263,6 +278,10 @@ private:
         Metrics recv;
     } metrics_;
 
+    // Bytes to and from this peer in Prometheus, added in doProtocolStart
+    prometheus::Counter* trafficRecv_ = nullptr;
+    prometheus::Counter* trafficSent_ = nullptr;
+
 public:
     PeerImp(PeerImp const&) = delete;
     PeerImp&
@@ -329,6 +348,17 @@ public:
     void
     send(std::shared_ptr<Message> const& m) override;
 
+    /** Send a message of a validator `key` we relay,
+        unless this peer squelched `key`. */
+    void
+    relay(
+        std::shared_ptr<Message> const& m,
+        uint256 const& schemaId,
+        PublicKey const& key);
+
+    bool
+    isSquelched(uint256 const& schemaId, PublicKey const& key) const;
+
     /** Send a set of PeerFinder endpoints as a protocol message. */
     template <
         class FwdIt,
@@ -543,6 +573,19 @@ private:
     void
     onWriteMessage(error_code ec, std::size_t bytes_transferred);
 
+    // Write the messages at the front of the send queue, as many as
+    // fit in a single write
+    void
+    writeQueued();
+
+    // Whether writing `m` may wait for more messages to write with it
+    bool
+    delayWrite(Message& m);
+
+    // Called when a delayed write is due
+    void
+    onWriteTimer(error_code ec);
+
 public:
     //--------------------------------------------------------------------------
     //
@@ -604,6 +647,8 @@ public:
     onMessage(std::shared_ptr<protocol::TMConsensus> const& m);
     void
     onMessage(std::shared_ptr<protocol::TMSyncSchema> const& m);
+    void
+    onMessage(std::shared_ptr<protocol::TMSquelch> const& m);
 
 private:
     State
@@ -649,6 +694,14 @@ private:
         uint256 schemaId,
         std::shared_ptr<protocol::TMSyncSchema> const& packet);
 
+    // Count the message `uid` of `key` relayed by this peer towards
+    // selecting the sources of `key`
+    void
+    updateSlotAndSquelch(
+        uint256 const& schemaId,
+        uint256 const& uid,
+        PublicKey const& key);
+
     void
     getLedger(std::shared_ptr<protocol::TMGetLedger> const& packet);
 };
@@ -681,6 +734,7 @@ PeerImp::PeerImp(
     , stream_(*stream_ptr_)
     , strand_(socket_.get_executor())
     , timer_(waitable_timer{socket_.get_executor()})
+    , writeTimer_(waitable_timer{socket_.get_executor()})
     , remote_address_(slot->remote_endpoint())
     , overlay_(overlay)
     , m_inbound(false)
@@ -698,6 +752,9 @@ PeerImp::PeerImp(
           headers_["X-Offer-Compression"] == "lz4" && app_.config().COMPRESSION
               ? Compressed::On
               : Compressed::Off)
+    , squelchEnabled_(
+          headers_["X-Offer-Squelch"] == "1" &&
+          app_.config().REDUCE_RELAY_ENABLE)
 {
     read_buffer_.commit (boost::asio::buffer_copy(read_buffer_.prepare(
         boost::asio::buffer_size(buffers)), buffers));
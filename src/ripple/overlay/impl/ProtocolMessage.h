@@ -81,6 +81,8 @@ protocolMessageName(int type)
             return "consensus";
         case protocol::mtSYNC_SCHEMA:
             return "sync_schema";
+        case protocol::mtSQUELCH:
+            return "squelch";
         default:
             break;
     }
@@ -393,6 +395,10 @@ invokeProtocolMessage(Buffers const& buffers, Handler& handler)
             success = detail::invoke<protocol::TMSyncSchema>(
                 *header, buffers, handler);
             break;
+        case protocol::mtSQUELCH:
+            success =
+                detail::invoke<protocol::TMSquelch>(*header, buffers, handler);
+            break;
         default:
             handler.onMessageUnknown(header->message_type);
             success = true;
@@ -59,6 +59,9 @@ TrafficCount::categorize(
     if (type == protocol::mtSYNC_SCHEMA)
         return TrafficCount::category::sync_schema;
 
+    if (type == protocol::mtSQUELCH)
+        return TrafficCount::category::squelch;
+
 
     if(type == protocol::mtGET_TABLE)
         return TrafficCount::category::get_table;
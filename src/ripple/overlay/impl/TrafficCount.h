@@ -77,6 +77,13 @@ public:
         sync_schema,
         shards,  // shard-related traffic
 
+        // Relaying reduced by squelching
+        squelch,                // TMSquelch
+        squelch_suppressed,     // not relayed to a peer which squelched it
+        consensus_duplicate,    // consensus messages we already had
+        transaction_duplicate,  // transactions we already had
+        transaction_suppressed, // transactions not relayed to a peer
+
         get_table,
 
         // TMHaveSet message:
@@ -204,6 +211,11 @@ protected:
         {"consensus"},          // category::consensus
         {"sync_schema"},
         {"shards"},          // category::shards
+        {"squelch"},                 // category::squelch
+        {"squelch_suppressed"},      // category::squelch_suppressed
+        {"consensus_duplicate"},     // category::consensus_duplicate
+        {"transaction_duplicate"},   // category::transaction_duplicate
+        {"transaction_suppressed"},  // category::transaction_suppressed
         {"get table data"},
         {"set_get"},                                    // category::get_set
         {"set_share"},                                  // category::share_set
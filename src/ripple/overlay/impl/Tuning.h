@@ -76,11 +76,25 @@ enum {
 
     /** How often to log send queue size */
     sendQueueLogFreq = 64,
+
+    /** The maximum number of queued messages sent in a single write */
+    maxWriteMessages = 64,
+
+    /** The maximum byte size of a single write, a larger message is
+        written alone */
+    maxWriteBytes = 65536,
+
+    /** The largest consensus message whose write may be delayed so that
+        the messages following it go in the same write */
+    smallWriteBytes = 1024,
 };
 
 /** The threshold above which we treat a peer connection as high latency */
 std::chrono::milliseconds constexpr peerHighLatency{300};
 
+/** The longest a write may be delayed to gather more messages */
+std::chrono::microseconds constexpr maxWriteDelay{5000};
+
 }  // namespace Tuning
 
 }  // namespace ripple
@@ -121,7 +121,9 @@ class FeatureCollections
         "TableSLEChange",
         "ContractStorage",
         "PromethSLEHideInMeta",
-        "TableGrant"
+        "TableGrant",
+        "TypedTableRows",
+        "BatchHash"
     };
     std::vector<uint256> features;
     boost::container::flat_map<uint256, std::size_t> featureToIndex;
@@ -396,6 +398,8 @@ extern uint256 const featureTableSleChange;
 extern uint256 const featureContractStorage;
 extern uint256 const featureTableGrant;
 extern uint256 const featurePromethSLEHideInMeta;
+extern uint256 const featureTypedTableRows;
+extern uint256 const featureBatchHash;
 
 }  // namespace ripple
 
@@ -413,6 +413,7 @@ public:
     STBase&
     getIndex(int offset)
     {
+        onModify();
         return v_[offset].get();
     }
     const STBase*
@@ -423,6 +424,7 @@ public:
     STBase*
     getPIndex(int offset)
     {
+        onModify();
         return &v_[offset].get();
     }
 
@@ -453,6 +455,8 @@ public:
     AccountID getAccountID (SField const& field) const;
 
     Blob getFieldVL (SField const& field) const;
+    // Like getFieldVL, without copying; valid while the field is unchanged
+    Slice getFieldSlice (SField const& field) const;
     STAmount const& getFieldAmount (SField const& field) const;
     STPathSet const& getFieldPathSet (SField const& field) const;
     const STVector256& getFieldV256 (SField const& field) const;
@@ -580,6 +584,14 @@ public:
         return !(*this == o);
     }
 
+protected:
+    // Called before any field is changed or handed out to be changed, so
+    // derived classes can drop what they derived from the fields.
+    virtual void
+    onModify()
+    {
+    }
+
 private:
     enum WhichFields : bool {
         // These values are carefully chosen to do the right thing if passed
@@ -24,10 +24,12 @@
 #include <ripple/protocol/PublicKey.h>
 #include <ripple/protocol/STArray.h>
 #include <ripple/protocol/STObject.h>
+#include <ripple/protocol/STTxView.h>
 #include <ripple/protocol/SecretKey.h>
 #include <ripple/protocol/TxFormats.h>
 #include <boost/container/flat_set.hpp>
 #include <boost/logic/tribool.hpp>
+#include <atomic>
 #include <functional>
 
 namespace ripple {
@@ -58,7 +60,8 @@ public:
     STTx&
     operator=(STTx const& other) = delete;
 
-    STTx(STTx const& other) = default;
+    // The copy decodes its own view, since it may be modified
+    STTx(STTx const& other);
 
     explicit STTx(
         SerialIter& sit,
@@ -212,6 +215,14 @@ public:
         return tid_;
     }
 
+    /** The commonly used fields, decoded on first use.
+        Changing a field drops the decoded view, so the next call decodes
+        the new values. A view held from before stays alive, but its
+        slices may no longer point into the transaction.
+    */
+    std::shared_ptr<STTxView const>
+    view() const;
+
     Json::Value
     getJson() const;
     Json::Value
@@ -281,6 +292,13 @@ private:
     TxType tx_type_;
     std::shared_ptr<std::vector<STTx>> pTxs_;
     std::shared_ptr<Json::Value> paJsonLog_;
+    void
+    onModify() override;
+
+    // Accessed atomically
+    mutable std::shared_ptr<STTxView const> view_;
+    // Whether view_ may be set, so modifying skips the atomic store
+    mutable std::atomic<bool> hasView_{false};
 };
 
 bool
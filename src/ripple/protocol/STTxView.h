@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#ifndef RIPPLE_PROTOCOL_STTXVIEW_H_INCLUDED
+#define RIPPLE_PROTOCOL_STTXVIEW_H_INCLUDED
+
+#include <ripple/basics/Slice.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/protocol/AccountID.h>
+#include <ripple/protocol/STAmount.h>
+#include <ripple/protocol/TxFormats.h>
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+class STTx;
+
+/** The commonly used fields of a transaction, decoded once.
+
+    Obtained with STTx::view(), which decodes them the first time it is
+    called and shares the result with every later caller.
+
+    The slices point into the transaction and are valid as long as it is
+    alive and the fields they point to are not changed. Changing any field
+    drops the transaction's view, and the next STTx::view() decodes again.
+*/
+class STTxView
+{
+public:
+    struct Table
+    {
+        uint160 nameInDB;
+        Slice name;
+
+        std::string
+        nameString() const
+        {
+            return std::string(
+                reinterpret_cast<char const*>(name.data()), name.size());
+        }
+    };
+
+    explicit STTxView(STTx const& tx);
+
+    STTxView(STTxView const&) = delete;
+    STTxView&
+    operator=(STTxView const&) = delete;
+
+    TxType type;
+    AccountID account;
+    std::uint32_t sequence;
+    STAmount fee;
+
+    // Table transactions only
+    boost::optional<std::uint16_t> opType;
+    boost::optional<AccountID> owner;
+    std::vector<Table> tables;
+    Slice raw;
+
+    /** The owner of the tables: sfOwner if present, else the account. */
+    AccountID const&
+    tableOwner() const
+    {
+        return owner ? *owner : account;
+    }
+};
+
+}  // namespace ripple
+
+#endif
@@ -99,6 +99,8 @@ detail::supportedAmendments()
         "TableSLEChange",
         "ContractStorage",
         "TableGrant",
+        "TypedTableRows",
+        "BatchHash",
         "MultiSign",      // Unconditionally supported.
         "Tickets",
         "TrustSetAuth",   // Unconditionally supported.
@@ -202,7 +204,9 @@ featureDecreaseStorage = *getRegisteredFeature("DecreaseStorage"),
 featureTableSleChange = *getRegisteredFeature("TableSLEChange"),
 featureContractStorage = *getRegisteredFeature("ContractStorage"),
 featurePromethSLEHideInMeta = *getRegisteredFeature("PromethSLEHideInMeta"),
-featureTableGrant = *getRegisteredFeature("TableGrant");
+featureTableGrant = *getRegisteredFeature("TableGrant"),
+featureTypedTableRows = *getRegisteredFeature("TypedTableRows"),
+featureBatchHash = *getRegisteredFeature("BatchHash");
 // uint256 const featureTrustSetAuth = *getRegisteredFeature("TrustSetAuth");
 // uint256 const featureFeeEscalation = *getRegisteredFeature("FeeEscalation");
 // uint256 const featureCompareFlowV1V2 = *getRegisteredFeature("CompareFlowV1V2");
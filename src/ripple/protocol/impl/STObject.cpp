@@ -70,6 +70,7 @@ STObject::STObject(SerialIter& sit, SField const& name, int depth) noexcept(
 STObject&
 STObject::operator=(STObject&& other)
 {
+    onModify();
     setFName(other.getFName());
     mType = other.mType;
     v_ = std::move(other.v_);
@@ -79,6 +80,7 @@ STObject::operator=(STObject&& other)
 void
 STObject::set(const SOTemplate& type)
 {
+    onModify();
     v_.clear();
     v_.reserve(type.size());
     mType = &type;
@@ -104,6 +106,7 @@ STObject::applyTemplate(const SOTemplate& type) noexcept(false)
     };
 
     mType = &type;
+    onModify();
     decltype(v_) v;
     v.reserve(type.size());
     for (auto const& e : type)
@@ -161,6 +164,7 @@ STObject::set(SerialIter& sit, int depth) noexcept(false)
 {
     bool reachedEndOfObject = false;
 
+    onModify();
     v_.clear();
 
     // Consume data in the pipe until we run out or reach the end
@@ -502,6 +506,7 @@ STObject::makeFieldAbsent(SField const& field)
 
     if (f.getSType() == STI_NOTPRESENT)
         return;
+    onModify();
     v_[index] = detail::STVar(detail::nonPresentObject, f.getFName());
 }
 
@@ -520,6 +525,7 @@ STObject::delField(SField const& field)
 void
 STObject::delField(int index)
 {
+    onModify();
     v_.erase(v_.begin() + index);
 }
 
@@ -579,6 +585,13 @@ STObject::getFieldVL(SField const& field) const
     return Blob(b.data(), b.data() + b.size());
 }
 
+Slice
+STObject::getFieldSlice(SField const& field) const
+{
+    static STBlob const empty{};
+    return getFieldByConstRef<STBlob>(field, empty).value();
+}
+
 STAmount const&
 STObject::getFieldAmount(SField const& field) const
 {
@@ -636,6 +649,7 @@ STObject::peekFieldM256(SField const& field)
 void
 STObject::set(std::unique_ptr<STBase> v)
 {
+    onModify();
     auto const i = getFieldIndex(v->getFName());
     if (i != -1)
     {
@@ -60,6 +60,17 @@ getTxFormat(TxType type)
     return format;
 }
 
+STTx::STTx(STTx const& other)
+    : STObject(other)
+    , CountedObject<STTx>(other)
+    , tidParent_(other.tidParent_)
+    , tid_(other.tid_)
+    , tx_type_(other.tx_type_)
+    , pTxs_(other.pTxs_)
+    , paJsonLog_(other.paJsonLog_)
+{
+}
+
 STTx::STTx(STObject&& object, CommonKey::HashType hashType) noexcept(false)
     : STObject (std::move (object))
 {
@@ -471,6 +482,28 @@ STTx::getSigningHash() const
     return STObject::getSigningHash(HashPrefix::txSign);
 }
 
+std::shared_ptr<STTxView const>
+STTx::view() const
+{
+    auto v = std::atomic_load(&view_);
+    if (!v)
+    {
+        // Threads racing here decode the same fields; the first one wins
+        auto decoded = std::make_shared<STTxView const>(*this);
+        hasView_ = true;
+        if (std::atomic_compare_exchange_strong(&view_, &v, decoded))
+            v = std::move(decoded);
+    }
+    return v;
+}
+
+void
+STTx::onModify()
+{
+    if (hasView_.exchange(false))
+        std::atomic_store(&view_, std::shared_ptr<STTxView const>());
+}
+
 Blob
 STTx::getSignature() const
 {
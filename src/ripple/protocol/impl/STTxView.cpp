@@ -0,0 +1,56 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <ripple/protocol/STArray.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/protocol/STTxView.h>
+
+namespace ripple {
+
+STTxView::STTxView(STTx const& tx)
+    : type(tx.getTxnType())
+    , account(tx.getAccountID(sfAccount))
+    , sequence(tx.getFieldU32(sfSequence))
+    , fee(tx.getFieldAmount(sfFee))
+{
+    if (tx.isFieldPresent(sfOpType))
+        opType = tx.getFieldU16(sfOpType);
+    if (tx.isFieldPresent(sfOwner))
+        owner = tx.getAccountID(sfOwner);
+    if (tx.isFieldPresent(sfRaw))
+        raw = tx.getFieldSlice(sfRaw);
+
+    if (tx.isFieldPresent(sfTables))
+    {
+        auto const& array = tx.getFieldArray(sfTables);
+        tables.reserve(array.size());
+        for (auto const& table : array)
+        {
+            // Table entries have no template, so each lookup is a scan
+            Table t;
+            if (table.isFieldPresent(sfNameInDB))
+                t.nameInDB = table.getFieldH160(sfNameInDB);
+            if (table.isFieldPresent(sfTableName))
+                t.name = table.getFieldSlice(sfTableName);
+            tables.push_back(t);
+        }
+    }
+}
+
+}  // namespace ripple
@@ -504,6 +504,7 @@ JSS(state_accounting);    // out: NetworkOPs
 JSS(state_now);           // in: Subscribe
 JSS(status);              // error
 JSS(stop);                // in: LedgerCleaner
+JSS(stream);              // in: AccountTx, LedgerData, TxHistory, r_get
 JSS(streams);             // in: Subscribe, Unsubscribe
 JSS(strict);              // in: AccountCurrencies, AccountInfo
 JSS(sub_index);           // in: LedgerEntry
@@ -27,6 +27,8 @@
 
 #include <ripple/beast/utility/Journal.h>
 
+#include <functional>
+
 namespace ripple {
 
 class Schema;
@@ -64,6 +66,14 @@ struct JsonContext : public Context
     Json::Value params;
 
     Headers headers{};
+
+    /** Set when the response is streamed to the client.
+
+        Bulk reads that support streaming pass each row here as it is
+        produced, instead of adding it to the result, and stop early if
+        it returns false because the client has gone away.
+    */
+    std::function<bool(Json::Value const&)> rowSink{};
 };
 
 template <class RequestType>
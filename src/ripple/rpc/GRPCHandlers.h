@@ -23,6 +23,7 @@
 #include <ripple/rpc/Context.h>
 #include <grpcpp/grpcpp.h>
 #include <org/zxcl/rpc/v1/zxc_ledger.pb.h>
+#include <functional>
 
 namespace ripple {
 
@@ -56,6 +57,33 @@ doAccountTxGrpc(
     RPC::GRPCContext<org::zxcl::rpc::v1::GetAccountTransactionHistoryRequest>&
         context);
 
+/*
+ * The streaming handlers pass each message to send as it is produced, which
+ * may suspend the coroutine until the client catches up, and stop early if it
+ * returns false because the call is over. The returned status ends the call.
+ */
+
+grpc::Status
+doLedgerDataStreamGrpc(
+    RPC::GRPCContext<org::zxcl::rpc::v1::StreamLedgerDataRequest>& context,
+    std::function<bool(org::zxcl::rpc::v1::StreamLedgerDataResponse&&)> const&
+        send);
+
+grpc::Status
+doAccountTxStreamGrpc(
+    RPC::GRPCContext<
+        org::zxcl::rpc::v1::StreamAccountTransactionHistoryRequest>& context,
+    std::function<bool(
+        org::zxcl::rpc::v1::StreamAccountTransactionHistoryResponse&&)> const&
+        send);
+
+grpc::Status
+doTxHistoryStreamGrpc(
+    RPC::GRPCContext<org::zxcl::rpc::v1::StreamTransactionHistoryRequest>&
+        context,
+    std::function<bool(org::zxcl::rpc::v1::StreamTransactionHistoryResponse&&)>
+        const& send);
+
 }  // namespace ripple
 
 #endif
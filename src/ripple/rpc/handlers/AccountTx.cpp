@@ -30,9 +30,11 @@
 #include <ripple/resource/Fees.h>
 #include <ripple/rpc/Context.h>
 #include <ripple/rpc/DeliveredAmount.h>
+#include <ripple/rpc/GRPCHandlers.h>
 #include <ripple/rpc/Role.h>
 #include <ripple/rpc/impl/GRPCHelpers.h>
 #include <ripple/rpc/impl/RPCHelpers.h>
+#include <ripple/rpc/impl/Tuning.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <grpcpp/grpcpp.h>
 #include <ripple/app/misc/impl/AccountTxPaging.h>
@@ -78,9 +80,11 @@ struct AccountTxResult
 };
 
 // parses args into a ledger specifier, or returns a grpc status object on error
+// Request is GetAccountTransactionHistoryRequest or
+// StreamAccountTransactionHistoryRequest
+template <class Request>
 std::variant<std::optional<LedgerSpecifier>, grpc::Status>
-parseLedgerArgs(
-    org::zxcl::rpc::v1::GetAccountTransactionHistoryRequest const& params)
+parseLedgerArgs(Request const& params)
 {
     grpc::Status status;
     if (params.has_ledger_range())
@@ -326,6 +330,16 @@ doAccountTxHelp(RPC::Context& context, AccountTxArgs const& args)
     return {result, rpcSUCCESS};
 }
 
+grpc::Status
+toGrpcStatus(RPC::Status const& error)
+{
+    if (error.toErrorCode() == rpcLGR_NOT_FOUND)
+        return {grpc::StatusCode::NOT_FOUND, error.message()};
+    if (error.toErrorCode() == rpcNOT_SYNCED)
+        return {grpc::StatusCode::FAILED_PRECONDITION, error.message()};
+    return {grpc::StatusCode::INVALID_ARGUMENT, error.message()};
+}
+
 std::pair<
     org::zxcl::rpc::v1::GetAccountTransactionHistoryResponse,
     grpc::Status>
@@ -341,18 +355,7 @@ populateProtoResponse(
     RPC::Status const& error = res.second;
     if (error.toErrorCode() != rpcSUCCESS)
     {
-        if (error.toErrorCode() == rpcLGR_NOT_FOUND)
-        {
-            status = {grpc::StatusCode::NOT_FOUND, error.message()};
-        }
-        else if (error.toErrorCode() == rpcNOT_SYNCED)
-        {
-            status = {grpc::StatusCode::FAILED_PRECONDITION, error.message()};
-        }
-        else
-        {
-            status = {grpc::StatusCode::INVALID_ARGUMENT, error.message()};
-        }
+        status = toGrpcStatus(error);
     }
     else
     {
@@ -474,6 +477,14 @@ populateJsonResponse(
 
         Json::Value& jvTxns = (response[jss::transactions] = Json::arrayValue);
 
+        // When streaming, the transactions go to the sink instead
+        auto addTxn = [&](Json::Value&& jvObj) {
+            if (context.rowSink)
+                return context.rowSink(jvObj);
+            jvTxns.append(std::move(jvObj));
+            return true;
+        };
+
         if (auto txnsData = std::get_if<TxnsData>(&result.transactions))
         {
             assert(!args.binary);
@@ -481,7 +492,7 @@ populateJsonResponse(
             {
                 if (txn)
                 {
-                    Json::Value& jvObj = jvTxns.append(Json::objectValue);
+                    Json::Value jvObj(Json::objectValue);
 
                     jvObj[jss::tx] = txn->getJson(JsonOptions::include_date);
                     if (txnMeta)
@@ -492,6 +503,8 @@ populateJsonResponse(
                         insertDeliveredAmount(
                             jvObj[jss::meta], context, txn, *txnMeta);
                     }
+                    if (!addTxn(std::move(jvObj)))
+                        break;
                 }
             }
         }
@@ -502,12 +515,14 @@ populateJsonResponse(
             for (auto const& binaryData :
                  std::get<TxnsDataBinary>(result.transactions))
             {
-                Json::Value& jvObj = jvTxns.append(Json::objectValue);
+                Json::Value jvObj(Json::objectValue);
 
                 jvObj[jss::tx_blob] = strHex(std::get<0>(binaryData));
                 jvObj[jss::meta] = strHex(std::get<1>(binaryData));
                 jvObj[jss::ledger_index] = std::get<2>(binaryData);
                 jvObj[jss::validated] = true;
+                if (!addTxn(std::move(jvObj)))
+                    break;
             }
         }
 
@@ -530,6 +545,8 @@ populateJsonResponse(
 //   limit: integer,                 // optional
 //   marker: object {ledger: ledger_index, seq: txn_sequence} // optional,
 //   resume previous query
+//   stream: boolean                 // optional, send the transactions as
+//   they are read; unlimited roles are sent every page up to the limit
 // }
 Json::Value
 doAccountTxJson(RPC::JsonContext& context)
@@ -582,8 +599,43 @@ doAccountTxJson(RPC::JsonContext& context)
         args.marker = {token[jss::ledger].asUInt(), token[jss::seq].asUInt()};
     }
 
-    auto res = doAccountTxHelp(context, args);
-    return populateJsonResponse(res, args, context);
+    if (!context.rowSink || !isUnlimited(context.role))
+    {
+        auto res = doAccountTxHelp(context, args);
+        return populateJsonResponse(res, args, context);
+    }
+
+    // Streaming to an unlimited role: read page after page, up to the limit
+    // if there is one, holding one page in memory at a time
+    bool stopped = false;
+    auto const sink = context.rowSink;
+    context.rowSink = [&](Json::Value const& row) {
+        stopped = !sink(row);
+        return !stopped;
+    };
+
+    auto const total = args.limit;
+    std::uint32_t received = 0;
+    for (;;)
+    {
+        args.limit = RPC::Tuning::streamPageLength;
+        if (total != 0)
+            args.limit = std::min(args.limit, total - received);
+
+        auto res = doAccountTxHelp(context, args);
+        response = populateJsonResponse(res, args, context);
+        if (res.second.toErrorCode() != rpcSUCCESS)
+            return response;
+
+        received += std::visit(
+            [](auto const& txns) { return txns.size(); },
+            res.first.transactions);
+        if (stopped || !res.first.marker || (total != 0 && received >= total))
+            break;
+        args.marker = res.first.marker;
+    }
+    response[jss::limit] = total;
+    return response;
 }
 
 std::pair<
@@ -640,6 +692,98 @@ doAccountTxGrpc(
     return populateProtoResponse(res, args, context);
 }
 
+static org::zxcl::rpc::v1::StreamAccountTransactionHistoryResponse
+accountTxStreamPage(AccountTxResult const& result)
+{
+    org::zxcl::rpc::v1::StreamAccountTransactionHistoryResponse page;
+    auto const& txns = std::get<TxnsDataBinary>(result.transactions);
+    for (auto const& [txn, meta, ledgerSeq] : txns)
+    {
+        auto proto = page.add_transactions();
+        Blob const txnBlob = *strUnHex(txn);
+        proto->set_transaction(txnBlob.data(), txnBlob.size());
+        Blob const metaBlob = *strUnHex(meta);
+        proto->set_meta(metaBlob.data(), metaBlob.size());
+        proto->set_ledger_index(ledgerSeq);
+    }
+    if (result.marker)
+    {
+        page.mutable_marker()->set_ledger_index(result.marker->ledgerSeq);
+        page.mutable_marker()->set_account_sequence(result.marker->txnSeq);
+    }
+    return page;
+}
+
+grpc::Status
+doAccountTxStreamGrpc(
+    RPC::GRPCContext<
+        org::zxcl::rpc::v1::StreamAccountTransactionHistoryRequest>& context,
+    std::function<bool(
+        org::zxcl::rpc::v1::StreamAccountTransactionHistoryResponse&&)> const&
+        send)
+{
+    if (!context.app.config().useTxTables())
+        return {
+            grpc::StatusCode::UNIMPLEMENTED, "Not enabled in configuration."};
+
+    AccountTxArgs args;
+    auto& request = context.params;
+
+    auto const account = parseBase58<AccountID>(request.account().address());
+    if (!account)
+        return {grpc::StatusCode::INVALID_ARGUMENT, "Could not decode account"};
+
+    args.account = *account;
+    args.binary = true;
+    args.forward = request.forward();
+
+    if (request.has_marker())
+    {
+        args.marker = {
+            request.marker().ledger_index(),
+            request.marker().account_sequence()};
+    }
+
+    auto parseRes = parseLedgerArgs(request);
+    if (auto stat = std::get_if<grpc::Status>(&parseRes))
+        return *stat;
+    args.ledger = std::get<std::optional<LedgerSpecifier>>(parseRes);
+
+    // Other roles get a single page, as over HTTP, and continue from its
+    // marker
+    if (!isUnlimited(context.role))
+    {
+        args.limit = request.limit();
+        auto res = doAccountTxHelp(context, args);
+        if (res.second.toErrorCode() != rpcSUCCESS)
+            return toGrpcStatus(res.second);
+        send(accountTxStreamPage(res.first));
+        return grpc::Status::OK;
+    }
+
+    // One message for each page read, holding one page in memory at a time
+    auto const total = request.limit();
+    std::uint32_t received = 0;
+    for (;;)
+    {
+        args.limit = RPC::Tuning::streamPageLength;
+        if (total != 0)
+            args.limit = std::min(args.limit, total - received);
+
+        auto res = doAccountTxHelp(context, args);
+        if (res.second.toErrorCode() != rpcSUCCESS)
+            return toGrpcStatus(res.second);
+
+        received +=
+            std::get<TxnsDataBinary>(res.first.transactions).size();
+        if (!send(accountTxStreamPage(res.first)) || !res.first.marker ||
+            (total != 0 && received >= total))
+            break;
+        args.marker = res.first.marker;
+    }
+    return grpc::Status::OK;
+}
+
 std::pair<AccountTxResult, RPC::Status>
 doContractTxHelp(RPC::Context& context, AccountTxArgs const& args)
 {
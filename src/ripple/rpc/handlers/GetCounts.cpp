@@ -20,11 +20,13 @@
 #include <ripple/app/ledger/AcceptedLedger.h>
 #include <ripple/app/ledger/InboundLedgers.h>
 #include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/OpenLedger.h>
 #include <peersafe/schema/Schema.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/basics/UptimeClock.h>
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/json/json_value.h>
+#include <ripple/ledger/ApplyArena.h>
 #include <ripple/ledger/CachedSLEs.h>
 #include <ripple/net/RPCErr.h>
 #include <ripple/nodestore/Database.h>
@@ -34,7 +36,12 @@
 #include <ripple/rpc/Context.h>
 #include <ripple/shamap/ShardFamily.h>
 #include <peersafe/app/misc/ConnectionPool.h>
+#include <peersafe/app/ledger/TxSetPreflight.h>
+#include <peersafe/app/misc/ContractHelper.h>
 #include <peersafe/app/sql/TxnDBConn.h>
+#include <peersafe/app/table/QueryCache.h>
+#include <peersafe/app/table/TableMirror.h>
+#include <eth/vm/executor/interpreter/interpreter.h>
 
 namespace ripple {
 
@@ -111,6 +118,24 @@ getCountsJson(Schema& app, int minObjectCount)
     ret["LedgerHistorySize"] =
         app.getLedgerMaster().getLedgerHistory().getCacheSize();
     ret["HeldTransactionSize"] = app.getLedgerMaster().heldTransactionSize();
+    ret["open_ledger"] = app.openLedger().getJson();
+    ret["tx_batch"] = app.getOPs().getTxBatchInfo();
+    if (app.getQueryCache().enabled())
+        ret["query_cache"] = app.getQueryCache().getJson();
+    if (app.getTableMirror().enabled())
+        ret["table_mirror"] = app.getTableMirror().getJson();
+    if (app.getContractHelper().prefetch().enabled())
+        ret["storage_prefetch"] = app.getContractHelper().prefetch().getJson();
+    if (app.getTxSetPreflight().enabled())
+        ret["tx_set_preflight"] = app.getTxSetPreflight().getJson();
+    ret["apply_arena"] = ApplyArena::getJson();
+    {
+        auto const pool = eth::interpreterPoolStats();
+        Json::Value& vm = ret["vm_pool"] = Json::objectValue;
+        vm["created"] = static_cast<Json::UInt>(pool.created);
+        vm["reused"] = static_cast<Json::UInt>(pool.reused);
+        vm["memory_grows"] = static_cast<Json::UInt>(pool.memoryGrows);
+    }
 
     ret["state_leafset_cache_size"] =
         static_cast<int> (app.getNodeFamily().getStateNodeHashSet()->size());
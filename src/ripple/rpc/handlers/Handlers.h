@@ -171,6 +171,7 @@ Json::Value doLedgerTxs             (RPC::JsonContext&);
 Json::Value doGetCrossChainTx       (RPC::JsonContext&);
 Json::Value doTxCount				(RPC::JsonContext&);
 Json::Value doLedgerObjects			(RPC::JsonContext&);
+Json::Value doLedgerTimeline        (RPC::JsonContext&);
 Json::Value doNodeSize              (RPC::JsonContext&);
 Json::Value doMallocTrim            (RPC::JsonContext&);
 Json::Value doSchemaList			(RPC::JsonContext&);
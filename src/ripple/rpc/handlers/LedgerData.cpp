@@ -23,9 +23,12 @@
 #include <ripple/protocol/LedgerFormats.h>
 #include <ripple/protocol/jss.h>
 #include <ripple/rpc/Context.h>
+#include <ripple/rpc/GRPCHandlers.h>
 #include <ripple/rpc/Role.h>
 #include <ripple/rpc/impl/RPCHelpers.h>
 #include <ripple/rpc/impl/Tuning.h>
+#include <limits>
+#include <utility>
 
 namespace ripple {
 
@@ -35,6 +38,8 @@ namespace ripple {
 //     marker:       opaque, resume point
 //     binary:       boolean, format
 //     type:         string // optional, defaults to all ledger node types
+//     stream:       boolean // optional, send the state nodes as they are
+//                           // read; unlimited roles then default to no limit
 //   Outputs:
 //     ledger_hash:  chosen ledger's hash
 //     ledger_index: chosen ledger's index
@@ -71,6 +76,9 @@ doLedgerData(RPC::JsonContext& context)
         limit = jLimit.asInt();
     }
 
+    if (limit < 0 && context.rowSink && isUnlimited(context.role))
+        limit = std::numeric_limits<int>::max();
+
     auto maxLimit = RPC::Tuning::pageLength(isBinary);
     if ((limit < 0) || ((limit > maxLimit) && (!isUnlimited(context.role))))
         limit = maxLimit;
@@ -92,7 +100,12 @@ doLedgerData(RPC::JsonContext& context)
         rpcStatus.inject(jvResult);
         return jvResult;
     }
-    Json::Value& nodes = jvResult[jss::state];
+    auto addNode = [&](Json::Value&& entry) {
+        if (context.rowSink)
+            return context.rowSink(entry);
+        jvResult[jss::state].append(std::move(entry));
+        return true;
+    };
 
     auto e = lpLedger->sles.end();
     for (auto i = lpLedger->sles.upper_bound(key); i != e; ++i)
@@ -108,22 +121,88 @@ doLedgerData(RPC::JsonContext& context)
 
         if (type == ltINVALID || sle->getType() == type)
         {
+            Json::Value entry;
             if (isBinary)
             {
-                Json::Value& entry = nodes.append(Json::objectValue);
+                entry = Json::objectValue;
                 entry[jss::data] = serializeHex(*sle);
-                entry[jss::index] = to_string(sle->key());
             }
             else
             {
-                Json::Value& entry =
-                    nodes.append(sle->getJson(JsonOptions::none));
-                entry[jss::index] = to_string(sle->key());
+                entry = sle->getJson(JsonOptions::none);
             }
+            entry[jss::index] = to_string(sle->key());
+            if (!addNode(std::move(entry)))
+                break;
         }
     }
 
     return jvResult;
 }
 
+grpc::Status
+doLedgerDataStreamGrpc(
+    RPC::GRPCContext<org::zxcl::rpc::v1::StreamLedgerDataRequest>& context,
+    std::function<bool(org::zxcl::rpc::v1::StreamLedgerDataResponse&&)> const&
+        send)
+{
+    auto const& request = context.params;
+
+    std::shared_ptr<ReadView const> ledger;
+    auto lgrStatus =
+        RPC::ledgerFromSpecifier(ledger, request.ledger(), context);
+    if (lgrStatus || !ledger)
+    {
+        if (lgrStatus.toErrorCode() == rpcINVALID_PARAMS)
+        {
+            return grpc::Status(
+                grpc::StatusCode::INVALID_ARGUMENT, lgrStatus.message());
+        }
+        return grpc::Status(grpc::StatusCode::NOT_FOUND, lgrStatus.message());
+    }
+
+    ReadView::key_type key;
+    if (!request.marker().empty())
+    {
+        if (request.marker().size() != ReadView::key_type::size())
+            return {grpc::StatusCode::INVALID_ARGUMENT, "marker malformed"};
+        key = ReadView::key_type::fromVoid(request.marker().data());
+    }
+
+    org::zxcl::rpc::v1::StreamLedgerDataResponse batch;
+    auto const newBatch = [&]() {
+        batch.set_ledger_index(ledger->info().seq);
+        batch.set_ledger_hash(
+            ledger->info().hash.data(), ledger->info().hash.size());
+    };
+    newBatch();
+
+    // Past the usual page only to an unlimited role. The others resume
+    // from the key of the last object they received.
+    int left = isUnlimited(context.role)
+        ? std::numeric_limits<int>::max()
+        : RPC::Tuning::binaryPageLength;
+    auto e = ledger->sles.end();
+    for (auto i = ledger->sles.upper_bound(key); i != e && left > 0;
+         ++i, --left)
+    {
+        auto const& sle = *i;
+        auto object = batch.add_objects();
+        object->set_key(sle->key().data(), sle->key().size());
+        Serializer s;
+        sle->add(s);
+        object->set_data(s.data(), s.size());
+
+        if (batch.objects_size() < RPC::Tuning::grpcStreamBatch)
+            continue;
+        if (!send(std::exchange(batch, {})))
+            return grpc::Status::OK;
+        newBatch();
+    }
+
+    if (batch.objects_size() > 0)
+        send(std::move(batch));
+    return grpc::Status::OK;
+}
+
 }  // namespace ripple
@@ -25,11 +25,18 @@
 #include <ripple/core/SociDB.h>
 #include <ripple/net/RPCErr.h>
 #include <ripple/protocol/ErrorCodes.h>
+#include <ripple/protocol/TxFormats.h>
 #include <ripple/protocol/jss.h>
 #include <ripple/resource/Fees.h>
 #include <ripple/rpc/Context.h>
+#include <ripple/rpc/GRPCHandlers.h>
 #include <ripple/rpc/Role.h>
+#include <ripple/rpc/impl/Tuning.h>
 #include <boost/format.hpp>
+#include <functional>
+#include <limits>
+#include <tuple>
+#include <utility>
 
 namespace ripple {
 
@@ -49,9 +56,120 @@ parseTypes(Json::Value const& jvArray)
     return result;
 }
 
+namespace {
+
+// Returns the (TransID, TxResult, LedgerSeq) rows of the query, holding the
+// database only while reading them
+std::vector<std::tuple<uint256, std::string, std::uint32_t>>
+readTxHistory(RPC::Context& context, std::string const& sql)
+{
+    std::vector<std::tuple<uint256, std::string, std::uint32_t>> rows;
+    auto db = context.app.getTxnDB().checkoutDbRead();
+
+    boost::optional<std::string> stxnHash;
+    boost::optional<std::string> stxnResult;
+    boost::optional<std::uint64_t> ledgerSeq;
+    soci::statement st =
+        (db->prepare << sql,
+         soci::into(stxnHash),
+         soci::into(stxnResult),
+         soci::into(ledgerSeq));
+    st.execute();
+
+    while (st.fetch())
+    {
+        rows.emplace_back(
+            from_hex_text<uint256>(stxnHash.value()),
+            stxnResult.value_or(""),
+            static_cast<std::uint32_t>(ledgerSeq.value_or(0)));
+    }
+    return rows;
+}
+
+std::string
+typesCondition(std::vector<std::string> const& txTypes)
+{
+    if (txTypes.empty())
+    {
+        return "TransType != 'EnableAmendment' "
+               "AND TransType != 'SetFee' AND TransType != 'UNLModify'";
+    }
+
+    std::string cond;
+    for (std::size_t idx = 0; idx < txTypes.size(); idx++)
+    {
+        cond += boost::str(boost::format("TransType = '%s'") % txTypes[idx]);
+        if (idx != txTypes.size() - 1)
+            cond += " OR ";
+    }
+    return cond;
+}
+
+// Calls f with each transaction of the history matching cond, most recent
+// first, skipping the first startIndex of them. Up to total transactions
+// are read, a page at a time if allPages. Returns false if f does.
+bool
+forEachTxHistory(
+    RPC::Context& context,
+    std::string const& cond,
+    std::uint32_t startIndex,
+    std::uint32_t total,
+    bool allPages,
+    std::function<bool(Transaction const&, std::string const&)> const& f)
+{
+    // Pages after the first resume after the last row read rather than
+    // skip the rows before it, so the ties on LedgerSeq are broken by
+    // TransID
+    std::uint32_t const pageLength =
+        allPages ? RPC::Tuning::streamPageLength : total;
+    std::string sql = boost::str(
+        boost::format("SELECT TransID, TxResult, LedgerSeq "
+                      "FROM Transactions WHERE (%s) "
+                      "ORDER BY LedgerSeq desc%s LIMIT %u,%u;") %
+        cond % (allPages ? ", TransID desc" : "") % startIndex %
+        std::min(pageLength, total));
+
+    std::uint32_t received = 0;
+    for (;;)
+    {
+        auto const rows = readTxHistory(context, sql);
+
+        for (auto const& [txID, result, ledgerSeq] : rows)
+        {
+            auto txn = context.app.getMasterTransaction().fetch(txID);
+            if (!txn)
+            {
+                continue;
+            }
+
+            if (!f(*txn, result))
+                return false;
+        }
+
+        received += rows.size();
+        if (!allPages || rows.size() < pageLength || received >= total)
+            return true;
+
+        auto const& last = rows.back();
+        sql = boost::str(
+            boost::format(
+                "SELECT TransID, TxResult, LedgerSeq "
+                "FROM Transactions WHERE (%s) AND (LedgerSeq < %u OR "
+                "(LedgerSeq = %u AND TransID < '%s')) "
+                "ORDER BY LedgerSeq desc, TransID desc LIMIT %u;") %
+            cond % std::get<2>(last) % std::get<2>(last) %
+            to_string(std::get<0>(last)) %
+            std::min(pageLength, total - received));
+    }
+}
+
+}  // namespace
+
 // {
 //   "start": <index>
 //   "types": [type1, type2...]
+//   "stream": boolean  // optional, send the transactions as they are read
+//   "limit": <count>   // optional, when streaming to an unlimited role
 // }
 Json::Value
 doTxHistory(RPC::JsonContext& context)
@@ -86,69 +204,114 @@ doTxHistory(RPC::JsonContext& context)
         }
     }
 
+    // Past the usual 20 transactions only when streaming to an unlimited
+    // role, up to the limit if there is one
+    bool const allPages = context.rowSink && isUnlimited(context.role);
+    std::uint32_t total = 20;
+    if (allPages)
+    {
+        total = std::numeric_limits<std::uint32_t>::max();
+        if (context.params.isMember(jss::limit) &&
+            context.params[jss::limit].asUInt() > 0)
+            total = context.params[jss::limit].asUInt();
+    }
+
     Json::Value obj;
     Json::Value txs;
 
     obj[jss::index] = startIndex;
 
-    std::string sql;
-
-    if (txTypes.size() <= 0)
-    {
-        sql = boost::str(
-            boost::format(
-                "SELECT TransID, TxResult "
-                "FROM Transactions WHERE (TransType != 'EnableAmendment' "
-                "AND TransType != 'SetFee' AND TransType != 'UNLModify') "
-                "ORDER BY LedgerSeq desc LIMIT %u,20;") %
-            startIndex);
-    }
-    else
-    {
-        std::string cond;
-        for (std::size_t idx = 0; idx < txTypes.size(); idx++)
-        {
-            cond +=
-                boost::str(boost::format("TransType = '%s'") % txTypes[idx]);
-            if (idx != txTypes.size() - 1)
-                cond += " OR ";
-        }
+    bool const complete = forEachTxHistory(
+        context,
+        typesCondition(txTypes),
+        startIndex,
+        total,
+        allPages,
+        [&](Transaction const& txn, std::string const& result) {
+            Json::Value jvTx = txn.getJson(JsonOptions::include_date);
+            jvTx["TransactionResult"] = result;
 
-        sql = boost::str(
-            boost::format("SELECT TransID, TxResult "
-                          "FROM Transactions WHERE (%s) "
-                          "ORDER BY LedgerSeq desc LIMIT %u,20;") %
-            cond % startIndex);
-    }
+            if (!context.rowSink)
+            {
+                txs.append(jvTx);
+                return true;
+            }
+            return context.rowSink(jvTx);
+        });
 
-    {
-        auto db = context.app.getTxnDB().checkoutDbRead();
+    if (complete && !context.rowSink)
+        obj[jss::txs] = txs;
 
-        boost::optional<std::string> stxnHash;
-        boost::optional<std::string> stxnResult;
-        soci::statement st =
-            (db->prepare << sql, soci::into(stxnHash), soci::into(stxnResult));
-        st.execute();
+    return obj;
+}
 
-        while (st.fetch())
-        {
-            uint256 txID = from_hex_text<uint256>(stxnHash.value());
-            auto txn = context.app.getMasterTransaction().fetch(txID);
-            if (!txn)
-            {
-                continue;
-            }
+grpc::Status
+doTxHistoryStreamGrpc(
+    RPC::GRPCContext<org::zxcl::rpc::v1::StreamTransactionHistoryRequest>&
+        context,
+    std::function<bool(org::zxcl::rpc::v1::StreamTransactionHistoryResponse&&)>
+        const& send)
+{
+    if (!context.app.config().useTxTables())
+        return {
+            grpc::StatusCode::UNIMPLEMENTED, "Not enabled in configuration."};
 
-            Json::Value obj = txn->getJson(JsonOptions::include_date);
-            obj["TransactionResult"] = stxnResult.value();
+    auto const& request = context.params;
+    if (request.start() > 10000 && !isUnlimited(context.role))
+        return {grpc::StatusCode::PERMISSION_DENIED, "start is too large"};
 
-            txs.append(obj);
+    std::vector<std::string> txTypes;
+    for (auto const& type : request.types())
+    {
+        // The names go into the query, so only known ones are accepted
+        try
+        {
+            TxFormats::getInstance().findTypeByName(type);
+        }
+        catch (std::exception const&)
+        {
+            return {
+                grpc::StatusCode::INVALID_ARGUMENT, "Field types is malformed"};
         }
+        if (type != "EnableAmendment" && type != "SetFee" &&
+            type != "UNLModify")
+            txTypes.push_back(type);
     }
+    if (request.types_size() > 0 && txTypes.empty())
+        return {grpc::StatusCode::INVALID_ARGUMENT, "Field types is malformed"};
 
-    obj[jss::txs] = txs;
+    // Past the usual 20 transactions only to an unlimited role, as over
+    // HTTP. The others continue with a higher start.
+    bool const allPages = isUnlimited(context.role);
+    std::uint32_t total = 20;
+    if (allPages)
+    {
+        total = request.limit() > 0
+            ? request.limit()
+            : std::numeric_limits<std::uint32_t>::max();
+    }
 
-    return obj;
+    org::zxcl::rpc::v1::StreamTransactionHistoryResponse batch;
+    bool const complete = forEachTxHistory(
+        context,
+        typesCondition(txTypes),
+        request.start(),
+        total,
+        allPages,
+        [&](Transaction const& txn, std::string const& result) {
+            auto proto = batch.add_transactions();
+            auto const s = txn.getSTransaction()->getSerializer();
+            proto->set_transaction(s.data(), s.size());
+            proto->set_result(result);
+            proto->set_ledger_index(txn.getLedger());
+            if (batch.transactions_size() < RPC::Tuning::grpcStreamBatch)
+                return true;
+            return send(std::exchange(batch, {}));
+        });
+
+    if (complete && batch.transactions_size() > 0)
+        send(std::move(batch));
+    return grpc::Status::OK;
 }
 
 }  // namespace ripple
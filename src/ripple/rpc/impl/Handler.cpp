@@ -69,7 +69,7 @@ Handler const handlerArray[]{
     {"account_channels", byRef(&doAccountChannels), Role::USER, NO_CONDITION},
     {"account_objects", byRef(&doAccountObjects), Role::USER, NO_CONDITION},
     {"account_offers", byRef(&doAccountOffers), Role::USER, NO_CONDITION},
-    {"account_tx", byRef(&doAccountTxJson), Role::USER, NO_CONDITION},
+    {"account_tx", byRef(&doAccountTxJson), Role::USER, NO_CONDITION, true},
     {"account_authorized", byRef(&doAccountAuthorized), Role::USER, NO_CONDITION},
     {"contract_tx", byRef(&doContractTxJson), Role::USER, NO_CONDITION},
     {"blacklist", byRef(&doBlackList), Role::ADMIN, NO_CONDITION},
@@ -102,7 +102,7 @@ Handler const handlerArray[]{
      byRef(&doLedgerCurrent),
      Role::USER,
      NEEDS_CURRENT_LEDGER},
-    {"ledger_data", byRef(&doLedgerData), Role::USER, NO_CONDITION},
+    {"ledger_data", byRef(&doLedgerData), Role::USER, NO_CONDITION, true},
     {"ledger_entry", byRef(&doLedgerEntry), Role::USER, NO_CONDITION},
     {"ledger_header", byRef(&doLedgerHeader), Role::USER, NO_CONDITION},
     {"ledger_request", byRef(&doLedgerRequest), Role::ADMIN, NO_CONDITION},
@@ -151,7 +151,7 @@ Handler const handlerArray[]{
      Role::USER,
      NEEDS_NETWORK_CONNECTION},
     {"tx_merkle_verify", byRef(&doTxMerkleVerify), Role::USER, NO_CONDITION},
-    {"tx_history", byRef(&doTxHistory), Role::USER, NO_CONDITION},
+    {"tx_history", byRef(&doTxHistory), Role::USER, NO_CONDITION, true},
     {"unl_list", byRef(&doUnlList), Role::ADMIN, NO_CONDITION},
     {"validation_create",
      byRef(&doValidationCreate),
@@ -191,7 +191,7 @@ Handler const handlerArray[]{
     {"r_update", byRef(&doRpcSubmit), Role::USER, NO_CONDITION},
     {"r_delete", byRef(&doRpcSubmit), Role::USER, NO_CONDITION},
     {"t_sqlTxs", byRef(&doRpcSubmit), Role::USER, NO_CONDITION},
-    {"r_get", byRef(&doGetRecord), Role::USER, NO_CONDITION},
+    {"r_get", byRef(&doGetRecord), Role::USER, NO_CONDITION, true},
     {"r_get_sql_admin", byRef(&doGetRecordBySql), Role::ADMIN, NO_CONDITION},
     {"r_get_sql_user", byRef(&doGetRecordBySqlUser), Role::USER, NO_CONDITION},
     {"readraw_create", byRef(&doCreateFromRaw), Role::USER, NO_CONDITION},
@@ -212,6 +212,7 @@ Handler const handlerArray[]{
     {"g_cryptdata", byRef(&doCryptData), Role::USER, NO_CONDITION},
 
     {"ledger_objects", byRef(&doLedgerObjects), Role::USER, NO_CONDITION},
+    {"ledger_timeline", byRef(&doLedgerTimeline), Role::ADMIN, NO_CONDITION},
     {"node_size", byRef(&doNodeSize), Role::ADMIN, NO_CONDITION},
     {"malloc_trim", byRef(&doMallocTrim), Role::ADMIN, NO_CONDITION},
     {"schema_list", byRef(&doSchemaList), Role::USER, NO_CONDITION},
@@ -52,6 +52,9 @@ struct Handler
     Method<Json::Value> valueMethod_;
     Role role_;
     RPC::Condition condition_;
+
+    // Whether the method can stream its rows, see JsonContext::rowSink
+    bool streaming_ = false;
 };
 
 Handler const*
@@ -274,25 +274,31 @@ ledgerFromRequest(
     T& ledger,
     GRPCContext<org::zxcl::rpc::v1::GetAccountInfoRequest>& context)
 {
-    ledger.reset();
+    return ledgerFromSpecifier(ledger, context.params.ledger(), context);
+}
 
-    org::zxcl::rpc::v1::GetAccountInfoRequest& request = context.params;
+Status
+ledgerFromSpecifier(
+    std::shared_ptr<ReadView const>& ledger,
+    org::zxcl::rpc::v1::LedgerSpecifier const& specifier,
+    Context& context)
+{
+    ledger.reset();
 
     using LedgerCase = org::zxcl::rpc::v1::LedgerSpecifier::LedgerCase;
-    LedgerCase ledgerCase = request.ledger().ledger_case();
+    LedgerCase ledgerCase = specifier.ledger_case();
     switch (ledgerCase)
     {
         case LedgerCase::kHash: {
-            uint256 ledgerHash =
-                uint256::fromVoid(request.ledger().hash().data());
+            uint256 ledgerHash = uint256::fromVoid(specifier.hash().data());
             return getLedger(ledger, ledgerHash, context);
         }
         case LedgerCase::kSequence:
-            return getLedger(ledger, request.ledger().sequence(), context);
+            return getLedger(ledger, specifier.sequence(), context);
         case LedgerCase::kShortcut:
             [[fallthrough]];
         case LedgerCase::LEDGER_NOT_SET: {
-            auto const shortcut = request.ledger().shortcut();
+            auto const shortcut = specifier.shortcut();
             if (shortcut ==
                 org::zxcl::rpc::v1::LedgerSpecifier::SHORTCUT_VALIDATED)
                 return getLedger(ledger, LedgerShortcut::VALIDATED, context);
@@ -143,6 +143,13 @@ ledgerFromRequest(
     T& ledger,
     GRPCContext<org::zxcl::rpc::v1::GetAccountInfoRequest>& context);
 
+/** Get the ledger a gRPC request specifies, the current ledger if none. */
+Status
+ledgerFromSpecifier(
+    std::shared_ptr<ReadView const>& ledger,
+    org::zxcl::rpc::v1::LedgerSpecifier const& specifier,
+    Context& context);
+
 bool
 isValidated(
     LedgerMaster& ledgerMaster,
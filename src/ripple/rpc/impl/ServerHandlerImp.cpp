@@ -35,8 +35,10 @@
 #include <ripple/rpc/RPCHandler.h>
 #include <ripple/rpc/Role.h>
 #include <ripple/rpc/ServerHandler.h>
+#include <ripple/rpc/impl/Handler.h>
 #include <ripple/rpc/impl/RPCHelpers.h>
 #include <ripple/rpc/impl/ServerHandlerImp.h>
+#include <ripple/rpc/impl/StreamWriter.h>
 #include <ripple/rpc/impl/Tuning.h>
 #include <ripple/rpc/json_body.h>
 #include <ripple/server/Server.h>
@@ -572,7 +574,7 @@ ServerHandlerImp::processSession(
     std::shared_ptr<Session> const& session,
     std::shared_ptr<JobQueue::Coro> coro)
 {
-    processRequest(
+    bool const streamed = processRequest(
         session->port(),
         buffers_to_string(session->request().body().data()),
         session->remoteAddress().at_port(0),
@@ -584,7 +586,12 @@ ServerHandlerImp::processSession(
             if (iter != session->request().end())
                 return iter->value();
             return boost::beast::string_view{};
-        }());
+        }(),
+        session);
+
+    // The writer keeps the connection alive, or closes it, once sent
+    if (streamed)
+        return;
 
     if (beast::rfc2616::is_keep_alive(session->request()))
         session->complete();
@@ -609,7 +616,7 @@ Json::Int constexpr forbidden = -32605;
 Json::Int constexpr wrong_version = -32606;
 //Json::Int constexpr schema_not_found  = -32608;
 
-void
+bool
 ServerHandlerImp::processRequest(
     Port const& port,
     std::string const& request,
@@ -617,7 +624,8 @@ ServerHandlerImp::processRequest(
     Output&& output,
     std::shared_ptr<JobQueue::Coro> coro,
     boost::string_view forwardedFor,
-    boost::string_view user)
+    boost::string_view user,
+    std::shared_ptr<Session> const& session)
 {
     auto rpcJ = app_.journal("RPC");
 
@@ -633,7 +641,7 @@ ServerHandlerImp::processRequest(
                 "Unable to parse request: " + reader.getFormatedErrorMessages(),
                 output,
                 rpcJ);
-            return;
+            return false;
         }
     }
 
@@ -645,12 +653,13 @@ ServerHandlerImp::processRequest(
         if (!jsonOrig.isMember(jss::params) || !jsonOrig[jss::params].isArray())
         {
             HTTPReply(400, "Malformed batch request", output, rpcJ);
-            return;
+            return false;
         }
         size = jsonOrig[jss::params].size();
     }
 
     Json::Value reply(batch ? Json::arrayValue : Json::objectValue);
+    std::shared_ptr<RPC::StreamWriter> streamWriter;
     auto const start(std::chrono::high_resolution_clock::now());
     for (unsigned i = 0; i < size; ++i)
     {
@@ -687,7 +696,7 @@ ServerHandlerImp::processRequest(
             if (!batch)
             {
                 HTTPReply(400, jss::invalid_API_version.c_str(), output, rpcJ);
-                return;
+                return false;
             }
             Json::Value r(Json::objectValue);
             r[jss::request] = jsonRPC;
@@ -735,7 +744,7 @@ ServerHandlerImp::processRequest(
                 if (!batch)
                 {
                     HTTPReply(503, "Server is overloaded", output, rpcJ);
-                    return;
+                    return false;
                 }
                 Json::Value r = jsonRPC;
                 r[jss::error] =
@@ -751,7 +760,7 @@ ServerHandlerImp::processRequest(
             if (!batch)
             {
                 HTTPReply(403, "Forbidden", output, rpcJ);
-                return;
+                return false;
             }
             Json::Value r = jsonRPC;
             r[jss::error] = make_json_error(forbidden, "Forbidden");
@@ -765,7 +774,7 @@ ServerHandlerImp::processRequest(
             if (!batch)
             {
                 HTTPReply(400, "Null method", output, rpcJ);
-                return;
+                return false;
             }
             Json::Value r = jsonRPC;
             r[jss::error] = make_json_error(method_not_found, "Null method");
@@ -780,7 +789,7 @@ ServerHandlerImp::processRequest(
             if (!batch)
             {
                 HTTPReply(400, "method is not string", output, rpcJ);
-                return;
+                return false;
             }
             Json::Value r = jsonRPC;
             r[jss::error] =
@@ -796,7 +805,7 @@ ServerHandlerImp::processRequest(
             if (!batch)
             {
                 HTTPReply(400, "method is empty", output, rpcJ);
-                return;
+                return false;
             }
             Json::Value r = jsonRPC;
             r[jss::error] =
@@ -822,7 +831,7 @@ ServerHandlerImp::processRequest(
             {
                 usage.charge(Resource::feeInvalidRPC);
                 HTTPReply(400, "params unparseable", output, rpcJ);
-                return;
+                return false;
             }
             else
             {
@@ -831,7 +840,7 @@ ServerHandlerImp::processRequest(
                 {
                     usage.charge(Resource::feeInvalidRPC);
                     HTTPReply(400, "params unparseable", output, rpcJ);
-                    return;
+                    return false;
                 }
             }
         }
@@ -849,7 +858,7 @@ ServerHandlerImp::processRequest(
                 if (!batch)
                 {
                     HTTPReply(400, "ripplerpc is not a string", output, rpcJ);
-                    return;
+                    return false;
                 }
 
                 Json::Value r = jsonRPC;
@@ -916,6 +925,25 @@ ServerHandlerImp::processRequest(
              apiVersion},
             params,
             {user, forwardedFor}};
+
+        // Bulk reads can send their rows as they go, rather than building
+        // the whole response first
+        if (!batch && session && params.isMember(jss::stream) &&
+            params[jss::stream].asBool())
+        {
+            auto const handler = RPC::getHandler(apiVersion, strMethod);
+            if (handler && handler->streaming_)
+            {
+                streamWriter = std::make_shared<RPC::StreamWriter>(coro);
+                session->write(
+                    streamWriter,
+                    beast::rfc2616::is_keep_alive(session->request()));
+                context.rowSink = [&](Json::Value const& row) {
+                    return streamWriter->write(row);
+                };
+            }
+        }
+
         Json::Value result;
         RPC::doCommand(context, result);
         usage.charge(loadType);
@@ -1044,7 +1072,14 @@ ServerHandlerImp::processRequest(
             stream << "Reply: " << response.substr(0, maxSize);
     }
 
+    if (streamWriter)
+    {
+        streamWriter->finish(response);
+        return true;
+    }
+
     HTTPReply(200, response, output, rpcJ);
+    return false;
 }
 
 //------------------------------------------------------------------------------
@@ -182,7 +182,9 @@ private:
         std::shared_ptr<Session> const&,
         std::shared_ptr<JobQueue::Coro> coro);
 
-    void
+    // Returns true if the response was streamed through the session, which
+    // then finishes it
+    bool
     processRequest(
         Port const& port,
         std::string const& request,
@@ -190,7 +192,8 @@ private:
         Output&&,
         std::shared_ptr<JobQueue::Coro> coro,
         boost::string_view forwardedFor,
-        boost::string_view user);
+        boost::string_view user,
+        std::shared_ptr<Session> const& session);
 
     Handoff
     statusResponse(http_request_type const& request) const;
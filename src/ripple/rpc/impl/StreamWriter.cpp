@@ -0,0 +1,197 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/json/to_string.h>
+#include <ripple/protocol/BuildInfo.h>
+#include <ripple/protocol/SystemParameters.h>
+#include <ripple/rpc/impl/StreamWriter.h>
+#include <ripple/rpc/impl/Tuning.h>
+#include <ripple/server/impl/JSONRPCUtil.h>
+#include <cstdio>
+
+namespace ripple {
+namespace RPC {
+
+StreamWriter::StreamWriter(std::shared_ptr<JobQueue::Coro> coro)
+    : coro_(std::move(coro))
+{
+    std::string header =
+        "HTTP/1.1 200 OK\r\n" + getHTTPHeaderTimestamp() +
+        "Connection: Keep-Alive\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "Content-Type: application/octet-stream\r\n"
+        "Server: " +
+        systemName() + "-json-rpc/" + BuildInfo::getFullVersionString() +
+        "\r\n\r\n";
+    buffered_ = header.size();
+    chunks_.push_back(std::move(header));
+}
+
+std::string
+StreamWriter::frame(std::string const& text)
+{
+    auto const size = static_cast<std::uint32_t>(text.size());
+    std::string result;
+    result.reserve(4 + text.size());
+    result.push_back(static_cast<char>(size >> 24));
+    result.push_back(static_cast<char>(size >> 16));
+    result.push_back(static_cast<char>(size >> 8));
+    result.push_back(static_cast<char>(size));
+    result += text;
+    return result;
+}
+
+void
+StreamWriter::enqueue(std::string const& frame)
+{
+    char size[16];
+    auto const n = std::snprintf(size, sizeof(size), "%zx\r\n", frame.size());
+
+    std::string chunk;
+    chunk.reserve(n + frame.size() + 2);
+    chunk.append(size, n);
+    chunk += frame;
+    chunk += "\r\n";
+    buffered_ += chunk.size();
+    chunks_.push_back(std::move(chunk));
+}
+
+bool
+StreamWriter::write(Json::Value const& row)
+{
+    auto const f = frame(Json::to_string(row));
+
+    std::function<void(void)> resume;
+    bool wait = false;
+    {
+        std::lock_guard lock(mutex_);
+        if (aborted_ || finished_)
+            return false;
+        enqueue(f);
+        resume.swap(resume_);
+        if (coro_ && buffered_ > Tuning::streamHighWater)
+            waiting_ = wait = true;
+    }
+    if (resume)
+        resume();
+
+    // consume() or abort() posts the coroutine when it may go on. If that
+    // happens before we yield, the resumption waits for the yield.
+    if (wait)
+        coro_->yield();
+
+    std::lock_guard lock(mutex_);
+    return !aborted_;
+}
+
+void
+StreamWriter::finish(std::string const& response)
+{
+    std::function<void(void)> resume;
+    {
+        std::lock_guard lock(mutex_);
+        if (finished_)
+            return;
+        enqueue(frame(response));
+        buffered_ += 5;
+        chunks_.push_back("0\r\n\r\n");
+        finished_ = true;
+        resume.swap(resume_);
+    }
+    if (resume)
+        resume();
+}
+
+bool
+StreamWriter::complete()
+{
+    std::lock_guard lock(mutex_);
+    return finished_ && chunks_.empty();
+}
+
+void
+StreamWriter::consume(std::size_t bytes)
+{
+    bool wake = false;
+    {
+        std::lock_guard lock(mutex_);
+        buffered_ -= bytes;
+        while (bytes > 0)
+        {
+            auto const left = chunks_.front().size() - offset_;
+            if (bytes < left)
+            {
+                offset_ += bytes;
+                break;
+            }
+            bytes -= left;
+            offset_ = 0;
+            chunks_.pop_front();
+        }
+        if (waiting_ && buffered_ <= Tuning::streamLowWater)
+        {
+            waiting_ = false;
+            wake = true;
+        }
+    }
+    if (wake)
+        coro_->post();
+}
+
+bool
+StreamWriter::prepare(std::size_t, std::function<void(void)> resume)
+{
+    std::lock_guard lock(mutex_);
+    if (!chunks_.empty())
+        return true;
+    resume_ = std::move(resume);
+    return false;
+}
+
+std::vector<boost::asio::const_buffer>
+StreamWriter::data()
+{
+    std::lock_guard lock(mutex_);
+    std::vector<boost::asio::const_buffer> result;
+    result.reserve(chunks_.size());
+    auto offset = offset_;
+    for (auto const& chunk : chunks_)
+    {
+        result.emplace_back(chunk.data() + offset, chunk.size() - offset);
+        offset = 0;
+    }
+    return result;
+}
+
+void
+StreamWriter::abort()
+{
+    bool wake = false;
+    {
+        std::lock_guard lock(mutex_);
+        aborted_ = true;
+        resume_ = nullptr;
+        std::swap(wake, waiting_);
+    }
+    if (wake)
+        coro_->post();
+}
+
+}  // namespace RPC
+}  // namespace ripple
@@ -0,0 +1,106 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_RPC_STREAMWRITER_H_INCLUDED
+#define RIPPLE_RPC_STREAMWRITER_H_INCLUDED
+
+#include <ripple/core/JobQueue.h>
+#include <ripple/json/json_value.h>
+#include <ripple/server/Writer.h>
+#include <deque>
+#include <mutex>
+#include <string>
+
+namespace ripple {
+namespace RPC {
+
+/** Sends the response to an HTTP request as its rows are produced.
+
+    The body is sent with chunked transfer encoding, as a sequence of
+    frames: a 32 bit big-endian length followed by that many bytes of
+    JSON. Every frame but the last is one row; the last is the response
+    as it would be sent without streaming, less the rows.
+
+    Rows are written by the coroutine serving the request. When more than
+    Tuning::streamHighWater bytes are waiting to be sent it is suspended,
+    until the client has read down to Tuning::streamLowWater.
+*/
+class StreamWriter : public Writer
+{
+public:
+    explicit StreamWriter(std::shared_ptr<JobQueue::Coro> coro);
+
+    /** Queue a row, waiting if the client is behind.
+
+        Must be called from the coroutine.
+
+        @return `false` if the client has gone away.
+    */
+    bool
+    write(Json::Value const& row);
+
+    /** Queue the last frame and end the body. */
+    void
+    finish(std::string const& response);
+
+    bool
+    complete() override;
+
+    void
+    consume(std::size_t bytes) override;
+
+    bool
+    prepare(std::size_t bytes, std::function<void(void)> resume) override;
+
+    std::vector<boost::asio::const_buffer>
+    data() override;
+
+    void
+    abort() override;
+
+    /** Returns a frame holding the given text. */
+    static std::string
+    frame(std::string const& text);
+
+private:
+    // Requires the lock
+    void
+    enqueue(std::string const& frame);
+
+    std::shared_ptr<JobQueue::Coro> const coro_;
+
+    std::mutex mutex_;
+    // Elements of a deque stay in place as it grows, so the buffers
+    // returned by data() are valid while rows are added.
+    std::deque<std::string> chunks_;
+    // Bytes of the first chunk already sent
+    std::size_t offset_ = 0;
+    std::size_t buffered_ = 0;
+    bool finished_ = false;
+    bool aborted_ = false;
+    // The coroutine is suspended until the client catches up
+    bool waiting_ = false;
+    // Resumes the peer when there is more to send
+    std::function<void(void)> resume_;
+};
+
+}  // namespace RPC
+}  // namespace ripple
+
+#endif
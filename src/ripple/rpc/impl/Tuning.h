@@ -87,6 +87,21 @@ static int constexpr max_auto_src_cur = 88;
 /** Maximum size of a transaction. */
 static int const max_txn_size = 1024 * 500;
 
+/** Bytes of a streamed response that may wait to be sent before the
+    request producing it is suspended, and the level it resumes at. */
+static std::size_t constexpr streamHighWater = 4 * 1024 * 1024;
+static std::size_t constexpr streamLowWater = 1024 * 1024;
+
+/** Rows read from the database at a time when streaming a bulk read. */
+static int constexpr streamPageLength = 1024;
+
+/** Rows sent in one message of a gRPC stream. */
+static int constexpr grpcStreamBatch = 256;
+
+/** Messages of a gRPC stream that may wait to be sent before the request
+    producing them is suspended. */
+static std::size_t constexpr grpcStreamPending = 16;
+
 } // Tuning
 /** @} */
 
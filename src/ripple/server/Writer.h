@@ -53,6 +53,12 @@ public:
     /** Returns a ConstBufferSequence representing the input sequence. */
     virtual std::vector<boost::asio::const_buffer>
     data() = 0;
+
+    /** Called if the connection fails before the writer is complete. */
+    virtual void
+    abort()
+    {
+    }
 };
 
 }  // namespace ripple
@@ -396,7 +396,10 @@ BaseHTTPPeer<Handler, Impl>::do_writer(
             boost::asio::transfer_at_least(1),
             do_yield[ec]);
         if (ec)
+        {
+            writer->abort();
             return fail(ec, "writer");
+        }
         writer->consume(bytes_transferred);
         if (writer->complete())
             break;
@@ -405,6 +408,9 @@ BaseHTTPPeer<Handler, Impl>::do_writer(
     if (!keep_alive)
         return do_close();
 
+    // As complete() does, before reading the next request
+    message_ = {};
+
     boost::asio::spawn(
         strand_,
         std::bind(
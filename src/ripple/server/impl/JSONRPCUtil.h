@@ -25,6 +25,10 @@
 
 namespace ripple {
 
+/** Returns the Date header for an HTTP response, with its line ending. */
+std::string
+getHTTPHeaderTimestamp();
+
 void
 HTTPReply(
     int nStatus,
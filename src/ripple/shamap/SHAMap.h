@@ -258,6 +258,17 @@ public:
         Slice const& rawNode,
         SHAMapSyncFilter* filter);
 
+    /** Add a node already decoded with SHAMapAbstractNode::makeFromWire.
+
+        Decoding, which also hashes the node, needs no access to the map,
+        so callers can do it concurrently and outside their locks.
+    */
+    SHAMapAddNode
+    addKnownNode(
+        SHAMapNodeID const& nodeID,
+        std::shared_ptr<SHAMapAbstractNode> newNode,
+        SHAMapSyncFilter* filter);
+
     // status functions
     void
     setImmutable();
@@ -598,6 +598,22 @@ SHAMap::addKnownNode(
     const SHAMapNodeID& node,
     Slice const& rawNode,
     SHAMapSyncFilter* filter)
+{
+    if (!isSynching())
+    {
+        JLOG(journal_.trace()) << "AddKnownNode while not synching";
+        return SHAMapAddNode::duplicate();
+    }
+
+    return addKnownNode(
+        node, SHAMapAbstractNode::makeFromWire(rawNode), filter);
+}
+
+SHAMapAddNode
+SHAMap::addKnownNode(
+    const SHAMapNodeID& node,
+    std::shared_ptr<SHAMapAbstractNode> newNode,
+    SHAMapSyncFilter* filter)
 {
     // return value: true=okay, false=error
     assert(!node.isRoot());
@@ -609,7 +625,6 @@ SHAMap::addKnownNode(
     }
 
     auto const generation = f_.getFullBelowCache(ledgerSeq_)->getGeneration();
-    auto newNode = SHAMapAbstractNode::makeFromWire(rawNode);
     SHAMapNodeID iNodeID;
     auto iNode = root_.get();
 
@@ -29,7 +29,9 @@
 #include <peersafe/consensus/pop/impl/PopConsensus.cpp>
 
 #include <peersafe/consensus/hotstuff/impl/Block.cpp>
+#include <peersafe/consensus/hotstuff/impl/BlockLog.cpp>
 #include <peersafe/consensus/hotstuff/impl/BlockStorage.cpp>
+#include <peersafe/consensus/hotstuff/impl/CertVerifier.cpp>
 #include <peersafe/consensus/hotstuff/impl/EpochChange.cpp>
 #include <peersafe/consensus/hotstuff/impl/EpochState.cpp>
 #include <peersafe/consensus/hotstuff/impl/HotstuffCore.cpp>
@@ -180,6 +180,13 @@ class HashRouter_test : public beast::unit_test::suite
         BEAST_EXPECT(router.setFlags(key1, 10));
         BEAST_EXPECT(!router.setFlags(key1, 10));
         BEAST_EXPECT(router.setFlags(key1, 20));
+
+        uint256 const key2(2);
+        BEAST_EXPECT(router.setFlags(key2, 12));
+        router.clearFlags(8);
+        BEAST_EXPECT(router.getFlags(key1) == 22);
+        BEAST_EXPECT(router.getFlags(key2) == 4);
+        BEAST_EXPECT(router.setFlags(key2, 8));
     }
 
     void
@@ -223,6 +230,17 @@ class HashRouter_test : public beast::unit_test::suite
         // Confirm that peers list is empty.
         peers = router.shouldRelay(key1);
         BEAST_EXPECT(peers && peers->size() == 0);
+
+        // The status tells when an entry was last relayed
+        uint256 const key2(2);
+        auto status = router.addSuppressionPeerWithStatus(key2, 1);
+        BEAST_EXPECT(status.first && !status.second);
+        status = router.addSuppressionPeerWithStatus(key2, 2);
+        BEAST_EXPECT(!status.first && !status.second);
+        peers = router.shouldRelay(key2);
+        BEAST_EXPECT(peers && peers->size() == 2);
+        status = router.addSuppressionPeerWithStatus(key2, 3);
+        BEAST_EXPECT(!status.first && status.second == stopwatch.now());
     }
 
     void
@@ -0,0 +1,345 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <eth/vm/executor/interpreter/interpreter.h>
+#include <peersafe/app/ledger/LedgerTimeline.h>
+#include <peersafe/app/misc/ContractHelper.h>
+#include <ripple/app/ledger/BuildLedger.h>
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/ledger/LedgerReplay.h>
+#include <ripple/app/misc/CanonicalTXSet.h>
+#include <ripple/app/tx/apply.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/core/ConfigSections.h>
+#include <ripple/ledger/ApplyArena.h>
+#include <ripple/ledger/OpenView.h>
+#include <ripple/protocol/TxFormats.h>
+#include <boost/algorithm/string.hpp>
+#include <test/jtx.h>
+
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
+
+namespace ripple {
+namespace test {
+
+/*
+Replays a range of ledgers from an existing database through buildLedger
+and reports where the apply pipeline spends its time.
+
+Run with
+
+    chainsqld --unittest=LedgerReplayBench --unittest-arg="config=<file>,
+        first=<seq>,last=<seq>[,mode=replay|consensus][,tables=0|1]
+        [,prefetch=0|1][,vmpool=0|1][,profile=0|1][,rounds=<n>]"
+
+`config` is the configuration of a stopped node, whose [node_db],
+[database_path] and [sync_db] hold the ledgers first - 1 through last. The
+replayed ledgers are written back to the node store, so point it at a copy.
+
+Every ledger is rebuilt on its recorded parent:
+
+    mode=replay     the recorded transactions in their recorded order, as
+                    with --replay (the default)
+    mode=consensus  the transactions as a consensus set, in canonical order
+                    with retry passes and signature checks
+
+tables, prefetch and vmpool turn table storage, contract storage prefetch
+and interpreter VM reuse on or off. With profile=1 every transaction is
+also applied once more on its own, to break the cost down by type.
+*/
+class LedgerReplayBench_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    struct Cost
+    {
+        std::size_t count = 0;
+        clock_type::duration time{0};
+    };
+
+    struct Totals
+    {
+        std::size_t ledgers = 0;
+        std::size_t txs = 0;
+        std::size_t mismatched = 0;
+        clock_type::duration build{0};
+        std::array<std::chrono::microseconds, LedgerTimeline::phaseCount>
+            phases{};
+        // Of the state tables, from the arenas of the built ledgers
+        std::uint64_t allocations = 0;
+        std::uint64_t bytes = 0;
+        std::uint64_t blocks = 0;
+        std::map<TxType, Cost> types;
+    };
+
+    static Section
+    parse(std::string s)
+    {
+        Section section;
+        std::vector<std::string> v;
+        boost::split(v, s, boost::algorithm::is_any_of(","));
+        for (auto& e : v)
+            boost::trim(e);
+        section.append(v);
+        return section;
+    }
+
+    static std::string
+    ms(clock_type::duration d)
+    {
+        using namespace std::chrono;
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(3)
+           << duration_cast<microseconds>(d).count() / 1000. << "ms";
+        return ss.str();
+    }
+
+    static std::string
+    typeName(TxType type)
+    {
+        if (auto const item = TxFormats::getInstance().findByType(type))
+            return item->getName();
+        return std::to_string(type);
+    }
+
+    std::unique_ptr<Config>
+    makeConfig(Section const& args)
+    {
+        auto cfg = std::make_unique<Config>();
+        cfg->setup(get<std::string>(args, "config"), true, false, true);
+
+        // The node's ports may be in use, and nothing here needs them
+        cfg->deprecatedClearSection("server");
+        cfg->deprecatedClearSection(ConfigSection::prometheus());
+
+        cfg->START_UP = Config::LOAD;
+        cfg->START_LEDGER =
+            std::to_string(get<std::uint32_t>(args, "first") - 1);
+
+        cfg->overwrite(
+            "sync_db", "first_storage", get<std::string>(args, "tables", "0"));
+        cfg->deprecatedClearSection(ConfigSection::autoSync());
+        cfg->section(ConfigSection::autoSync()).append("0");
+        cfg->overwrite(
+            ConfigSection::contractPrefetch(),
+            "enable",
+            get<std::string>(args, "prefetch", "0"));
+        // For the apply and flush times of each ledger
+        cfg->overwrite(ConfigSection::ledgerTimeline(), "enable", "1");
+        return cfg;
+    }
+
+    // Applies the transactions one at a time, on a view nobody keeps
+    void
+    profile(
+        Schema& app,
+        LedgerReplay const& replay,
+        ApplyFlags flags,
+        std::map<TxType, Cost>& types)
+    {
+        auto const& info = replay.replay()->info();
+        auto const built =
+            std::make_shared<Ledger>(*replay.parent(), info.closeTime);
+
+        ApplyArena::Scope arena;
+        OpenView accum(&*built);
+        app.getContractHelper().clearCache();
+        for (auto const& item : replay.orderedTxns())
+        {
+            auto const& tx = *item.second;
+            auto const start = clock_type::now();
+            applyTransaction(
+                app, accum, tx, false, flags, app.journal("Bench"));
+            auto& cost = types[tx.getTxnType()];
+            ++cost.count;
+            cost.time += clock_type::now() - start;
+        }
+        app.getContractHelper().clearCache();
+    }
+
+    std::shared_ptr<Ledger>
+    build(Schema& app, LedgerReplay const& replay, bool consensus)
+    {
+        auto const j = app.journal("Bench");
+        if (!consensus)
+            return buildLedger(
+                replay, tapNO_CHECK_SIGN | tapForConsensus, app, j);
+
+        auto const& info = replay.replay()->info();
+        // A consensus set is salted with its own hash
+        CanonicalTXSet txns(info.txHash);
+        for (auto const& item : replay.orderedTxns())
+            txns.insert(item.second);
+        std::set<TxID> failed;
+        return buildLedger(
+            replay.parent(),
+            info.closeTime,
+            getCloseAgree(info),
+            info.closeTimeResolution,
+            app,
+            txns,
+            failed,
+            j);
+    }
+
+    void
+    replayRange(Schema& app, Section const& args, Totals& totals)
+    {
+        auto const first = get<std::uint32_t>(args, "first");
+        auto const last = get<std::uint32_t>(args, "last");
+        bool const consensus =
+            get<std::string>(args, "mode", "replay") == "consensus";
+        bool const doProfile = get<int>(args, "profile", 1) != 0;
+        auto& timeline = app.getLedgerTimeline();
+
+        std::shared_ptr<Ledger const> parent =
+            loadByIndex(first - 1, app, false);
+        for (auto seq = first; seq <= last && parent; ++seq)
+        {
+            std::shared_ptr<Ledger const> const ledger =
+                loadByIndex(seq, app, false);
+            if (!ledger)
+            {
+                log << "Ledger " << seq << " is missing" << std::endl;
+                break;
+            }
+
+            LedgerReplay const replay(parent, ledger);
+            timeline.drainSamples([](auto, auto) {});
+
+            auto const arena0 = ApplyArena::getJson();
+            auto const start = clock_type::now();
+            auto const built = build(app, replay, consensus);
+            totals.build += clock_type::now() - start;
+            auto const arena1 = ApplyArena::getJson();
+            auto delta = [&](char const* field) {
+                return arena1[field].asUInt() - arena0[field].asUInt();
+            };
+            totals.allocations += delta("allocations");
+            totals.bytes += delta("bytes");
+            totals.blocks += delta("blocks");
+
+            timeline.drainSamples(
+                [&](LedgerTimeline::Phase phase, std::chrono::microseconds d) {
+                    totals.phases[phase] += d;
+                });
+
+            ++totals.ledgers;
+            totals.txs += replay.orderedTxns().size();
+            if (!built || built->info().hash != ledger->info().hash)
+            {
+                ++totals.mismatched;
+                JLOG(app.journal("Bench").warn())
+                    << "Ledger " << seq << " replayed to a different hash";
+            }
+
+            if (doProfile)
+                profile(
+                    app,
+                    replay,
+                    consensus ? tapForConsensus
+                              : tapNO_CHECK_SIGN | tapForConsensus,
+                    totals.types);
+
+            parent = ledger;
+        }
+    }
+
+    void
+    report(Totals const& totals)
+    {
+        using namespace std::chrono;
+        auto const us = duration_cast<microseconds>(totals.build).count();
+
+        log << "    " << totals.ledgers << " ledgers, " << totals.txs
+            << " transactions in " << ms(totals.build) << ", "
+            << (us ? totals.txs * 1000000 / us : 0) << " tx/s";
+        if (totals.mismatched)
+            log << ", " << totals.mismatched << " with a different hash";
+        log << std::endl;
+
+        for (int p = 0; p < LedgerTimeline::phaseCount; ++p)
+        {
+            auto const phase = static_cast<LedgerTimeline::Phase>(p);
+            if (totals.phases[p].count())
+                log << "    " << LedgerTimeline::phaseName(phase) << ": "
+                    << ms(totals.phases[p]) << std::endl;
+        }
+
+        log << "    allocations: " << totals.allocations << " ("
+            << totals.bytes << " bytes) in " << totals.blocks << " heap blocks"
+            << std::endl;
+
+        for (auto const& [type, cost] : totals.types)
+            log << "    " << std::setw(24) << std::left << typeName(type)
+                << std::right << std::setw(8) << cost.count << " x "
+                << duration_cast<nanoseconds>(cost.time).count() /
+                    std::max<std::size_t>(cost.count, 1) / 1000.
+                << "us" << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        auto const args = parse(arg());
+        if (!args.exists("config") || !args.exists("first") ||
+            !args.exists("last"))
+        {
+            log << "LedgerReplayBench needs "
+                   "--unittest-arg=\"config=<file>,first=<seq>,last=<seq>\""
+                << std::endl;
+            return;
+        }
+
+        testcase(
+            "replay " + get<std::string>(args, "first") + " to " +
+            get<std::string>(args, "last") + " (" +
+            get<std::string>(args, "mode", "replay") + ")");
+
+        eth::setInterpreterPooling(get<int>(args, "vmpool", 1) != 0);
+
+        using namespace jtx;
+        Env env(*this, makeConfig(args));
+
+        auto const rounds = std::max(get<int>(args, "rounds", 1), 1);
+        for (int round = 0; round < rounds; ++round)
+        {
+            Totals totals;
+            replayRange(env.app(), args, totals);
+
+            log << "  round " << round + 1 << ":" << std::endl;
+            report(totals);
+            BEAST_EXPECT(totals.ledgers != 0);
+            BEAST_EXPECT(totals.mismatched == 0);
+        }
+
+        eth::setInterpreterPooling(true);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(LedgerReplayBench, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
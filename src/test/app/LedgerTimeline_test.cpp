@@ -0,0 +1,179 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <peersafe/app/ledger/LedgerTimeline.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/jss.h>
+#include <test/unit_test/SuiteJournal.h>
+#include <chrono>
+
+namespace ripple {
+
+class LedgerTimeline_test : public beast::unit_test::suite
+{
+    using clock_type = LedgerTimeline::clock_type;
+
+    static LedgerTimeline::Setup
+    makeSetup(std::size_t size)
+    {
+        LedgerTimeline::Setup setup;
+        setup.enable = true;
+        setup.size = size;
+        return setup;
+    }
+
+    void
+    testDisabled()
+    {
+        testcase("disabled");
+        test::SuiteJournal journal("LedgerTimeline_test", *this);
+
+        LedgerTimeline timeline(LedgerTimeline::Setup{}, journal);
+        BEAST_EXPECT(!timeline.enabled());
+        {
+            LedgerTimeline::Scope timing(timeline, 5, LedgerTimeline::build);
+        }
+        timeline.txSetRequested(uint256(1), 5);
+        timeline.txSetAcquired(uint256(1));
+        BEAST_EXPECT(timeline.getJson(10, boost::none).size() == 0);
+
+        int samples = 0;
+        timeline.drainSamples(
+            [&](LedgerTimeline::Phase, std::chrono::microseconds) {
+                ++samples;
+            });
+        BEAST_EXPECT(samples == 0);
+    }
+
+    void
+    testPhases()
+    {
+        testcase("phases");
+        using namespace std::chrono_literals;
+        test::SuiteJournal journal("LedgerTimeline_test", *this);
+
+        LedgerTimeline timeline(makeSetup(8), journal);
+        auto const t0 = clock_type::now();
+        timeline.record(7, LedgerTimeline::build, t0, t0 + 30ms);
+        timeline.record(7, LedgerTimeline::applyTxs, t0 + 1ms, t0 + 11ms);
+        timeline.record(7, LedgerTimeline::applyTxs, t0 + 11ms, t0 + 16ms);
+        timeline.record(7, LedgerTimeline::shamapFlush, t0 + 20ms, t0 + 29ms);
+        timeline.record(7, LedgerTimeline::publish, t0 + 40ms, t0 + 42ms);
+
+        auto const json = timeline.getJson(10, boost::none);
+        BEAST_EXPECT(json.size() == 1);
+        auto const& ledger = json[0u];
+        BEAST_EXPECT(ledger[jss::ledger_index].asUInt() == 7);
+        BEAST_EXPECT(ledger["total_us"].asUInt() == 42000);
+
+        auto const& phases = ledger["phases"];
+        BEAST_EXPECT(phases["build"]["offset_us"].asUInt() == 0);
+        BEAST_EXPECT(phases["build"]["duration_us"].asUInt() == 30000);
+        BEAST_EXPECT(phases["apply"]["offset_us"].asUInt() == 1000);
+        BEAST_EXPECT(phases["apply"]["duration_us"].asUInt() == 15000);
+        BEAST_EXPECT(phases["apply"]["count"].asUInt() == 2);
+        BEAST_EXPECT(phases["publish"]["offset_us"].asUInt() == 40000);
+        BEAST_EXPECT(!phases.isMember("sql_commit"));
+
+        auto const& passes = ledger["apply_passes_us"];
+        BEAST_EXPECT(passes.size() == 2);
+        BEAST_EXPECT(passes[0u].asUInt() == 10000);
+        BEAST_EXPECT(passes[1u].asUInt() == 5000);
+
+        std::chrono::microseconds apply{0};
+        int samples = 0;
+        timeline.drainSamples(
+            [&](LedgerTimeline::Phase phase, std::chrono::microseconds d) {
+                ++samples;
+                if (phase == LedgerTimeline::applyTxs)
+                    apply += d;
+            });
+        BEAST_EXPECT(samples == 5);
+        BEAST_EXPECT(apply == 15ms);
+
+        samples = 0;
+        timeline.drainSamples(
+            [&](LedgerTimeline::Phase, std::chrono::microseconds) {
+                ++samples;
+            });
+        BEAST_EXPECT(samples == 0);
+    }
+
+    void
+    testRing()
+    {
+        testcase("ring");
+        using namespace std::chrono_literals;
+        test::SuiteJournal journal("LedgerTimeline_test", *this);
+
+        LedgerTimeline timeline(makeSetup(4), journal);
+        auto const t0 = clock_type::now();
+        for (LedgerIndex seq = 1; seq <= 10; ++seq)
+            timeline.record(seq, LedgerTimeline::build, t0, t0 + 1ms);
+
+        auto json = timeline.getJson(100, boost::none);
+        BEAST_EXPECT(json.size() == 4);
+        BEAST_EXPECT(json[0u][jss::ledger_index].asUInt() == 10);
+        BEAST_EXPECT(json[3u][jss::ledger_index].asUInt() == 7);
+
+        BEAST_EXPECT(timeline.getJson(2, boost::none).size() == 2);
+        BEAST_EXPECT(timeline.getJson(10, LedgerIndex{9}).size() == 1);
+        BEAST_EXPECT(timeline.getJson(10, LedgerIndex{5}).size() == 0);
+
+        // A phase reported after its ledger was overwritten is dropped
+        timeline.record(6, LedgerTimeline::sqlCommit, t0, t0 + 1ms);
+        json = timeline.getJson(10, LedgerIndex{10});
+        BEAST_EXPECT(!json[0u]["phases"].isMember("sql_commit"));
+    }
+
+    void
+    testTxSet()
+    {
+        testcase("tx set acquire");
+        test::SuiteJournal journal("LedgerTimeline_test", *this);
+
+        LedgerTimeline timeline(makeSetup(8), journal);
+        timeline.txSetAcquired(uint256(1));
+        BEAST_EXPECT(timeline.getJson(10, boost::none).size() == 0);
+
+        timeline.txSetRequested(uint256(1), 3);
+        timeline.txSetAcquired(uint256(1));
+        timeline.txSetAcquired(uint256(1));
+
+        auto const json = timeline.getJson(10, LedgerIndex{3});
+        BEAST_EXPECT(json.size() == 1);
+        BEAST_EXPECT(
+            json[0u]["phases"]["tx_set_acquire"].isMember("duration_us"));
+        BEAST_EXPECT(!json[0u]["phases"]["tx_set_acquire"].isMember("count"));
+    }
+
+public:
+    void
+    run() override
+    {
+        testDisabled();
+        testPhases();
+        testRing();
+        testTxSet();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LedgerTimeline, app, ripple);
+
+}  // namespace ripple
@@ -0,0 +1,255 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <peersafe/app/table/QueryCache.h>
+#include <ripple/beast/unit_test.h>
+#include <test/unit_test/SuiteJournal.h>
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+namespace ripple {
+
+class QueryCache_test : public beast::unit_test::suite
+{
+    static Json::Value
+    makeResult(int rows)
+    {
+        Json::Value ret(Json::objectValue);
+        Json::Value& lines = (ret["lines"] = Json::arrayValue);
+        for (int i = 0; i < rows; ++i)
+        {
+            Json::Value line(Json::objectValue);
+            line["id"] = i;
+            line["name"] = "name_" + std::to_string(i);
+            lines.append(line);
+        }
+        return ret;
+    }
+
+    static QueryCache::Setup
+    makeSetup(std::size_t maxBytes = 1024 * 1024, std::size_t maxEntries = 64)
+    {
+        QueryCache::Setup setup;
+        setup.enable = true;
+        setup.maxBytes = maxBytes;
+        setup.maxEntries = maxEntries;
+        return setup;
+    }
+
+    void
+    testNormalize()
+    {
+        testcase("normalize");
+
+        BEAST_EXPECT(
+            QueryCache::normalize("  select *   from\tt_1 \n where a=1 ;") ==
+            "select * from t_1 where a=1");
+        BEAST_EXPECT(
+            QueryCache::normalize("select * from t where a='x   y';") ==
+            "select * from t where a='x   y'");
+        BEAST_EXPECT(
+            QueryCache::normalize("select * from t where a='x;'") ==
+            "select * from t where a='x;'");
+    }
+
+    void
+    testHitAndInvalidate()
+    {
+        testcase("hit and invalidate");
+        test::SuiteJournal journal("QueryCache_test", *this);
+
+        QueryCache cache(makeSetup(), journal);
+        uint160 const t1(1);
+        uint160 const t2(2);
+        std::set<uint160> const both{t1, t2};
+        std::set<uint160> const only1{t1};
+
+        auto const k12 = QueryCache::makeKey("sql", "", "q12", both);
+        auto const k1 = QueryCache::makeKey("sql", "", "q1", only1);
+
+        BEAST_EXPECT(!cache.fetch(k12, both));
+        cache.insert(k12, cache.snapshot(both), makeResult(3));
+        cache.insert(k1, cache.snapshot(only1), makeResult(1));
+
+        auto hit = cache.fetch(k12, both);
+        BEAST_EXPECT(hit && (*hit)["lines"].size() == 3);
+        BEAST_EXPECT(cache.fetch(k1, only1));
+
+        // Writing t2 drops the join but keeps the single table query.
+        cache.invalidate(t2);
+        BEAST_EXPECT(!cache.fetch(k12, both));
+        BEAST_EXPECT(cache.fetch(k1, only1));
+
+        cache.invalidate(t1);
+        BEAST_EXPECT(!cache.fetch(k1, only1));
+
+        auto const jv = cache.getJson();
+        BEAST_EXPECT(jv["entries"].asUInt() == 0);
+        BEAST_EXPECT(jv["tables"].isMember(to_string(t1)));
+        BEAST_EXPECT(jv["tables"][to_string(t2)]["invalidations"] == "1");
+    }
+
+    void
+    testStaleInsert()
+    {
+        testcase("stale insert");
+        test::SuiteJournal journal("QueryCache_test", *this);
+
+        QueryCache cache(makeSetup(), journal);
+        uint160 const t1(1);
+        std::set<uint160> const tables{t1};
+        auto const key = QueryCache::makeKey("sql", "", "q", tables);
+
+        // The table is committed while the query runs: the result read
+        // before the commit must not be cached.
+        auto const generations = cache.snapshot(tables);
+        cache.invalidate(t1);
+        cache.insert(key, generations, makeResult(1));
+        BEAST_EXPECT(!cache.fetch(key, tables));
+        BEAST_EXPECT(cache.getJson()["stale_inserts"] == "1");
+    }
+
+    void
+    testLimits()
+    {
+        testcase("limits");
+        test::SuiteJournal journal("QueryCache_test", *this);
+
+        uint160 const t1(1);
+        std::set<uint160> const tables{t1};
+        {
+            QueryCache cache(makeSetup(1024 * 1024, 4), journal);
+            for (int i = 0; i < 8; ++i)
+            {
+                auto const key = QueryCache::makeKey(
+                    "sql", "", "q" + std::to_string(i), tables);
+                cache.insert(key, cache.snapshot(tables), makeResult(1));
+            }
+            BEAST_EXPECT(cache.getJson()["entries"].asUInt() == 4);
+            // least recently used entries went first
+            BEAST_EXPECT(!cache.fetch(
+                QueryCache::makeKey("sql", "", "q0", tables), tables));
+            BEAST_EXPECT(cache.fetch(
+                QueryCache::makeKey("sql", "", "q7", tables), tables));
+        }
+        {
+            auto const big = makeResult(100);
+            auto const bytes = QueryCache::approximateSize(big);
+            QueryCache cache(makeSetup(bytes * 3, 100), journal);
+            for (int i = 0; i < 8; ++i)
+            {
+                auto const key = QueryCache::makeKey(
+                    "sql", "", "q" + std::to_string(i), tables);
+                cache.insert(key, cache.snapshot(tables), big);
+            }
+            auto const jv = cache.getJson();
+            BEAST_EXPECT(jv["bytes"].asUInt() <= bytes * 3);
+            BEAST_EXPECT(jv["entries"].asUInt() == 2);
+        }
+    }
+
+    void
+    run() override
+    {
+        testNormalize();
+        testHitAndInvalidate();
+        testStaleInsert();
+        testLimits();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(QueryCache, app, ripple);
+
+// Dashboard style load: a handful of queries polled over and over, with the
+// table written every `writeEvery` queries. The backend is simulated by a
+// fixed latency plus building the result rows.
+class QueryCacheLoad_test : public beast::unit_test::suite
+{
+    double
+    measure(bool enable, int writeEvery)
+    {
+        using namespace std::chrono;
+        test::SuiteJournal journal("QueryCacheLoad_test", *this);
+
+        QueryCache::Setup setup;
+        setup.enable = enable;
+        QueryCache cache(setup, journal);
+
+        uint160 const table(1);
+        std::set<uint160> const tables{table};
+        int const queries = 2000;
+        int const distinct = 8;
+
+        auto backend = [](int q) {
+            std::this_thread::sleep_for(microseconds(200));
+            Json::Value ret(Json::objectValue);
+            Json::Value& lines = (ret["lines"] = Json::arrayValue);
+            for (int i = 0; i < 50; ++i)
+                lines.append(q * 100 + i);
+            return ret;
+        };
+
+        auto const start = steady_clock::now();
+        for (int i = 0; i < queries; ++i)
+        {
+            if (writeEvery && i % writeEvery == 0)
+                cache.invalidate(table);
+
+            int const q = i % distinct;
+            auto const key = QueryCache::makeKey(
+                "r_get_sql_admin",
+                "",
+                "select * from t_1 where id=" + std::to_string(q),
+                tables);
+            if (enable)
+            {
+                if (auto hit = cache.fetch(key, tables))
+                    continue;
+            }
+            auto const generations = cache.snapshot(tables);
+            auto result = backend(q);
+            if (enable)
+                cache.insert(key, generations, result);
+        }
+        auto const elapsed =
+            duration_cast<duration<double>>(steady_clock::now() - start);
+        return queries / elapsed.count();
+    }
+
+public:
+    void
+    run() override
+    {
+        for (int writeEvery : {0, 100, 10})
+        {
+            auto const off = measure(false, writeEvery);
+            auto const on = measure(true, writeEvery);
+            std::stringstream ss;
+            ss << "write every " << writeEvery << " queries: " << off
+               << " qps uncached, " << on << " qps cached";
+            log << ss.str() << std::endl;
+        }
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(QueryCacheLoad, app, ripple);
+
+}  // namespace ripple
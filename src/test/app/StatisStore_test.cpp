@@ -0,0 +1,253 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <peersafe/app/ledger/LedgerAdjust.h>
+#include <peersafe/app/ledger/StatisStore.h>
+#include <peersafe/app/sql/TxnDBConn.h>
+#include <ripple/core/JobQueue.h>
+#include <test/jtx.h>
+
+namespace ripple {
+
+class StatisStore_test : public beast::unit_test::suite
+{
+    void
+    testIncremental()
+    {
+        testcase("incremental");
+        using namespace test::jtx;
+        Env env{*this};
+        auto& store = env.app().getStatisStore();
+
+        env.fund(ZXC(10000), "alice", "bob");
+        env.close();
+
+        // Nothing is counted before the first checkpoint
+        BEAST_EXPECT(!store.totals());
+        auto const start = store.rebuild();
+        if (!BEAST_EXPECT(start))
+            return;
+        BEAST_EXPECT(start->txSuccess > 0);
+        BEAST_EXPECT(start->accounts >= 3);
+        BEAST_EXPECT(store.totals() == start);
+
+        env.fund(ZXC(10000), "carol", "dan");
+        env.close();
+        env(pay("alice", "bob", ZXC(100)));
+        env.close();
+        env(pay("alice", "bob", ZXC(100000)), ter(tecUNFUNDED_PAYMENT));
+        env.close();
+
+        auto const now = store.totals();
+        if (!BEAST_EXPECT(now))
+            return;
+        BEAST_EXPECT(now->txSuccess > start->txSuccess + 2);
+        BEAST_EXPECT(now->txFailure == start->txFailure + 1);
+        BEAST_EXPECT(now->accounts == start->accounts + 2);
+
+        // Counting again from scratch agrees with the saved deltas
+        BEAST_EXPECT(store.rebuild() == now);
+    }
+
+    void
+    testChunks()
+    {
+        testcase("rebuild chunks");
+        using namespace test::jtx;
+        Env env{*this};
+        auto& store = env.app().getStatisStore();
+
+        for (int i = 0; i < 5; ++i)
+        {
+            Account const a("acct" + std::to_string(i));
+            env.fund(ZXC(10000), a);
+            env.close();
+            env(pay(a, env.master, ZXC(10)));
+            env.close();
+        }
+
+        auto const whole = store.rebuild();
+        if (!BEAST_EXPECT(whole))
+            return;
+        for (std::uint32_t size : {1, 2, 3})
+            BEAST_EXPECT(store.rebuild(size) == whole);
+
+        // Ledgers after the chunks still add to the checkpoint
+        env.fund(ZXC(10000), "alice");
+        env.close();
+        auto const now = store.totals();
+        if (!BEAST_EXPECT(now))
+            return;
+        BEAST_EXPECT(now->accounts == whole->accounts + 1);
+        BEAST_EXPECT(store.rebuild(4) == now);
+    }
+
+    void
+    testOnlineDelete()
+    {
+        testcase("online delete");
+        using namespace test::jtx;
+        Env env{*this};
+        auto& store = env.app().getStatisStore();
+
+        env.fund(ZXC(10000), "alice", "bob");
+        env.close();
+        auto const start = store.rebuild();
+        if (!BEAST_EXPECT(start))
+            return;
+
+        // What SHAMapStoreImp::clearPrior does to the stored ledgers
+        auto const seq = env.closed()->info().seq;
+        {
+            auto db = env.app().getTxnDB().checkoutDb();
+            *db << "DELETE FROM AccountTransactions WHERE LedgerSeq <= " +
+                    std::to_string(seq) + ";";
+        }
+
+        // Accounts seen before the pruned ledgers aren't new
+        env(pay("alice", "bob", ZXC(100)));
+        env.close();
+        auto now = store.totals();
+        if (!BEAST_EXPECT(now))
+            return;
+        BEAST_EXPECT(now->accounts == start->accounts);
+
+        env.fund(ZXC(10000), "carol");
+        env.close();
+        now = store.totals();
+        if (!BEAST_EXPECT(now))
+            return;
+        BEAST_EXPECT(now->accounts == start->accounts + 1);
+
+        // Nor are they lost by counting again
+        BEAST_EXPECT(store.rebuild() == now);
+    }
+
+    void
+    testFold()
+    {
+        testcase("fold");
+        using namespace test::jtx;
+        Env env{*this};
+        auto& store = env.app().getStatisStore();
+
+        env.fund(ZXC(10000), "alice", "bob");
+        env.close();
+        auto const start = store.rebuild();
+        if (!BEAST_EXPECT(start))
+            return;
+
+        auto const deltaRows = [&] {
+            boost::optional<std::uint64_t> rows;
+            auto db = env.app().getTxnDB().checkoutDb();
+            *db << "SELECT COUNT(*) FROM StatisDeltas;", soci::into(rows);
+            return rows.value_or(0);
+        };
+
+        for (std::uint32_t i = 0; i < 3 * StatisStore::foldSize; ++i)
+        {
+            if (i % 64 == 0)
+                env(pay("alice", "bob", ZXC(10)));
+            env.close();
+        }
+
+        // Complete blocks are folded into the chunk before them
+        BEAST_EXPECT(deltaRows() < 2 * StatisStore::foldSize);
+        auto const now = store.totals();
+        if (!BEAST_EXPECT(now))
+            return;
+        BEAST_EXPECT(now->txSuccess >= start->txSuccess + 12);
+
+        // Saving a folded ledger again doesn't count it twice
+        auto const folded = env.closed()->info().seq - StatisStore::foldSize;
+        {
+            auto db = env.app().getTxnDB().checkoutDb();
+            soci::transaction tr(*db);
+            store.onLedgerSaved(*db, folded, 100, 100);
+            tr.commit();
+        }
+        BEAST_EXPECT(store.totals() == now);
+        BEAST_EXPECT(store.rebuild() == now);
+    }
+
+    void
+    testScheduledRebuild()
+    {
+        testcase("scheduled rebuild");
+        using namespace test::jtx;
+        Env env{*this};
+        auto& store = env.app().getStatisStore();
+
+        env.fund(ZXC(10000), "alice", "bob");
+        env.close();
+        BEAST_EXPECT(!store.totals());
+
+        int calls = 0;
+        boost::optional<StatisStore::Statis> first, second;
+        store.scheduleRebuild([&](auto const& statis) {
+            ++calls;
+            first = statis;
+        });
+        // Joins the rebuild already scheduled, if it hasn't finished
+        store.scheduleRebuild([&](auto const& statis) {
+            ++calls;
+            second = statis;
+        });
+        env.app().getJobQueue().rendezvous();
+
+        BEAST_EXPECT(!store.rebuilding());
+        BEAST_EXPECT(calls == 2);
+        BEAST_EXPECT(first && first == store.totals());
+        BEAST_EXPECT(second == first);
+    }
+
+    void
+    testAccountCount()
+    {
+        testcase("account count");
+
+        StatisStore::Statis statis;
+        BEAST_EXPECT(LedgerAdjust::getAccountCount(statis) == 1);
+        statis.accounts = 10;
+        statis.contractCreate = 3;
+        BEAST_EXPECT(LedgerAdjust::getAccountCount(statis) == 7);
+
+        // More contracts than accounts doesn't wrap around
+        statis.contractCreate = 12;
+        BEAST_EXPECT(LedgerAdjust::getAccountCount(statis) == 1);
+        statis.accounts = 12;
+        BEAST_EXPECT(LedgerAdjust::getAccountCount(statis) == 1);
+    }
+
+public:
+    void
+    run() override
+    {
+        testIncremental();
+        testChunks();
+        testOnlineDelete();
+        testFold();
+        testScheduledRebuild();
+        testAccountCount();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(StatisStore, app, ripple);
+
+}  // namespace ripple
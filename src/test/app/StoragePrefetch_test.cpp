@@ -0,0 +1,248 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <peersafe/app/misc/StoragePrefetch.h>
+#include <peersafe/protocol/ContractDefines.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/digest.h>
+#include <test/jtx.h>
+#include <map>
+
+namespace ripple {
+
+class StoragePrefetch_test : public beast::unit_test::suite
+{
+    using TxMap = std::map<int, std::shared_ptr<STTx const>>;
+
+    static StoragePrefetch::Setup
+    makeSetup(
+        std::size_t maxKeys = 64,
+        std::size_t maxFunctions = 4096,
+        std::uint64_t maxIdle = 256)
+    {
+        StoragePrefetch::Setup setup;
+        setup.enable = true;
+        setup.maxKeys = maxKeys;
+        setup.maxFunctions = maxFunctions;
+        setup.maxIdle = maxIdle;
+        return setup;
+    }
+
+    static std::shared_ptr<STTx const>
+    makeCall(
+        AccountID const& contract,
+        Blob const& data,
+        std::uint16_t opType = MessageCall)
+    {
+        return std::make_shared<STTx const>(ttCONTRACT, [&](STObject& obj) {
+            obj.setAccountID(sfAccount, test::jtx::Account("alice").id());
+            obj.setAccountID(sfContractAddress, contract);
+            obj.setFieldU16(sfContractOpType, opType);
+            obj.setFieldVL(sfContractData, data);
+            obj.setFieldU32(sfGas, 30000);
+        });
+    }
+
+    // A function key falling in the shard `shard`
+    static uint256
+    functionIn(std::uint8_t shard, std::uint8_t n)
+    {
+        uint256 function;
+        function.begin()[0] = shard;
+        function.begin()[31] = n;
+        return function;
+    }
+
+    static std::uint64_t
+    counter(StoragePrefetch const& prefetch, char const* name)
+    {
+        return prefetch.getJson()[name].asUInt();
+    }
+
+    void
+    testFunctionKey()
+    {
+        testcase("function key");
+
+        AccountID const contract = test::jtx::Account("contract").id();
+        AccountID const other = test::jtx::Account("other").id();
+
+        auto const f = StoragePrefetch::functionKey(
+            *makeCall(contract, {0xa9, 0x05, 0x9c, 0xbb, 0x01}));
+        BEAST_EXPECT(f != beast::zero);
+        // Arguments don't matter, the selector and the contract do
+        BEAST_EXPECT(
+            f ==
+            StoragePrefetch::functionKey(
+                *makeCall(contract, {0xa9, 0x05, 0x9c, 0xbb, 0x02})));
+        BEAST_EXPECT(
+            f !=
+            StoragePrefetch::functionKey(
+                *makeCall(contract, {0x70, 0xa0, 0x82, 0x31})));
+        BEAST_EXPECT(
+            f !=
+            StoragePrefetch::functionKey(
+                *makeCall(other, {0xa9, 0x05, 0x9c, 0xbb})));
+        BEAST_EXPECT(
+            StoragePrefetch::functionKey(*makeCall(
+                contract, {0xa9, 0x05, 0x9c, 0xbb}, QueryCall)) ==
+            beast::zero);
+    }
+
+    void
+    testPredict()
+    {
+        testcase("predict");
+        using namespace test::jtx;
+        Env env(*this);
+
+        StoragePrefetch prefetch(
+            env.app(), makeSetup(), env.app().journal("StoragePrefetch"));
+        AccountID const contract = Account("contract").id();
+        auto const tx = makeCall(contract, {0xa9, 0x05, 0x9c, 0xbb});
+        auto const function = StoragePrefetch::functionKey(*tx);
+        uint256 const key1(1);
+        uint256 const key2(2);
+
+        prefetch.recordAccess(function, contract, key1);
+        prefetch.recordAccess(function, contract, key1);
+        prefetch.recordAccess(function, contract, key2);
+        // Not a message call
+        prefetch.recordAccess(beast::zero, contract, uint256(3));
+        BEAST_EXPECT(counter(prefetch, "functions") == 1);
+
+        prefetch.prefetch(*env.current(), TxMap{{0, tx}});
+        BEAST_EXPECT(counter(prefetch, "calls") == 1);
+        BEAST_EXPECT(counter(prefetch, "predicted_calls") == 1);
+
+        prefetch.onRead(sha512Half(contract, key1));
+        prefetch.onRead(sha512Half(contract, key2));
+        prefetch.onRead(sha512Half(contract, uint256(3)));
+        BEAST_EXPECT(counter(prefetch, "storage_reads") == 3);
+        BEAST_EXPECT(counter(prefetch, "storage_hits") == 2);
+
+        // The next ledger expects nothing of what it doesn't call
+        prefetch.prefetch(*env.current(), TxMap{});
+        prefetch.onRead(sha512Half(contract, key1));
+        BEAST_EXPECT(counter(prefetch, "storage_hits") == 2);
+    }
+
+    void
+    testKeyEviction()
+    {
+        testcase("key eviction");
+        using namespace test::jtx;
+        Env env(*this);
+
+        StoragePrefetch prefetch(
+            env.app(), makeSetup(2), env.app().journal("StoragePrefetch"));
+        AccountID const contract = Account("contract").id();
+        auto const tx = makeCall(contract, {0xa9, 0x05, 0x9c, 0xbb});
+        auto const function = StoragePrefetch::functionKey(*tx);
+
+        prefetch.recordAccess(function, contract, uint256(1));
+        prefetch.recordAccess(function, contract, uint256(2));
+        // Both keys were accessed in this ledger, the new one is dropped
+        prefetch.recordAccess(function, contract, uint256(3));
+        prefetch.prefetch(*env.current(), TxMap{{0, tx}});
+        prefetch.onRead(sha512Half(contract, uint256(3)));
+        BEAST_EXPECT(counter(prefetch, "storage_hits") == 0);
+
+        // In a later ledger the key accessed least recently makes room
+        prefetch.recordAccess(function, contract, uint256(2));
+        prefetch.recordAccess(function, contract, uint256(3));
+        prefetch.prefetch(*env.current(), TxMap{{0, tx}});
+        prefetch.onRead(sha512Half(contract, uint256(1)));
+        BEAST_EXPECT(counter(prefetch, "storage_hits") == 0);
+        prefetch.onRead(sha512Half(contract, uint256(2)));
+        prefetch.onRead(sha512Half(contract, uint256(3)));
+        BEAST_EXPECT(counter(prefetch, "storage_hits") == 2);
+    }
+
+    void
+    testFunctionEviction()
+    {
+        testcase("function eviction");
+        using namespace test::jtx;
+        Env env(*this);
+
+        // One function per shard
+        StoragePrefetch prefetch(
+            env.app(), makeSetup(64, 16), env.app().journal("StoragePrefetch"));
+        AccountID const contract = Account("contract").id();
+
+        prefetch.recordAccess(functionIn(1, 1), contract, uint256(1));
+        prefetch.recordAccess(functionIn(2, 1), contract, uint256(1));
+        BEAST_EXPECT(counter(prefetch, "functions") == 2);
+
+        // The older function of the shard makes room
+        prefetch.prefetch(*env.current(), TxMap{});
+        prefetch.recordAccess(functionIn(1, 2), contract, uint256(1));
+        BEAST_EXPECT(counter(prefetch, "functions") == 2);
+    }
+
+    void
+    testAging()
+    {
+        testcase("aging");
+        using namespace test::jtx;
+        Env env(*this);
+
+        StoragePrefetch prefetch(
+            env.app(),
+            makeSetup(64, 4096, 2),
+            env.app().journal("StoragePrefetch"));
+        AccountID const contract = Account("contract").id();
+        auto const tx = makeCall(contract, {0xa9, 0x05, 0x9c, 0xbb});
+        auto const function = StoragePrefetch::functionKey(*tx);
+
+        prefetch.recordAccess(function, contract, uint256(1));
+        prefetch.recordAccess(functionIn(1, 1), contract, uint256(1));
+        BEAST_EXPECT(counter(prefetch, "functions") == 2);
+
+        // A function called keeps its keys until they go idle
+        for (int i = 0; i < 2; ++i)
+            prefetch.prefetch(*env.current(), TxMap{{0, tx}});
+        BEAST_EXPECT(counter(prefetch, "functions") == 2);
+        prefetch.prefetch(*env.current(), TxMap{{0, tx}});
+        BEAST_EXPECT(counter(prefetch, "functions") == 1);
+        prefetch.onRead(sha512Half(contract, uint256(1)));
+        BEAST_EXPECT(counter(prefetch, "storage_hits") == 0);
+
+        // A function no longer called is forgotten
+        for (int i = 0; i < 3; ++i)
+            prefetch.prefetch(*env.current(), TxMap{});
+        BEAST_EXPECT(counter(prefetch, "functions") == 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        testFunctionKey();
+        testPredict();
+        testKeyEviction();
+        testFunctionEviction();
+        testAging();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(StoragePrefetch, app, ripple);
+
+}  // namespace ripple
@@ -0,0 +1,733 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <peersafe/app/ledger/LedgerTimeline.h>
+#include <peersafe/precompiled/ABI.h>
+#include <peersafe/precompiled/Utils.h>
+#include <peersafe/protocol/Contract.h>
+#include <peersafe/protocol/ContractDefines.h>
+#include <peersafe/protocol/TableDefines.h>
+#include <peersafe/rpc/impl/TableAssistant.h>
+#include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/core/ConfigSections.h>
+#include <ripple/json/to_string.h>
+#include <ripple/net/InfoSub.h>
+#include <ripple/protocol/jss.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/optional.hpp>
+#include <test/jtx.h>
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace ripple {
+namespace test {
+
+/*
+Drives a standalone node with a synthetic ChainSQL workload and reports how
+long the transactions take to be validated, and then to reach the table
+database.
+
+Run with
+
+    chainsqld --unittest=TableLoadBench --unittest-arg="[count=<n>]
+        [,rate=<tx/s>][,interval=<ms>][,accounts=<n>][,rows=<n>]
+        [,create=<w>][,insert=<w>][,update=<w>][,grant=<w>][,strict=<w>]
+        [,contract=<w>][,storage=0|1][,autosync=0|1][,seed=<n>]
+        [,wait=<s>][,report=<file>]"
+
+The transactions are submitted at `rate` per second, and a ledger is closed
+every `interval` milliseconds. Each one is picked at random, in proportion
+to the weights:
+
+    create      creates a table
+    insert      inserts `rows` rows at once
+    update      updates the rows matching a condition
+    grant       grants another account rights on a table
+    strict      inserts a row in strict mode, with a check hash
+    contract    inserts a row from a contract, through the table precompile
+
+The tables are kept in SQLite. With storage=1 (the default) the rows are
+written as the ledgers validate, with storage=0 they are left to the table
+sync. Latency percentiles go to the log, and the whole report as JSON to
+`report` when given.
+*/
+class TableLoadBench_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    enum Kind { create, insert, update, grant, strict, contract, kindCount };
+
+    static char const*
+    kindName(int kind)
+    {
+        static char const* const names[kindCount] = {
+            "create", "insert", "update", "grant", "strict", "contract"};
+        return names[kind];
+    }
+
+    struct Timing
+    {
+        Kind kind;
+        clock_type::time_point submitted;
+        boost::optional<clock_type::time_point> validated;
+        boost::optional<clock_type::time_point> stored;
+        std::string error;
+    };
+
+    // Times the validate_success and db_success of the transactions it is
+    // subscribed to
+    class Recorder : public InfoSub
+    {
+    public:
+        explicit Recorder(Source& source) : InfoSub(source)
+        {
+        }
+
+        void
+        expect(uint256 const& id, Kind kind)
+        {
+            std::lock_guard lock(mutex_);
+            txs_[id] = {kind, clock_type::now(), boost::none, boost::none, {}};
+        }
+
+        void
+        reject(uint256 const& id, std::string const& error)
+        {
+            std::lock_guard lock(mutex_);
+            txs_[id].error = error;
+        }
+
+        void
+        send(Json::Value const& jvObj, bool) override
+        {
+            auto const now = clock_type::now();
+            uint256 id;
+            if (!id.SetHex(jvObj[jss::transaction][jss::hash].asString()))
+                return;
+
+            std::lock_guard lock(mutex_);
+            auto const it = txs_.find(id);
+            if (it == txs_.end())
+                return;
+
+            auto const status = jvObj[jss::status].asString();
+            if (status == jss::validate_success)
+                it->second.validated = now;
+            else if (status == jss::db_success)
+                it->second.stored = now;
+            else if (it->second.error.empty())
+                it->second.error = status;
+        }
+
+        // Neither stored nor failed yet
+        std::size_t
+        pending() const
+        {
+            std::lock_guard lock(mutex_);
+            return std::count_if(txs_.begin(), txs_.end(), [](auto const& tx) {
+                return !tx.second.stored && tx.second.error.empty();
+            });
+        }
+
+        std::map<uint256, Timing>
+        results() const
+        {
+            std::lock_guard lock(mutex_);
+            return txs_;
+        }
+
+    private:
+        mutable std::mutex mutex_;
+        std::map<uint256, Timing> txs_;
+    };
+
+    struct Client
+    {
+        jtx::Account account;
+        std::uint32_t tables = 0;
+        std::uint32_t rows = 0;
+        bool grantInsert = false;
+    };
+
+    struct Workload
+    {
+        std::vector<Client> clients;
+        AccountID proxy;
+        std::uint32_t rows = 10;
+        std::mt19937 rng;
+    };
+
+    static Section
+    parse(std::string s)
+    {
+        Section section;
+        std::vector<std::string> v;
+        boost::split(v, s, boost::algorithm::is_any_of(","));
+        for (auto& e : v)
+            boost::trim(e);
+        section.append(v);
+        return section;
+    }
+
+    static double
+    ms(clock_type::duration d)
+    {
+        using namespace std::chrono;
+        return duration_cast<microseconds>(d).count() / 1000.;
+    }
+
+    std::unique_ptr<Config>
+    makeConfig(Section const& args)
+    {
+        auto cfg = jtx::envconfig();
+        cfg->overwrite("sync_db", "type", "sqlite");
+        cfg->overwrite("sync_db", "db", "chainsql");
+        cfg->overwrite(
+            "sync_db", "first_storage", get<std::string>(args, "storage", "1"));
+        cfg->deprecatedClearSection(ConfigSection::autoSync());
+        cfg->section(ConfigSection::autoSync())
+            .append(get<std::string>(args, "autosync", "1"));
+        cfg->overwrite(ConfigSection::ledgerTimeline(), "enable", "1");
+        return cfg;
+    }
+
+    // The columns of every table of the workload
+    static Json::Value
+    columns()
+    {
+        Json::Value raw(Json::arrayValue);
+        Json::Value id;
+        id["field"] = "id";
+        id["type"] = "int";
+        id["PK"] = 1;
+        raw.append(id);
+        Json::Value name;
+        name["field"] = "name";
+        name["type"] = "varchar";
+        name["length"] = 64;
+        raw.append(name);
+        Json::Value amount;
+        amount["field"] = "amount";
+        amount["type"] = "int";
+        raw.append(amount);
+        return raw;
+    }
+
+    static Json::Value
+    makeRows(Client& client, std::uint32_t count)
+    {
+        Json::Value raw(Json::arrayValue);
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            auto const id = ++client.rows;
+            Json::Value row;
+            row["id"] = id;
+            row["name"] = "row " + std::to_string(id);
+            row["amount"] = id % 1000;
+            raw.append(row);
+        }
+        return raw;
+    }
+
+    // A table transaction as a client sends it, prepared the way the RPC
+    // handlers prepare it, with a fee that covers the raw bytes
+    boost::optional<Json::Value>
+    tableTx(
+        jtx::Env& env,
+        Client const& client,
+        std::string const& table,
+        TableOpType opType,
+        Json::Value raw,
+        bool strictMode = false)
+    {
+        bool const statement = opType == R_INSERT || opType == R_UPDATE;
+        Json::Value jv;
+        jv[jss::TransactionType] =
+            statement ? jss::SQLStatement : jss::TableListSet;
+        jv[jss::Account] = client.account.human();
+        if (statement)
+            jv[jss::Owner] = client.account.human();
+        jv[jss::OpType] = opType;
+        Json::Value tables;
+        tables[jss::Table][jss::TableName] = table;
+        jv[jss::Tables].append(tables);
+        jv[jss::Raw] = std::move(raw);
+        // Only the transactions carrying StrictMode get a check hash
+        if (strictMode)
+            jv[jss::StrictMode] = true;
+        return prepare(env, std::move(jv));
+    }
+
+    boost::optional<Json::Value>
+    prepare(jtx::Env& env, Json::Value jv)
+    {
+        auto const ret =
+            env.app().getTableAssistant().prepare("", "", jv, false);
+        if (ret.isMember(jss::error))
+        {
+            log << "prepare failed: " << to_string(ret) << std::endl;
+            return boost::none;
+        }
+
+        auto const fees = env.current()->fees();
+        auto const rawBytes = jv[jss::Raw].asString().size() / 2;
+        jv[jss::Fee] = std::to_string(
+            2 * (fees.base.drops() + 1000 + rawBytes * fees.drops_per_byte));
+        return jv;
+    }
+
+    // Copies its call data into memory, calls the table precompile with it
+    // and returns the first word of the result, reverting if the call fails
+    static eth::bytes
+    proxyCode()
+    {
+        eth::bytes const runtime = {
+            0x36,              // CALLDATASIZE
+            0x60, 0x00,        // PUSH1 0
+            0x60, 0x00,        // PUSH1 0
+            0x37,              // CALLDATACOPY
+            0x60, 0x20,        // PUSH1 32    out size
+            0x60, 0x00,        // PUSH1 0     out offset
+            0x36,              // CALLDATASIZE
+            0x60, 0x00,        // PUSH1 0     in offset
+            0x60, 0x00,        // PUSH1 0     value
+            0x61, 0x10, 0x01,  // PUSH2 0x1001
+            0x5a,              // GAS
+            0xf1,              // CALL
+            0x60, 0x1c,        // PUSH1 ok
+            0x57,              // JUMPI
+            0x60, 0x00,        // PUSH1 0
+            0x60, 0x00,        // PUSH1 0
+            0xfd,              // REVERT
+            0x5b,              // ok: JUMPDEST
+            0x60, 0x20,        // PUSH1 32
+            0x60, 0x00,        // PUSH1 0
+            0xf3,              // RETURN
+        };
+        eth::bytes code = {
+            0x60, static_cast<std::uint8_t>(runtime.size()),  // PUSH1 size
+            0x80,                                             // DUP1
+            0x60, 0x0b,                                       // PUSH1 11
+            0x60, 0x00,                                       // PUSH1 0
+            0x39,                                             // CODECOPY
+            0x60, 0x00,                                       // PUSH1 0
+            0xf3,                                             // RETURN
+        };
+        code.insert(code.end(), runtime.begin(), runtime.end());
+        return code;
+    }
+
+    Json::Value
+    contractTx(Client const& client, std::uint16_t opType, eth::bytes const& data)
+    {
+        Json::Value jv;
+        jv[jss::TransactionType] = jss::Contract;
+        jv[jss::Account] = client.account.human();
+        jv[sfContractOpType.jsonName] = opType;
+        jv[jss::ContractData] = strHex(data);
+        jv[sfGas.jsonName] = 3000000;
+        return jv;
+    }
+
+    boost::optional<Json::Value>
+    generate(jtx::Env& env, Workload& w, Client& client, Kind kind)
+    {
+        switch (kind)
+        {
+            case create:
+                return tableTx(
+                    env,
+                    client,
+                    "t" + std::to_string(++client.tables),
+                    T_CREATE,
+                    columns());
+
+            case update:
+                if (client.rows != 0)
+                {
+                    Json::Value raw(Json::arrayValue);
+                    Json::Value values;
+                    values["amount"] = static_cast<Json::UInt>(w.rng() % 1000);
+                    raw.append(values);
+                    Json::Value condition;
+                    condition["id"] =
+                        static_cast<Json::UInt>(w.rng() % client.rows + 1);
+                    raw.append(condition);
+                    return tableTx(env, client, "bulk", R_UPDATE, raw);
+                }
+                // Nothing to update yet
+                [[fallthrough]];
+
+            case insert:
+                return tableTx(
+                    env, client, "bulk", R_INSERT, makeRows(client, w.rows));
+
+            case grant: {
+                auto const& user =
+                    w.clients[(&client - &w.clients[0] + 1) % w.clients.size()];
+                client.grantInsert = !client.grantInsert;
+                Json::Value raw(Json::arrayValue);
+                Json::Value flags;
+                flags["select"] = true;
+                flags["insert"] = client.grantInsert;
+                raw.append(flags);
+                Json::Value jv;
+                jv[jss::TransactionType] = jss::TableListSet;
+                jv[jss::Account] = client.account.human();
+                jv[jss::User] = user.account.human();
+                jv[jss::OpType] = T_GRANT;
+                Json::Value tables;
+                tables[jss::Table][jss::TableName] = "bulk";
+                jv[jss::Tables].append(tables);
+                jv[jss::Raw] = raw;
+                return prepare(env, std::move(jv));
+            }
+
+            case strict: {
+                return tableTx(
+                    env, client, "strict", R_INSERT, makeRows(client, 1), true);
+            }
+
+            case contract: {
+                auto const raw = to_string(makeRows(client, 1));
+                auto const selector =
+                    getFuncSelectorByFunctionName("insert(address,string,string)");
+                eth::bytes data = {
+                    static_cast<std::uint8_t>(selector >> 24),
+                    static_cast<std::uint8_t>(selector >> 16),
+                    static_cast<std::uint8_t>(selector >> 8),
+                    static_cast<std::uint8_t>(selector)};
+                ContractABI abi;
+                auto const args = abi.abiIn(
+                    "", client.account.id(), std::string("bulk"), raw);
+                data.insert(data.end(), args.begin(), args.end());
+
+                auto jv = contractTx(client, MessageCall, data);
+                jv[jss::ContractAddress] = to_string(w.proxy);
+                return jv;
+            }
+
+            default:
+                break;
+        }
+        return boost::none;
+    }
+
+    // Creates the tables every client writes to and deploys the proxy
+    void
+    setup(jtx::Env& env, Workload& w)
+    {
+        using namespace jtx;
+        for (auto const& client : w.clients)
+            env.fund(ZXC(10000000), client.account);
+        env.close();
+
+        for (auto& client : w.clients)
+        {
+            if (auto jv = tableTx(env, client, "bulk", T_CREATE, columns()))
+                env(*jv);
+            if (auto jv = tableTx(
+                    env, client, "strict", T_CREATE, columns(), true))
+                env(*jv);
+        }
+
+        auto const deploy = env.jt(
+            contractTx(w.clients[0], ContractCreation, proxyCode()));
+        w.proxy = Contract::calcNewAddress(
+            w.clients[0].account.id(), deploy.jv[jss::Sequence].asUInt());
+        env.submit(deploy);
+        env.close();
+    }
+
+    static Json::Value
+    percentiles(std::vector<double> v)
+    {
+        Json::Value ret(Json::objectValue);
+        ret["count"] = static_cast<Json::UInt>(v.size());
+        if (v.empty())
+            return ret;
+
+        std::sort(v.begin(), v.end());
+        auto at = [&v](double p) {
+            return v[std::min(
+                v.size() - 1, static_cast<std::size_t>(p * v.size()))];
+        };
+        double sum = 0;
+        for (auto const d : v)
+            sum += d;
+        ret["mean"] = sum / v.size();
+        ret["p50"] = at(0.50);
+        ret["p90"] = at(0.90);
+        ret["p99"] = at(0.99);
+        ret["max"] = v.back();
+        return ret;
+    }
+
+    Json::Value
+    report(
+        Section const& args,
+        std::map<uint256, Timing> const& txs,
+        std::array<std::uint32_t, kindCount> const& weights,
+        clock_type::time_point start,
+        clock_type::time_point submitted,
+        std::size_t ledgers,
+        std::array<std::chrono::microseconds, LedgerTimeline::phaseCount> const&
+            phases)
+    {
+        struct Totals
+        {
+            std::size_t submitted = 0;
+            std::size_t validated = 0;
+            std::size_t stored = 0;
+            std::size_t failed = 0;
+            std::vector<double> toValidated;
+            std::vector<double> toStored;
+        };
+
+        Totals all;
+        std::array<Totals, kindCount> kinds;
+        std::map<std::string, std::size_t> errors;
+        auto last = start;
+        for (auto const& [id, tx] : txs)
+        {
+            for (auto* t : {&all, &kinds[tx.kind]})
+            {
+                ++t->submitted;
+                if (!tx.error.empty())
+                    ++t->failed;
+                if (tx.validated)
+                {
+                    ++t->validated;
+                    t->toValidated.push_back(ms(*tx.validated - tx.submitted));
+                }
+                if (tx.stored)
+                {
+                    ++t->stored;
+                    if (tx.validated)
+                        t->toStored.push_back(ms(*tx.stored - *tx.validated));
+                }
+            }
+            if (!tx.error.empty())
+                ++errors[tx.error];
+            if (tx.stored)
+                last = std::max(last, *tx.stored);
+        }
+
+        auto totals = [](Totals const& t) {
+            Json::Value ret(Json::objectValue);
+            ret["submitted"] = static_cast<Json::UInt>(t.submitted);
+            ret["validated"] = static_cast<Json::UInt>(t.validated);
+            ret["stored"] = static_cast<Json::UInt>(t.stored);
+            ret["failed"] = static_cast<Json::UInt>(t.failed);
+            ret["submit_to_validated_ms"] = percentiles(t.toValidated);
+            ret["validated_to_stored_ms"] = percentiles(t.toStored);
+            return ret;
+        };
+
+        Json::Value ret = totals(all);
+
+        Json::Value& config = ret["config"];
+        config["count"] = get<std::string>(args, "count", "1000");
+        config["rate"] = get<std::string>(args, "rate", "200");
+        config["interval_ms"] = get<std::string>(args, "interval", "1000");
+        config["accounts"] = get<std::string>(args, "accounts", "4");
+        config["rows"] = get<std::string>(args, "rows", "10");
+        config["storage"] = get<std::string>(args, "storage", "1");
+        config["autosync"] = get<std::string>(args, "autosync", "1");
+        for (int k = 0; k < kindCount; ++k)
+            config["mix"][kindName(k)] = weights[k];
+
+        ret["ledgers"] = static_cast<Json::UInt>(ledgers);
+        ret["elapsed_ms"] = ms(clock_type::now() - start);
+        auto const submitTime = ms(submitted - start) / 1000.;
+        if (submitTime > 0)
+            ret["submit_rate"] = all.submitted / submitTime;
+        auto const storeTime = ms(last - start) / 1000.;
+        if (storeTime > 0)
+            ret["stored_rate"] = all.stored / storeTime;
+
+        for (int k = 0; k < kindCount; ++k)
+            if (kinds[k].submitted)
+                ret["kinds"][kindName(k)] = totals(kinds[k]);
+        for (auto const& [error, count] : errors)
+            ret["errors"][error] = static_cast<Json::UInt>(count);
+        for (int p = 0; p < LedgerTimeline::phaseCount; ++p)
+        {
+            auto const phase = static_cast<LedgerTimeline::Phase>(p);
+            if (phases[p].count())
+                ret["phases_ms"][LedgerTimeline::phaseName(phase)] =
+                    phases[p].count() / 1000.;
+        }
+        return ret;
+    }
+
+    void
+    summarize(Json::Value const& r)
+    {
+        auto line = [this](std::string const& name, Json::Value const& p) {
+            if (p["count"].asUInt() == 0)
+                return;
+            log << "    " << name << ": p50 " << p["p50"].asDouble()
+                << "ms, p90 " << p["p90"].asDouble() << "ms, p99 "
+                << p["p99"].asDouble() << "ms, max " << p["max"].asDouble()
+                << "ms" << std::endl;
+        };
+
+        log << "    " << r["submitted"].asUInt() << " submitted, "
+            << r["validated"].asUInt() << " validated, "
+            << r["stored"].asUInt() << " stored, " << r["failed"].asUInt()
+            << " failed in " << r["ledgers"].asUInt() << " ledgers"
+            << std::endl;
+        if (r.isMember("submit_rate"))
+            log << "    " << r["submit_rate"].asDouble() << " tx/s submitted, "
+                << r["stored_rate"].asDouble() << " tx/s stored" << std::endl;
+        line("submit to validated", r["submit_to_validated_ms"]);
+        line("validated to stored", r["validated_to_stored_ms"]);
+        for (auto const& kind : r["kinds"].getMemberNames())
+            line(kind + " to stored", r["kinds"][kind]["validated_to_stored_ms"]);
+        for (auto const& error : r["errors"].getMemberNames())
+            log << "    " << error << ": " << r["errors"][error].asUInt()
+                << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        using namespace jtx;
+        using namespace std::chrono;
+
+        auto const args = parse(arg());
+        auto const count = get<std::size_t>(args, "count", 1000);
+        auto const rate = std::max(get<std::uint32_t>(args, "rate", 200), 1u);
+        auto const interval =
+            milliseconds(std::max(get<int>(args, "interval", 1000), 1));
+
+        std::array<std::uint32_t, kindCount> weights;
+        std::array<std::uint32_t, kindCount> const defaults = {1, 4, 2, 1, 1, 1};
+        for (int k = 0; k < kindCount; ++k)
+            weights[k] = get<std::uint32_t>(args, kindName(k), defaults[k]);
+
+        testcase(
+            std::to_string(count) + " transactions at " +
+            std::to_string(rate) + " tx/s");
+
+        Env env(*this, makeConfig(args));
+        auto& app = env.app();
+
+        Workload w;
+        w.rows = std::max(get<std::uint32_t>(args, "rows", 10), 1u);
+        w.rng.seed(get<std::uint32_t>(args, "seed", 1));
+        auto const accounts = std::max<std::size_t>(get<std::size_t>(args, "accounts", 4), 1);
+        for (std::size_t i = 0; i < accounts; ++i)
+            w.clients.push_back({Account("bench" + std::to_string(i))});
+        setup(env, w);
+
+        auto& timeline = app.getLedgerTimeline();
+        timeline.drainSamples([](auto, auto) {});
+        std::array<microseconds, LedgerTimeline::phaseCount> phases{};
+        std::size_t ledgers = 0;
+        auto close = [&] {
+            env.close();
+            ++ledgers;
+            timeline.drainSamples(
+                [&](LedgerTimeline::Phase phase, microseconds d) {
+                    phases[phase] += d;
+                });
+        };
+
+        auto recorder = std::make_shared<Recorder>(app.getOPs());
+        std::discrete_distribution<int> pick(weights.begin(), weights.end());
+
+        auto const start = clock_type::now();
+        auto nextClose = start + interval;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto const due = start +
+                duration_cast<clock_type::duration>(
+                                 duration<double>(double(i) / rate));
+            while (nextClose <= due)
+            {
+                std::this_thread::sleep_until(nextClose);
+                close();
+                nextClose += interval;
+            }
+            std::this_thread::sleep_until(due);
+
+            auto& client = w.clients[i % w.clients.size()];
+            auto const kind = static_cast<Kind>(pick(w.rng));
+            auto jv = generate(env, w, client, kind);
+            if (!jv)
+                continue;
+
+            auto const jt = env.jt(std::move(*jv), ter(std::ignore));
+            if (!jt.stx)
+                continue;
+            auto const id = jt.stx->getTransactionID();
+            recorder->expect(id, kind);
+            app.getOPs().subTransaction(recorder, id);
+            env.submit(jt);
+            if (!isTesSuccess(env.ter()) && env.ter() != terQUEUED)
+                recorder->reject(id, transToken(env.ter()));
+        }
+        auto const submitted = clock_type::now();
+
+        // Keep closing ledgers until every transaction reached the
+        // database or failed
+        auto const deadline = submitted + seconds(get<int>(args, "wait", 30));
+        while (recorder->pending() != 0 && clock_type::now() < deadline)
+        {
+            close();
+            auto const until = std::min(clock_type::now() + interval, deadline);
+            while (recorder->pending() != 0 && clock_type::now() < until)
+                std::this_thread::sleep_for(milliseconds(10));
+        }
+
+        auto const results = recorder->results();
+        auto const r =
+            report(args, results, weights, start, submitted, ledgers, phases);
+        summarize(r);
+
+        if (args.exists("report"))
+        {
+            std::ofstream out(get<std::string>(args, "report"));
+            out << r.toStyledString();
+            BEAST_EXPECT(out.good());
+        }
+        else
+        {
+            log << to_string(r) << std::endl;
+        }
+
+        BEAST_EXPECT(recorder->pending() == 0);
+        BEAST_EXPECT(r["failed"].asUInt() == 0);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(TableLoadBench, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -0,0 +1,457 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <peersafe/app/table/TableMirror.h>
+#include <peersafe/app/util/TableSyncUtil.h>
+#include <peersafe/protocol/TableDefines.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/json/json_reader.h>
+#include <ripple/json/to_string.h>
+#include <ripple/protocol/STArray.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/protocol/jss.h>
+#include <test/unit_test/SuiteJournal.h>
+#include <chrono>
+
+namespace ripple {
+
+class TableMirror_test : public beast::unit_test::suite
+{
+    static uint160 const&
+    table()
+    {
+        static uint160 const t(42);
+        return t;
+    }
+
+    static TableMirror::Setup
+    makeSetup()
+    {
+        TableMirror::Setup setup;
+        setup.tables.insert(table());
+        return setup;
+    }
+
+    // id, name, score and balance; every fifth score and name is null
+    static TableMirror::Columns
+    makeColumns(int rows)
+    {
+        TableMirror::Columns columns;
+        columns.addColumn("id", TableMirror::Kind::integer);
+        columns.addColumn("name", TableMirror::Kind::text);
+        columns.addColumn("score", TableMirror::Kind::integer);
+        columns.addColumn("balance", TableMirror::Kind::real);
+        for (int i = 0; i < rows; ++i)
+        {
+            Json::Value row(Json::objectValue);
+            row["id"] = i;
+            row["name"] = i % 5 == 4 ? Json::Value()
+                                     : Json::Value("name_" + std::to_string(i));
+            row["score"] = i % 5 == 4 ? Json::Value() : Json::Value(i % 3);
+            row["balance"] = i * 0.5;
+            columns.append(row);
+        }
+        return columns;
+    }
+
+    static Json::Value
+    makeQuery(std::string const& raw, uint160 const& nameInDB = table())
+    {
+        Json::Value query(Json::objectValue);
+        Json::Value t(Json::objectValue);
+        t["Table"]["TableName"] = to_string(nameInDB);
+        query["Tables"].append(t);
+        query["Raw"] = raw;
+        return query;
+    }
+
+    static Json::Value
+    lines(TableMirror& mirror, std::string const& raw, int selectLimit = 200)
+    {
+        auto result = mirror.select(makeQuery(raw), selectLimit, nullptr);
+        if (!result)
+            return Json::Value();
+        return (*result)[jss::lines];
+    }
+
+    static std::vector<int>
+    ids(Json::Value const& lines)
+    {
+        std::vector<int> ret;
+        for (auto const& line : lines)
+            ret.push_back(line["id"].asInt());
+        return ret;
+    }
+
+    void
+    testConditions()
+    {
+        testcase("conditions");
+        test::SuiteJournal journal("TableMirror_test", *this);
+
+        TableMirror mirror(makeSetup(), journal);
+        mirror.install(table(), makeColumns(20));
+
+        BEAST_EXPECT(lines(mirror, R"([[]])").size() == 20);
+        BEAST_EXPECT(lines(mirror, R"([[], {"id": 3}])")[0u]["name"] ==
+                     "name_3");
+        BEAST_EXPECT(
+            ids(lines(mirror, R"([["id"], {"id": {"$ge": 17}}])")) ==
+            std::vector<int>({17, 18, 19}));
+        BEAST_EXPECT(
+            ids(lines(
+                mirror,
+                R"([["id"], {"id": {"$lt": 3}, "balance": {"$gt": 0.5}}])")) ==
+            std::vector<int>({2}));
+        BEAST_EXPECT(
+            ids(lines(
+                mirror, R"([["id"], {"$or": [{"id": 1}, {"id": 12}]}])")) ==
+            std::vector<int>({1, 12}));
+        BEAST_EXPECT(
+            ids(lines(mirror, R"([["id"], {"id": {"$in": [2, 5, 99]}}])")) ==
+            std::vector<int>({2, 5}));
+        BEAST_EXPECT(
+            ids(lines(mirror, R"([["id"], {"name": {"$regex": "/_1/"}}])")) ==
+            std::vector<int>({1, 10, 11, 12, 13, 15, 16, 17, 18}));
+
+        // NULL is neither equal nor unequal to anything
+        BEAST_EXPECT(
+            ids(lines(mirror, R"([["id"], {"score": {"$is": null}}])")) ==
+            std::vector<int>({4, 9, 14, 19}));
+        BEAST_EXPECT(
+            lines(mirror, R"([["id"], {"score": {"$ne": 0}}])").size() == 10);
+        BEAST_EXPECT(
+            lines(mirror, R"([["id"], {"id": {"$nin": [1, null]}}])").size() ==
+            0);
+        BEAST_EXPECT(lines(mirror, R"([["name"], {"id": 4}])")[0u]["name"]
+                         .isNull());
+    }
+
+    void
+    testOrderAndLimit()
+    {
+        testcase("order and limit");
+        test::SuiteJournal journal("TableMirror_test", *this);
+
+        TableMirror mirror(makeSetup(), journal);
+        mirror.install(table(), makeColumns(20));
+
+        BEAST_EXPECT(
+            ids(lines(
+                mirror,
+                R"([["id"], {"$order": [{"id": "desc"}]},)"
+                R"( {"$limit": {"index": 2, "total": 3}}])")) ==
+            std::vector<int>({17, 16, 15}));
+        // NULL sorts first, ties keep their order
+        BEAST_EXPECT(
+            ids(lines(
+                mirror,
+                R"([["id"], {"$order": [{"score": 1}]},)"
+                R"( {"$limit": {"index": 0, "total": 6}}])")) ==
+            std::vector<int>({4, 9, 14, 19, 0, 3}));
+        // Capped at select_limit
+        BEAST_EXPECT(lines(mirror, R"([[]])", 7).size() == 7);
+        BEAST_EXPECT(
+            lines(mirror, R"([[], {"$limit": {"index": 0, "total": 50}}])", 7)
+                .size() == 7);
+    }
+
+    void
+    testAggregates()
+    {
+        testcase("aggregates");
+        test::SuiteJournal journal("TableMirror_test", *this);
+
+        TableMirror mirror(makeSetup(), journal);
+        mirror.install(table(), makeColumns(20));
+
+        auto all = lines(
+            mirror,
+            R"j([["count(*)", "count(score)", "sum(id)", "max(name)",)j"
+            R"j( "avg(balance)", "min(score)"]])j");
+        if (BEAST_EXPECT(all.size() == 1))
+        {
+            BEAST_EXPECT(all[0u]["count(*)"].asInt() == 20);
+            BEAST_EXPECT(all[0u]["count(score)"].asInt() == 16);
+            BEAST_EXPECT(all[0u]["sum(id)"].asInt() == 190);
+            BEAST_EXPECT(all[0u]["max(name)"] == "name_8");
+            BEAST_EXPECT(all[0u]["avg(balance)"].asDouble() == 4.75);
+            BEAST_EXPECT(all[0u]["min(score)"].asInt() == 0);
+        }
+
+        // Empty input still makes one line
+        auto none = lines(mirror, R"j([["count(*)", "sum(id)"], {"id": -1}])j");
+        if (BEAST_EXPECT(none.size() == 1))
+        {
+            BEAST_EXPECT(none[0u]["count(*)"].asInt() == 0);
+            BEAST_EXPECT(none[0u]["sum(id)"].isNull());
+        }
+
+        auto grouped = lines(
+            mirror,
+            R"j([["score", "count(*)"], {"$group": ["score"]},)j"
+            R"( {"$order": [{"score": -1}]}])");
+        if (BEAST_EXPECT(grouped.size() == 4))
+        {
+            BEAST_EXPECT(grouped[0u]["score"].asInt() == 2);
+            BEAST_EXPECT(grouped[0u]["count(*)"].asInt() == 5);
+            BEAST_EXPECT(grouped[3u]["score"].isNull());
+            BEAST_EXPECT(grouped[3u]["count(*)"].asInt() == 4);
+        }
+    }
+
+    void
+    testFallback()
+    {
+        testcase("fallback");
+        test::SuiteJournal journal("TableMirror_test", *this);
+
+        TableMirror mirror(makeSetup(), journal);
+
+        // Not loaded, and no database to load it from
+        BEAST_EXPECT(!mirror.select(makeQuery(R"([[]])"), 200, nullptr));
+
+        mirror.install(table(), makeColumns(20));
+        for (auto const raw :
+             {R"([[], {"$join": {}}])",
+              R"([[], {"nosuch": 1}])",
+              R"j([["nosuch(id)"]])j",
+              R"([["id"], {"$group": ["id"]}, {"$order": [{"name": 1}]}])",
+              R"j([["name", "count(*)"], {"$group": ["score"]}])j",
+              R"([[], {"name": "it's"}])",
+              R"([[], {"id": {"$eq": "1"}}])",
+              R"(not json)"})
+        {
+            BEAST_EXPECT(!mirror.select(makeQuery(raw), 200, nullptr));
+        }
+        BEAST_EXPECT(
+            !mirror.select(makeQuery(R"([[]])", uint160(7)), 200, nullptr));
+
+        // Selects that don't parse aren't counted against any table
+        auto const jv = mirror.getJson();
+        BEAST_EXPECT(jv["fallbacks"] == "7");
+    }
+
+    static STTx
+    makeTx(TableOpType opType, std::string const& raw)
+    {
+        return STTx(ttSQLSTATEMENT, [&](auto& obj) {
+            obj.setFieldU16(sfOpType, opType);
+            obj.setFieldVL(sfRaw, makeSlice(raw));
+            obj.setFieldVL(sfAutoFillField, makeSlice(std::string("hash")));
+            STObject t(sfTable);
+            t.setFieldVL(sfTableName, makeSlice(std::string("mirrored")));
+            t.setFieldH160(sfNameInDB, table());
+            STArray tables(sfTables);
+            tables.push_back(std::move(t));
+            obj.setFieldArray(sfTables, tables);
+        });
+    }
+
+    void
+    testWrites()
+    {
+        testcase("writes");
+        test::SuiteJournal journal("TableMirror_test", *this);
+
+        TableMirror mirror(makeSetup(), journal);
+        auto columns = makeColumns(3);
+        columns.addColumn("hash", TableMirror::Kind::text);
+        mirror.install(table(), std::move(columns));
+
+        SyncParam const param{""};
+        auto const insert = makeTx(
+            R_INSERT,
+            R"([{"id": 3, "name": "x", "score": "2", "balance": 1.5},)"
+            R"( {"id": 4, "name": null, "score": null, "balance": 2}])");
+
+        // Staged rows are not visible until committed
+        mirror.stage(insert, param);
+        BEAST_EXPECT(lines(mirror, R"([[]])").size() == 3);
+        mirror.commit(table());
+        auto const rows = lines(mirror, R"([[], {"id": {"$ge": 3}}])");
+        if (BEAST_EXPECT(rows.size() == 2))
+        {
+            BEAST_EXPECT(rows[0u]["score"].asInt() == 2);
+            BEAST_EXPECT(
+                rows[1u]["hash"] == to_string(insert.getRealTxID()));
+        }
+
+        // A rolled back insert is dropped along with the rows
+        mirror.stage(insert, param);
+        mirror.invalidate(table());
+        BEAST_EXPECT(!mirror.select(makeQuery(R"([[]])"), 200, nullptr));
+
+        // Updates make the table read again
+        mirror.install(table(), makeColumns(3));
+        mirror.stage(makeTx(R_UPDATE, R"([{"name": "y"}, {"id": 1}])"), param);
+        mirror.commit(table());
+        BEAST_EXPECT(!mirror.select(makeQuery(R"([[]])"), 200, nullptr));
+
+        // As does an insert that doesn't match the columns
+        mirror.install(table(), makeColumns(3));
+        mirror.stage(makeTx(R_INSERT, R"([{"id": 5}])"), param);
+        mirror.commit(table());
+        BEAST_EXPECT(!mirror.select(makeQuery(R"([[]])"), 200, nullptr));
+    }
+
+public:
+    void
+    run() override
+    {
+        testConditions();
+        testOrderAndLimit();
+        testAggregates();
+        testFallback();
+        testWrites();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TableMirror, app, ripple);
+
+/*
+Latency of dashboard style selects on a mirrored table of 100000 rows: a
+filtered count, a grouped sum, and an ordered page. Compared with the same
+selects evaluated row by row over the rows held as JSON objects, which is
+the lower bound of what reading them back from the database costs.
+*/
+class TableMirrorBench_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    template <class F>
+    std::chrono::microseconds
+    measure(char const* name, F&& f)
+    {
+        using namespace std::chrono;
+        int const rounds = 5;
+        auto best = microseconds::max();
+        for (int i = 0; i < rounds; ++i)
+        {
+            auto const start = clock_type::now();
+            f();
+            best = std::min(
+                best, duration_cast<microseconds>(clock_type::now() - start));
+        }
+        log << "    " << name << ": " << best.count() << " us" << std::endl;
+        return best;
+    }
+
+public:
+    void
+    run() override
+    {
+        using namespace std::chrono;
+        test::SuiteJournal journal("TableMirrorBench_test", *this);
+
+        int const rows = 100000;
+        beast::xor_shift_engine gen(1);
+        TableMirror::Setup setup;
+        uint160 const nameInDB(1);
+        setup.tables.insert(nameInDB);
+        TableMirror mirror(setup, journal);
+
+        TableMirror::Columns columns;
+        columns.addColumn("id", TableMirror::Kind::integer);
+        columns.addColumn("region", TableMirror::Kind::integer);
+        columns.addColumn("amount", TableMirror::Kind::real);
+        std::vector<Json::Value> json;
+        json.reserve(rows);
+        for (int i = 0; i < rows; ++i)
+        {
+            Json::Value row(Json::objectValue);
+            row["id"] = i;
+            row["region"] = static_cast<int>(gen() % 16);
+            row["amount"] = static_cast<double>(gen() % 100000) / 100;
+            columns.append(row);
+            json.push_back(std::move(row));
+        }
+        mirror.install(nameInDB, std::move(columns));
+
+        auto const query = [&](std::string const& raw) {
+            Json::Value q(Json::objectValue);
+            Json::Value t(Json::objectValue);
+            t["Table"]["TableName"] = to_string(nameInDB);
+            q["Tables"].append(t);
+            q["Raw"] = raw;
+            return q;
+        };
+
+        testcase("filtered count");
+        auto const count = query(
+            R"j([["count(*)"],)j"
+            R"( {"amount": {"$gt": 500}, "region": {"$le": 3}}])");
+        int mirrored = 0;
+        measure("mirror", [&] {
+            mirrored = (*mirror.select(count, 200, nullptr))[jss::lines][0u]
+                                                             ["count(*)"]
+                                                                 .asInt();
+        });
+        int scanned = 0;
+        measure("row by row", [&] {
+            scanned = 0;
+            for (auto const& row : json)
+                scanned += row["amount"].asDouble() > 500 &&
+                    row["region"].asInt() <= 3;
+        });
+        BEAST_EXPECT(mirrored == scanned);
+
+        testcase("grouped sum");
+        auto const sum = query(
+            R"j([["region", "sum(amount)"], {"$group": ["region"]}])j");
+        measure("mirror", [&] {
+            BEAST_EXPECT(
+                (*mirror.select(sum, 200, nullptr))[jss::lines].size() == 16);
+        });
+        measure("row by row", [&] {
+            std::map<int, double> sums;
+            for (auto const& row : json)
+                sums[row["region"].asInt()] += row["amount"].asDouble();
+            BEAST_EXPECT(sums.size() == 16);
+        });
+
+        testcase("ordered page");
+        auto const page = query(
+            R"([["id", "amount"], {"region": 7}, {"$order": [{"amount": -1}]},)"
+            R"( {"$limit": {"index": 0, "total": 20}}])");
+        measure("mirror", [&] {
+            BEAST_EXPECT(
+                (*mirror.select(page, 200, nullptr))[jss::lines].size() == 20);
+        });
+        measure("row by row", [&] {
+            std::vector<Json::Value const*> selected;
+            for (auto const& row : json)
+            {
+                if (row["region"].asInt() == 7)
+                    selected.push_back(&row);
+            }
+            std::stable_sort(
+                selected.begin(), selected.end(), [](auto a, auto b) {
+                    return (*a)["amount"].asDouble() >
+                        (*b)["amount"].asDouble();
+                });
+            BEAST_EXPECT(selected.size() >= 20);
+        });
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(TableMirrorBench, app, ripple);
+
+}  // namespace ripple
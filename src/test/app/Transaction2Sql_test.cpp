@@ -40,6 +40,7 @@ OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 #include <peersafe/app/sql/SQLConditionTree.h>
 #include <peersafe/app/sql/STTx2SQL.h>
 #include <peersafe/app/sql/TxStore.h>
+#include <peersafe/precompiled/TableRows.h>
 #include <test/jtx.h>
 #include <test/app/SuitLogs.h>
 
@@ -714,6 +715,58 @@ public:
 		BEAST_EXPECT(result_string == excepted_query);
 	}
 
+	// insertRows/updateRows/deleteRows pass every value as a JSON string,
+	// numbers included; int and decimal columns take them through the
+	// database's own conversion.
+	void test_TypedRowsTransaction() {
+		auto dispose = [this](const std::string& raw, std::uint16_t opType) {
+			const auto keypair = randomKeyPair(KeyType::ed25519);
+			STTx tx(ttSQLSTATEMENT, [this, &raw, opType](STObject &obj) {
+				set_OwnerID(obj);
+				obj.setFieldU16(sfOpType, opType);
+				set_tables(obj);
+				ripple::Blob blob;
+				blob.assign(raw.begin(), raw.end());
+				obj.setFieldVL(sfRaw, blob);
+			});
+			tx.sign(keypair.first, keypair.second);
+
+			TxStoreTransaction tr(txstore_dbconn_.get());
+			auto res = txstore_->Dispose(tx);
+			BEAST_EXPECT(res.first == true);
+			if (res.first == true)
+				tr.commit();
+			else
+				tr.rollback();
+		};
+
+		TableRows rows;
+		rows.fields = { "id", "name", "cash", "deci" };
+		rows.values = { "4", "test4", "400.5", "12.50" };
+		BEAST_EXPECT(rows.toRaw() ==
+			"[{\"cash\":\"400.5\",\"deci\":\"12.50\",\"id\":\"4\",\"name\":\"test4\"}]");
+		dispose(rows.toRaw(), 6); // insert
+
+		std::string query = "[[\"id\",\"cash\",\"deci\"],{\"id\":4}]";
+		std::string result_string = Json::jsonAsString(getRecords(query));
+		BEAST_EXPECT(result_string == "{\"lines\":[{\"cash\":400.5,\"deci\":12.5,\"id\":4}],\"status\":\"success\"}");
+
+		TableRows set, where;
+		set.fields = { "cash" };
+		set.values = { "401.25" };
+		where.fields = { "id" };
+		where.values = { "4" };
+		dispose(toUpdateRaw(set, where), 8); // update
+
+		result_string = Json::jsonAsString(getRecords(query));
+		BEAST_EXPECT(result_string == "{\"lines\":[{\"cash\":401.25,\"deci\":12.5,\"id\":4}],\"status\":\"success\"}");
+
+		// leave the rows the later cases expect
+		dispose(where.toRaw(), 9); // delete
+		result_string = Json::jsonAsString(getRecords(query));
+		BEAST_EXPECT(result_string == "{\"lines\":null,\"status\":\"success\"}");
+	}
+
 	void test_SelectRecord() {
 		//  desc/asc ؼֽ,   desc/asc ؼֵַᴦ asc
 		{
@@ -2625,6 +2678,7 @@ public:
 		test_CreateTableTransaction();
 		test_InsertRecordTransaction();
 		test_UpdateRecordTransaction();
+		test_TypedRowsTransaction();
 		test_SelectRecord();
 
 
@@ -0,0 +1,163 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/misc/TxBatcher.h>
+#include <ripple/beast/unit_test.h>
+
+namespace ripple {
+
+class TxBatcher_test : public beast::unit_test::suite
+{
+    using clock_type = TxBatcher::clock_type;
+    using us = std::chrono::microseconds;
+
+    // Queues transactions evenly spaced over the given time
+    static clock_type::time_point
+    arrive(
+        TxBatcher& batcher,
+        clock_type::time_point now,
+        std::size_t count,
+        std::chrono::milliseconds over)
+    {
+        auto const gap = std::chrono::duration_cast<clock_type::duration>(
+                             over) /
+            count;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            now += gap;
+            batcher.arrived(now);
+        }
+        return now;
+    }
+
+    void
+    testLowLoad()
+    {
+        testcase("low load");
+
+        TxBatcher batcher;
+        auto now = clock_type::now();
+        BEAST_EXPECT(batcher.target(now) == 1);
+        BEAST_EXPECT(batcher.wait(1, now) == us{0});
+
+        // Expensive batches, but a few transactions a second: waiting
+        // would only add latency
+        for (int i = 0; i < 20; ++i)
+            batcher.applied(1 + i % 3, us{1000});
+        now = arrive(batcher, now, 5, std::chrono::milliseconds{1000});
+        BEAST_EXPECT(batcher.target(now) == 1);
+        BEAST_EXPECT(batcher.wait(1, now) == us{0});
+    }
+
+    void
+    testHighLoad()
+    {
+        testcase("high load");
+
+        TxBatcher::Setup setup;
+        setup.maxDelay = us{2000};
+        TxBatcher batcher(setup);
+
+        // 200us a batch and 10us a transaction
+        for (std::size_t size : {1, 5, 20, 3, 50, 8, 1, 30, 12, 2})
+            batcher.applied(size, us{200 + 10 * size});
+        auto const info = batcher.getJson(clock_type::now());
+        BEAST_EXPECT(info["batch_cost_us"].asUInt() == 200);
+        BEAST_EXPECT(std::abs(info["tx_cost_us"].asDouble() - 10) < 0.01);
+
+        // 100000 a second: 200 arrive within the longest delay, but 200
+        // is enough to bring the batch cost down to a tenth of 10us each
+        auto now = arrive(
+            batcher, clock_type::now(), 30000, std::chrono::milliseconds{300});
+        BEAST_EXPECT(batcher.target(now) == 200);
+        BEAST_EXPECT(batcher.wait(200, now) == us{0});
+        auto const wait = batcher.wait(100, now);
+        BEAST_EXPECT(wait > us{0} && wait <= setup.maxDelay);
+
+        // 20000 a second: only 40 arrive within the longest delay
+        now = arrive(batcher, now, 60000, std::chrono::milliseconds{3000});
+        auto const target = batcher.target(now);
+        BEAST_EXPECT(target >= 38 && target <= 42);
+        BEAST_EXPECT(batcher.wait(1, now) <= setup.maxDelay);
+
+        // After a quiet spell the next transaction goes straight through
+        now += std::chrono::seconds{5};
+        batcher.arrived(now);
+        BEAST_EXPECT(batcher.target(now) == 1);
+    }
+
+    void
+    testUnfitted()
+    {
+        testcase("unfitted");
+
+        // Batches of one can't tell the fixed cost from the rest, so
+        // the batcher assumes half and starts batching at high load
+        TxBatcher batcher;
+        for (int i = 0; i < 10; ++i)
+            batcher.applied(1, us{100});
+        auto const now = arrive(
+            batcher, clock_type::now(), 30000, std::chrono::milliseconds{300});
+        BEAST_EXPECT(batcher.target(now) == 10);
+    }
+
+    void
+    testHistograms()
+    {
+        testcase("histograms");
+
+        TxBatcher batcher;
+        batcher.applied(1, us{10});
+        batcher.applied(3, us{10});
+        batcher.applied(4, us{10});
+        batcher.applied(100, us{10});
+        batcher.waited(us{0});
+        batcher.waited(us{1500});
+
+        auto const info = batcher.getJson(clock_type::now());
+        BEAST_EXPECT(info["batches"].asUInt() == 4);
+        BEAST_EXPECT(info["transactions"].asUInt() == 2);
+
+        auto const& sizes = info["batch_size"];
+        BEAST_EXPECT(sizes.size() == 4);
+        BEAST_EXPECT(sizes["1"].asUInt() == 1);
+        BEAST_EXPECT(sizes["3"].asUInt() == 1);
+        BEAST_EXPECT(sizes["7"].asUInt() == 1);
+        BEAST_EXPECT(sizes["127"].asUInt() == 1);
+
+        auto const& latencies = info["latency_us"];
+        BEAST_EXPECT(latencies.size() == 2);
+        BEAST_EXPECT(latencies["0"].asUInt() == 1);
+        BEAST_EXPECT(latencies["2047"].asUInt() == 1);
+    }
+
+public:
+    void
+    run() override
+    {
+        testLowLoad();
+        testHighLoad();
+        testUnfitted();
+        testHistograms();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TxBatcher, app, ripple);
+
+}  // namespace ripple
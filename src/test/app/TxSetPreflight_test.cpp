@@ -0,0 +1,239 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <peersafe/app/ledger/TxSetPreflight.h>
+#include <ripple/app/tx/apply.h>
+#include <ripple/core/ConfigSections.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/ledger/OpenView.h>
+#include <ripple/shamap/SHAMap.h>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+class TxSetPreflight_test : public beast::unit_test::suite
+{
+    static std::unique_ptr<Config>
+    enable(std::unique_ptr<Config> cfg)
+    {
+        cfg->section(ConfigSection::consensusPreflight()).set("enable", "1");
+        cfg->section(ConfigSection::consensusPreflight()).set("chunk", "2");
+        return cfg;
+    }
+
+    static std::shared_ptr<STTx const>
+    tamper(STTx const& tx)
+    {
+        // Signed for another fee
+        STObject obj(tx);
+        obj.setFieldAmount(
+            sfFee, tx.getFieldAmount(sfFee).zxc() + ZXCAmount{1});
+        Serializer s;
+        obj.add(s);
+        return std::make_shared<STTx const>(SerialIter{s.slice()});
+    }
+
+    static std::shared_ptr<SHAMap>
+    makeSet(
+        jtx::Env& env,
+        std::vector<std::shared_ptr<STTx const>> const& txs)
+    {
+        auto set = std::make_shared<SHAMap>(
+            SHAMapType::TRANSACTION, env.app().getNodeFamily());
+        for (auto const& tx : txs)
+        {
+            Serializer s;
+            tx->add(s);
+            set->addItem(
+                SHAMapItem{tx->getTransactionID(), std::move(s)}, true, false);
+        }
+        return set;
+    }
+
+    static std::uint32_t
+    delta(Json::Value const& before, Json::Value const& after, char const* f)
+    {
+        return after[f].asUInt() - before[f].asUInt();
+    }
+
+    void
+    testDisabled()
+    {
+        testcase("disabled");
+        using namespace jtx;
+
+        Env env(*this);
+        Account const alice("alice");
+        env.fund(ZXC(10000), alice);
+        env.close();
+
+        auto& stage = env.app().getTxSetPreflight();
+        BEAST_EXPECT(!stage.enabled());
+
+        auto const jt = env.jt(noop(alice));
+        stage.verify(makeSet(env, {jt.stx}), env.closed());
+        env.app().getJobQueue().rendezvous();
+        BEAST_EXPECT(
+            !stage.passed(*jt.stx, env.closed()->rules(), tapForConsensus));
+        BEAST_EXPECT(stage.getJson()["sets"].asUInt() == 0);
+    }
+
+    void
+    testVerify()
+    {
+        testcase("verify");
+        using namespace jtx;
+
+        Env env(*this, envconfig(enable));
+        Account const alice("alice");
+        Account const becky("becky");
+        env.fund(ZXC(10000), alice, becky);
+        env.close();
+        env.app().getJobQueue().rendezvous();
+
+        auto& stage = env.app().getTxSetPreflight();
+        BEAST_EXPECT(stage.enabled());
+
+        auto const good1 = env.jt(noop(alice)).stx;
+        auto const good2 = env.jt(noop(becky)).stx;
+        auto const bad = tamper(*good2);
+        BEAST_EXPECT(
+            bad->getTransactionID() != good2->getTransactionID());
+
+        auto const rules = env.closed()->rules();
+        auto const before = stage.getJson();
+        stage.verify(makeSet(env, {good1, good2, bad}), env.closed());
+        env.app().getJobQueue().rendezvous();
+
+        auto const after = stage.getJson();
+        BEAST_EXPECT(delta(before, after, "sets") == 1);
+        BEAST_EXPECT(delta(before, after, "checked") == 3);
+        BEAST_EXPECT(delta(before, after, "failed") == 1);
+
+        BEAST_EXPECT(stage.passed(*good1, rules, tapForConsensus));
+        BEAST_EXPECT(
+            stage.passed(*good2, rules, tapForConsensus | tapRETRY));
+        BEAST_EXPECT(!stage.passed(*bad, rules, tapForConsensus));
+
+        // Not for the open ledger
+        BEAST_EXPECT(!stage.passed(*good1, rules, tapNONE));
+
+        // Nor with other rules
+        std::unordered_set<uint256, beast::uhash<>> const presets;
+        BEAST_EXPECT(
+            !stage.passed(*good1, Rules{presets}, tapForConsensus));
+
+        // The same set again only checks what failed
+        stage.verify(makeSet(env, {good1, good2, bad}), env.closed());
+        env.app().getJobQueue().rendezvous();
+        auto const again = stage.getJson();
+        BEAST_EXPECT(delta(after, again, "checked") == 1);
+        BEAST_EXPECT(delta(after, again, "already_checked") == 2);
+    }
+
+    void
+    testRulesChange()
+    {
+        testcase("rules change");
+        using namespace jtx;
+
+        Env env(*this, envconfig(enable));
+        Account const alice("alice");
+        env.fund(ZXC(10000), alice);
+        env.close();
+        env.app().getJobQueue().rendezvous();
+
+        auto& stage = env.app().getTxSetPreflight();
+        auto const tx = env.jt(noop(alice)).stx;
+        auto const rules = env.closed()->rules();
+        stage.verify(makeSet(env, {tx}), env.closed());
+        env.app().getJobQueue().rendezvous();
+        BEAST_EXPECT(stage.passed(*tx, rules, tapForConsensus));
+
+        // The next set is to be applied with other amendments
+        std::unordered_set<uint256, beast::uhash<>> const presets;
+        Rules const other{presets};
+        BEAST_EXPECT(other != rules);
+        auto const parent =
+            std::make_shared<OpenView>(open_ledger, other, env.closed());
+        stage.verify(makeSet(env, {}), parent);
+
+        // The pass under the old rules counts for neither
+        BEAST_EXPECT(!stage.passed(*tx, other, tapForConsensus));
+        BEAST_EXPECT(!stage.passed(*tx, rules, tapForConsensus));
+
+        // Until it is checked again with the new ones
+        stage.verify(makeSet(env, {tx}), parent);
+        env.app().getJobQueue().rendezvous();
+        BEAST_EXPECT(stage.passed(*tx, other, tapForConsensus));
+        BEAST_EXPECT(!stage.passed(*tx, rules, tapForConsensus));
+    }
+
+    void
+    testApply()
+    {
+        testcase("apply");
+        using namespace jtx;
+
+        Env env(*this, envconfig(enable));
+        Account const alice("alice");
+        env.fund(ZXC(10000), alice);
+        env.close();
+        env.app().getJobQueue().rendezvous();
+
+        auto& stage = env.app().getTxSetPreflight();
+        auto const tx = env.jt(noop(alice)).stx;
+        auto const bad = tamper(*tx);
+        stage.verify(makeSet(env, {tx, bad}), env.closed());
+        env.app().getJobQueue().rendezvous();
+
+        auto const before = stage.getJson();
+        OpenView view(&*env.closed());
+        auto const result =
+            apply(env.app(), view, *tx, tapForConsensus, env.journal);
+        BEAST_EXPECT(result.first == tesSUCCESS);
+        BEAST_EXPECT(result.second);
+
+        // A bad signature still fails, from the router's cached result
+        auto const failed =
+            apply(env.app(), view, *bad, tapForConsensus, env.journal);
+        BEAST_EXPECT(failed.first == temINVALID);
+        BEAST_EXPECT(!failed.second);
+
+        auto const after = stage.getJson();
+        BEAST_EXPECT(delta(before, after, "apply_skipped") == 1);
+        BEAST_EXPECT(delta(before, after, "apply_unchecked") == 1);
+    }
+
+public:
+    void
+    run() override
+    {
+        testDisabled();
+        testVerify();
+        testRulesChange();
+        testApply();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TxSetPreflight, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -0,0 +1,182 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <algorithm>
+#include <atomic>
+
+#include <peersafe/consensus/hotstuff/impl/CertVerifier.h>
+
+#include <ripple/protocol/digest.h>
+#include <ripple/protocol/SecretKey.h>
+#include <ripple/beast/unit_test.h>
+
+namespace ripple {
+namespace test {
+
+class CertVerifier_test : public beast::unit_test::suite {
+	using CertVerifier = ripple::hotstuff::CertVerifier;
+	using KeyPair = std::pair<ripple::PublicKey, ripple::SecretKey>;
+
+	std::vector<KeyPair> keys_;
+	std::atomic<int> calls_;
+
+	CertVerifier::VerifyOne counting(const ripple::hotstuff::HashValue& message) {
+		return [this, message](
+			const ripple::hotstuff::Author& author,
+			const ripple::hotstuff::Signature& signature) {
+			calls_++;
+			return ripple::verifyDigest(
+				author,
+				message,
+				ripple::Slice(signature.data(), signature.size()),
+				false);
+		};
+	}
+
+	CertVerifier::Signatures sign(
+		const ripple::hotstuff::HashValue& message,
+		std::size_t first,
+		std::size_t count) {
+		CertVerifier::Signatures signatures;
+		for (std::size_t i = first; i < first + count; i++) {
+			signatures.emplace(
+				keys_[i].first,
+				ripple::signDigest(ripple::KeyType::secp256k1, keys_[i].second, message));
+		}
+		return signatures;
+	}
+
+	void testCache() {
+		testcase("cache");
+
+		CertVerifier verifier(16, 0);
+		ripple::hotstuff::HashValue message = sha512Half(std::uint32_t(1));
+		CertVerifier::Signatures signatures = sign(message, 0, 4);
+
+		calls_ = 0;
+		BEAST_EXPECT(verifier.verify(message, signatures, counting(message)));
+		BEAST_EXPECT(calls_ == 4);
+
+		// the same certificate again costs nothing
+		BEAST_EXPECT(verifier.verify(message, signatures, counting(message)));
+		BEAST_EXPECT(calls_ == 4);
+		BEAST_EXPECT(verifier.cacheHits() == 1);
+		BEAST_EXPECT(verifier.savedSignatures() == 4);
+
+		// another signer set of the same message is a different certificate
+		BEAST_EXPECT(verifier.verify(message, sign(message, 1, 4), counting(message)));
+		BEAST_EXPECT(calls_ == 8);
+
+		verifier.clear();
+		BEAST_EXPECT(verifier.verify(message, signatures, counting(message)));
+		BEAST_EXPECT(calls_ == 12);
+	}
+
+	void testBadSignature() {
+		testcase("bad signature");
+
+		CertVerifier verifier(16, 0);
+		ripple::hotstuff::HashValue message = sha512Half(std::uint32_t(2));
+		CertVerifier::Signatures signatures = sign(message, 0, 5);
+		// signed by the right key, but for another message
+		signatures.begin()->second = ripple::signDigest(
+			ripple::KeyType::secp256k1,
+			keys_[0].second,
+			sha512Half(std::uint32_t(3)));
+
+		calls_ = 0;
+		BEAST_EXPECT(verifier.verify(message, signatures, counting(message)) == false);
+		// stopped at the first signature
+		BEAST_EXPECT(calls_ == 1);
+		BEAST_EXPECT(verifier.savedSignatures() == 4);
+
+		// failures are never remembered
+		BEAST_EXPECT(verifier.verify(message, signatures, counting(message)) == false);
+		BEAST_EXPECT(calls_ == 2);
+		BEAST_EXPECT(verifier.cacheHits() == 0);
+	}
+
+	void testParallel() {
+		testcase("parallel");
+
+		CertVerifier verifier(16, 3);
+		for (std::uint32_t i = 0; i < 20; i++) {
+			ripple::hotstuff::HashValue message = sha512Half(i + 100);
+			CertVerifier::Signatures signatures = sign(message, 0, keys_.size());
+
+			calls_ = 0;
+			BEAST_EXPECT(verifier.verify(message, signatures, counting(message)));
+			BEAST_EXPECT(calls_ == static_cast<int>(keys_.size()));
+
+			signatures.rbegin()->second = ripple::Buffer(8);
+			BEAST_EXPECT(verifier.verify(message, signatures, counting(message)) == false);
+		}
+		BEAST_EXPECT(verifier.verifiedSignatures() >= 20 * keys_.size());
+	}
+
+	void testEviction() {
+		testcase("eviction");
+
+		CertVerifier verifier(2, 0);
+		ripple::hotstuff::HashValue m1 = sha512Half(std::uint32_t(11));
+		ripple::hotstuff::HashValue m2 = sha512Half(std::uint32_t(12));
+		ripple::hotstuff::HashValue m3 = sha512Half(std::uint32_t(13));
+		CertVerifier::Signatures s1 = sign(m1, 0, 2);
+		CertVerifier::Signatures s2 = sign(m2, 0, 2);
+		CertVerifier::Signatures s3 = sign(m3, 0, 2);
+
+		BEAST_EXPECT(verifier.verify(m1, s1, counting(m1)));
+		BEAST_EXPECT(verifier.verify(m2, s2, counting(m2)));
+		// m1 is the most recently used now, so m2 goes
+		BEAST_EXPECT(verifier.verify(m1, s1, counting(m1)));
+		BEAST_EXPECT(verifier.verify(m3, s3, counting(m3)));
+
+		calls_ = 0;
+		BEAST_EXPECT(verifier.verify(m1, s1, counting(m1)));
+		BEAST_EXPECT(verifier.verify(m3, s3, counting(m3)));
+		BEAST_EXPECT(calls_ == 0);
+		BEAST_EXPECT(verifier.verify(m2, s2, counting(m2)));
+		BEAST_EXPECT(calls_ == 2);
+	}
+
+public:
+	CertVerifier_test()
+	: keys_()
+	, calls_(0) {
+		for (int i = 0; i < 7; i++) {
+			keys_.emplace_back(ripple::randomKeyPair(ripple::KeyType::secp256k1));
+		}
+		// signatures are kept ordered by author
+		std::sort(keys_.begin(), keys_.end(), [](const KeyPair& a, const KeyPair& b) {
+			return a.first < b.first;
+		});
+	}
+
+	void run() override {
+		testCache();
+		testBadSignature();
+		testParallel();
+		testEviction();
+	}
+};
+
+BEAST_DEFINE_TESTSUITE(CertVerifier, consensus, ripple);
+
+} // namespace test
+} // namespace ripple
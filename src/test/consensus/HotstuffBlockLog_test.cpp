@@ -0,0 +1,332 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <fstream>
+
+#include <peersafe/consensus/hotstuff/impl/BlockLog.h>
+#include <peersafe/consensus/hotstuff/impl/BlockStorage.h>
+
+#include <ripple/protocol/digest.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/utility/temp_dir.h>
+
+namespace ripple {
+namespace test {
+
+class HotstuffBlockLog_test : public beast::unit_test::suite {
+	using BlockLog = ripple::hotstuff::BlockLog;
+
+	// Executes every block without touching any ledger
+	class NullStateCompute : public ripple::hotstuff::StateCompute {
+	public:
+		bool compute(
+			const ripple::hotstuff::Block&,
+			ripple::hotstuff::StateComputeResult&) override {
+			return true;
+		}
+		bool verify(
+			const ripple::hotstuff::Block&,
+			const ripple::hotstuff::StateComputeResult&) override {
+			return true;
+		}
+		int commit(const ripple::hotstuff::ExecutedBlock&) override {
+			return 0;
+		}
+		bool syncState(const ripple::hotstuff::BlockInfo&) override {
+			return true;
+		}
+		bool syncBlock(
+			const ripple::hotstuff::HashValue&,
+			const ripple::hotstuff::Author&,
+			ripple::hotstuff::ExecutedBlock&) override {
+			return false;
+		}
+		void asyncBlock(
+			const ripple::hotstuff::HashValue&,
+			const ripple::hotstuff::Author&,
+			AsyncCompletedHander) override {
+		}
+	};
+
+	static ripple::LedgerInfo ledgerInfo(std::uint32_t seq) {
+		ripple::LedgerInfo info;
+		info.seq = seq;
+		info.hash = sha512Half(seq);
+		return info;
+	}
+
+	static ripple::hotstuff::ExecutedBlock nilBlock(
+		ripple::hotstuff::Round round,
+		const ripple::hotstuff::QuorumCertificate& hqc) {
+		ripple::hotstuff::ExecutedBlock executed_block;
+		executed_block.block = ripple::hotstuff::Block::nil_block(round, hqc);
+		return executed_block;
+	}
+
+	static BlockLog::State genesisState(const ripple::LedgerInfo& info) {
+		BlockLog::State state;
+		state.genesis_block = ripple::hotstuff::Block::new_genesis_block(info, 0);
+		state.highest_quorum_cert = state.genesis_block.block_data().quorum_cert;
+		state.highest_commit_cert = state.genesis_block.block_data().quorum_cert;
+		return state;
+	}
+
+	static ripple::hotstuff::TimeoutCertificate timeoutCert(
+		ripple::hotstuff::Round round) {
+		ripple::hotstuff::Timeout timeout;
+		timeout.epoch = 0;
+		timeout.round = round;
+		return ripple::hotstuff::TimeoutCertificate(timeout);
+	}
+
+	void testAppendAndLoad() {
+		testcase("append and load");
+
+		beast::temp_dir dir;
+		BlockLog::State state = genesisState(ledgerInfo(5));
+		ripple::hotstuff::QuorumCertificate qc = state.highest_quorum_cert;
+		{
+			BlockLog log(journal_, dir.path(), 256);
+			log.reset(state);
+			for (ripple::hotstuff::Round round = 1; round <= 4; round++) {
+				log.appendBlock(nilBlock(round, qc));
+			}
+			qc.certified_block().round = 3;
+			log.appendQuorumCert(qc);
+			log.appendTimeoutCert(timeoutCert(4));
+			log.appendCommitted(1);
+			BEAST_EXPECT(log.appendedRecords() == 7);
+		}
+
+		BlockLog log(journal_, dir.path(), 256);
+		BlockLog::State loaded;
+		BEAST_EXPECT(log.load(loaded));
+		BEAST_EXPECT(loaded.genesis_block.id() == state.genesis_block.id());
+		BEAST_EXPECT(loaded.blocks.size() == 4);
+		BEAST_EXPECT(loaded.blocks.count(nilBlock(2, state.highest_quorum_cert).block.id()) == 1);
+		BEAST_EXPECT(loaded.highest_quorum_cert.certified_block().round == 3);
+		BEAST_EXPECT(loaded.highest_timeout_cert);
+		BEAST_EXPECT(loaded.highest_timeout_cert->timeout().round == 4);
+		BEAST_EXPECT(loaded.committed_round == 1);
+		BEAST_EXPECT(log.appendedRecords() == 7);
+
+		// an older certificate doesn't replace a newer one on replay
+		qc.certified_block().round = 2;
+		log.appendQuorumCert(qc);
+		BlockLog::State reloaded;
+		BEAST_EXPECT(BlockLog(journal_, dir.path(), 256).load(reloaded));
+		BEAST_EXPECT(reloaded.highest_quorum_cert.certified_block().round == 3);
+	}
+
+	void testTornTail() {
+		testcase("torn tail");
+
+		beast::temp_dir dir;
+		BlockLog::State state = genesisState(ledgerInfo(5));
+		std::uintmax_t valid_size = 0;
+		{
+			BlockLog log(journal_, dir.path(), 256);
+			log.reset(state);
+			log.appendBlock(nilBlock(1, state.highest_quorum_cert));
+			log.appendBlock(nilBlock(2, state.highest_quorum_cert));
+			valid_size = boost::filesystem::file_size(log.logPath());
+		}
+
+		// a crash in the middle of writing the next record
+		{
+			std::ofstream os(
+				(boost::filesystem::path(dir.path()) / "block.log").string(),
+				std::ios::binary | std::ios::app);
+			const char partial[] = { 2, 100, 0, 0, 0, 1, 2 };
+			os.write(partial, sizeof(partial));
+		}
+
+		{
+			BlockLog log(journal_, dir.path(), 256);
+			BlockLog::State loaded;
+			BEAST_EXPECT(log.load(loaded));
+			BEAST_EXPECT(loaded.blocks.size() == 2);
+			BEAST_EXPECT(boost::filesystem::file_size(log.logPath()) == valid_size);
+
+			// appending continues right after the last good record
+			log.appendBlock(nilBlock(3, state.highest_quorum_cert));
+		}
+
+		// a flipped byte fails the checksum of that record and
+		// everything after it
+		{
+			std::fstream fs(
+				(boost::filesystem::path(dir.path()) / "block.log").string(),
+				std::ios::binary | std::ios::in | std::ios::out);
+			fs.seekp(valid_size - 1);
+			fs.put('#');
+		}
+
+		BlockLog log(journal_, dir.path(), 256);
+		BlockLog::State loaded;
+		BEAST_EXPECT(log.load(loaded));
+		BEAST_EXPECT(loaded.blocks.size() == 1);
+	}
+
+	void testSnapshot() {
+		testcase("snapshot");
+
+		beast::temp_dir dir;
+		BlockLog::State state = genesisState(ledgerInfo(5));
+		BlockLog log(journal_, dir.path(), 4);
+		log.reset(state);
+		BEAST_EXPECT(boost::filesystem::file_size(log.logPath()) == 0);
+
+		for (ripple::hotstuff::Round round = 1; round <= 4; round++) {
+			ripple::hotstuff::ExecutedBlock executed_block =
+				nilBlock(round, state.highest_quorum_cert);
+			state.blocks.emplace(executed_block.block.id(), executed_block);
+			log.appendBlock(executed_block);
+		}
+		BEAST_EXPECT(log.shouldSnapshot());
+
+		state.highest_timeout_cert = timeoutCert(4);
+		log.reset(state);
+		BEAST_EXPECT(log.shouldSnapshot() == false);
+		BEAST_EXPECT(boost::filesystem::file_size(log.logPath()) == 0);
+
+		log.appendBlock(nilBlock(5, state.highest_quorum_cert));
+
+		BlockLog::State loaded;
+		BEAST_EXPECT(BlockLog(journal_, dir.path(), 4).load(loaded));
+		BEAST_EXPECT(loaded.blocks.size() == 5);
+		BEAST_EXPECT(loaded.highest_timeout_cert);
+
+		// A snapshot cut short is ignored as a whole
+		boost::filesystem::resize_file(
+			log.snapshotPath(),
+			boost::filesystem::file_size(log.snapshotPath()) - 1);
+		BEAST_EXPECT(BlockLog(journal_, dir.path(), 4).load(loaded) == false);
+	}
+
+	void testPrune() {
+		testcase("prune");
+
+		beast::temp_dir dir;
+		BlockLog::State state = genesisState(ledgerInfo(5));
+		{
+			BlockLog log(journal_, dir.path(), 256);
+			log.reset(state);
+			for (ripple::hotstuff::Round round = 1; round <= 80; round++) {
+				log.appendBlock(nilBlock(round, state.highest_quorum_cert));
+			}
+			log.appendPrune(0, 80);
+		}
+
+		BlockLog::State loaded;
+		BEAST_EXPECT(BlockLog(journal_, dir.path(), 256).load(loaded));
+		// rounds [20, 70) were collected
+		BEAST_EXPECT(loaded.blocks.size() == 30);
+		for (auto it = loaded.blocks.begin(); it != loaded.blocks.end(); it++) {
+			ripple::hotstuff::Round round = it->second.block.block_data().round;
+			BEAST_EXPECT(round < 20 || round >= 70);
+		}
+	}
+
+	void testStorageRecover() {
+		testcase("storage recover");
+
+		beast::temp_dir dir;
+		NullStateCompute state_compute;
+		ripple::LedgerInfo info = ledgerInfo(5);
+		ripple::hotstuff::Block genesis =
+			ripple::hotstuff::Block::new_genesis_block(info, 0);
+		ripple::hotstuff::HashValue block_id;
+		{
+			ripple::hotstuff::BlockStorage storage(journal_, &state_compute);
+			storage.blockLog(std::make_unique<BlockLog>(journal_, dir.path(), 256));
+			storage.updateCeritificates(genesis);
+
+			ripple::hotstuff::ExecutedBlock executed_block =
+				nilBlock(1, storage.HighestQuorumCert());
+			block_id = executed_block.block.id();
+			storage.addExecutedBlock(executed_block);
+			storage.insertTimeoutCert(timeoutCert(1));
+
+			ripple::hotstuff::SafetyData safety_data;
+			safety_data.last_voted_round = 1;
+			safety_data.preferred_round = 1;
+			BEAST_EXPECT(storage.saveSafetyData(safety_data));
+		}
+
+		{
+			ripple::hotstuff::BlockStorage storage(journal_, &state_compute);
+			storage.blockLog(std::make_unique<BlockLog>(journal_, dir.path(), 256));
+			BEAST_EXPECT(storage.recover(info, 0));
+			BEAST_EXPECT(storage.existsBlock(genesis.id()));
+			BEAST_EXPECT(storage.existsBlock(block_id));
+			BEAST_EXPECT(storage.HighestTimeoutCert());
+			BEAST_EXPECT(storage.HighestTimeoutCert()->timeout().round == 1);
+			BEAST_EXPECT(storage.safetyData());
+			BEAST_EXPECT(storage.safetyData()->last_voted_round == 1);
+		}
+
+		// Another ledger or epoch to restart from makes the log useless
+		ripple::hotstuff::BlockStorage storage(journal_, &state_compute);
+		storage.blockLog(std::make_unique<BlockLog>(journal_, dir.path(), 256));
+		BEAST_EXPECT(storage.recover(ledgerInfo(6), 0) == false);
+		BEAST_EXPECT(storage.recover(info, 1) == false);
+		BEAST_EXPECT(storage.existsBlock(block_id) == false);
+		BEAST_EXPECT(storage.safetyData() == boost::none);
+
+		// Without a block log there is nothing to recover
+		ripple::hotstuff::BlockStorage memory_storage(journal_, &state_compute);
+		BEAST_EXPECT(memory_storage.recover(info, 0) == false);
+		ripple::hotstuff::SafetyData safety_data;
+		safety_data.last_voted_round = 2;
+		BEAST_EXPECT(memory_storage.saveSafetyData(safety_data));
+
+		// A block log that can't be written refuses the safety data
+		boost::filesystem::path not_dir = dir.file("not_a_directory");
+		{
+			std::ofstream os(not_dir.string());
+			os << "x";
+		}
+		ripple::hotstuff::BlockStorage broken_storage(journal_, &state_compute);
+		broken_storage.blockLog(std::make_unique<BlockLog>(journal_, not_dir, 256));
+		broken_storage.updateCeritificates(genesis);
+		BEAST_EXPECT(broken_storage.saveSafetyData(safety_data) == false);
+	}
+
+public:
+	HotstuffBlockLog_test()
+	: journal_(beast::Journal::getNullSink()) {
+	}
+
+	void run() override {
+		testAppendAndLoad();
+		testTornTail();
+		testSnapshot();
+		testPrune();
+		testStorageRecover();
+	}
+
+private:
+	beast::Journal journal_;
+};
+
+BEAST_DEFINE_TESTSUITE(HotstuffBlockLog, consensus, ripple);
+
+} // namespace test
+} // namespace ripple
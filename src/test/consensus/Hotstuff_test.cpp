@@ -17,6 +17,9 @@
 */
 //==============================================================================
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <vector>
 #include <set>
 #include <map>
@@ -30,6 +33,7 @@
 #include <algorithm>
 
 #include <boost/format.hpp>
+#include <boost/filesystem.hpp>
 
 #include <peersafe/consensus/hotstuff/Hotstuff.h>
 
@@ -44,6 +48,7 @@
 #include <ripple/beast/unit_test.h>
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/basics/Log.h>
+#include <ripple/beast/utility/temp_dir.h>
 
 #include <test/app/SuitLogs.h>
 #include <test/jtx/Env.h>
@@ -175,7 +180,9 @@ public:
 	, can_extract_(true)
 	, epoch_change_hash_()
 	, committing_epoch_change_(false)
-	, changed_epoch_successed_() {
+	, changed_epoch_successed_()
+	, journal_(journal)
+	, down_(false) {
 
 		ordered_committed_blocks_.reserve(20);
 		ordered_committed_blocks_.resize(20);
@@ -186,14 +193,7 @@ public:
 		hash_append(h, epoch_change);
 		epoch_change_hash_ = static_cast<typename sha512_half_hasher::result_type>(h);
 
-		hotstuff_ = ripple::hotstuff::Hotstuff::Builder(io_service_, journal)
-			.setConfig(config_.config)
-			.setCommandManager(this)
-			.setNetWork(this)
-			.setProposerElection(this)
-			.setStateCompute(this)
-			//.setValidatorVerifier(this)
-			.build();
+		hotstuff_ = buildHotstuff();
 
 		//Replica::replicas[Replica::index++] = this;
 		Replica::replicas[config.round] = this;
@@ -290,6 +290,8 @@ public:
 		std::thread sync_block_worker = std::thread([this, &block_id, &execute_block_promise]() {
 			ripple::hotstuff::ExecutedBlock executed_block;
 			for (auto it = Replica::replicas.begin(); it != Replica::replicas.end(); it++) {
+				if (it->second->down())
+					continue;
 				if (it->second->hotstuff()->unsafetyExpectBlock(block_id, executed_block)) {
 					execute_block_promise.set_value(executed_block);
 					break;
@@ -479,13 +481,10 @@ public:
 		const ripple::hotstuff::Block& proposal,
 		const ripple::hotstuff::SyncInfo& sync_info) {
 
-		env_->app().getJobQueue().addJob(
-			jtPROPOSAL_t,
-			"broadcast_proposal",
-			[this, proposal, sync_info](Job&) {
-				if (hotstuff_->CheckProposal(proposal, sync_info))
-					hotstuff_->handleProposal(proposal);
-			});
+		addJob("broadcast_proposal", [this, proposal, sync_info]() {
+			if (hotstuff_->CheckProposal(proposal, sync_info))
+				hotstuff_->handleProposal(proposal);
+		});
 	}
 
 	void broadcast(
@@ -547,12 +546,9 @@ public:
 		const ripple::hotstuff::Vote& vote,
 		const ripple::hotstuff::SyncInfo& sync_info) {
 
-		env_->app().getJobQueue().addJob(
-			jtPROPOSAL_t,
-			"send_vote",
-			[this, vote, sync_info](Job&) {
-				hotstuff_->handleVote(vote, sync_info);
-			});
+		addJob("send_vote", [this, vote, sync_info]() {
+			hotstuff_->handleVote(vote, sync_info);
+		});
 	}
 
 	std::shared_ptr<ripple::hotstuff::Hotstuff>& hotstuff() {
@@ -584,6 +580,33 @@ public:
 		hotstuff_->stop();
 	}
 
+	// Simulate a crash, all in-memory state of hotstuff is gone
+	void crash() {
+		{
+			std::lock_guard<std::mutex> lock(jobs_mutex_);
+			down_ = true;
+		}
+		stop();
+		std::unique_lock<std::mutex> lock(jobs_mutex_);
+		jobs_done_.wait(lock, [this]() { return jobs_ == 0; });
+	}
+
+	// Restart after a crash with a new hotstuff instance
+	void restart(ripple::hotstuff::RecoverData& recover_data) {
+		io_service_.reset();
+		hotstuff_ = buildHotstuff();
+		down_ = false;
+		run(recover_data);
+	}
+
+	bool down() const {
+		return down_;
+	}
+
+	ripple::hotstuff::Round highestQuorumRound() const {
+		return hotstuff_->storage_.HighestQuorumCert().certified_block().round;
+	}
+
 	const ripple::hotstuff::Author& author() const {
 		return config_.config.id;
 	}
@@ -626,6 +649,50 @@ private:
 	ripple::hotstuff::HashValue epoch_change_hash_;
 	bool committing_epoch_change_;
 	std::promise<bool> changed_epoch_successed_;
+	beast::Journal journal_;
+	std::atomic<bool> down_;
+	// Jobs of this replica queued or running, so crash() can wait for them
+	std::mutex jobs_mutex_;
+	std::condition_variable jobs_done_;
+	std::size_t jobs_ = 0;
+
+	// Runs `f` in a job unless the replica is down
+	template <class F>
+	void addJob(char const* name, F&& f) {
+		{
+			std::lock_guard<std::mutex> lock(jobs_mutex_);
+			if (down_)
+				return;
+			++jobs_;
+		}
+
+		auto done = [this]() {
+			std::lock_guard<std::mutex> lock(jobs_mutex_);
+			if (--jobs_ == 0)
+				jobs_done_.notify_all();
+		};
+		bool const added = env_->app().getJobQueue().addJob(
+			jtPROPOSAL_t,
+			name,
+			[this, f = std::forward<F>(f), done](Job&) {
+				if (!down())
+					f();
+				done();
+			});
+		if (!added)
+			done();
+	}
+
+	ripple::hotstuff::Hotstuff::pointer buildHotstuff() {
+		return ripple::hotstuff::Hotstuff::Builder(io_service_, journal_)
+			.setConfig(config_.config)
+			.setCommandManager(this)
+			.setNetWork(this)
+			.setProposerElection(this)
+			.setStateCompute(this)
+			//.setValidatorVerifier(this)
+			.build();
+	}
 
 	//static int index;
 };
@@ -716,6 +783,10 @@ public:
 		config.timeout = timeout_;
 		config.disable_nil_block = disable_nil_block_;
 		config.id = (boost::format("%1%") % round).str();
+		if (block_log_dir_.empty() == false) {
+			config.block_log_path =
+				(boost::filesystem::path(block_log_dir_) / std::to_string(round)).string();
+		}
 
 		Replica::Config replicaConfig;
 		replicaConfig.round = round;
@@ -758,14 +829,16 @@ public:
 		return replicas_vec;
 	}
 
-	void runReplica(const ripple::hotstuff::Round& round) {
+	ripple::hotstuff::RecoverData recoverData() {
 		ripple::hotstuff::EpochState init_epoch_state;
 		init_epoch_state.epoch = Replica::epoch;
 		init_epoch_state.verifier = nullptr;
 
-		ripple::hotstuff::RecoverData recover_data =
-			ripple::hotstuff::RecoverData{ Replica::genesis_ledger_info, init_epoch_state };
+		return ripple::hotstuff::RecoverData{ Replica::genesis_ledger_info, init_epoch_state };
+	}
 
+	void runReplica(const ripple::hotstuff::Round& round) {
+		ripple::hotstuff::RecoverData recover_data = recoverData();
 		Replica::replicas[round]->run(recover_data);
 	}
 
@@ -1141,6 +1214,36 @@ public:
 		std::cout << "passed on testCanExtractTxs" << std::endl;
 	}
 
+	// A replica crashes and restarts from its block log. It has to come back
+	// at the round it reached rather than at the genesis block, and then
+	// keep committing the same blocks as the others.
+	void testRestartFromBlockLog() {
+		std::cout << "begin testRestartFromBlockLog" << std::endl;
+		beast::temp_dir dir;
+		block_log_dir_ = dir.path();
+
+		newReplicas("testRestartFromBlockLog", replicas_);
+		runReplicas();
+		BEAST_EXPECT(waitUntilCommittedBlocks(blocks_) == true);
+
+		Replica* replica = Replica::replicas[2];
+		replica->crash();
+		ripple::hotstuff::Round crashed_round = replica->highestQuorumRound();
+		BEAST_EXPECT(crashed_round > 0);
+
+		ripple::hotstuff::RecoverData recover_data = recoverData();
+		replica->restart(recover_data);
+		BEAST_EXPECT(replica->highestQuorumRound() >= crashed_round);
+
+		BEAST_EXPECT(waitUntilCommittedBlocks(2*blocks_) == true);
+		stopReplicas(replicas_);
+		BEAST_EXPECT(hasConsensusedOrderedCommittedBlocks(2*blocks_) == true);
+		releaseReplicas(replicas_);
+
+		block_log_dir_.clear();
+		std::cout << "passed on testRestartFromBlockLog" << std::endl;
+	}
+
     void run() override {
 		parse_args();
 
@@ -1153,6 +1256,7 @@ public:
 		testAddReplicas();
 		testRemoveReplicas();
 		testDisableNilBlock();
+		testRestartFromBlockLog();
     }
 
 	Hotstuff_test()
@@ -1161,7 +1265,8 @@ public:
 	, blocks_(4)
 	, timeout_(60)
 	, disable_log_(false)
-	, disable_nil_block_(false) {
+	, disable_nil_block_(false)
+	, block_log_dir_() {
 
 		std::string genesis_info = "This is a test for hotstuff";
 		using beast::hash_append;
@@ -1177,6 +1282,7 @@ private:
 	int timeout_;
 	bool disable_log_;
 	bool disable_nil_block_;
+	std::string block_log_dir_;
 };
 
 BEAST_DEFINE_TESTSUITE(Hotstuff, consensus, ripple);
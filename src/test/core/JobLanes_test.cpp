@@ -0,0 +1,216 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/unit_test.h>
+#include <ripple/core/JobTypes.h>
+#include <ripple/core/impl/JobLanes.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+
+class JobLanes_test : public beast::unit_test::suite
+{
+    std::uint64_t index_ = 0;
+
+    Job
+    makeJob(JobType type)
+    {
+        return Job(type, ++index_);
+    }
+
+    void
+    testPriority()
+    {
+        testcase("priority");
+        JobLanes lanes(4);
+        lanes.setAdaptive(false);
+
+        BEAST_EXPECT(lanes.push(makeJob(jtCLIENT)));
+        BEAST_EXPECT(lanes.push(makeJob(jtTRANSACTION)));
+        BEAST_EXPECT(lanes.push(makeJob(jtACCEPT)));
+        BEAST_EXPECT(lanes.size() == 3);
+        BEAST_EXPECT(lanes.waiting(jtTRANSACTION) == 1);
+
+        BEAST_EXPECT(lanes.pop(0).getType() == jtACCEPT);
+        BEAST_EXPECT(lanes.running(jtACCEPT) == 1);
+        BEAST_EXPECT(lanes.pop(1).getType() == jtTRANSACTION);
+        BEAST_EXPECT(lanes.pop(2).getType() == jtCLIENT);
+        BEAST_EXPECT(lanes.size() == 0);
+
+        using namespace std::chrono_literals;
+        BEAST_EXPECT(lanes.finish(jtACCEPT, 0us) == 0);
+        BEAST_EXPECT(lanes.finish(jtTRANSACTION, 0us) == 0);
+        BEAST_EXPECT(lanes.finish(jtCLIENT, 0us) == 0);
+        BEAST_EXPECT(lanes.running(jtACCEPT) == 0);
+    }
+
+    void
+    testLimit()
+    {
+        testcase("limit");
+        using namespace std::chrono_literals;
+        JobLanes lanes(4);
+        lanes.setAdaptive(false);
+
+        // One tableSync job at a time, in the order queued
+        LoadMonitor lm{beast::Journal{beast::Journal::getNullSink()}};
+        std::vector<int> order;
+        for (int i = 0; i < 3; ++i)
+        {
+            bool const signaled = lanes.push(Job(
+                jtTABLESYNC,
+                "sync",
+                ++index_,
+                lm,
+                [&order, i](Job&) { order.push_back(i); },
+                nullptr));
+            BEAST_EXPECT(signaled == (i == 0));
+        }
+        BEAST_EXPECT(lanes.waiting(jtTABLESYNC) == 3);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            auto job = lanes.pop(i);
+            job.doJob();
+            BEAST_EXPECT(lanes.running(jtTABLESYNC) == 1);
+            BEAST_EXPECT(lanes.finish(jtTABLESYNC, 0us) == (i < 2 ? 1 : 0));
+        }
+        BEAST_EXPECT((order == std::vector<int>{0, 1, 2}));
+    }
+
+    void
+    testStealing()
+    {
+        testcase("stealing");
+        using namespace std::chrono_literals;
+        JobLanes lanes(4);
+        lanes.setAdaptive(false);
+
+        // Jobs queued outside the workers are spread over the shards; a
+        // worker takes the ones in other shards too
+        int signaled = 0;
+        std::thread producer([&] {
+            for (int i = 0; i < 16; ++i)
+                signaled += lanes.push(makeJob(jtTX_PREFLIGHT));
+        });
+        producer.join();
+        BEAST_EXPECT(signaled == 16);
+        for (int i = 0; i < 16; ++i)
+            BEAST_EXPECT(lanes.pop(0).getType() == jtTX_PREFLIGHT);
+        BEAST_EXPECT(lanes.size() == 0);
+        BEAST_EXPECT(lanes.running(jtTX_PREFLIGHT) == 16);
+    }
+
+    void
+    testOrder()
+    {
+        testcase("order");
+        using namespace std::chrono_literals;
+        JobLanes lanes(4);
+        lanes.setAdaptive(false);
+
+        // Transactions and ledger data start in the order queued, whichever
+        // worker queued them and whichever takes them
+        LoadMonitor lm{beast::Journal{beast::Journal::getNullSink()}};
+        for (auto const type : {jtTRANSACTION, jtLEDGER_DATA})
+        {
+            std::vector<int> order;
+            auto push = [&](int i) {
+                lanes.push(Job(
+                    type,
+                    "ordered",
+                    ++index_,
+                    lm,
+                    [&order, i](Job&) { order.push_back(i); },
+                    nullptr));
+            };
+            std::thread producer([&] {
+                for (int i = 0; i < 4; ++i)
+                    push(i);
+            });
+            producer.join();
+            auto run = [&](int instance) {
+                lanes.pop(instance).doJob();
+                lanes.finish(type, 0us);
+            };
+            // Queued from worker 2, which pop() marks this thread as
+            run(2);
+            for (int i = 4; i < 8; ++i)
+                push(i);
+            for (int i = 1; i < 8; ++i)
+                run(i % 4);
+            BEAST_EXPECT((order == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}));
+        }
+    }
+
+    void
+    testAdaptive()
+    {
+        testcase("adaptive limits");
+        using namespace std::chrono_literals;
+        JobLanes lanes(4);
+        lanes.setThreadCount(4);
+
+        for (int i = 0; i < 4; ++i)
+            lanes.push(makeJob(jtTRANSACTION));
+        for (int i = 0; i < 4; ++i)
+            lanes.pop(i);
+
+        // An acceptLedger job waits past its target with no thread free
+        BEAST_EXPECT(lanes.push(makeJob(jtACCEPT)));
+        std::this_thread::sleep_for(
+            JobTypes::instance().get(jtACCEPT).getQueueTarget() + 50ms);
+        lanes.finish(jtTRANSACTION, 0us);
+        BEAST_EXPECT(lanes.limit(jtTRANSACTION) == 2);
+        BEAST_EXPECT(lanes.limit(jtACCEPT) > 2);
+
+        // New transactions are held back while three still run
+        BEAST_EXPECT(!lanes.push(makeJob(jtTRANSACTION)));
+        BEAST_EXPECT(lanes.pop(0).getType() == jtACCEPT);
+        BEAST_EXPECT(lanes.finish(jtACCEPT, 0us) == 0);
+
+        // The limit grows back once the target is met
+        std::this_thread::sleep_for(JobLanes::adaptInterval + 10ms);
+        BEAST_EXPECT(lanes.finish(jtTRANSACTION, 0us) == 1);
+        BEAST_EXPECT(lanes.limit(jtTRANSACTION) == 3);
+        std::this_thread::sleep_for(JobLanes::adaptInterval + 10ms);
+        lanes.finish(jtTRANSACTION, 0us);
+        BEAST_EXPECT(
+            lanes.limit(jtTRANSACTION) ==
+            JobTypes::instance().get(jtTRANSACTION).limit());
+    }
+
+public:
+    void
+    run() override
+    {
+        testPriority();
+        testLimit();
+        testStealing();
+        testOrder();
+        testAdaptive();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(JobLanes, core, ripple);
+
+}  // namespace ripple
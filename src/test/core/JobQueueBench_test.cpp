@@ -0,0 +1,310 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/unit_test.h>
+#include <ripple/core/JobTypes.h>
+#include <ripple/core/impl/JobLanes.h>
+#include <ripple/core/impl/Workers.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+
+/*
+Compares the job scheduling of the JobQueue before and after per type lanes:
+a flood of transaction jobs from several producers, with an acceptLedger
+job queued every millisecond, on the same Workers pool.
+
+Reported: job throughput, and the time jobs spent queued.
+*/
+class JobQueueBench_test : public beast::unit_test::suite
+{
+    using clock_type = Job::clock_type;
+
+    struct Scheduler : Workers::Callback
+    {
+        virtual void
+        add(Job&& job) = 0;
+    };
+
+    // The scheduling of the JobQueue before lanes: one set of all jobs in
+    // priority order behind one mutex.
+    class LegacyScheduler : public Scheduler
+    {
+        struct Counts
+        {
+            int waiting = 0;
+            int running = 0;
+            int deferred = 0;
+        };
+
+        std::mutex mutex_;
+        std::set<Job> jobs_;
+        std::map<JobType, Counts> counts_;
+        Workers workers_;
+
+        static int
+        limit(JobType type)
+        {
+            return JobTypes::instance().get(type).limit();
+        }
+
+    public:
+        explicit LegacyScheduler(int threads)
+            : workers_(*this, nullptr, "Legacy", threads)
+        {
+        }
+
+        void
+        add(Job&& job) override
+        {
+            std::lock_guard lock(mutex_);
+            auto& counts = counts_[job.getType()];
+            if (counts.waiting + counts.running < limit(job.getType()))
+                workers_.addTask();
+            else
+                ++counts.deferred;
+            ++counts.waiting;
+            jobs_.insert(std::move(job));
+        }
+
+        void
+        processTask(int) override
+        {
+            Job job;
+            {
+                std::lock_guard lock(mutex_);
+                auto iter = jobs_.begin();
+                while (counts_[iter->getType()].running >=
+                       limit(iter->getType()))
+                    ++iter;
+                job = *iter;
+                jobs_.erase(iter);
+                auto& counts = counts_[job.getType()];
+                --counts.waiting;
+                ++counts.running;
+            }
+            auto const type = job.getType();
+            job.doJob();
+            {
+                std::lock_guard lock(mutex_);
+                auto& counts = counts_[type];
+                if (counts.deferred > 0)
+                {
+                    --counts.deferred;
+                    workers_.addTask();
+                }
+                --counts.running;
+            }
+        }
+    };
+
+    class LaneScheduler : public Scheduler
+    {
+        JobLanes lanes_;
+        Workers workers_;
+
+    public:
+        LaneScheduler(int threads, bool adaptive)
+            : workers_(*this, nullptr, "Lanes", threads)
+        {
+            lanes_.setThreadCount(threads);
+            lanes_.setAdaptive(adaptive);
+        }
+
+        void
+        add(Job&& job) override
+        {
+            if (lanes_.push(std::move(job)))
+                workers_.addTask();
+        }
+
+        void
+        processTask(int instance) override
+        {
+            auto const start = clock_type::now();
+            Job job = lanes_.pop(instance);
+            auto const type = job.getType();
+            auto const queued =
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    start - job.queue_time());
+            job.doJob();
+            for (auto n = lanes_.finish(type, queued); n > 0; --n)
+                workers_.addTask();
+        }
+    };
+
+    struct Params
+    {
+        int threads;
+        int producers;
+        int jobsPerProducer;
+        std::chrono::microseconds work;
+    };
+
+    // Recorded without locking, so as not to serialize the workers
+    struct Latencies
+    {
+        std::vector<std::chrono::microseconds> samples;
+        std::atomic<std::size_t> count{0};
+
+        explicit Latencies(std::size_t capacity) : samples(capacity)
+        {
+        }
+
+        void
+        add(std::chrono::microseconds d)
+        {
+            auto const i = count++;
+            if (i < samples.size())
+                samples[i] = d;
+        }
+
+        std::chrono::microseconds
+        percentile(double p)
+        {
+            auto const n = std::min(count.load(), samples.size());
+            if (n == 0)
+                return {};
+            std::sort(samples.begin(), samples.begin() + n);
+            return samples[static_cast<std::size_t>(p * (n - 1))];
+        }
+    };
+
+    static void
+    spin(std::chrono::microseconds d)
+    {
+        auto const until = clock_type::now() + d;
+        while (clock_type::now() < until)
+            ;
+    }
+
+    void
+    measure(char const* name, Scheduler& scheduler, Params const& params)
+    {
+        using namespace std::chrono;
+        LoadMonitor txLoad{beast::Journal{beast::Journal::getNullSink()}};
+        LoadMonitor acceptLoad{beast::Journal{beast::Journal::getNullSink()}};
+        Latencies txWait(params.producers * params.jobsPerProducer);
+        Latencies acceptWait(1 << 20);
+        std::atomic<std::uint64_t> index{0};
+        std::atomic<int> done{0};
+        std::atomic<bool> producing{true};
+
+        auto job = [&](JobType type, LoadMonitor& load, Latencies& latencies) {
+            scheduler.add(Job(
+                type,
+                "bench",
+                ++index,
+                load,
+                [&, work = params.work](Job& j) {
+                    latencies.add(duration_cast<microseconds>(
+                        clock_type::now() - j.queue_time()));
+                    spin(work);
+                    ++done;
+                },
+                nullptr));
+        };
+
+        auto const start = clock_type::now();
+        std::vector<std::thread> producers;
+        for (int p = 0; p < params.producers; ++p)
+        {
+            producers.emplace_back([&] {
+                for (int i = 0; i < params.jobsPerProducer; ++i)
+                    job(jtTRANSACTION, txLoad, txWait);
+            });
+        }
+        int accepts = 0;
+        std::thread ticker([&] {
+            while (producing)
+            {
+                job(jtACCEPT, acceptLoad, acceptWait);
+                ++accepts;
+                std::this_thread::sleep_for(1ms);
+            }
+        });
+        for (auto& t : producers)
+            t.join();
+
+        auto const total = params.producers * params.jobsPerProducer;
+        while (done < total)
+            std::this_thread::sleep_for(1ms);
+        producing = false;
+        ticker.join();
+        while (done < total + accepts)
+            std::this_thread::sleep_for(1ms);
+        auto const elapsed = duration_cast<milliseconds>(clock_type::now() - start);
+
+        log << "    " << name << ": " << total << " jobs in " << elapsed.count()
+            << " ms, " << (elapsed.count() ? total * 1000 / elapsed.count() : 0)
+            << " jobs/s" << std::endl;
+        log << "      transaction wait us p50 "
+            << txWait.percentile(0.5).count() << " p99 "
+            << txWait.percentile(0.99).count() << " max "
+            << txWait.percentile(1).count() << std::endl;
+        log << "      acceptLedger wait us p50 "
+            << acceptWait.percentile(0.5).count() << " p99 "
+            << acceptWait.percentile(0.99).count() << " max "
+            << acceptWait.percentile(1).count() << std::endl;
+    }
+
+    void
+    compare(char const* title, Params const& params)
+    {
+        testcase(title);
+        {
+            LegacyScheduler legacy(params.threads);
+            measure("single set", legacy, params);
+        }
+        {
+            LaneScheduler lanes(params.threads, false);
+            measure("lanes", lanes, params);
+        }
+        {
+            LaneScheduler lanes(params.threads, true);
+            measure("lanes, adaptive", lanes, params);
+        }
+        pass();
+    }
+
+public:
+    void
+    run() override
+    {
+        using namespace std::chrono_literals;
+        int const threads = std::max(
+            2, std::min(8, static_cast<int>(std::thread::hardware_concurrency())));
+
+        compare("tiny jobs", {threads, 4, 100000, 0us});
+        compare("short jobs", {threads, 4, 20000, 20us});
+        compare("flood", {threads, 8, 2000, 500us});
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(JobQueueBench, core, ripple);
+
+}  // namespace ripple
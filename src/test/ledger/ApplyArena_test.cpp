@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/ledger/ApplyArena.h>
+#include <ripple/ledger/ApplyViewImpl.h>
+#include <ripple/ledger/Sandbox.h>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+class ApplyArena_test : public beast::unit_test::suite
+{
+    static std::shared_ptr<SLE>
+    sle(std::uint64_t id)
+    {
+        auto const le =
+            std::make_shared<SLE>(Keylet{ltACCOUNT_ROOT, uint256(id)});
+        le->setFieldU32(sfSequence, 1);
+        return le;
+    }
+
+    void
+    testScope()
+    {
+        testcase("scope");
+
+        auto const& thread = ApplyArena::current();
+        BEAST_EXPECT(&ApplyArena::current() == &thread);
+        {
+            ApplyArena::Scope ledger;
+            auto const& arena = ApplyArena::current();
+            BEAST_EXPECT(&arena != &thread);
+            {
+                ApplyArena::Scope nested;
+                BEAST_EXPECT(&ApplyArena::current() != &arena);
+            }
+            BEAST_EXPECT(&ApplyArena::current() == &arena);
+        }
+        BEAST_EXPECT(&ApplyArena::current() == &thread);
+    }
+
+    void
+    testTables()
+    {
+        testcase("state tables");
+
+        using namespace jtx;
+        Env env(*this);
+        auto const before = ApplyArena::getJson();
+        {
+            ApplyArena::Scope scope;
+            auto const& arena = ApplyArena::current().arena();
+
+            ApplyViewImpl view(&*env.current(), tapNONE);
+            for (std::uint64_t id = 1; id <= 100; ++id)
+            {
+                Sandbox sb(&view);
+                sb.insert(sle(id));
+                sb.apply(view);
+            }
+            BEAST_EXPECT(view.size() == 100);
+
+            // A node in the sandbox and one in the view, per item
+            BEAST_EXPECT(arena.allocations() >= 200);
+            // One allocation from the heap for all of them
+            BEAST_EXPECT(arena.blocks() == 1);
+        }
+        auto const after = ApplyArena::getJson();
+        BEAST_EXPECT(
+            after["ledgers"].asUInt() >= before["ledgers"].asUInt() + 1);
+        BEAST_EXPECT(
+            after["allocations"].asUInt() >=
+            before["allocations"].asUInt() + 200);
+    }
+
+public:
+    void
+    run() override
+    {
+        testScope();
+        testTables();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ApplyArena, ledger, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -0,0 +1,124 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/OpenLedger.h>
+#include <test/jtx.h>
+#include <atomic>
+#include <thread>
+
+namespace ripple {
+namespace test {
+
+class OpenLedger_test : public beast::unit_test::suite
+{
+    static std::uint64_t
+    count(Json::Value const& jv, char const* name)
+    {
+        return std::stoull(jv[name].asString());
+    }
+
+    void
+    testSnapshots()
+    {
+        testcase("snapshots");
+        using namespace jtx;
+        Env env(*this);
+        auto& open = env.app().openLedger();
+
+        auto const before = open.getJson();
+        auto held = open.current();
+        BEAST_EXPECT(open.modify([](OpenView&, beast::Journal) {
+            return true;
+        }));
+        // The reader keeps its snapshot, new readers get the next one
+        BEAST_EXPECT(open.current() != held);
+        BEAST_EXPECT(held->info().seq == open.current()->info().seq);
+
+        auto jv = open.getJson();
+        BEAST_EXPECT(
+            count(jv, "snapshots_published") ==
+            count(before, "snapshots_published") + 1);
+        BEAST_EXPECT(jv["snapshots_held"].asUInt() >= 1);
+        BEAST_EXPECT(jv.isMember("oldest_held_ms"));
+
+        // Unchanged views are not published
+        BEAST_EXPECT(!open.modify([](OpenView&, beast::Journal) {
+            return false;
+        }));
+        BEAST_EXPECT(
+            count(open.getJson(), "snapshots_published") ==
+            count(jv, "snapshots_published"));
+
+        held.reset();
+        open.modify([](OpenView&, beast::Journal) { return true; });
+        jv = open.getJson();
+        BEAST_EXPECT(jv["snapshots_held"].asUInt() == 0);
+        BEAST_EXPECT(
+            count(jv, "snapshots_reclaimed") >
+            count(before, "snapshots_reclaimed"));
+    }
+
+    void
+    testConcurrentReaders()
+    {
+        testcase("concurrent readers");
+        using namespace jtx;
+        Env env(*this);
+        auto& open = env.app().openLedger();
+
+        std::atomic<bool> stop{false};
+        std::atomic<std::uint64_t> reads{0};
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 4; ++i)
+        {
+            readers.emplace_back([&] {
+                while (!stop)
+                {
+                    auto const view = open.current();
+                    if (view && view->txCount() == 0)
+                        ++reads;
+                }
+            });
+        }
+
+        // Each modify holds the writer lock while it copies and changes
+        // the view; readers go on meanwhile
+        for (int i = 0; i < 200; ++i)
+            open.modify([](OpenView&, beast::Journal) { return true; });
+        stop = true;
+        for (auto& t : readers)
+            t.join();
+
+        BEAST_EXPECT(reads > 0);
+        BEAST_EXPECT(open.getJson()["snapshots_held"].asUInt() <= 1);
+    }
+
+public:
+    void
+    run() override
+    {
+        testSnapshots();
+        testConcurrentReaders();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(OpenLedger, ledger, ripple);
+
+}  // namespace test
+}  // namespace ripple
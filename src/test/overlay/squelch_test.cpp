@@ -0,0 +1,327 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/misc/HashRouter.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/overlay/Slot.h>
+#include <ripple/overlay/Squelch.h>
+#include <ripple/protocol/SecretKey.h>
+#include <ripple/protocol/digest.h>
+
+#include <chrono>
+#include <map>
+#include <ratio>
+
+namespace ripple {
+
+namespace test {
+
+/** A clock the test moves by hand */
+class ManualClock
+{
+public:
+    using rep = std::int64_t;
+    using period = std::milli;
+    using duration = std::chrono::duration<rep, period>;
+    using time_point = std::chrono::time_point<ManualClock>;
+    static bool const is_steady = false;
+
+    static time_point
+    now()
+    {
+        return now_;
+    }
+
+    static void
+    advance(duration d)
+    {
+        now_ += d;
+    }
+
+private:
+    inline static time_point now_{};
+};
+
+class squelch_test : public beast::unit_test::suite
+{
+    using id_t = Peer::id_t;
+
+    /** Remembers the last decision sent to each peer */
+    class Handler : public squelch::SquelchHandler
+    {
+    public:
+        void
+        squelch(PublicKey const&, id_t id, std::uint32_t duration)
+            const override
+        {
+            squelched_[id] = duration;
+        }
+
+        void
+        unsquelch(PublicKey const&, id_t id) const override
+        {
+            squelched_.erase(id);
+            ++unsquelched_;
+        }
+
+        mutable std::map<id_t, std::uint32_t> squelched_;
+        mutable std::size_t unsquelched_ = 0;
+    };
+
+    beast::Journal const journal_{beast::Journal::getNullSink()};
+
+    static PublicKey
+    randomKey()
+    {
+        return randomKeyPair(KeyType::secp256k1).first;
+    }
+
+    // Each of the peers relays messages [first, first + count) of `key`
+    static void
+    relay(
+        squelch::Slots<ManualClock>& slots,
+        PublicKey const& key,
+        std::vector<id_t> const& peers,
+        std::uint32_t first,
+        std::uint32_t count)
+    {
+        for (std::uint32_t m = first; m < first + count; ++m)
+            for (auto const id : peers)
+                slots.updateSlotAndSquelch(sha512Half(key, m), key, id);
+    }
+
+    void
+    testSquelch()
+    {
+        testcase("squelch");
+
+        using namespace std::chrono_literals;
+        squelch::Squelch<ManualClock> squelch;
+        auto const key = randomKey();
+
+        BEAST_EXPECT(!squelch.addSquelch(key, 10s));
+        BEAST_EXPECT(!squelch.addSquelch(key, squelch::MAX_UNSQUELCH_EXPIRE + 1s));
+        BEAST_EXPECT(!squelch.isSquelched(key));
+
+        BEAST_EXPECT(squelch.addSquelch(key, squelch::MIN_UNSQUELCH_EXPIRE));
+        BEAST_EXPECT(squelch.isSquelched(key));
+        BEAST_EXPECT(!squelch.isSquelched(randomKey()));
+
+        ManualClock::advance(squelch::MIN_UNSQUELCH_EXPIRE + 1s);
+        BEAST_EXPECT(!squelch.isSquelched(key));
+        BEAST_EXPECT(squelch.size() == 0);
+
+        BEAST_EXPECT(squelch.addSquelch(key, squelch::MAX_UNSQUELCH_EXPIRE));
+        squelch.removeSquelch(key);
+        BEAST_EXPECT(!squelch.isSquelched(key));
+    }
+
+    void
+    testSelection()
+    {
+        testcase("selection");
+
+        using namespace std::chrono_literals;
+        Handler handler;
+        squelch::Slots<ManualClock> slots(handler, 3, 16, journal_);
+        auto const key = randomKey();
+        std::vector<id_t> const peers{1, 2, 3, 4, 5};
+
+        relay(slots, key, peers, 0, squelch::MAX_MESSAGE_THRESHOLD);
+        BEAST_EXPECT(slots.slotState(key) == squelch::SlotState::Counting);
+        BEAST_EXPECT(handler.squelched_.empty());
+
+        relay(slots, key, peers, squelch::MAX_MESSAGE_THRESHOLD, 1);
+        BEAST_EXPECT(slots.slotState(key) == squelch::SlotState::Selected);
+        BEAST_EXPECT(handler.squelched_.size() == 2);
+
+        std::size_t selected = 0;
+        for (auto const id : peers)
+        {
+            auto const state = slots.peerState(key, id);
+            if (state == squelch::PeerState::Selected)
+            {
+                ++selected;
+                BEAST_EXPECT(handler.squelched_.count(id) == 0);
+            }
+            else
+            {
+                BEAST_EXPECT(state == squelch::PeerState::Squelched);
+                auto const duration = handler.squelched_[id];
+                BEAST_EXPECT(
+                    duration >= squelch::MIN_UNSQUELCH_EXPIRE.count() &&
+                    duration <= squelch::MAX_UNSQUELCH_EXPIRE.count());
+            }
+        }
+        BEAST_EXPECT(selected == 3);
+
+        // A peer turning up late is squelched at once
+        relay(slots, key, {6}, 100, 1);
+        BEAST_EXPECT(slots.peerState(key, 6) == squelch::PeerState::Squelched);
+        BEAST_EXPECT(handler.squelched_.size() == 3);
+
+        // Losing a source lets everybody relay again
+        id_t source = 0;
+        for (auto const id : peers)
+            if (slots.peerState(key, id) == squelch::PeerState::Selected)
+                source = id;
+        slots.deletePeer(source, true);
+        BEAST_EXPECT(slots.slotState(key) == squelch::SlotState::Counting);
+        BEAST_EXPECT(!slots.peerState(key, source));
+        BEAST_EXPECT(handler.squelched_.empty());
+        BEAST_EXPECT(handler.unsquelched_ == 3);
+    }
+
+    void
+    testDuplicates()
+    {
+        testcase("duplicates");
+
+        Handler handler;
+        squelch::Slots<ManualClock> slots(handler, 3, 16, journal_);
+        auto const key = randomKey();
+
+        // The same message relayed again by the same peers counts once
+        for (int i = 0; i < 3 * squelch::MAX_MESSAGE_THRESHOLD; ++i)
+            relay(slots, key, {1, 2, 3, 4}, 0, 1);
+        BEAST_EXPECT(slots.slotState(key) == squelch::SlotState::Counting);
+        BEAST_EXPECT(handler.squelched_.empty());
+    }
+
+    void
+    testForged()
+    {
+        testcase("forged messages");
+
+        Handler handler;
+        squelch::Slots<ManualClock> slots(handler, 3, 16, journal_);
+        HashRouter router(
+            stopwatch(),
+            HashRouter::getDefaultHoldTime(),
+            HashRouter::getDefaultRecoverLimit());
+        auto const key = randomKey();
+
+        // What PeerImp and PeerManagerImpl count of a consensus message
+        auto receive = [&](uint256 const& uid, id_t id) {
+            auto const [added, relayed] =
+                router.addSuppressionPeerWithStatus(uid, id);
+            if (!added && relayed &&
+                stopwatch().now() - *relayed < squelch::IDLED)
+                slots.updateSlotAndSquelch(uid, key, id);
+        };
+        auto verified = [&](uint256 const& uid) {
+            if (auto const from = router.shouldRelay(uid))
+                for (auto const id : *from)
+                    slots.updateSlotAndSquelch(uid, key, id);
+        };
+
+        std::vector<id_t> const honest{1, 2, 3, 4};
+        id_t const forger = 5;
+        for (std::uint32_t m = 0; m <= 2 * squelch::MAX_MESSAGE_THRESHOLD;
+             ++m)
+        {
+            // Forged under the key with a fresh uid, first to arrive, and
+            // never verified
+            auto const forged = sha512Half(key, m, forger);
+            receive(forged, forger);
+
+            // The real message: one peer's copy is verified and relayed,
+            // the others come in later as duplicates
+            auto const uid = sha512Half(key, m);
+            receive(uid, honest.front());
+            verified(uid);
+            for (auto it = std::next(honest.begin()); it != honest.end(); ++it)
+                receive(uid, *it);
+        }
+
+        BEAST_EXPECT(slots.slotState(key) == squelch::SlotState::Selected);
+        BEAST_EXPECT(!slots.peerState(key, forger));
+        BEAST_EXPECT(handler.squelched_.count(forger) == 0);
+        std::size_t selected = 0;
+        for (auto const id : honest)
+            if (slots.peerState(key, id) == squelch::PeerState::Selected)
+                ++selected;
+        BEAST_EXPECT(selected == 3);
+    }
+
+    void
+    testIdle()
+    {
+        testcase("idle");
+
+        using namespace std::chrono_literals;
+        Handler handler;
+        squelch::Slots<ManualClock> slots(handler, 2, 16, journal_);
+        auto const key = randomKey();
+
+        relay(slots, key, {1, 2, 3}, 0, squelch::MAX_MESSAGE_THRESHOLD + 1);
+        BEAST_EXPECT(slots.slotState(key) == squelch::SlotState::Selected);
+        BEAST_EXPECT(handler.squelched_.size() == 1);
+
+        // The sources went quiet: counting starts over, but the slot stays
+        // while a squelch is running
+        ManualClock::advance(squelch::IDLED + 1s);
+        slots.deleteIdlePeers();
+        BEAST_EXPECT(slots.size() == 1);
+        BEAST_EXPECT(slots.slotState(key) == squelch::SlotState::Counting);
+        BEAST_EXPECT(handler.squelched_.empty());
+
+        ManualClock::advance(squelch::MAX_UNSQUELCH_EXPIRE);
+        slots.deleteIdlePeers();
+        BEAST_EXPECT(slots.size() == 0);
+    }
+
+    void
+    testMaxSlots()
+    {
+        testcase("max slots");
+
+        Handler handler;
+        squelch::Slots<ManualClock> slots(handler, 3, 2, journal_);
+        auto const k1 = randomKey();
+        auto const k2 = randomKey();
+        auto const k3 = randomKey();
+
+        relay(slots, k1, {1}, 0, 1);
+        relay(slots, k2, {1}, 0, 1);
+        relay(slots, k3, {1}, 0, 1);
+        BEAST_EXPECT(slots.size() == 2);
+        BEAST_EXPECT(slots.slotState(k1));
+        BEAST_EXPECT(slots.slotState(k2));
+        BEAST_EXPECT(!slots.slotState(k3));
+    }
+
+public:
+    void
+    run() override
+    {
+        testSquelch();
+        testSelection();
+        testDuplicates();
+        testForged();
+        testIdle();
+        testMaxSlots();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(squelch, overlay, ripple);
+
+}  // namespace test
+
+}  // namespace ripple
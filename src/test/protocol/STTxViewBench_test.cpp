@@ -0,0 +1,208 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/protocol/STArray.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/protocol/SecretKey.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+/*
+Compares reading the commonly used transaction fields through the STObject
+accessors with reading them through STTx::view(), on a stream of payments,
+table inserts, and table creates.
+
+Each pass does what the hot paths do with a transaction: order it by
+account and sequence, as the TxPool does, and for table transactions read
+the operation, the table and the raw statement, as table sync and
+publishing do.
+*/
+class STTxViewBench_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    std::vector<std::shared_ptr<STTx const>>
+    makeStream(std::size_t count)
+    {
+        beast::xor_shift_engine gen(1);
+        std::vector<AccountID> accounts;
+        for (int i = 0; i < 200; ++i)
+            accounts.push_back(
+                calcAccountID(randomKeyPair(KeyType::ed25519).first));
+
+        std::string raw = R"([{"id":1,"name":"a name","balance":12345,)"
+                          R"("note":"some text stored with the row"}])";
+
+        std::vector<std::shared_ptr<STTx const>> stream;
+        stream.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto const& account = accounts[gen() % accounts.size()];
+            auto const& other = accounts[gen() % accounts.size()];
+            auto const seq = static_cast<std::uint32_t>(gen() % 1000);
+            auto const kind = gen() % 10;
+            if (kind < 5)
+            {
+                stream.push_back(
+                    std::make_shared<STTx const>(ttPAYMENT, [&](auto& obj) {
+                        obj.setAccountID(sfAccount, account);
+                        obj.setAccountID(sfDestination, other);
+                        obj.setFieldAmount(sfAmount, STAmount(1000000ull));
+                        obj.setFieldAmount(sfFee, STAmount(10ull));
+                        obj.setFieldU32(sfSequence, seq);
+                    }));
+                continue;
+            }
+
+            bool const create = kind == 9;
+            auto const type = create ? ttTABLELISTSET : ttSQLSTATEMENT;
+            stream.push_back(std::make_shared<STTx const>(type, [&](auto& obj) {
+                obj.setAccountID(sfAccount, account);
+                obj.setFieldAmount(sfFee, STAmount(10ull));
+                obj.setFieldU32(sfSequence, seq);
+                obj.setFieldU16(sfOpType, create ? 1 : 6);
+                obj.setFieldVL(sfRaw, makeSlice(raw));
+                if (!create)
+                    obj.setAccountID(sfOwner, other);
+                STObject table(sfTable);
+                table.setFieldVL(
+                    sfTableName,
+                    makeSlice("table_" + std::to_string(gen() % 50)));
+                table.setFieldH160(sfNameInDB, uint160(gen()));
+                STArray tables(sfTables);
+                tables.push_back(std::move(table));
+                obj.setFieldArray(sfTables, tables);
+            }));
+        }
+        return stream;
+    }
+
+    // What the hot paths did before the view
+    static std::size_t
+    consumeFields(std::vector<std::shared_ptr<STTx const>> stream)
+    {
+        std::sort(stream.begin(), stream.end(), [](auto const& a, auto const& b) {
+            if (a->getAccountID(sfAccount) == b->getAccountID(sfAccount))
+                return a->getFieldU32(sfSequence) < b->getFieldU32(sfSequence);
+            return a->getAccountID(sfAccount) < b->getAccountID(sfAccount);
+        });
+
+        std::size_t n = 0;
+        for (auto const& tx : stream)
+        {
+            if (!tx->isFieldPresent(sfOpType))
+                continue;
+            auto const opType = tx->getFieldU16(sfOpType);
+            AccountID owner = tx->isFieldPresent(sfOwner)
+                ? tx->getAccountID(sfOwner)
+                : tx->getAccountID(sfAccount);
+            auto tables = tx->getFieldArray(sfTables);
+            uint160 const nameInDB = tables[0].getFieldH160(sfNameInDB);
+            auto const tableBlob = tables[0].getFieldVL(sfTableName);
+            std::string const tableName(tableBlob.begin(), tableBlob.end());
+            auto const raw = tx->getFieldVL(sfRaw);
+            n += opType + tableName.size() + raw.size() + owner.size() +
+                nameInDB.size();
+        }
+        return n;
+    }
+
+    static std::size_t
+    consumeView(std::vector<std::shared_ptr<STTx const>> stream)
+    {
+        std::sort(stream.begin(), stream.end(), [](auto const& a, auto const& b) {
+            auto const va = a->view();
+            auto const vb = b->view();
+            if (va->account == vb->account)
+                return va->sequence < vb->sequence;
+            return va->account < vb->account;
+        });
+
+        std::size_t n = 0;
+        for (auto const& tx : stream)
+        {
+            auto const view = tx->view();
+            if (!view->opType)
+                continue;
+            auto const& table = view->tables[0];
+            std::string const tableName = table.nameString();
+            n += *view->opType + tableName.size() + view->raw.size() +
+                view->tableOwner().size() + table.nameInDB.size();
+        }
+        return n;
+    }
+
+    template <class F>
+    std::chrono::microseconds
+    measure(char const* name, std::size_t count, F&& f)
+    {
+        using namespace std::chrono;
+        int const rounds = 5;
+        auto best = microseconds::max();
+        for (int i = 0; i < rounds; ++i)
+        {
+            auto const start = clock_type::now();
+            f();
+            best = std::min(
+                best, duration_cast<microseconds>(clock_type::now() - start));
+        }
+        log << "    " << name << ": " << best.count() << " us, "
+            << (best.count() ? count * 1000000 / best.count() : 0) << " tx/s"
+            << std::endl;
+        return best;
+    }
+
+public:
+    void
+    run() override
+    {
+        std::size_t const count = 100000;
+        testcase("mixed stream of " + std::to_string(count) + " transactions");
+        auto const stream = makeStream(count);
+
+        std::size_t fields = 0;
+        measure("field accessors", count, [&] {
+            fields = consumeFields(stream);
+        });
+
+        // Paid once per transaction, on first use
+        std::size_t decoded = 0;
+        measure("decoding the view", count, [&] {
+            for (auto const& tx : stream)
+                decoded += STTxView(*tx).tables.size();
+        });
+
+        std::size_t viewed = 0;
+        measure("view", count, [&] { viewed = consumeView(stream); });
+
+        BEAST_EXPECT(decoded > 0);
+        BEAST_EXPECT(fields == viewed);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(STTxViewBench, protocol, ripple);
+
+}  // namespace ripple
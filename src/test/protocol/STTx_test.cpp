@@ -61,6 +61,9 @@ public:
 
         testcase("STObject constructor errors");
         testObjectCtorErrors();
+
+        testcase("view");
+        testView();
     }
 
     void
@@ -1628,6 +1631,76 @@ public:
         }
     }
 
+    void
+    testView()
+    {
+        auto const alice = calcAccountID(randomKeyPair(KeyType::ed25519).first);
+        auto const bob = calcAccountID(randomKeyPair(KeyType::ed25519).first);
+        std::string const raw = R"([{"id":1,"name":"test"}])";
+
+        STTx tx(ttSQLSTATEMENT, [&](auto& obj) {
+            obj.setAccountID(sfAccount, alice);
+            obj.setAccountID(sfOwner, bob);
+            obj.setFieldU32(sfSequence, 7);
+            obj.setFieldAmount(sfFee, STAmount(12ull));
+            obj.setFieldU16(sfOpType, 6);
+            obj.setFieldVL(sfRaw, makeSlice(raw));
+            STObject table(sfTable);
+            table.setFieldVL(sfTableName, makeSlice(std::string("users")));
+            table.setFieldH160(sfNameInDB, uint160(42));
+            STArray tables(sfTables);
+            tables.push_back(std::move(table));
+            obj.setFieldArray(sfTables, tables);
+        });
+
+        auto const view = tx.view();
+        BEAST_EXPECT(tx.view() == view);
+        BEAST_EXPECT(view->type == ttSQLSTATEMENT);
+        BEAST_EXPECT(view->account == alice);
+        BEAST_EXPECT(view->sequence == 7);
+        BEAST_EXPECT(view->fee == STAmount(12ull));
+        BEAST_EXPECT(view->opType && *view->opType == 6);
+        BEAST_EXPECT(view->owner && *view->owner == bob);
+        BEAST_EXPECT(view->tableOwner() == bob);
+        if (BEAST_EXPECT(view->tables.size() == 1))
+        {
+            BEAST_EXPECT(view->tables[0].nameString() == "users");
+            BEAST_EXPECT(view->tables[0].nameInDB == uint160(42));
+        }
+
+        // The raw statement is not copied
+        BEAST_EXPECT(view->raw == makeSlice(raw));
+        BEAST_EXPECT(view->raw.data() == tx.getFieldSlice(sfRaw).data());
+
+        // A copy decodes its own fields
+        STTx copy(tx);
+        BEAST_EXPECT(copy.view() != view);
+        BEAST_EXPECT(copy.view()->raw.data() == copy.getFieldSlice(sfRaw).data());
+
+        // Changing a field decodes the view again
+        std::string const decrypted = "{\"id\":1}";
+        copy.setFieldVL(sfRaw, makeSlice(decrypted));
+        copy.setFieldU32(sfSequence, 8);
+        auto const changed = copy.view();
+        BEAST_EXPECT(changed->raw == makeSlice(decrypted));
+        BEAST_EXPECT(changed->raw.data() == copy.getFieldSlice(sfRaw).data());
+        BEAST_EXPECT(changed->sequence == 8);
+        BEAST_EXPECT(copy.view() == changed);
+        // A view taken before is left as it was
+        BEAST_EXPECT(view->sequence == 7);
+
+        // Fields a payment lacks are left empty
+        STTx payment(ttPAYMENT, [&](auto& obj) {
+            obj.setAccountID(sfAccount, alice);
+            obj.setAccountID(sfDestination, bob);
+            obj.setFieldAmount(sfAmount, STAmount(100ull));
+        });
+        auto const pv = payment.view();
+        BEAST_EXPECT(!pv->opType && !pv->owner);
+        BEAST_EXPECT(pv->tables.empty() && pv->raw.empty());
+        BEAST_EXPECT(pv->tableOwner() == alice);
+    }
+
     void
     testObjectCtorErrors()
     {
@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <ripple/protocol/jss.h>
+#include <test/jtx.h>
+
+namespace ripple {
+
+class LedgerObjects_test : public beast::unit_test::suite
+{
+    static Json::Value
+    ledgerObjects(
+        test::jtx::Env& env,
+        std::string const& ledger,
+        bool verify = false)
+    {
+        Json::Value params;
+        params[jss::ledger_index] = ledger;
+        if (verify)
+            params["verify"] = true;
+        return env.rpc(
+            "json",
+            "ledger_objects",
+            boost::lexical_cast<std::string>(params))[jss::result];
+    }
+
+    void
+    testIncremental()
+    {
+        testcase("incremental counts");
+        using namespace test::jtx;
+        Env env{*this};
+
+        env.fund(ZXC(10000), "alice", "bob");
+        env.close();
+
+        // The first request may have to scan; it leaves counts behind
+        auto jrr = ledgerObjects(env, "validated", true);
+        BEAST_EXPECT(!jrr.isMember(jss::error));
+        auto const accounts = jrr[jss::state][jss::account].asUInt();
+        BEAST_EXPECT(accounts >= 3);
+
+        env.fund(ZXC(10000), "carol", "dan", "erin");
+        env.close();
+
+        jrr = ledgerObjects(env, "validated", true);
+        BEAST_EXPECT(jrr["incremental"].asBool());
+        BEAST_EXPECT(jrr["verified"].asBool());
+        BEAST_EXPECT(!jrr.isMember("mismatch"));
+        BEAST_EXPECT(jrr[jss::state][jss::account].asUInt() == accounts + 3);
+
+        // A few more ledgers, asked about only at the end
+        for (int i = 0; i < 3; ++i)
+        {
+            env.fund(ZXC(10000), Account("acct" + std::to_string(i)));
+            env.close();
+        }
+        jrr = ledgerObjects(env, "validated", true);
+        BEAST_EXPECT(jrr["incremental"].asBool());
+        BEAST_EXPECT(jrr["verified"].asBool());
+        BEAST_EXPECT(jrr[jss::state][jss::account].asUInt() == accounts + 6);
+    }
+
+    void
+    testOpenLedger()
+    {
+        testcase("open ledger");
+        using namespace test::jtx;
+        Env env{*this};
+
+        env.fund(ZXC(10000), "alice");
+        env.close();
+        auto jrr = ledgerObjects(env, "validated", true);
+        auto const accounts = jrr[jss::state][jss::account].asUInt();
+
+        // Pending in the open ledger only
+        env.fund(ZXC(10000), "bob");
+        jrr = ledgerObjects(env, "current", true);
+        BEAST_EXPECT(jrr["incremental"].asBool());
+        BEAST_EXPECT(jrr["verified"].asBool());
+        BEAST_EXPECT(jrr[jss::state][jss::account].asUInt() == accounts + 1);
+    }
+
+    void
+    testVerifyNeedsAdmin()
+    {
+        testcase("verify needs admin");
+        using namespace test::jtx;
+        Env env{*this, envconfig(no_admin)};
+        env.close();
+
+        auto jrr = ledgerObjects(env, "validated");
+        BEAST_EXPECT(!jrr.isMember(jss::error));
+        BEAST_EXPECT(jrr[jss::state][jss::account].asUInt() >= 1);
+
+        // A scan on a user's behalf answers the request but isn't kept
+        if (!jrr["incremental"].asBool())
+        {
+            auto const again = ledgerObjects(env, "validated");
+            BEAST_EXPECT(!again["incremental"].asBool());
+            BEAST_EXPECT(again[jss::state] == jrr[jss::state]);
+        }
+
+        jrr = ledgerObjects(env, "validated", true);
+        BEAST_EXPECT(jrr[jss::error] == "noPermission");
+    }
+
+public:
+    void
+    run() override
+    {
+        testIncremental();
+        testOpenLedger();
+        testVerifyNeedsAdmin();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LedgerObjects, rpc, ripple);
+
+}  // namespace ripple
@@ -0,0 +1,194 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/unit_test.h>
+#include <ripple/json/json_reader.h>
+#include <ripple/json/to_string.h>
+#include <ripple/protocol/jss.h>
+#include <ripple/rpc/impl/StreamWriter.h>
+#include <cstdlib>
+
+namespace ripple {
+namespace RPC {
+
+class StreamWriter_test : public beast::unit_test::suite
+{
+    // Reads what the writer has to send, a few bytes at a time
+    static std::string
+    drain(StreamWriter& writer, std::size_t step)
+    {
+        std::string sent;
+        while (writer.prepare(step, [] {}))
+        {
+            auto const buffers = writer.data();
+            std::size_t n = 0;
+            for (auto const& b : buffers)
+            {
+                auto const take = std::min(step - n, b.size());
+                sent.append(static_cast<char const*>(b.data()), take);
+                n += take;
+                if (n == step)
+                    break;
+            }
+            writer.consume(n);
+        }
+        return sent;
+    }
+
+    // Returns the body of a chunked response, or nothing if it is malformed
+    static boost::optional<std::string>
+    dechunk(std::string const& response)
+    {
+        auto pos = response.find("\r\n\r\n");
+        if (pos == std::string::npos)
+            return boost::none;
+        pos += 4;
+
+        std::string body;
+        for (;;)
+        {
+            auto const eol = response.find("\r\n", pos);
+            if (eol == std::string::npos)
+                return boost::none;
+            auto const size = std::strtoul(
+                response.substr(pos, eol - pos).c_str(), nullptr, 16);
+            pos = eol + 2;
+            if (size == 0)
+                break;
+            if (response.size() < pos + size + 2 ||
+                response.compare(pos + size, 2, "\r\n") != 0)
+                return boost::none;
+            body.append(response, pos, size);
+            pos += size + 2;
+        }
+        if (response.compare(pos, std::string::npos, "\r\n") != 0)
+            return boost::none;
+        return body;
+    }
+
+    static std::vector<Json::Value>
+    deframe(std::string const& body)
+    {
+        std::vector<Json::Value> frames;
+        std::size_t pos = 0;
+        while (pos + 4 <= body.size())
+        {
+            auto const byte = [&](int i) {
+                return static_cast<std::uint32_t>(
+                    static_cast<unsigned char>(body[pos + i]));
+            };
+            auto const size =
+                (byte(0) << 24) | (byte(1) << 16) | (byte(2) << 8) | byte(3);
+            pos += 4;
+            Json::Value jv;
+            Json::Reader().parse(body.substr(pos, size), jv);
+            frames.push_back(jv);
+            pos += size;
+        }
+        return frames;
+    }
+
+    void
+    testFrames()
+    {
+        testcase("frames");
+
+        StreamWriter writer(nullptr);
+        int const rows = 1000;
+        for (int i = 0; i < rows; ++i)
+        {
+            Json::Value row;
+            row[jss::index] = i;
+            BEAST_EXPECT(writer.write(row));
+        }
+        BEAST_EXPECT(!writer.complete());
+
+        Json::Value result;
+        result[jss::status] = jss::success;
+        writer.finish(to_string(result));
+
+        auto const sent = drain(writer, 1000);
+        BEAST_EXPECT(writer.complete());
+        BEAST_EXPECT(sent.compare(0, 17, "HTTP/1.1 200 OK\r\n") == 0);
+        BEAST_EXPECT(
+            sent.find("Transfer-Encoding: chunked\r\n") != std::string::npos);
+
+        auto const body = dechunk(sent);
+        if (!BEAST_EXPECT(body))
+            return;
+        auto const frames = deframe(*body);
+        if (!BEAST_EXPECT(frames.size() == rows + 1))
+            return;
+        for (int i = 0; i < rows; ++i)
+            BEAST_EXPECT(frames[i][jss::index].asInt() == i);
+        BEAST_EXPECT(frames.back()[jss::status] == jss::success);
+    }
+
+    void
+    testResume()
+    {
+        testcase("resume");
+
+        StreamWriter writer(nullptr);
+        drain(writer, 4096);
+
+        // Nothing to send: the peer waits until a row is written
+        bool resumed = false;
+        BEAST_EXPECT(!writer.prepare(4096, [&] { resumed = true; }));
+        Json::Value row;
+        row[jss::index] = 1;
+        BEAST_EXPECT(writer.write(row));
+        BEAST_EXPECT(resumed);
+
+        resumed = false;
+        drain(writer, 4096);
+        BEAST_EXPECT(!writer.prepare(4096, [&] { resumed = true; }));
+        writer.finish("{}");
+        BEAST_EXPECT(resumed);
+        drain(writer, 4096);
+        BEAST_EXPECT(writer.complete());
+    }
+
+    void
+    testAbort()
+    {
+        testcase("abort");
+
+        StreamWriter writer(nullptr);
+        Json::Value row;
+        row[jss::index] = 1;
+        BEAST_EXPECT(writer.write(row));
+        writer.abort();
+        BEAST_EXPECT(!writer.write(row));
+    }
+
+public:
+    void
+    run() override
+    {
+        testFrames();
+        testResume();
+        testAbort();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(StreamWriter, rpc, ripple);
+
+}  // namespace RPC
+}  // namespace ripple
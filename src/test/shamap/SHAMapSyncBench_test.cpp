@@ -0,0 +1,223 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/random.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/shamap/SHAMap.h>
+#include <ripple/shamap/SHAMapItem.h>
+#include <test/shamap/common.h>
+#include <test/unit_test/SuiteJournal.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace ripple {
+namespace tests {
+
+/*
+Catching up on consecutive ledgers: the state maps of a chain of ledgers,
+each changing a few hundred items of the last, are synced one after the
+other into one node family, the way InboundLedger does from peers' replies.
+
+Compared: decoding each node while adding it to the map, as before, and
+decoding each reply's nodes in parallel before adding them, as the ledger
+data jobs now do. Later ledgers only fetch the nodes they don't share with
+earlier ones, which they find in the family's caches.
+*/
+class SHAMapSyncBench_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    beast::xor_shift_engine eng_;
+
+    SHAMapItem
+    makeRandomAS()
+    {
+        Serializer s;
+        for (int d = 0; d < 3; ++d)
+            s.add32(rand_int<std::uint32_t>(eng_));
+        return SHAMapItem{s.getSHA512Half(), s.peekData()};
+    }
+
+    std::vector<std::shared_ptr<SHAMap>>
+    makeChain(Family& f, int items, int ledgers, int changes)
+    {
+        std::vector<std::shared_ptr<SHAMap>> chain;
+        auto map = std::make_shared<SHAMap>(SHAMapType::FREE, f);
+        std::vector<uint256> keys;
+        for (int i = 0; i < items; ++i)
+        {
+            auto item = makeRandomAS();
+            keys.push_back(item.key());
+            map->addItem(std::move(item), false, false);
+        }
+        map->setImmutable();
+        chain.push_back(map);
+
+        for (int l = 1; l < ledgers; ++l)
+        {
+            map = chain.back()->snapShot(true);
+            for (int c = 0; c < changes; ++c)
+            {
+                auto const i = rand_int(eng_, keys.size() - 1);
+                map->delItem(keys[i]);
+                auto item = makeRandomAS();
+                keys[i] = item.key();
+                map->addItem(std::move(item), false, false);
+            }
+            map->setImmutable();
+            chain.push_back(map);
+        }
+        return chain;
+    }
+
+    static std::vector<std::shared_ptr<SHAMapAbstractNode>>
+    decodeParallel(std::vector<Blob> const& raw, unsigned threads)
+    {
+        std::vector<std::shared_ptr<SHAMapAbstractNode>> decoded(raw.size());
+        auto const chunk = (raw.size() + threads - 1) / threads;
+        std::vector<std::thread> workers;
+        for (std::size_t first = 0; first < raw.size(); first += chunk)
+        {
+            workers.emplace_back([&, first] {
+                auto const last = std::min(first + chunk, raw.size());
+                for (auto i = first; i < last; ++i)
+                    decoded[i] =
+                        SHAMapAbstractNode::makeFromWire(makeSlice(raw[i]));
+            });
+        }
+        for (auto& t : workers)
+            t.join();
+        return decoded;
+    }
+
+    // Returns the number of nodes received
+    std::size_t
+    sync(SHAMap const& source, SHAMap& destination, unsigned threads)
+    {
+        std::size_t received = 0;
+        {
+            std::vector<SHAMapNodeID> ids;
+            std::vector<Blob> nodes;
+            source.getNodeFat(SHAMapNodeID(), ids, nodes, false, 1);
+            destination.addRootNode(
+                source.getHash(), makeSlice(nodes.front()), nullptr);
+            ++received;
+        }
+
+        for (;;)
+        {
+            auto const missing = destination.getMissingNodes(2048, nullptr);
+            if (missing.empty())
+                break;
+
+            std::vector<SHAMapNodeID> ids;
+            std::vector<Blob> nodes;
+            for (auto const& m : missing)
+                source.getNodeFat(m.first, ids, nodes, false, 1);
+            received += nodes.size();
+
+            if (threads == 0)
+            {
+                for (std::size_t i = 0; i < nodes.size(); ++i)
+                    destination.addKnownNode(
+                        ids[i], makeSlice(nodes[i]), nullptr);
+            }
+            else
+            {
+                auto const decoded = decodeParallel(nodes, threads);
+                for (std::size_t i = 0; i < nodes.size(); ++i)
+                    destination.addKnownNode(ids[i], decoded[i], nullptr);
+            }
+        }
+        destination.clearSynching();
+        return received;
+    }
+
+    void
+    catchUp(
+        char const* name,
+        std::vector<std::shared_ptr<SHAMap>> const& chain,
+        unsigned threads)
+    {
+        using namespace std::chrono;
+        test::SuiteJournal journal("SHAMapSyncBench_test", *this);
+        TestNodeFamily f(journal);
+
+        std::size_t received = 0;
+        std::size_t firstLedger = 0;
+        bool same = true;
+        auto const start = clock_type::now();
+        for (auto const& source : chain)
+        {
+            SHAMap destination(
+                SHAMapType::STATE, source->getHash().as_uint256(), f);
+            auto const n = sync(*source, destination, threads);
+            if (received == 0)
+                firstLedger = n;
+            received += n;
+            same = same && source->deepCompare(destination);
+        }
+        auto const elapsed =
+            duration_cast<milliseconds>(clock_type::now() - start);
+
+        BEAST_EXPECT(same);
+        log << "    " << name << ": " << chain.size() << " ledgers in "
+            << elapsed.count() << " ms, "
+            << (elapsed.count() ? received * 1000 / elapsed.count() : 0)
+            << " nodes/s; " << firstLedger << " nodes for the first ledger, "
+            << (chain.size() > 1
+                    ? (received - firstLedger) / (chain.size() - 1)
+                    : 0)
+            << " for each after it" << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        test::SuiteJournal journal("SHAMapSyncBench_test", *this);
+        TestNodeFamily f(journal);
+
+        unsigned const threads =
+            std::max(2u, std::min(4u, std::thread::hardware_concurrency()));
+
+        for (auto const& [items, ledgers, changes] :
+             {std::make_tuple(20000, 16, 300),
+              std::make_tuple(100000, 8, 2000)})
+        {
+            testcase(
+                std::to_string(ledgers) + " ledgers of " +
+                std::to_string(items) + " items, " + std::to_string(changes) +
+                " changes each");
+            auto const chain = makeChain(f, items, ledgers, changes);
+            catchUp("decoding while adding", chain, 0);
+            catchUp(
+                ("decoded on " + std::to_string(threads) + " threads").c_str(),
+                chain,
+                threads);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(SHAMapSyncBench, shamap, ripple);
+
+}  // namespace tests
+}  // namespace ripple
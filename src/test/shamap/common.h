@@ -36,6 +36,7 @@ private:
 
     std::shared_ptr<FullBelowCache> fbCache_;
     std::shared_ptr<TreeNodeCache> tnCache_;
+    std::shared_ptr<StateNodeHashSet> snHashSet_;
 
     TestStopwatch clock_;
     NodeStore::DummyScheduler scheduler_;
@@ -54,6 +55,7 @@ public:
               std::chrono::minutes{1},
               clock_,
               j))
+        , snHashSet_(std::make_shared<StateNodeHashSet>())
         , parent_("TestRootStoppable")
         , j_(j)
     {
@@ -92,6 +94,12 @@ public:
         return tnCache_;
     }
 
+    std::shared_ptr<StateNodeHashSet>
+    getStateNodeHashSet() override
+    {
+        return snHashSet_;
+    }
+
     void
     sweep() override
     {
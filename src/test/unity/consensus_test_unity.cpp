@@ -18,9 +18,11 @@
 //==============================================================================
 
 #include <test/consensus/ByzantineFailureSim_test.cpp>
+#include <test/consensus/CertVerifier_test.cpp>
 #include <test/consensus/Consensus_test.cpp>
 #include <test/consensus/DistributedValidatorsSim_test.cpp>
 #include <test/consensus/Hotstuff_test.cpp>
+#include <test/consensus/HotstuffBlockLog_test.cpp>
 #include <test/consensus/HotstuffCore_test.cpp>
 #include <test/consensus/LedgerTiming_test.cpp>
 #include <test/consensus/LedgerTrie_test.cpp>
@@ -20,4 +20,6 @@
 
 #include <test/vm/Executive_test.cpp>
 #include <test/vm/FakeExtVM.cpp>
+#include <test/vm/Hash_test.cpp>
+#include <test/vm/VMPoolBench_test.cpp>
 #include <test/vm/vm_test.cpp>
\ No newline at end of file
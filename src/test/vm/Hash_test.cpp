@@ -0,0 +1,227 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <eth/vm/utils/keccak.h>
+#include <peersafe/precompiled/Utils.h>
+#include <ripple/basics/strHex.h>
+#include <ripple/beast/unit_test.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+
+class Hash_test : public beast::unit_test::suite
+{
+    static std::string
+    keccakHex(std::string const& s)
+    {
+        std::uint8_t out[32];
+        eth::keccak((std::uint8_t const*)s.data(), s.size(), out);
+        return strHex(out, out + 32);
+    }
+
+    void
+    testKeccak()
+    {
+        testcase("keccak256");
+
+        BEAST_EXPECT(
+            keccakHex("") ==
+            "C5D2460186F7233C927E7DB2DCC703C0E500B653CA82273B7BFAD8045D85A470");
+        BEAST_EXPECT(
+            keccakHex("abc") ==
+            "4E03657AEA45A94FC7D47BA826C8D667C0D1E6E33A64A036EC44F58FA12D6C45");
+        BEAST_EXPECT(
+            keccakHex("The quick brown fox jumps over the lazy dog") ==
+            "4D741B6F1EB29CB2A9B9911C82F56FA8D73B04959D3D9D222895DF6C0B28AA15");
+        // 200 bytes of 0xA3, from the Keccak team's test vectors: two blocks
+        BEAST_EXPECT(
+            keccakHex(std::string(200, '\xA3')) ==
+            "3A57666B048777F2C953DC4456F45A2588E1CB6F2DA760122D530AC2CE607D4A");
+
+        // Around and past the 136 byte rate: the padding lands in the last
+        // byte, takes a block of its own, or follows several full blocks.
+        // Computed with an independent Keccak checked against SHA3-256.
+        std::pair<std::size_t, char const*> const repeated[] = {
+            {135,
+             "34367DC248BBD832F4E3E69DFAAC2F92638BD0BBD18F2912BA4EF454919CF446"},
+            {136,
+             "A6C4D403279FE3E0AF03729CAADA8374B5CA54D8065329A3EBCAEB4B60AA386E"},
+            {137,
+             "D869F639C7046B4929FC92A4D988A8B22C55FBADB802C0C66EBCD484F1915F39"},
+            {272,
+             "CF7FCD4F705EE749930D19CA84561A9BF62516BD90A471545FA2F49FDC7E63C8"},
+            {1000,
+             "B6A4AC1F51884D71F30FA397A5E155DE3099E11FC0EDEF5D08B646E621E19DE9"}};
+        for (auto const& [size, hash] : repeated)
+            BEAST_EXPECT(keccakHex(std::string(size, 'a')) == hash);
+
+        // The function selector of transfer(address,uint256)
+        BEAST_EXPECT(
+            keccakHex("transfer(address,uint256)").substr(0, 8) == "A9059CBB");
+
+        // Messages around the 136 byte block, hashed one at a time and in
+        // a single batch
+        std::vector<std::string> messages;
+        for (std::size_t size : {0, 1, 135, 136, 137, 271, 272, 273, 1000})
+        {
+            std::string m(size, 0);
+            for (std::size_t i = 0; i < size; ++i)
+                m[i] = static_cast<char>(i * 7 + size);
+            messages.push_back(std::move(m));
+        }
+
+        std::vector<std::uint8_t const*> data;
+        std::vector<std::uint64_t> sizes;
+        for (auto const& m : messages)
+        {
+            data.push_back((std::uint8_t const*)m.data());
+            sizes.push_back(m.size());
+        }
+        std::vector<std::uint8_t> hashes(32 * messages.size());
+        eth::keccak(data.data(), sizes.data(), messages.size(), hashes.data());
+        for (std::size_t i = 0; i < messages.size(); ++i)
+            BEAST_EXPECT(
+                strHex(hashes.begin() + 32 * i, hashes.begin() + 32 * (i + 1)) ==
+                keccakHex(messages[i]));
+
+        // A message longer than a block differs from its first block
+        BEAST_EXPECT(keccakHex(messages[4]) != keccakHex(messages[3]));
+    }
+
+    void
+    testSha256()
+    {
+        testcase("eth_sha256");
+
+        std::string const abc = "abc";
+        BEAST_EXPECT(
+            to_string(eth_sha256(makeSlice(abc))) ==
+            "BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD");
+        BEAST_EXPECT(
+            to_string(eth_sha256(makeSlice(std::string{}))) ==
+            "E3B0C44298FC1C149AFBF4C8996FB92427AE41E4649B934CA495991B7852B855");
+    }
+
+    void
+    testRipemd160()
+    {
+        testcase("eth_ripemd160");
+
+        std::string const abc = "abc";
+        auto const digest = eth_ripemd160(makeSlice(abc));
+        BEAST_EXPECT(digest.size() == 20);
+        BEAST_EXPECT(
+            strHex(digest) == "8EB208F7E05D987A9B044A8E98C6B087F15A0BFC");
+        BEAST_EXPECT(
+            strHex(eth_ripemd160(makeSlice(std::string{}))) ==
+            "9C1185A5C5E9FC54612808977EE8F548B2258D31");
+    }
+
+public:
+    void
+    run() override
+    {
+        testKeccak();
+        testSha256();
+        testRipemd160();
+    }
+};
+
+/*
+Hashes the 64 byte nodes of a Merkle proof, one at a time and as a batch.
+*/
+class HashBench_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    template <class F>
+    std::chrono::microseconds
+    measure(F&& f)
+    {
+        using namespace std::chrono;
+        auto best = microseconds::max();
+        for (int round = 0; round < 5; ++round)
+        {
+            auto const start = clock_type::now();
+            f();
+            best = std::min(
+                best, duration_cast<microseconds>(clock_type::now() - start));
+        }
+        return best;
+    }
+
+    void
+    report(char const* name, std::size_t count, std::chrono::microseconds t)
+    {
+        log << "    " << name << ": " << t.count() << " us, "
+            << (t.count() ? count * 1000000 / t.count() : 0) << " hashes/s"
+            << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        testcase("merkle nodes");
+
+        std::size_t const count = 100000;
+        std::vector<std::string> nodes(count, std::string(64, 0));
+        for (std::size_t i = 0; i < count; ++i)
+            for (std::size_t j = 0; j < 64; ++j)
+                nodes[i][j] = static_cast<char>(i + j);
+
+        std::vector<std::uint8_t const*> data;
+        std::vector<std::uint64_t> sizes;
+        for (auto const& node : nodes)
+        {
+            data.push_back((std::uint8_t const*)node.data());
+            sizes.push_back(node.size());
+        }
+        std::vector<std::uint8_t> hashes(32 * count);
+
+        report("keccak256", count, measure([&] {
+                   for (std::size_t i = 0; i < count; ++i)
+                       eth::keccak(data[i], sizes[i], &hashes[32 * i]);
+               }));
+        report("keccak256 batch", count, measure([&] {
+                   eth::keccak(data.data(), sizes.data(), count, hashes.data());
+               }));
+
+        uint256 sum;
+        report("eth_sha256", count, measure([&] {
+                   for (auto const& node : nodes)
+                       sum ^= eth_sha256(makeSlice(node));
+               }));
+        std::size_t size = 0;
+        report("eth_ripemd160", count, measure([&] {
+                   for (auto const& node : nodes)
+                       size += eth_ripemd160(makeSlice(node)).size();
+               }));
+        BEAST_EXPECT(size == 5 * 20 * count);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Hash, vm, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(HashBench, vm, ripple);
+
+}  // namespace ripple
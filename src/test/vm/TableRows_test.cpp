@@ -0,0 +1,269 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <peersafe/precompiled/ABI.h>
+#include <peersafe/precompiled/TableRows.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/json/json_reader.h>
+#include <ripple/json/json_writer.h>
+#include <chrono>
+#include <sstream>
+
+namespace ripple {
+
+namespace {
+
+// The rows as a contract would have spelled them for the JSON methods.
+Json::Value
+toJson(TableRows const& rows)
+{
+    Json::Value ret(Json::arrayValue);
+    for (std::size_t r = 0; r < rows.rowCount(); ++r)
+    {
+        Json::Value row(Json::objectValue);
+        for (std::size_t c = 0; c < rows.fields.size(); ++c)
+            row[rows.fields[c]] = rows.values[r * rows.fields.size() + c];
+        ret.append(row);
+    }
+    return ret;
+}
+
+TableRows
+makeRows(std::size_t count)
+{
+    TableRows rows;
+    rows.fields = {"name", "id", "balance", "memo"};
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        rows.values.push_back("user_" + std::to_string(i));
+        rows.values.push_back(std::to_string(i));
+        rows.values.push_back(std::to_string(i * 1000 + 7));
+        rows.values.push_back("row " + std::to_string(i) + " of the batch");
+    }
+    return rows;
+}
+
+}  // namespace
+
+class TableRows_test : public beast::unit_test::suite
+{
+    void
+    testRaw()
+    {
+        testcase("raw matches the JSON encoding");
+
+        auto rows = makeRows(3);
+        rows.values[3] = "quote \" backslash \\ tab \t newline \n";
+        BEAST_EXPECT(rows.toRaw() == Json::FastWriter().write(toJson(rows)));
+
+        TableRows set;
+        set.fields = {"memo", "balance"};
+        set.values = {"new", "1"};
+        TableRows where;
+        where.fields = {"id"};
+        where.values = {"1", "2"};
+
+        Json::Value update(Json::arrayValue);
+        update.append(toJson(set)[0u]);
+        update.append(toJson(where)[0u]);
+        update.append(toJson(where)[1u]);
+        BEAST_EXPECT(
+            toUpdateRaw(set, where) == Json::FastWriter().write(update));
+        BEAST_EXPECT(
+            toUpdateRaw(set, TableRows{}) ==
+            "[" + Json::FastWriter().write(toJson(set)[0u]) + "]");
+
+        Json::Value parsed;
+        BEAST_EXPECT(Json::Reader().parse(rows.toRaw(), parsed));
+        BEAST_EXPECT(parsed == toJson(rows));
+    }
+
+    void
+    testValid()
+    {
+        testcase("valid");
+
+        BEAST_EXPECT(makeRows(1).valid());
+        BEAST_EXPECT(!TableRows{}.valid());
+
+        auto rows = makeRows(2);
+        rows.values.pop_back();
+        BEAST_EXPECT(!rows.valid());
+
+        rows = makeRows(1);
+        rows.fields[2] = "id";
+        BEAST_EXPECT(!rows.valid());
+
+        rows = makeRows(1);
+        rows.fields[0].clear();
+        BEAST_EXPECT(!rows.valid());
+
+        TableRows set;
+        set.fields = {"memo"};
+        set.values = {"new"};
+        TableRows where;
+        BEAST_EXPECT(validUpdate(set, where));
+        where.fields = {"id"};
+        where.values = {"1", "2"};
+        BEAST_EXPECT(validUpdate(set, where));
+
+        // A condition must not turn into an update of every row
+        where.values.clear();
+        BEAST_EXPECT(!validUpdate(set, where));
+        where.fields.clear();
+        where.values = {"1"};
+        BEAST_EXPECT(!validUpdate(set, where));
+        where.fields = {"id", "name"};
+        where.values = {"1", "a", "2"};
+        BEAST_EXPECT(!validUpdate(set, where));
+
+        where = TableRows{};
+        set.values = {"a", "b"};
+        BEAST_EXPECT(!validUpdate(set, where));
+    }
+
+    void
+    testAbi()
+    {
+        testcase("abi");
+
+        AccountID const owner(7);
+        std::string const table("t_user");
+        auto const rows = makeRows(5);
+
+        // Checked sizes, as with featureTypedTableRows
+        ContractABI abi(true);
+        auto const data =
+            abi.abiIn("", owner, table, rows.fields, rows.values);
+
+        AccountID outOwner;
+        std::string outTable;
+        TableRows out;
+        BEAST_EXPECT(abi.abiOut(
+            bytesConstRef(&data), outOwner, outTable, out.fields, out.values));
+        BEAST_EXPECT(outOwner == owner);
+        BEAST_EXPECT(outTable == table);
+        BEAST_EXPECT(out.fields == rows.fields);
+        BEAST_EXPECT(out.values == rows.values);
+
+        // Well formed data decodes the same before the amendment
+        ContractABI legacy;
+        TableRows old;
+        BEAST_EXPECT(legacy.abiOut(
+            bytesConstRef(&data), outOwner, outTable, old.fields, old.values));
+        BEAST_EXPECT(old.fields == out.fields);
+        BEAST_EXPECT(old.values == out.values);
+
+        // An array claiming more elements than the call data holds is
+        // rejected without allocating for it.
+        auto bad = data;
+        auto const fieldsOffset = 3 * 32;
+        std::size_t arrayAt = 0;
+        for (int i = 0; i < 32; ++i)
+            arrayAt = (arrayAt << 8) | bad[fieldsOffset + i];
+        bad[arrayAt + 28] = 0x10;
+        BEAST_EXPECT(!abi.abiOut(
+            bytesConstRef(&bad), outOwner, outTable, out.fields, out.values));
+    }
+
+public:
+    void
+    run() override
+    {
+        testRaw();
+        testValid();
+        testAbi();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TableRows, vm, ripple);
+
+// Cost of a 1000 row insert through the table precompile: the JSON string
+// method against insertRows. Calldata gas uses the EVM schedule (16 per
+// non-zero byte, 4 per zero byte); the table fee is drops_per_byte * sfRaw
+// size and so only depends on the raw length.
+class TableRowsBench_test : public beast::unit_test::suite
+{
+    static std::int64_t
+    calldataGas(bytes const& data)
+    {
+        std::int64_t gas = 0;
+        for (auto const b : data)
+            gas += b ? 16 : 4;
+        return gas;
+    }
+
+public:
+    void
+    run() override
+    {
+        using namespace std::chrono;
+        int const calls = 50;
+        auto const rows = makeRows(1000);
+        AccountID const owner(7);
+        std::string const table("t_user");
+
+        ContractABI abi(true);
+        auto const jsonRaw = Json::FastWriter().write(toJson(rows));
+        auto const jsonData = abi.abiIn("", owner, table, jsonRaw);
+        auto const typedData =
+            abi.abiIn("", owner, table, rows.fields, rows.values);
+
+        std::size_t rawSize = 0;
+        auto start = steady_clock::now();
+        for (int i = 0; i < calls; ++i)
+        {
+            AccountID o;
+            std::string t, raw;
+            abi.abiOut(bytesConstRef(&jsonData), o, t, raw);
+            rawSize += raw.size();
+        }
+        auto const jsonTime = steady_clock::now() - start;
+
+        start = steady_clock::now();
+        for (int i = 0; i < calls; ++i)
+        {
+            AccountID o;
+            std::string t;
+            TableRows r;
+            abi.abiOut(bytesConstRef(&typedData), o, t, r.fields, r.values);
+            if (r.valid())
+                rawSize -= r.toRaw().size();
+        }
+        auto const typedTime = steady_clock::now() - start;
+        BEAST_EXPECT(rawSize == 0);
+
+        auto us = [&](auto d) {
+            return duration_cast<microseconds>(d).count() / calls;
+        };
+        std::stringstream ss;
+        ss << "1000 rows: sfRaw " << jsonRaw.size() << " bytes both ways; "
+           << "json calldata " << jsonData.size() << " bytes / "
+           << calldataGas(jsonData) << " gas, decode " << us(jsonTime)
+           << " us; typed calldata " << typedData.size() << " bytes / "
+           << calldataGas(typedData) << " gas, decode+raw " << us(typedTime)
+           << " us";
+        log << ss.str() << std::endl;
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(TableRowsBench, vm, ripple);
+
+}  // namespace ripple
@@ -0,0 +1,192 @@
+//------------------------------------------------------------------------------
+/*
+ This file is part of chainsqld: https://github.com/chainsql/chainsqld
+ Copyright (c) 2016-2018 Peersafe Technology Co., Ltd.
+
+	chainsqld is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	chainsqld is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//==============================================================================
+
+#include <eth/vm/executor/interpreter/interpreter.h>
+#include <eth/vm/Common.h>
+#include <ripple/beast/unit_test.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+namespace ripple {
+
+/*
+Runs a contract which calls itself a given number of times, each frame
+growing its memory before making the next call, with the interpreter
+allocating a VM per call and with the VMs it keeps per thread.
+
+The host is as thin as the interpreter allows, so the time measured is
+the interpreter's own.
+*/
+class VMPoolBench_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    struct Host
+    {
+        evmc_host_interface iface = {};
+        evmc_vm* vm = nullptr;
+        eth::bytes code;
+        std::size_t calls = 0;
+    };
+
+    static evmc_result
+    call(evmc_host_context* context, evmc_message const* msg)
+    {
+        auto& host = *reinterpret_cast<Host*>(context);
+        ++host.calls;
+        return host.vm->execute(
+            host.vm,
+            &host.iface,
+            context,
+            EVMC_ISTANBUL,
+            msg,
+            host.code.data(),
+            host.code.size());
+    }
+
+    // Stores its depth argument at `memory`, then calls itself with depth - 1
+    static eth::bytes
+    makeCode(std::uint16_t memory)
+    {
+        auto const hi = static_cast<std::uint8_t>(memory >> 8);
+        auto const lo = static_cast<std::uint8_t>(memory & 0xff);
+        return {
+            0x60, 0x00,        // PUSH1 0
+            0x35,              // CALLDATALOAD
+            0x80,              // DUP1
+            0x15,              // ISZERO
+            0x60, 0x23,        // PUSH1 end
+            0x57,              // JUMPI
+            0x80,              // DUP1
+            0x61, hi,   lo,    // PUSH2 memory
+            0x52,              // MSTORE
+            0x60, 0x01,        // PUSH1 1
+            0x90,              // SWAP1
+            0x03,              // SUB
+            0x60, 0x00,        // PUSH1 0
+            0x52,              // MSTORE
+            0x60, 0x20,        // PUSH1 32    out size
+            0x60, 0x00,        // PUSH1 0     out offset
+            0x60, 0x20,        // PUSH1 32    in size
+            0x60, 0x00,        // PUSH1 0     in offset
+            0x60, 0x00,        // PUSH1 0     value
+            0x30,              // ADDRESS
+            0x5a,              // GAS
+            0xf1,              // CALL
+            0x50,              // POP
+            0x00,              // STOP
+            0x5b,              // end: JUMPDEST
+            0x00,              // STOP
+        };
+    }
+
+    bool
+    execute(Host& host, std::uint8_t depth)
+    {
+        std::uint8_t input[32] = {};
+        input[31] = depth;
+
+        evmc_message msg = {};
+        msg.kind = EVMC_CALL;
+        msg.gas = 100000000;
+        msg.destination.bytes[19] = 1;
+        msg.input_data = input;
+        msg.input_size = sizeof(input);
+        msg.drops_per_byte = 1000;
+
+        auto result = call(reinterpret_cast<evmc_host_context*>(&host), &msg);
+        if (result.release)
+            result.release(&result);
+        return result.status_code == EVMC_SUCCESS;
+    }
+
+    void
+    testNested(std::uint8_t depth, std::uint16_t memory)
+    {
+        testcase(
+            std::to_string(depth) + " nested calls with " +
+            std::to_string(memory) + " bytes of memory each");
+
+        using namespace std::chrono;
+        std::size_t const count = 2000;
+
+        Host host;
+        host.iface.call = &VMPoolBench_test::call;
+        host.vm = evmc_create_aleth_interpreter();
+        host.code = makeCode(memory);
+
+        auto measure = [&](char const* name, bool pooling) {
+            eth::setInterpreterPooling(pooling);
+            // Fills the pool, if there is one
+            BEAST_EXPECT(execute(host, depth));
+
+            auto const before = eth::interpreterPoolStats();
+            host.calls = 0;
+            auto best = microseconds::max();
+            bool ok = true;
+            for (int round = 0; round < 5; ++round)
+            {
+                auto const start = clock_type::now();
+                for (std::size_t i = 0; i < count; ++i)
+                    ok = execute(host, depth) && ok;
+                best = std::min(
+                    best,
+                    duration_cast<microseconds>(clock_type::now() - start));
+            }
+            auto const after = eth::interpreterPoolStats();
+
+            BEAST_EXPECT(ok);
+            BEAST_EXPECT(host.calls == 5 * count * (depth + 1));
+
+            eth::InterpreterPoolStats delta;
+            delta.created = after.created - before.created;
+            delta.reused = after.reused - before.reused;
+            delta.memoryGrows = after.memoryGrows - before.memoryGrows;
+            log << "    " << name << ": " << best.count() << " us, "
+                << (best.count() ? count * 1000000 / best.count() : 0)
+                << " calls/s, " << delta.created << " VMs created, "
+                << delta.memoryGrows << " memory grows" << std::endl;
+            return delta;
+        };
+
+        auto const unpooled = measure("VM per call", false);
+        BEAST_EXPECT(unpooled.created == 5 * count * (depth + 1));
+
+        // The warm up call allocated every VM and buffer the frames need
+        auto const pooled = measure("pooled VMs", true);
+        BEAST_EXPECT(pooled.created == 0);
+        BEAST_EXPECT(pooled.memoryGrows == 0);
+        BEAST_EXPECT(pooled.reused == 5 * count * (depth + 1));
+    }
+
+public:
+    void
+    run() override
+    {
+        testNested(4, 1024);
+        testNested(16, 4096);
+        testNested(31, 16384);
+        eth::setInterpreterPooling(true);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(VMPoolBench, vm, ripple);
+
+}  // namespace ripple
@@ -0,0 +1,100 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <tuple>
+
+#include "wasmvm/vm/chainsqlWasmVm.h"
+#include "wasmvm/vm/actionCallback.h"
+#include "wasmvm/common/name.h"
+#include "wasmvm/common/datastream.h"
+
+#include "wasmvm/contract/math/math.wasm.h"
+
+// Calls/sec of the math contract's add action, loading the module for every
+// call as chainsqlWasmVm does against chainsqlWasmVm::applyCached.
+
+namespace {
+
+std::function<void(int32_t, const void *)> assert_fn = [](int32_t test, const void *msg) {
+    if (!test)
+        throw std::runtime_error((const char *)msg);
+};
+std::function<void(int64_t)> printi_fn = [](int64_t) {};
+std::function<void(const void *)> prints_fn = [](const void *) {};
+std::function<void(const void *, int32_t)> prints_l_fn = [](const void *, int32_t) {};
+std::function<void(int64_t)> contract_name_fn = [](int64_t) {};
+std::function<void(int32_t, int64_t)> assert_code_fn = [](int32_t, int64_t) {};
+
+void link_host(wasm3::module &mod)
+{
+    mod.link_optional("*", "chainsql_assert", &assert_fn);
+    mod.link_optional("*", "printi", &printi_fn);
+    mod.link_optional("*", "prints", &prints_fn);
+    mod.link_optional("*", "prints_l", &prints_l_fn);
+    mod.link_optional("*", "chainsql_set_contract_name", &contract_name_fn);
+    mod.link_optional("*", "chainsql_assert_code", &assert_code_fn);
+}
+
+chainsql::action make_action(int a, int b)
+{
+    std::tuple<int, int> args = std::make_tuple(a, b);
+    std::string payload;
+    payload.resize(2 * sizeof(int));
+    chainsql::datastream<char *> ds = chainsql::datastream<char *>(payload.data(), payload.size());
+    ds << args;
+    return chainsql::action(chainsql::name("math"), chainsql::name("add"), payload);
+}
+
+template <typename F>
+double calls_per_sec(int calls, F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < calls; ++i)
+        f(i);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return calls / elapsed.count();
+}
+
+}
+
+int main(int argc, char** argv) {
+    int calls = argc > 1 ? std::atoi(argv[1]) : 20000;
+    size_t const stack_size = 64 * 1024;
+    std::string const code_hash = "math";
+
+    try {
+        long long sum = 0;
+        double uncached = calls_per_sec(calls, [&](int i) {
+            chainsql::action action = make_action(i, 1);
+            chainsql::chainsqlWasmVm vm(stack_size);
+            wasm3::module mod = vm.loadWasm(math_wasm, math_wasm_len);
+            link_host(mod);
+            chainsql::actionCallback<int> cb(action, mod);
+            sum += vm.apply<int>(&cb);
+        });
+
+        double cached = calls_per_sec(calls, [&](int i) {
+            chainsql::action action = make_action(i, 1);
+            sum -= chainsql::chainsqlWasmVm::applyCached<int>(
+                code_hash, math_wasm, math_wasm_len, action, link_host);
+        });
+
+        auto const &stats = chainsql::moduleCache::local().getStats();
+        std::cout << calls << " calls of math.add" << std::endl
+                  << "  load per call: " << (long long)uncached << " calls/sec" << std::endl
+                  << "  module cache:  " << (long long)cached << " calls/sec ("
+                  << cached / uncached << "x, " << stats.hits << " hits, "
+                  << stats.misses << " misses)" << std::endl;
+        if (sum != 0) {
+            std::cerr << "results differ between the two paths" << std::endl;
+            return 1;
+        }
+    }
+    catch (wasm3::error &e)
+    {
+        std::cerr << "WASM3 error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
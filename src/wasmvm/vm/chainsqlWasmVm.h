@@ -3,6 +3,7 @@
 #include <functional>
 
 #include <wasmvm/vm/actionCallback.h>
+#include <wasmvm/vm/moduleCache.h>
 #include <wasm3_cpp.h>
 
 namespace chainsql {
@@ -40,5 +41,47 @@ public:
 
         return cb->result();
     }
+
+    // Run `ac` against the calling thread's cached instance of the code
+    // identified by `code_hash`, loading it on a miss. Host functions bound
+    // by `link` must outlive the cache.
+    template <typename T>
+    static T
+    applyCached(
+        const std::string& code_hash,
+        const uint8_t* data,
+        size_t size,
+        const action& ac,
+        const cachedModule::linker& link = {})
+    {
+        moduleCache& cache = moduleCache::local();
+        std::unique_ptr<cachedModule> mod =
+            cache.acquire(code_hash, data, size, link);
+
+        mod->slot().begin(ac);
+        try
+        {
+            mod->function("apply").call(
+                ac.code().value, ac.code().value, ac.function().value);
+        }
+        catch (...)
+        {
+            mod->slot().end();
+            cache.release(code_hash, std::move(mod), false);
+            throw;
+        }
+        mod->slot().end();
+
+        if constexpr (std::is_void<T>::value)
+        {
+            cache.release(code_hash, std::move(mod), true);
+        }
+        else
+        {
+            T ret = mod->slot().template result<T>();
+            cache.release(code_hash, std::move(mod), true);
+            return ret;
+        }
+    }
 };
 }  // namespace chainsql
@@ -0,0 +1,111 @@
+#include <wasmvm/vm/moduleCache.h>
+
+namespace chainsql {
+
+cachedModule::cachedModule(
+    wasm3::environment &env,
+    const uint8_t *data,
+    size_t size,
+    size_t stack_size_bytes,
+    const linker &link)
+: runtime_(env.new_runtime(stack_size_bytes))
+, module_(env.parse_module(data, size)) {
+    runtime_.load(module_);
+    module_.link_libc();
+    module_.link("*", "read_action_data", &slot_.read_action_data);
+    module_.link("*", "action_data_size", &slot_.action_data_size);
+    module_.link_optional("*", "set_action_return_value", &slot_.set_action_return_value);
+    if (link)
+        link(module_);
+
+    IM3Runtime rt = runtime_.native();
+    IM3Module mod = rt->modules;
+    wasm3::detail::check_error(m3_RunStart(mod));
+
+    if (rt->memory.mallocated != nullptr) {
+        uint32_t bytes = 0;
+        uint8_t *memory = runtime_.memory(bytes);
+        memory_.assign(memory, memory + bytes);
+    }
+    globals_.reserve(mod->numGlobals);
+    for (u32 i = 0; i < mod->numGlobals; ++i)
+        globals_.push_back(mod->globals[i].intValue);
+}
+
+wasm3::function &cachedModule::function(const char *name) {
+    auto it = functions_.find(name);
+    if (it == functions_.end())
+        it = functions_.emplace(name, runtime_.find_function(name)).first;
+    return it->second;
+}
+
+bool cachedModule::reset() {
+    IM3Runtime rt = runtime_.native();
+    IM3Module mod = rt->modules;
+
+    if (rt->memory.mallocated != nullptr) {
+        uint32_t bytes = 0;
+        uint8_t *memory = runtime_.memory(bytes);
+        if (bytes != memory_.size())
+            return false;
+        std::memcpy(memory, memory_.data(), bytes);
+    }
+    for (u32 i = 0; i < mod->numGlobals; ++i)
+        mod->globals[i].intValue = globals_[i];
+    return true;
+}
+
+moduleCache::moduleCache(size_t capacity, size_t stack_size_bytes)
+: env_()
+, capacity_(capacity)
+, stack_size_(stack_size_bytes) {
+}
+
+moduleCache &moduleCache::local() {
+    static thread_local moduleCache cache;
+    return cache;
+}
+
+std::unique_ptr<cachedModule> moduleCache::acquire(
+    const std::string &code_hash,
+    const uint8_t *code,
+    size_t size,
+    const cachedModule::linker &link) {
+    auto it = modules_.find(code_hash);
+    if (it != modules_.end()) {
+        ++stats_.hits;
+        auto mod = std::move(it->second.mod);
+        lru_.erase(it->second.lru);
+        modules_.erase(it);
+        return mod;
+    }
+    ++stats_.misses;
+    return std::make_unique<cachedModule>(env_, code, size, stack_size_, link);
+}
+
+void moduleCache::release(
+    const std::string &code_hash,
+    std::unique_ptr<cachedModule> mod,
+    bool ok) {
+    if (!mod)
+        return;
+    // A module of the same code may have come back first from a nested call.
+    if (!ok || capacity_ == 0 || modules_.count(code_hash) || !mod->reset()) {
+        ++stats_.discards;
+        return;
+    }
+    while (modules_.size() >= capacity_) {
+        modules_.erase(lru_.back());
+        lru_.pop_back();
+        ++stats_.evictions;
+    }
+    lru_.push_front(code_hash);
+    modules_.emplace(code_hash, entry{std::move(mod), lru_.begin()});
+}
+
+void moduleCache::clear() {
+    modules_.clear();
+    lru_.clear();
+}
+
+}
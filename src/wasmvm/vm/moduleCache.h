@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstring>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <wasmvm/vm/action.h>
+#include <wasm3_cpp.h>
+
+namespace chainsql {
+
+    // Host side of the action imports of a cached module. The imports are
+    // linked once when the module is loaded; every call points the slot at
+    // its own action and collects its own return value.
+    class actionSlot
+    {
+    private:
+        const action *action_ = nullptr;
+        std::string result_;
+
+    public:
+        std::function<int32_t(void *, int32_t)> read_action_data =
+            [this](void *msg, int32_t len) -> int32_t {
+                if (action_ == nullptr || len < 0)
+                    return 0;
+                int32_t size = std::min(len, (int32_t)action_->payload().size());
+                std::memcpy(msg, action_->payload().data(), size);
+                return size;
+            };
+        std::function<int32_t()> action_data_size = [this]() -> int32_t {
+            return action_ == nullptr ? 0 : (int32_t)action_->payload().size();
+        };
+        std::function<void(void *, int32_t)> set_action_return_value =
+            [this](void *value, int32_t size) {
+                if (size > 0)
+                    result_.assign((const char *)value, size);
+            };
+
+        void begin(const action &ac)
+        {
+            action_ = &ac;
+            result_.clear();
+        }
+
+        void end()
+        {
+            action_ = nullptr;
+        }
+
+        template <typename T>
+        T result() const
+        {
+            T ret{};
+            std::memcpy(&ret, result_.data(), std::min(sizeof(T), result_.size()));
+            return ret;
+        }
+    };
+
+    // A contract module parsed, loaded and linked into its own runtime, kept
+    // across calls. wasm3 resolves exports by name over every module of a
+    // runtime and gives a runtime a single linear memory, so each module
+    // gets a runtime of its own.
+    //
+    // The linear memory and the globals are captured once the module is
+    // loaded and its start function has run; reset() puts them back so a
+    // call never sees what the previous one left behind.
+    class cachedModule
+    {
+    public:
+        using linker = std::function<void(wasm3::module &)>;
+
+        cachedModule(
+            wasm3::environment &env,
+            const uint8_t *data,
+            size_t size,
+            size_t stack_size_bytes,
+            const linker &link);
+
+        cachedModule(const cachedModule &) = delete;
+        cachedModule &operator=(const cachedModule &) = delete;
+
+        wasm3::module &module()
+        {
+            return module_;
+        }
+
+        actionSlot &slot()
+        {
+            return slot_;
+        }
+
+        // Resolved on first use and kept for the life of the module.
+        wasm3::function &function(const char *name);
+
+        // Restore memory and globals. Returns false if the module can't be
+        // reused, i.e. its memory grew.
+        bool reset();
+
+    private:
+        wasm3::runtime runtime_;
+        wasm3::module module_;
+        actionSlot slot_;
+        std::map<std::string, wasm3::function> functions_;
+        std::vector<uint8_t> memory_;
+        std::vector<int64_t> globals_;
+    };
+
+    // Per thread pool of cached modules, keyed by code hash and bounded by
+    // count. A module is taken out of the pool for the length of a call, so
+    // a contract re-entering itself gets a fresh instance, and is only put
+    // back if the call completed and the module could be reset.
+    class moduleCache
+    {
+    public:
+        static constexpr size_t defaultCapacity = 32;
+        static constexpr size_t defaultStackSize = 64 * 1024;
+
+        explicit moduleCache(
+            size_t capacity = defaultCapacity,
+            size_t stack_size_bytes = defaultStackSize);
+
+        moduleCache(const moduleCache &) = delete;
+        moduleCache &operator=(const moduleCache &) = delete;
+
+        // The calling thread's cache.
+        static moduleCache &local();
+
+        std::unique_ptr<cachedModule> acquire(
+            const std::string &code_hash,
+            const uint8_t *code,
+            size_t size,
+            const cachedModule::linker &link = {});
+
+        // Return a module after a call; `ok` is false if the call threw.
+        void release(
+            const std::string &code_hash,
+            std::unique_ptr<cachedModule> mod,
+            bool ok);
+
+        void clear();
+
+        size_t size() const
+        {
+            return modules_.size();
+        }
+
+        struct stats
+        {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t evictions = 0;
+            uint64_t discards = 0;
+        };
+
+        const stats &getStats() const
+        {
+            return stats_;
+        }
+
+    private:
+        using lru_list = std::list<std::string>;
+        struct entry
+        {
+            std::unique_ptr<cachedModule> mod;
+            lru_list::iterator lru;
+        };
+
+        wasm3::environment env_;
+        size_t const capacity_;
+        size_t const stack_size_;
+        lru_list lru_;
+        std::unordered_map<std::string, entry> modules_;
+        stats stats_;
+    };
+
+} // namespace chainsql
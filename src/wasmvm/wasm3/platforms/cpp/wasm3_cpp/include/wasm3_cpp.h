@@ -307,6 +307,8 @@ namespace wasm3 {
 
         uint8_t* memory(uint32_t& size);
         void reload_memory(uint8_t* m, uint32_t size);
+        /** Underlying runtime, for the calls this wrapper doesn't cover. */
+        IM3Runtime native() const { return m_runtime.get(); }
 
     protected:
         friend class environment;